@@ -34,7 +34,22 @@
 */
 #define SDL_PROC_UNUSED(ret, func, params)
 
+/* Functions from OpenGL versions or extensions newer than what the
+   library requires (OpenGL 3.3 core) are marked SDL_PROC_OPTIONAL.
+   They are still members of GL_Context, but a loader can leave them
+   as nullptr if the driver doesn't provide them.  Check
+   GLContext::supports() before calling one.
+
+   If the includer doesn't care about the difference, optional
+   functions are treated the same as SDL_PROC.
+*/
+#ifndef SDL_PROC_OPTIONAL
+#define SDL_PROC_OPTIONAL(ret, func, params) SDL_PROC(ret, func, params)
+#define SDL_GLFUNCS_DEFAULT_PROC_OPTIONAL
+#endif
+
 SDL_PROC_UNUSED(void, glAccum, (GLenum, GLfloat))
+SDL_PROC(void, glActiveTexture, (GLenum texture))
 SDL_PROC_UNUSED(void, glAlphaFunc, (GLenum, GLclampf))
 SDL_PROC_UNUSED(GLboolean, glAreTexturesResident,
                 (GLsizei, const GLuint *, GLboolean *))
@@ -48,8 +63,19 @@ SDL_PROC(void, glBegin, (GLenum))
 // Added by JMG 2025-03-16
 SDL_PROC(void, glBindBuffer, (GLenum, GLuint))
 
+SDL_PROC(void, glBindBufferBase, (GLenum target, GLuint index, GLuint buffer))
+
+SDL_PROC(void, glBindBufferRange,
+         (GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+          GLsizeiptr size))
+
 SDL_PROC(void, glBindTexture, (GLenum, GLuint))
 
+// OpenGL 4.3 or ARB_vertex_attrib_binding
+SDL_PROC_OPTIONAL(void, glBindVertexBuffer,
+                  (GLuint bindingindex, GLuint buffer, GLintptr offset,
+                   GLsizei stride))
+
 // Added by JMG 2025-03-16
 SDL_PROC(void, glBindVertexArray, (GLuint array))
 
@@ -67,6 +93,14 @@ SDL_PROC(void, glBlendFuncSeparate, (GLenum, GLenum, GLenum, GLenum))
 SDL_PROC(void, glBufferData,
          (GLenum target, GLsizeiptr size, const void *data, GLenum usage))
 
+// OpenGL 4.4 or ARB_buffer_storage
+SDL_PROC_OPTIONAL(void, glBufferStorage,
+                  (GLenum target, GLsizeiptr size, const void *data,
+                   GLbitfield flags))
+
+SDL_PROC(void, glBufferSubData,
+         (GLenum target, GLintptr offset, GLsizeiptr size, const void *data))
+
 SDL_PROC_UNUSED(void, glCallList, (GLuint))
 SDL_PROC_UNUSED(void, glCallLists, (GLsizei, GLenum, const GLvoid *))
 SDL_PROC(void, glClear, (GLbitfield))
@@ -75,6 +109,10 @@ SDL_PROC(void, glClearColor, (GLclampf, GLclampf, GLclampf, GLclampf))
 SDL_PROC_UNUSED(void, glClearDepth, (GLclampd))
 SDL_PROC_UNUSED(void, glClearIndex, (GLfloat))
 SDL_PROC_UNUSED(void, glClearStencil, (GLint))
+
+SDL_PROC(GLenum, glClientWaitSync,
+         (GLsync sync, GLbitfield flags, GLuint64 timeout))
+
 SDL_PROC_UNUSED(void, glClipPlane, (GLenum, const GLdouble *))
 SDL_PROC_UNUSED(void, glColor3b, (GLbyte, GLbyte, GLbyte))
 SDL_PROC_UNUSED(void, glColor3bv, (const GLbyte *))
@@ -121,6 +159,10 @@ SDL_PROC(void, glColorPointer,
 // Added by JMG 2025-03-16
 SDL_PROC(void, glCompileShader, (GLuint shader))
 
+SDL_PROC(void, glCopyBufferSubData,
+         (GLenum readTarget, GLenum writeTarget, GLintptr readOffset,
+          GLintptr writeOffset, GLsizeiptr size))
+
 SDL_PROC_UNUSED(void, glCopyPixels,
                 (GLint x, GLint y, GLsizei width, GLsizei height, GLenum type))
 SDL_PROC_UNUSED(void, glCopyTexImage1D,
@@ -136,12 +178,22 @@ SDL_PROC_UNUSED(void, glCopyTexSubImage2D,
                 (GLenum target, GLint level, GLint xoffset, GLint yoffset,
                  GLint x, GLint y, GLsizei width, GLsizei height))
 
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glCreateBuffers, (GLsizei n, GLuint *buffers))
+
 // Added by JMG 2025-03-16
 SDL_PROC(GLuint, glCreateProgram, (void))
 
 // Added by JMG 2025-03-16
 SDL_PROC(GLuint, glCreateShader, (GLenum type))
 
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glCreateTextures,
+                  (GLenum target, GLsizei n, GLuint *textures))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glCreateVertexArrays, (GLsizei n, GLuint *arrays))
+
 SDL_PROC_UNUSED(void, glCullFace, (GLenum mode))
 
 // Added by JMG 2025-03-16
@@ -155,6 +207,8 @@ SDL_PROC(void, glDeleteProgram, (GLuint program))
 // Added by JMG 2025-03-16
 SDL_PROC(void, glDeleteShader, (GLuint shader))
 
+SDL_PROC(void, glDeleteSync, (GLsync sync))
+
 SDL_PROC(void, glDeleteTextures, (GLsizei n, const GLuint *textures))
 
 // Added by JMG 2025-03-16
@@ -166,10 +220,22 @@ SDL_PROC_UNUSED(void, glDepthRange, (GLclampd zNear, GLclampd zFar))
 SDL_PROC(void, glDisable, (GLenum cap))
 SDL_PROC(void, glDisableClientState, (GLenum array))
 SDL_PROC(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count))
+SDL_PROC(void, glDrawArraysInstanced,
+         (GLenum mode, GLint first, GLsizei count, GLsizei instancecount))
 SDL_PROC_UNUSED(void, glDrawBuffer, (GLenum mode))
-SDL_PROC_UNUSED(void, glDrawElements,
-                (GLenum mode, GLsizei count, GLenum type,
-                 const GLvoid *indices))
+SDL_PROC(void, glDrawElements,
+         (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices))
+SDL_PROC(void, glDrawElementsBaseVertex,
+         (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices,
+          GLint basevertex))
+SDL_PROC(void, glDrawElementsInstanced,
+         (GLenum mode, GLsizei count, GLenum type, const void *indices,
+          GLsizei instancecount))
+
+SDL_PROC(void, glDrawElementsInstancedBaseVertex,
+         (GLenum mode, GLsizei count, GLenum type, const void *indices,
+          GLsizei instancecount, GLint basevertex))
+
 SDL_PROC(void, glDrawPixels,
          (GLsizei width, GLsizei height, GLenum format, GLenum type,
           const GLvoid *pixels))
@@ -180,6 +246,9 @@ SDL_PROC_UNUSED(void, glEdgeFlagv, (const GLboolean *flag))
 SDL_PROC(void, glEnable, (GLenum cap))
 SDL_PROC(void, glEnableClientState, (GLenum array))
 
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glEnableVertexArrayAttrib, (GLuint vaobj, GLuint index))
+
 // Added by JMG 2025-03-16
 SDL_PROC(void, glEnableVertexAttribArray, (GLuint index))
 
@@ -200,6 +269,9 @@ SDL_PROC_UNUSED(void, glEvalPoint1, (GLint i))
 SDL_PROC_UNUSED(void, glEvalPoint2, (GLint i, GLint j))
 SDL_PROC_UNUSED(void, glFeedbackBuffer,
                 (GLsizei size, GLenum type, GLfloat *buffer))
+
+SDL_PROC(GLsync, glFenceSync, (GLenum condition, GLbitfield flags))
+
 SDL_PROC_UNUSED(void, glFinish, (void))
 
 // SDL_PROC_UNUSED(void, glFlush, (void))
@@ -224,6 +296,11 @@ SDL_PROC(void, glGenTextures, (GLsizei n, GLuint *textures))
 // Added by JMG 2025-03-16
 SDL_PROC(void, glGenVertexArrays, (GLsizei n, GLuint *arrays))
 
+SDL_PROC(void, glGenerateMipmap, (GLenum target))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glGenerateTextureMipmap, (GLuint texture))
+
 // Added by JMG 2025-03-16
 SDL_PROC(void, glGetAttachedShaders,
          (GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders))
@@ -267,6 +344,9 @@ SDL_PROC(void, glGetShaderInfoLog,
          (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog))
 
 SDL_PROC(const GLubyte *, glGetString, (GLenum name))
+
+SDL_PROC(const GLubyte *, glGetStringi, (GLenum name, GLuint index))
+
 SDL_PROC_UNUSED(void, glGetTexEnvfv,
                 (GLenum target, GLenum pname, GLfloat *params))
 SDL_PROC_UNUSED(void, glGetTexEnviv,
@@ -289,6 +369,9 @@ SDL_PROC_UNUSED(void, glGetTexParameterfv,
 SDL_PROC_UNUSED(void, glGetTexParameteriv,
                 (GLenum target, GLenum pname, GLint *params))
 
+SDL_PROC(GLuint, glGetUniformBlockIndex,
+         (GLuint program, const GLchar *uniformBlockName))
+
 // Added by JMG 2025-03-25
 SDL_PROC(GLint, glGetUniformLocation, (GLuint program, const GLchar *name))
 
@@ -348,6 +431,11 @@ SDL_PROC_UNUSED(void, glMap2f,
                 (GLenum target, GLfloat u1, GLfloat u2, GLint ustride,
                  GLint uorder, GLfloat v1, GLfloat v2, GLint vstride,
                  GLint vorder, const GLfloat *points))
+
+SDL_PROC(void *, glMapBufferRange,
+         (GLenum target, GLintptr offset, GLsizeiptr length,
+          GLbitfield access))
+
 SDL_PROC_UNUSED(void, glMapGrid1d, (GLint un, GLdouble u1, GLdouble u2))
 SDL_PROC_UNUSED(void, glMapGrid1f, (GLint un, GLfloat u1, GLfloat u2))
 SDL_PROC_UNUSED(void, glMapGrid2d,
@@ -365,6 +453,36 @@ SDL_PROC_UNUSED(void, glMaterialiv,
 SDL_PROC(void, glMatrixMode, (GLenum mode))
 SDL_PROC_UNUSED(void, glMultMatrixd, (const GLdouble *m))
 SDL_PROC_UNUSED(void, glMultMatrixf, (const GLfloat *m))
+
+SDL_PROC(void, glMultiDrawArrays,
+         (GLenum mode, const GLint *first, const GLsizei *count,
+          GLsizei drawcount))
+
+// OpenGL 4.3 or ARB_multi_draw_indirect
+SDL_PROC_OPTIONAL(void, glMultiDrawArraysIndirect,
+                  (GLenum mode, const void *indirect, GLsizei drawcount,
+                   GLsizei stride))
+
+SDL_PROC(void, glMultiDrawElementsBaseVertex,
+         (GLenum mode, const GLsizei *count, GLenum type,
+          const void *const *indices, GLsizei drawcount,
+          const GLint *basevertex))
+
+// OpenGL 4.3 or ARB_multi_draw_indirect
+SDL_PROC_OPTIONAL(void, glMultiDrawElementsIndirect,
+                  (GLenum mode, GLenum type, const void *indirect,
+                   GLsizei drawcount, GLsizei stride))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glNamedBufferData,
+                  (GLuint buffer, GLsizeiptr size, const void *data,
+                   GLenum usage))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glNamedBufferSubData,
+                  (GLuint buffer, GLintptr offset, GLsizeiptr size,
+                   const void *data))
+
 SDL_PROC_UNUSED(void, glNewList, (GLuint list, GLenum mode))
 SDL_PROC_UNUSED(void, glNormal3b, (GLbyte nx, GLbyte ny, GLbyte nz))
 SDL_PROC_UNUSED(void, glNormal3bv, (const GLbyte *v))
@@ -537,13 +655,26 @@ SDL_PROC(void, glTexImage2D,
          (GLenum target, GLint level, GLint internalformat, GLsizei width,
           GLsizei height, GLint border, GLenum format, GLenum type,
           const GLvoid *pixels))
-SDL_PROC_UNUSED(void, glTexParameterf,
-                (GLenum target, GLenum pname, GLfloat param))
+SDL_PROC(void, glTexImage3D,
+         (GLenum target, GLint level, GLint internalformat, GLsizei width,
+          GLsizei height, GLsizei depth, GLint border, GLenum format,
+          GLenum type, const GLvoid *pixels))
+SDL_PROC(void, glTexParameterf, (GLenum target, GLenum pname, GLfloat param))
 SDL_PROC_UNUSED(void, glTexParameterfv,
                 (GLenum target, GLenum pname, const GLfloat *params))
 SDL_PROC(void, glTexParameteri, (GLenum target, GLenum pname, GLint param))
 SDL_PROC_UNUSED(void, glTexParameteriv,
                 (GLenum target, GLenum pname, const GLint *params))
+
+// OpenGL 4.2 or ARB_texture_storage
+SDL_PROC_OPTIONAL(void, glTexStorage2D,
+                  (GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height))
+
+// OpenGL 4.2 or ARB_texture_storage
+SDL_PROC_OPTIONAL(void, glTexStorage3D,
+                  (GLenum target, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth))
 SDL_PROC_UNUSED(void, glTexSubImage1D,
                 (GLenum target, GLint level, GLint xoffset, GLsizei width,
                  GLenum format, GLenum type, const GLvoid *pixels))
@@ -551,6 +682,42 @@ SDL_PROC(void, glTexSubImage2D,
          (GLenum target, GLint level, GLint xoffset, GLint yoffset,
           GLsizei width, GLsizei height, GLenum format, GLenum type,
           const GLvoid *pixels))
+SDL_PROC(void, glTexSubImage3D,
+         (GLenum target, GLint level, GLint xoffset, GLint yoffset,
+          GLint zoffset, GLsizei width, GLsizei height, GLsizei depth,
+          GLenum format, GLenum type, const GLvoid *pixels))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureParameterf,
+                  (GLuint texture, GLenum pname, GLfloat param))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureParameteri,
+                  (GLuint texture, GLenum pname, GLint param))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureStorage2D,
+                  (GLuint texture, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureStorage3D,
+                  (GLuint texture, GLsizei levels, GLenum internalformat,
+                   GLsizei width, GLsizei height, GLsizei depth))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureSubImage2D,
+                  (GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+                   GLsizei width, GLsizei height, GLenum format, GLenum type,
+                   const void *pixels))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glTextureSubImage3D,
+                  (GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+                   GLint zoffset, GLsizei width, GLsizei height,
+                   GLsizei depth, GLenum format, GLenum type,
+                   const void *pixels))
+
 SDL_PROC_UNUSED(void, glTranslated, (GLdouble x, GLdouble y, GLdouble z))
 SDL_PROC_UNUSED(void, glTranslatef, (GLfloat x, GLfloat y, GLfloat z))
 
@@ -562,11 +729,17 @@ SDL_PROC(void, glUniform3fv,
 SDL_PROC(void, glUniform4fv,
          (GLint location, GLsizei count, const GLfloat *value))
 
+SDL_PROC(void, glUniformBlockBinding,
+         (GLuint program, GLuint uniformBlockIndex,
+          GLuint uniformBlockBinding))
+
 // Added by JMG 2025-03-25
 SDL_PROC(void, glUniformMatrix4fv,
          (GLint location, GLsizei count, GLboolean transpose,
           const GLfloat *value))
 
+SDL_PROC(GLboolean, glUnmapBuffer, (GLenum target))
+
 // Added by JMG 2025-03-16
 SDL_PROC(void, glUseProgram, (GLuint program))
 
@@ -596,10 +769,61 @@ SDL_PROC_UNUSED(void, glVertex4iv, (const GLint *v))
 SDL_PROC_UNUSED(void, glVertex4s, (GLshort x, GLshort y, GLshort z, GLshort w))
 SDL_PROC_UNUSED(void, glVertex4sv, (const GLshort *v))
 
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayAttribBinding,
+                  (GLuint vaobj, GLuint attribindex, GLuint bindingindex))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayAttribFormat,
+                  (GLuint vaobj, GLuint attribindex, GLint size, GLenum type,
+                   GLboolean normalized, GLuint relativeoffset))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayAttribIFormat,
+                  (GLuint vaobj, GLuint attribindex, GLint size, GLenum type,
+                   GLuint relativeoffset))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayBindingDivisor,
+                  (GLuint vaobj, GLuint bindingindex, GLuint divisor))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayElementBuffer,
+                  (GLuint vaobj, GLuint buffer))
+
+// OpenGL 4.5 or ARB_direct_state_access
+SDL_PROC_OPTIONAL(void, glVertexArrayVertexBuffer,
+                  (GLuint vaobj, GLuint bindingindex, GLuint buffer,
+                   GLintptr offset, GLsizei stride))
+
+// OpenGL 4.3 or ARB_vertex_attrib_binding
+SDL_PROC_OPTIONAL(void, glVertexAttribBinding,
+                  (GLuint attribindex, GLuint bindingindex))
+
+SDL_PROC(void, glVertexAttribDivisor, (GLuint index, GLuint divisor))
+
+// OpenGL 4.3 or ARB_vertex_attrib_binding
+SDL_PROC_OPTIONAL(void, glVertexAttribFormat,
+                  (GLuint attribindex, GLint size, GLenum type,
+                   GLboolean normalized, GLuint relativeoffset))
+
+// OpenGL 4.3 or ARB_vertex_attrib_binding
+SDL_PROC_OPTIONAL(void, glVertexAttribIFormat,
+                  (GLuint attribindex, GLint size, GLenum type,
+                   GLuint relativeoffset))
+
+SDL_PROC(void, glVertexAttribIPointer,
+         (GLuint index, GLint size, GLenum type, GLsizei stride,
+          const void *pointer))
+
 SDL_PROC(void, glVertexAttribPointer,
          (GLuint index, GLint size, GLenum type, GLboolean normalized,
           GLsizei stride, const void *pointer))
 
+// OpenGL 4.3 or ARB_vertex_attrib_binding
+SDL_PROC_OPTIONAL(void, glVertexBindingDivisor,
+                  (GLuint bindingindex, GLuint divisor))
+
 // The following loading function has been moved into
 // test/src/sdl_opengl_tester.cpp
 
@@ -622,4 +846,9 @@ SDL_PROC(void, glVertexPointer,
 
 SDL_PROC(void, glViewport, (GLint x, GLint y, GLsizei width, GLsizei height))
 
+#ifdef SDL_GLFUNCS_DEFAULT_PROC_OPTIONAL
+#undef SDL_PROC_OPTIONAL
+#undef SDL_GLFUNCS_DEFAULT_PROC_OPTIONAL
+#endif
+
 /* vi: set ts=4 sw=4 expandtab: */
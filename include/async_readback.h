@@ -0,0 +1,248 @@
+#ifndef _SDL_OPENGL_CPP_ASYNC_READBACK_H_
+#define _SDL_OPENGL_CPP_ASYNC_READBACK_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "fence.h"
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace async_readback {
+
+#ifndef NO_EXCEPTIONS
+
+//! A ReadbackNotStartedError exception
+//!
+//! This exception is thrown when waiting on or fetching the result
+//! of an AsyncReadback that hasn't had a read issued.
+//!
+class ReadbackNotStartedError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A ReadbackFenceError exception
+//!
+//! This exception is thrown when creating or waiting on the fence
+//! guarding a read fails.
+//!
+class ReadbackFenceError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A ReadbackMapError exception
+//!
+//! This exception is thrown when the readback buffer could not be
+//! mapped, or its contents were lost while mapped.
+//!
+class ReadbackMapError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A AsyncReadbackUnspecifiedStateError exception
+//!
+//! This exception is thrown when the AsyncReadback is in an valid
+//! but unspecified state after a move operation.
+//!
+class AsyncReadbackUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace async_readback
+
+using namespace async_readback;
+
+//! An AsyncReadback copies GPU data back to the CPU without stalling
+//! the pipeline.
+//!
+//! A read is issued into a buffer the readback owns, with
+//! glReadPixels through GL_PIXEL_PACK_BUFFER or a
+//! glCopyBufferSubData from another buffer, followed by a fence.
+//! Neither call waits for the GPU.  The result is fetched a frame or
+//! two later, once the fence has signaled, by mapping the buffer.
+//! Reading straight into client memory would instead flush and wait
+//! for every command that is still queued.
+//!
+//! It acts like a future for one read at a time:
+//!
+//!   readback.read_pixels(x, y, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT);
+//!   // ...later frames
+//!   if (readback.is_ready())
+//!     readback.get(std::as_writable_bytes(std::span(&id, 1)));
+//!
+//! Issuing another read discards the pending one.  Keep one
+//! AsyncReadback per frame in flight to read every frame.
+#ifndef NO_EXCEPTIONS
+class AsyncReadback : private MoveChecker {
+#else
+class AsyncReadback : public Errors {
+#endif
+public:
+  //! Construct an async readback
+  //!
+  //! \param name The name of the async readback
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param capacity The largest read in bytes
+  //!
+  //! \throws a BufferDataError if the capacity isn't positive.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new AsyncReadback object
+  AsyncReadback(const string &name, const std::shared_ptr<GLContext> &ctx,
+                GLsizeiptr capacity);
+  ~AsyncReadback();
+
+  //! Cleanup the async readback
+  //!
+  //! Deletes any outstanding fence and the buffer.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  AsyncReadback(const AsyncReadback &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  AsyncReadback &operator=(const AsyncReadback &) = delete;
+
+  // move constructor
+  AsyncReadback(AsyncReadback &&) noexcept;
+
+  // move assignment operator
+  AsyncReadback &operator=(AsyncReadback &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Start reading a block of pixels from the current read
+  //! framebuffer
+  //!
+  //! Rows are padded to the default GL_PACK_ALIGNMENT of 4.
+  //!
+  //! \param x The left edge of the block in window coordinates
+  //! \param y The bottom edge of the block in window coordinates
+  //! \param width The width of the block in pixels
+  //! \param height The height of the block in pixels
+  //! \param format The pixel format, e.g. GL_RGBA or GL_DEPTH_COMPONENT
+  //! \param type The pixel type, e.g. GL_UNSIGNED_BYTE
+  //!
+  //! \throws a BufferDataError if the format or type is unknown or
+  //!         the pixels don't fit in the capacity.
+  //!
+  //! \throws a ReadbackFenceError if the fence could not be created.
+  void read_pixels(GLint x, GLint y, GLsizei width, GLsizei height,
+                   GLenum format, GLenum type);
+
+  //! Start reading part of another buffer
+  //!
+  //! \param source The buffer to read from
+  //! \param offset The byte offset into source to start reading at
+  //! \param read_size The number of bytes to read
+  //!
+  //! \throws a BufferDataError if the range doesn't fit in source or
+  //!         in the capacity.
+  //!
+  //! \throws a ReadbackFenceError if the fence could not be created.
+  void read_buffer(VertexBufferObject &source, GLintptr offset,
+                   GLsizeiptr read_size);
+
+  //! True if a read was issued and the GPU has finished it
+  //!
+  //! Never blocks.
+  //!
+  //! \throws a ReadbackFenceError if polling the fence failed.
+  bool is_ready();
+
+  //! Block until the GPU has finished the read
+  //!
+  //! \throws a ReadbackNotStartedError if no read was issued.
+  //!
+  //! \throws a ReadbackFenceError if waiting on the fence failed.
+  void wait();
+
+  //! Copy the result of the read into destination
+  //!
+  //! Waits for the read first if it isn't ready yet, which stalls
+  //! like a synchronous read would.  The result stays available
+  //! until the next read is issued.
+  //!
+  //! \param destination Where to copy the result, at least
+  //!                    get_result_size() bytes
+  //!
+  //! \throws a ReadbackNotStartedError if no read was issued.
+  //!
+  //! \throws a BufferDataError if destination is too small.
+  //!
+  //! \throws a ReadbackMapError if the buffer could not be mapped.
+  //!
+  //! \returns the part of destination that was written, or an empty
+  //!          span on error
+  std::span<std::byte> get(std::span<std::byte> destination);
+
+  //! The size in bytes of the last read issued, zero if none was
+  GLsizeiptr get_result_size() const;
+
+  //! The largest read in bytes
+  GLsizeiptr get_capacity() const;
+
+  //! The number of bytes glReadPixels writes for a block of pixels
+  //! with the default GL_PACK_ALIGNMENT of 4
+  //!
+  //! \returns the size in bytes, or zero for an unknown format or
+  //!          type
+  static GLsizeiptr pixel_data_size(GLsizei width, GLsizei height,
+                                    GLenum format, GLenum type);
+
+private:
+  // Fence the read just issued, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool fence_read(GLsizeiptr read_size);
+
+  // Wait until the fence has signaled and delete it, returns false
+  // if waiting failed
+  bool wait_for_fence();
+
+  string name;
+
+  // The OpenGL context this readback uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // The buffer reads are written into
+  std::optional<VertexBufferObject> buffer = std::nullopt;
+
+  // Signaled when the GPU has written the read, empty once it has
+  // been waited on
+  std::optional<Fence> fence = std::nullopt;
+
+  GLsizeiptr capacity = 0;
+
+  GLsizeiptr result_size = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
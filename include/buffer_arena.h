@@ -0,0 +1,267 @@
+#ifndef _SDL_OPENGL_CPP_BUFFER_ARENA_H_
+#define _SDL_OPENGL_CPP_BUFFER_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "offset_allocator.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace buffer_arena {
+
+#ifndef NO_EXCEPTIONS
+
+//! An ArenaAllocationError exception
+//!
+//! This exception is thrown when a mesh is larger than a whole arena
+//! page and can never be allocated.
+//!
+class ArenaAllocationError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! An InvalidArenaHandleError exception
+//!
+//! This exception is thrown when freeing a handle that was never
+//! allocated or has already been freed.
+//!
+class InvalidArenaHandleError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A BufferArenaUnspecifiedStateError exception
+//!
+//! This exception is thrown when the BufferArena is in an valid but
+//! unspecified state after a move operation.
+//!
+class BufferArenaUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace buffer_arena
+
+using namespace buffer_arena;
+
+//! A BufferArena packs the vertices of many small meshes into a few
+//! large vertex buffers.
+//!
+//! Each page of the arena is one VertexBufferObject of page_vertices
+//! vertices.  Ranges inside a page are handed out by an
+//! OffsetAllocator in units of whole vertices, so the offset of a
+//! mesh is directly usable as the first vertex of glDrawArrays or the
+//! base vertex of glDrawElementsBaseVertex.  Meshes in the same page
+//! can share one vertex array object binding.
+//!
+//! Meshes are referred to by Handles.  A handle stays valid until it
+//! is freed, even across defragment(), which moves meshes inside
+//! their page.  Look up the current location with get() before
+//! drawing.
+//!
+//! Pages are created on demand, the first allocation creates the
+//! first page.
+#ifndef NO_EXCEPTIONS
+class BufferArena : private MoveChecker {
+#else
+class BufferArena : public Errors {
+#endif
+public:
+  //! A reference to a mesh allocated in the arena
+  struct Handle {
+    uint32_t index = std::numeric_limits<uint32_t>::max();
+    uint32_t generation = 0;
+  };
+
+  //! Where a mesh currently lives
+  struct Range {
+    //! The page index, see page_buffer()
+    GLuint page;
+
+    //! The first vertex of the mesh in the page buffer
+    GLint first_vertex;
+
+    //! The number of vertices in the mesh
+    GLsizei vertex_count;
+  };
+
+  //! Usage statistics, in bytes
+  struct Stats {
+    size_t page_count;
+    size_t allocation_count;
+    GLsizeiptr used_bytes;
+    GLsizeiptr free_bytes;
+  };
+
+  //! Construct a buffer arena
+  //!
+  //! \param name The name of the buffer arena
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param vertex_stride The size of one vertex in bytes
+  //! \param page_vertices The number of vertices in each page
+  //! \param usage The usage hint for the page buffers
+  //!
+  //! \throws a BufferDataError if the stride or page size is invalid.
+  //!
+  //! \return A new BufferArena object
+  BufferArena(const string &name, const std::shared_ptr<GLContext> &ctx,
+              GLsizei vertex_stride, uint32_t page_vertices,
+              GLenum usage = GL_STATIC_DRAW);
+  ~BufferArena();
+
+  //! Cleanup the buffer arena
+  //!
+  //! Deletes every page buffer, invalidating all handles.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  BufferArena(const BufferArena &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  BufferArena &operator=(const BufferArena &) = delete;
+
+  // move constructor
+  BufferArena(BufferArena &&) noexcept;
+
+  // move assignment operator
+  BufferArena &operator=(BufferArena &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Allocate a mesh and upload its vertices
+  //!
+  //! \param vertices The vertex data, a whole number of vertices
+  //!
+  //! \throws a BufferDataError if vertices is empty or not a whole
+  //!         number of vertices.
+  //!
+  //! \throws an ArenaAllocationError if the mesh is larger than a
+  //!         page.
+  //!
+  //! \returns a handle to the new mesh
+  Handle allocate(std::span<const std::byte> vertices);
+
+  //! Allocate a mesh and upload its vertices
+  //!
+  //! \param vertices The vertices, usually packed vertex structs
+  //!
+  //! \returns a handle to the new mesh
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  Handle allocate(std::span<const T> vertices) {
+    return allocate(std::as_bytes(vertices));
+  }
+
+  //! Free a mesh, its range can be reused by later allocations
+  //!
+  //! \throws an InvalidArenaHandleError if the handle isn't live.
+  void free(Handle handle);
+
+  //! Look up where a mesh currently lives
+  //!
+  //! \returns the range, or std::nullopt if the handle isn't live
+  std::optional<Range> get(Handle handle) const;
+
+  //! The vertex buffer backing a page
+  //!
+  //! \param page The page, Range::page
+  //!
+  //! \throws an InvalidArenaHandleError if there is no such page.
+  //!
+  //! \returns the buffer, or nullptr on error with exceptions
+  //!          disabled
+  VertexBufferObject *page_buffer(GLuint page);
+
+  //! The number of pages
+  size_t page_count() const;
+
+  //! The size of one vertex in bytes
+  GLsizei get_vertex_stride() const;
+
+  //! Compact every page
+  //!
+  //! Live meshes are moved to the start of their page in offset
+  //! order, merging the free space into one range at the end.  The
+  //! data is copied on the GPU through a staging buffer, so page
+  //! buffer names and any vertex array objects pointing at them stay
+  //! valid.  Empty pages at the end of the arena are released.
+  //!
+  //! Ranges returned by get() before defragmenting are stale
+  //! afterwards.
+  void defragment();
+
+  //! Usage statistics
+  Stats stats() const;
+
+private:
+  struct Page {
+    VertexBufferObject buffer;
+    OffsetAllocator allocator;
+    size_t live_allocations = 0;
+  };
+
+  struct Slot {
+    GLuint page = 0;
+    OffsetAllocator::Allocation allocation;
+    uint32_t vertex_count = 0;
+    uint32_t generation = 0;
+    bool live = false;
+  };
+
+  // The slot for a handle, or nullptr if the handle isn't live
+  const Slot *find_slot(Handle handle) const;
+
+  // Compact one page through a staging buffer
+  void defragment_page(GLuint page);
+
+  string name;
+
+  // The OpenGL context this arena uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  GLsizei vertex_stride = 0;
+
+  uint32_t page_vertices = 0;
+
+  GLenum usage = GL_STATIC_DRAW;
+
+  // Pages are heap allocated so page_buffer() pointers stay valid
+  // when new pages are added
+  std::vector<std::unique_ptr<Page>> pages;
+
+  std::vector<Slot> slots;
+
+  // Indices of slots that can be reused
+  std::vector<uint32_t> free_slots;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
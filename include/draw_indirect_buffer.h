@@ -0,0 +1,234 @@
+#ifndef _SDL_OPENGL_CPP_DRAW_INDIRECT_BUFFER_H_
+#define _SDL_OPENGL_CPP_DRAW_INDIRECT_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+//! One glDrawArrays call, as read by glMultiDrawArraysIndirect
+struct DrawArraysIndirectCommand {
+  GLuint count;
+  GLuint instance_count;
+  GLuint first;
+  GLuint base_instance;
+};
+
+//! One glDrawElements call, as read by glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+  GLuint count;
+  GLuint instance_count;
+  GLuint first_index;
+  GLint base_vertex;
+  GLuint base_instance;
+};
+
+// The layouts OpenGL reads, commands are uploaded as is
+static_assert(sizeof(DrawArraysIndirectCommand) == 16);
+static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+// nested namespaces added in C++17
+namespace draw_indirect_buffer {
+
+#ifndef NO_EXCEPTIONS
+
+//! A CommandBufferFullError exception
+//!
+//! This exception is thrown when adding a command to a
+//! DrawIndirectBuffer that is already at capacity.
+//!
+class CommandBufferFullError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A BaseInstanceNotSupportedError exception
+//!
+//! This exception is thrown when drawing commands with a
+//! base_instance without multi-draw indirect support, the fallback
+//! draw calls can't offset instanced attributes.
+//!
+class BaseInstanceNotSupportedError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A DrawIndirectBufferUnspecifiedStateError exception
+//!
+//! This exception is thrown when the DrawIndirectBuffer is in an
+//! valid but unspecified state after a move operation.
+//!
+class DrawIndirectBufferUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace draw_indirect_buffer
+
+using namespace draw_indirect_buffer;
+
+//! A DrawIndirectBuffer batches many draw calls into one.
+//!
+//! Commands are filled on the CPU with add() and submitted with
+//! draw_arrays() or draw_elements().  Storage for capacity commands
+//! of each kind is reserved up front, adding a command never
+//! allocates.
+//!
+//! With GLFeature::MultiDrawIndirect the commands are uploaded to a
+//! GL_DRAW_INDIRECT_BUFFER, only when they changed, and drawn with
+//! one glMultiDrawArraysIndirect or glMultiDrawElementsIndirect
+//! call.  On older contexts they are drawn with glMultiDrawArrays or
+//! glMultiDrawElementsBaseVertex instead, which is still one call
+//! unless commands draw more than one instance.
+//!
+//! Meshes in a BufferArena page map directly to commands, the first
+//! vertex of a Range is the first of a DrawArraysIndirectCommand or
+//! the base_vertex of a DrawElementsIndirectCommand.
+//!
+//! The vertex array object to draw with is bound by the caller.
+#ifndef NO_EXCEPTIONS
+class DrawIndirectBuffer : private MoveChecker {
+#else
+class DrawIndirectBuffer : public Errors {
+#endif
+public:
+  //! Construct a draw indirect buffer
+  //!
+  //! \param name The name of the draw indirect buffer
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param command_capacity The largest number of commands of each
+  //!                         kind
+  //!
+  //! \throws a BufferDataError if the capacity is zero.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new DrawIndirectBuffer object
+  DrawIndirectBuffer(const string &name, const std::shared_ptr<GLContext> &ctx,
+                     size_t command_capacity);
+  ~DrawIndirectBuffer();
+
+  //! Cleanup the draw indirect buffer
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  DrawIndirectBuffer(const DrawIndirectBuffer &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  DrawIndirectBuffer &operator=(const DrawIndirectBuffer &) = delete;
+
+  // move constructor
+  DrawIndirectBuffer(DrawIndirectBuffer &&) noexcept;
+
+  // move assignment operator
+  DrawIndirectBuffer &operator=(DrawIndirectBuffer &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Add a non-indexed draw
+  //!
+  //! \throws a CommandBufferFullError if there are already capacity
+  //!         non-indexed commands.
+  void add(const DrawArraysIndirectCommand &command);
+
+  //! Add an indexed draw
+  //!
+  //! \throws a CommandBufferFullError if there are already capacity
+  //!         indexed commands.
+  void add(const DrawElementsIndirectCommand &command);
+
+  //! Remove every command, the reserved storage is kept
+  void clear();
+
+  //! Draw every non-indexed command
+  //!
+  //! \param mode The primitive type, e.g. GL_TRIANGLES
+  //!
+  //! \throws a BaseInstanceNotSupportedError if a command has a
+  //!         base_instance and multi-draw indirect isn't supported.
+  void draw_arrays(GLenum mode);
+
+  //! Draw every indexed command with the element array buffer of the
+  //! bound vertex array object
+  //!
+  //! \param mode The primitive type, e.g. GL_TRIANGLES
+  //! \param index_type GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, see
+  //!                   IndexBufferObject::get_index_type()
+  //!
+  //! \throws a BaseInstanceNotSupportedError if a command has a
+  //!         base_instance and multi-draw indirect isn't supported.
+  void draw_elements(GLenum mode, GLenum index_type);
+
+  //! The non-indexed commands
+  std::span<const DrawArraysIndirectCommand> get_arrays_commands() const;
+
+  //! The indexed commands
+  std::span<const DrawElementsIndirectCommand> get_elements_commands() const;
+
+  //! The largest number of commands of each kind
+  size_t get_capacity() const;
+
+  //! True if commands are drawn from a GL_DRAW_INDIRECT_BUFFER
+  bool uses_indirect_buffer() const;
+
+private:
+  // Upload the commands if they changed and bind the buffer to
+  // GL_DRAW_INDIRECT_BUFFER
+  void upload(GLintptr offset, std::span<const std::byte> commands,
+              bool &dirty);
+
+  // Fail if a fallback draw would need a base instance, returns
+  // false on error in NO_EXCEPTIONS builds
+  bool check_base_instance(GLuint base_instance);
+
+  string name;
+
+  // The OpenGL context this buffer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  size_t capacity = 0;
+
+  // Both kinds of commands live in one buffer, the non-indexed ones
+  // first.  Only created with multi-draw indirect support.
+  std::optional<VertexBufferObject> buffer = std::nullopt;
+
+  std::vector<DrawArraysIndirectCommand> arrays_commands;
+  std::vector<DrawElementsIndirectCommand> elements_commands;
+
+  // Set when the commands changed since they were last uploaded
+  bool arrays_dirty = true;
+  bool elements_dirty = true;
+
+  // Scratch space for the fallback draw calls, reserved to capacity
+  std::vector<GLint> fallback_firsts;
+  std::vector<GLsizei> fallback_counts;
+  std::vector<const void *> fallback_indices;
+  std::vector<GLint> fallback_base_vertices;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -12,6 +12,9 @@ enum class error {
   // General errors
   UnspecifiedStateError,
 
+  // An optional OpenGL feature the operation needs isn't available
+  FeatureNotSupportedError,
+
   // Errors related to OpenGL calls that haven't been mapped to custom
   // error types yet.
   InvalidOperationError,
@@ -19,10 +22,29 @@ enum class error {
   // Vertex Buffer Object errors
   BufferDataError,
   GenBuffersError,
+  MapBufferError,
+  OutOfMemoryError,
+
+  // Buffer arena errors
+  ArenaAllocationError,
+  InvalidHandleError,
+
+  // Draw command errors
+  CommandBufferFullError,
 
   // Vertex Array Object errors
   GenVertexArraysError,
 
+  // Texture errors
+  GenTexturesError,
+  TextureDataError,
+
+  // Synchronization errors
+  FenceSyncError,
+
+  // Readback errors
+  ReadbackNotStartedError,
+
   // Shader errors
   ShaderCreationError,
   ShaderCompilationError,
@@ -31,6 +53,7 @@ enum class error {
   ProgramCreationError,
   ProgramLinkingError,
   GetUniformLocationError,
+  GetUniformBlockIndexError,
 
   // General SDL errors
   SDLInitFailedError,
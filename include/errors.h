@@ -32,7 +32,7 @@ public:
   //!
   //! \return true if the last method call was successful AND the
   //!         object is not in a "valid but unspecified state".
-  bool valid();
+  bool valid() const;
 
   //! If the object is not valid(), this method will get the last error
   //! that occurred.
@@ -51,17 +51,20 @@ public:
   //! unspecified state".
   //!
   //! \return the last error that occurred during a method call.
-  std::optional<error> get_last_error();
+  std::optional<error> get_last_error() const;
 
   //! Set the error code
   //!
   //! This should be the only function that changes error_code.
   //! It also calls any error handler functions.
   //!
+  //! The error state is mutable, so const methods can report
+  //! errors too.
+  //!
   //!
   //! \return true if the error state changed
   //!         false if there was no change in the error state
-  bool set_error(const std::optional<error> &error);
+  bool set_error(const std::optional<error> &error) const;
 
   //! Register an error handler
   //!
@@ -87,10 +90,10 @@ public:
 
 protected:
   //! Whether the last operation failed
-  bool last_operation_failed = false;
+  mutable bool last_operation_failed = false;
 
   //! The last error that occured, or std::nullopt if there was none.
-  std::optional<error> last_error = std::nullopt;
+  mutable std::optional<error> last_error = std::nullopt;
 
   //! The error callback function
   std::optional<std::function<void(const error &error)>> error_handler =
@@ -0,0 +1,136 @@
+#ifndef _SDL_OPENGL_CPP_FENCE_H_
+#define _SDL_OPENGL_CPP_FENCE_H_
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace fence {
+
+#ifndef NO_EXCEPTIONS
+
+//! A FenceSyncError exception
+//!
+//! This exception is thrown when creating or waiting on a fence
+//! fails.
+//!
+class FenceSyncError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A FenceUnspecifiedStateError exception
+//!
+//! This exception is thrown when the Fence is in an valid but
+//! unspecified state after a move operation.
+//!
+class FenceUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace fence
+
+using namespace fence;
+
+//! A Fence owns an OpenGL sync object
+//!
+//! The sync object is inserted into the command stream when the
+//! Fence is constructed and becomes signaled once the GPU has
+//! finished every command issued before it.  That tells the CPU
+//! when memory the GPU was reading or writing can be reused.
+//!
+//! The sync object is deleted on object deletion.
+#ifndef NO_EXCEPTIONS
+class Fence : private MoveChecker {
+#else
+class Fence : public Errors {
+#endif
+public:
+  //! Insert a fence after the commands issued so far
+  //!
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //!
+  //! \throws a FenceSyncError if the sync object could not be
+  //!         created.
+  //!
+  //! \return A new Fence object
+  Fence(const std::shared_ptr<GLContext> &ctx);
+  ~Fence();
+
+  //! Cleanup the fence
+  //!
+  //! Deletes the sync object.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  Fence(const Fence &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  Fence &operator=(const Fence &) = delete;
+
+  // move constructor
+  Fence(Fence &&) noexcept;
+
+  // move assignment operator
+  Fence &operator=(Fence &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! True if the GPU has finished the commands before the fence
+  //!
+  //! Never blocks.
+  //!
+  //! \throws a FenceSyncError if polling the fence failed.
+  bool is_signaled();
+
+  //! Block until the fence has signaled or timeout has passed
+  //!
+  //! \param timeout How long to wait in nanoseconds
+  //!
+  //! \throws a FenceSyncError if waiting on the fence failed.
+  //!
+  //! \returns true if the fence has signaled
+  bool client_wait(GLuint64 timeout);
+
+  //! Block until the fence has signaled
+  //!
+  //! \throws a FenceSyncError if waiting on the fence failed.
+  void wait();
+
+private:
+  // The OpenGL context this fence uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  GLsync sync = nullptr;
+
+  // Set after the first wait, which flushes the fence to the GPU
+  bool flushed = false;
+
+  // Cached once the GPU has passed the fence, so later checks don't
+  // call into OpenGL
+  bool signaled = false;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,273 @@
+#ifndef _SDL_OPENGL_CPP_FRAME_IN_FLIGHT_H_
+#define _SDL_OPENGL_CPP_FRAME_IN_FLIGHT_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "fence.h"
+#include "gl_context.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace frame_in_flight {
+
+#ifndef NO_EXCEPTIONS
+
+//! A FrameInFlightUnspecifiedStateError exception
+//!
+//! This exception is thrown when the FrameInFlight is in an valid
+//! but unspecified state after a move operation.
+//!
+class FrameInFlightUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace frame_in_flight
+
+using namespace frame_in_flight;
+
+//! A FrameInFlight rotates N copies of a resource between frames
+//!
+//! The CPU fills one copy each frame while the GPU can still be
+//! reading the copies used by the previous N - 1 frames.  A Fence
+//! is inserted when a frame ends and waited on when its copy comes
+//! around again, so the CPU only blocks once it is a full N frames
+//! ahead of the GPU.  Two or three copies are usually enough.
+//!
+//! Typical use:
+//!
+//!   FrameInFlight<UniformBufferObject, 3> cameras(ctx, [&](size_t i) {
+//!     return UniformBufferObject("camera-" + to_string(i), ctx, size);
+//!   });
+//!
+//!   UniformBufferObject &camera = cameras.begin_frame();
+//!   // update camera and draw with it
+//!   cameras.end_frame();
+//!   sdl_opengl.swap_window();
+//!
+//! T can be any movable type, for example a VertexBufferObject, a
+//! UniformBufferObject or a plain CPU side struct.
+template <typename T, size_t N>
+  requires(N > 0) && std::is_move_constructible_v<T>
+#ifndef NO_EXCEPTIONS
+class FrameInFlight : private MoveChecker {
+#else
+class FrameInFlight : public Errors {
+#endif
+public:
+  //! Construct a frame in flight ring
+  //!
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param make Called with each index from 0 to N - 1, returns
+  //!             the copy of the resource for that index
+  //!
+  //! \return A new FrameInFlight object
+  template <typename Factory>
+    requires std::is_invocable_r_v<T, Factory &, size_t>
+  FrameInFlight(const std::shared_ptr<GLContext> &ctx, Factory make)
+      : gl_context{ctx},
+        resources{make_resources(make, std::make_index_sequence<N>{})} {}
+
+  ~FrameInFlight() { cleanup(); }
+
+  //! Cleanup the frame in flight ring
+  //!
+  //! Deletes the outstanding fences, the resources are destroyed
+  //! with the object.
+  void cleanup() noexcept {
+    for (std::optional<Fence> &fence : fences)
+      fence.reset();
+
+    gl_context = nullptr;
+  }
+
+  // Explicitly delete the generated default copy constructor
+  FrameInFlight(const FrameInFlight &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  FrameInFlight &operator=(const FrameInFlight &) = delete;
+
+  // move constructor
+  FrameInFlight(FrameInFlight &&frames) noexcept
+      : gl_context{frames.gl_context}, resources{std::move(frames.resources)},
+        fences{std::move(frames.fences)}, current{frames.current} {
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = frames.last_operation_failed;
+    last_error = frames.last_error;
+#endif
+
+    frames.gl_context = nullptr;
+    for (std::optional<Fence> &fence : frames.fences)
+      fence.reset();
+  }
+
+  // move assignment operator
+  FrameInFlight &operator=(FrameInFlight &&frames) noexcept {
+    if (&frames != this) {
+      cleanup();
+
+      gl_context = frames.gl_context;
+      resources = std::move(frames.resources);
+      fences = std::move(frames.fences);
+      current = frames.current;
+#ifdef NO_EXCEPTIONS
+      last_operation_failed = frames.last_operation_failed;
+      last_error = frames.last_error;
+#endif
+
+      frames.gl_context = nullptr;
+      for (std::optional<Fence> &fence : frames.fences)
+        fence.reset();
+    }
+
+    return *this;
+  }
+
+  bool is_in_unspecified_state() const override {
+    return gl_context == nullptr;
+  }
+
+  //! Start a frame
+  //!
+  //! Blocks until the GPU has finished the frame that last used the
+  //! current copy, which is N frames ago.
+  //!
+  //! \throws a FenceSyncError if waiting on the fence failed.
+  //!
+  //! \returns the copy of the resource for this frame.  With
+  //!          NO_EXCEPTIONS, check valid() before writing to it.
+  T &begin_frame() {
+    if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+      throw FrameInFlightUnspecifiedStateError(
+          "Frame In Flight is in an unspecified state");
+#else
+      set_error(std::optional<error>(error::UnspecifiedStateError));
+      return resources[current];
+#endif
+    }
+
+    std::optional<Fence> &fence = fences[current];
+
+    if (fence) {
+      fence->wait();
+
+#ifdef NO_EXCEPTIONS
+      if (!fence->valid()) {
+        set_error(fence->get_last_error());
+        return resources[current];
+      }
+#endif
+
+      fence.reset();
+    }
+
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+
+    return resources[current];
+  }
+
+  //! Finish a frame
+  //!
+  //! Call this after the commands that use the current copy have
+  //! been issued.  A fence is inserted and the ring advances to the
+  //! next copy.
+  //!
+  //! \throws a FenceSyncError if the fence could not be created.
+  void end_frame() {
+    if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+      throw FrameInFlightUnspecifiedStateError(
+          "Frame In Flight is in an unspecified state");
+#else
+      set_error(std::optional<error>(error::UnspecifiedStateError));
+      return;
+#endif
+    }
+
+    std::optional<Fence> &fence = fences[current];
+    fence.emplace(gl_context);
+
+#ifdef NO_EXCEPTIONS
+    if (!fence->valid()) {
+      set_error(fence->get_last_error());
+      fence.reset();
+      return;
+    }
+#endif
+
+    current = (current + 1) % N;
+
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+  }
+
+  //! True if begin_frame() would return without blocking
+  //!
+  //! \throws a FenceSyncError if polling the fence failed.
+  bool is_current_ready() {
+    std::optional<Fence> &fence = fences[current];
+
+    return !fence || fence->is_signaled();
+  }
+
+  //! The copy of the resource for the current frame, without waiting
+  T &get_current() { return resources[current]; }
+
+  //! The index of the current copy, between 0 and N - 1
+  size_t get_current_index() const { return current; }
+
+  //! Every copy of the resource, for setup that applies to all of
+  //! them
+  std::array<T, N> &get_resources() { return resources; }
+
+  //! The number of copies in the ring
+  static constexpr size_t size() { return N; }
+
+private:
+  template <typename Factory, size_t... I>
+  static std::array<T, N> make_resources(Factory &make,
+                                         std::index_sequence<I...>) {
+    return {make(I)...};
+  }
+
+  // The OpenGL context the fences use
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  std::array<T, N> resources;
+
+  // The fence inserted when each copy was last used, empty if the
+  // copy is free
+  std::array<std::optional<Fence>, N> fences{};
+
+  // The copy the CPU is currently using
+  size_t current = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,238 @@
+#ifndef _SDL_OPENGL_CPP_GEOMETRY_CACHE_H_
+#define _SDL_OPENGL_CPP_GEOMETRY_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+#include "vertex_layout.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace geometry_cache {
+
+#ifndef NO_EXCEPTIONS
+
+//! A GeometryCacheUnspecifiedStateError exception
+//!
+//! This exception is thrown when the GeometryCache is in an valid but
+//! unspecified state after a move operation.
+//!
+class GeometryCacheUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace geometry_cache
+
+using namespace geometry_cache;
+
+//! A GeometryCache shares one vertex buffer between every load of
+//! the same vertex data.
+//!
+//! Buffers are looked up by the XXH64 hash of the vertex bytes,
+//! their size and a key for their layout.  The first acquire() of
+//! some content creates and uploads a VertexBufferObject, later ones
+//! with the same bytes and layout return the same buffer without
+//! touching the GPU, whatever name they were loaded under.
+//!
+//! Handles are reference counted and read only, a buffer shared by
+//! every load of a mesh can be bound and drawn from but not changed
+//! under the other sharers.  The buffer is deleted when the last
+//! handle is dropped, and the next acquire() of that content creates
+//! it again.  Handles keep working after the cache itself is
+//! destroyed.
+//!
+//! Only hashes are kept, not a copy of the vertices.  A hit is
+//! checked against a second XXH64 hash with another seed, so two
+//! different meshes share a buffer only if both 64-bit hashes
+//! collide.  Hashes aren't a defense against chosen data though, so
+//! don't use the cache for data an attacker can choose.
+#ifndef NO_EXCEPTIONS
+class GeometryCache : private MoveChecker {
+#else
+class GeometryCache : public Errors {
+#endif
+public:
+  //! A shared, read only reference to a cached vertex buffer
+  using Handle = std::shared_ptr<const VertexBufferObject>;
+
+  //! Cache statistics
+  struct Stats {
+    //! The number of distinct buffers alive
+    size_t entry_count;
+
+    //! acquire() calls that returned an existing buffer
+    size_t hit_count;
+
+    //! acquire() calls that created a buffer
+    size_t miss_count;
+
+    //! The bytes in the buffers alive
+    GLsizeiptr unique_bytes;
+
+    //! The bytes hits didn't have to allocate and upload
+    GLsizeiptr bytes_saved;
+  };
+
+  //! Construct a geometry cache
+  //!
+  //! \param name The name of the geometry cache
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param usage The usage hint for the buffers the cache creates
+  //!
+  //! \return A new GeometryCache object
+  GeometryCache(const string &name, const std::shared_ptr<GLContext> &ctx,
+                GLenum usage = GL_STATIC_DRAW);
+  ~GeometryCache();
+
+  //! Cleanup the geometry cache
+  //!
+  //! Forgets every entry.  Buffers still referenced by handles stay
+  //! alive until their last handle is dropped.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  GeometryCache(const GeometryCache &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  GeometryCache &operator=(const GeometryCache &) = delete;
+
+  // move constructor
+  GeometryCache(GeometryCache &&) noexcept;
+
+  // move assignment operator
+  GeometryCache &operator=(GeometryCache &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Get a buffer holding vertices, creating it if the content isn't
+  //! cached
+  //!
+  //! \param buffer_name The name to give the buffer if it is created
+  //! \param vertices The vertex bytes
+  //! \param layout_key Distinguishes the same bytes read with
+  //!                   different layouts, see layout_key()
+  //!
+  //! \throws a BufferDataError if vertices is empty.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \returns a handle to the buffer, or nullptr on error in
+  //!          NO_EXCEPTIONS builds
+  Handle acquire(const string &buffer_name,
+                 std::span<const std::byte> vertices,
+                 std::uint64_t layout_key = 0);
+
+  //! Get a buffer holding vertices described by a VertexLayout
+  //!
+  //! \param buffer_name The name to give the buffer if it is created
+  //! \param vertices The vertices, usually packed vertex structs
+  //!
+  //! \returns a handle to the buffer
+  template <typename Layout, typename T>
+    requires std::is_trivially_copyable_v<T>
+  Handle acquire(const string &buffer_name, std::span<const T> vertices) {
+    return acquire(buffer_name, std::as_bytes(vertices),
+                   layout_key<Layout>());
+  }
+
+  //! Forget the entries whose buffers have been deleted
+  //!
+  //! Entries are also replaced when their content is acquired again,
+  //! this only keeps the table small when many meshes are unloaded.
+  void purge();
+
+  //! Cache statistics
+  Stats stats() const;
+
+  //! The bytes deduplication saved, the sum of the sizes of every hit
+  GLsizeiptr get_bytes_saved() const;
+
+  //! Hash bytes with XXH64
+  //!
+  //! \param data The bytes to hash
+  //! \param seed The seed, different seeds give unrelated hashes
+  static std::uint64_t hash(std::span<const std::byte> data,
+                            std::uint64_t seed = 0);
+
+  //! A key for a vertex layout, from its stride and attribute table
+  static std::uint64_t layout_key(std::span<const VertexAttribute> attributes,
+                                  GLsizei stride);
+
+  //! A key for a VertexLayout
+  template <typename Layout> static std::uint64_t layout_key() {
+    return layout_key(Layout::attributes, Layout::stride);
+  }
+
+private:
+  struct Key {
+    std::uint64_t hash;
+
+    // Hashed with check_seed, to tell apart content whose hash
+    // collides
+    std::uint64_t check;
+
+    std::uint64_t layout;
+    GLsizeiptr size;
+
+    bool operator==(const Key &) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const {
+      return static_cast<size_t>(key.hash ^ (key.layout * 31));
+    }
+  };
+
+  // The seed of the second hash of a Key
+  static constexpr std::uint64_t check_seed = 0x9e3779b97f4a7c15ULL;
+
+  // Check the cache can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  string name;
+
+  // The OpenGL context this cache uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  GLenum usage = GL_STATIC_DRAW;
+
+  // Entries don't keep their buffers alive, the handles do
+  std::unordered_map<Key, std::weak_ptr<const VertexBufferObject>, KeyHash>
+      entries;
+
+  size_t hit_count = 0;
+
+  size_t miss_count = 0;
+
+  GLsizeiptr bytes_saved = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -6,6 +6,9 @@
 #define _SDL_OPENGL_CPP_GL_CONTEXT_H_
 
 #include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
 
 #include "SDL_opengl.h"
 #include <SDL.h>
@@ -13,6 +16,49 @@
 #include "opengl.h"
 
 namespace sdl_opengl_cpp {
+
+//! Optional OpenGL features
+//!
+//! The library targets OpenGL 3.3 core.  Anything newer is exposed
+//! as a feature that can be queried at runtime with
+//! GLContext::supports() before using the classes that depend on
+//! it.
+enum class GLFeature {
+  //! Immutable buffer storage with glBufferStorage (OpenGL 4.4 or
+  //! ARB_buffer_storage), needed for persistent mapped buffers
+  BufferStorage,
+
+  //! Shader storage buffer objects (OpenGL 4.3 or
+  //! ARB_shader_storage_buffer_object), large read-write buffers
+  //! bound to GL_SHADER_STORAGE_BUFFER binding points
+  ShaderStorageBufferObject,
+
+  //! Draw commands read from a GL_DRAW_INDIRECT_BUFFER with
+  //! glMultiDrawArraysIndirect and glMultiDrawElementsIndirect
+  //! (OpenGL 4.3 or ARB_multi_draw_indirect)
+  MultiDrawIndirect,
+
+  //! Creating and editing objects by name, without binding them,
+  //! with glCreateBuffers, glNamedBufferData, glCreateVertexArrays,
+  //! glTextureStorage2D and friends (OpenGL 4.5 or
+  //! ARB_direct_state_access)
+  DirectStateAccess,
+
+  //! Vertex formats separate from vertex buffer bindings with
+  //! glVertexAttribFormat, glVertexAttribBinding and
+  //! glBindVertexBuffer (OpenGL 4.3 or ARB_vertex_attrib_binding)
+  VertexAttribBinding,
+
+  //! Immutable texture storage with glTexStorage2D and
+  //! glTexStorage3D (OpenGL 4.2 or ARB_texture_storage)
+  TextureStorage,
+
+  //! Anisotropic texture filtering with
+  //! GL_TEXTURE_MAX_ANISOTROPY (OpenGL 4.6,
+  //! ARB_texture_filter_anisotropic or EXT_texture_filter_anisotropic)
+  AnisotropicFiltering,
+};
+
 // gMock (google-mock, googlemock) doesn't allow testing directly on free
 // functions. (From the gMock cook book (gmock_cook_book.md):
 //
@@ -53,6 +99,37 @@ public:
       : gl_context{ctx} {};
   virtual ~GLContext(){};
 
+  //! Check if an optional OpenGL feature is available
+  //!
+  //! A feature is available if the context version is new enough or
+  //! the matching ARB extension is advertised, and every function
+  //! pointer the feature needs was loaded.  The version and extension
+  //! list are queried once and cached.
+  //!
+  //! \param feature The feature to check for
+  //!
+  //! \returns true if the feature can be used, false otherwise
+  virtual bool supports(GLFeature feature);
+
+  //! Check if objects should be created and edited with direct state
+  //! access
+  //!
+  //! VertexBufferObject, VertexArrayObject and
+  //! SDLSurface::GL_LoadTexture use the direct state access functions
+  //! when this is true, and bind-to-edit otherwise.  It is
+  //! supports(GLFeature::DirectStateAccess), checked once and cached.
+  virtual bool direct_state_access();
+
+  //! Check if vertex formats should be set up separately from the
+  //! buffers they read
+  //!
+  //! VertexArrayObject uses glVertexAttribFormat and
+  //! glBindVertexBuffer when this is true, so a buffer can be
+  //! swapped without specifying the attributes again.  It is
+  //! supports(GLFeature::VertexAttribBinding), checked once and
+  //! cached.
+  virtual bool vertex_attrib_binding();
+
   // General functions
 
   //! Pushes the attribute stack
@@ -314,12 +391,88 @@ public:
   //! GL_NO_ERROR          No error has occurred.
   virtual GLenum glGetError();
 
+  //! Return the value of an integer state variable, such as
+  //! GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+  virtual void glGetIntegerv(GLenum pname, GLint *params);
+
+  //! Return the value of a floating point state variable, such as
+  //! GL_MAX_TEXTURE_MAX_ANISOTROPY
+  virtual void glGetFloatv(GLenum pname, GLfloat *params);
+
   virtual void glFlush();
 
   virtual void glEnableClientState(GLenum array);
   virtual void glDisableClientState(GLenum array);
   virtual void glDrawArrays(GLenum mode, GLint first, GLsizei count);
 
+  //! Render primitives from the element array buffer bound to the
+  //! current vertex array object
+  //!
+  //! indices is a byte offset into the element array buffer.
+  virtual void glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                              const GLvoid *indices);
+
+  //! Render primitives from the element array buffer, adding
+  //! base_vertex to every index before fetching vertices
+  //!
+  //! Lets meshes that share a vertex buffer keep zero-based indices.
+  virtual void glDrawElementsBaseVertex(GLenum mode, GLsizei count,
+                                        GLenum type, const GLvoid *indices,
+                                        GLint base_vertex);
+
+  //! Draw instance_count instances of a range of vertices
+  //!
+  //! Attributes with a divisor advance once per divisor instances
+  //! instead of once per vertex.
+  virtual void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                                     GLsizei instance_count);
+
+  //! Draw instance_count instances from the element array buffer
+  virtual void glDrawElementsInstanced(GLenum mode, GLsizei count,
+                                       GLenum type, const void *indices,
+                                       GLsizei instance_count);
+
+  //! Draw instance_count instances from the element array buffer,
+  //! adding base_vertex to every index
+  virtual void glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count,
+                                                 GLenum type,
+                                                 const void *indices,
+                                                 GLsizei instance_count,
+                                                 GLint base_vertex);
+
+  //! Draw draw_count ranges of vertices in one call
+  virtual void glMultiDrawArrays(GLenum mode, const GLint *first,
+                                 const GLsizei *count, GLsizei draw_count);
+
+  //! Draw draw_count ranges of indices in one call, each with its
+  //! own base vertex
+  virtual void glMultiDrawElementsBaseVertex(GLenum mode,
+                                             const GLsizei *count,
+                                             GLenum type,
+                                             const void *const *indices,
+                                             GLsizei draw_count,
+                                             const GLint *base_vertex);
+
+  //! Draw draw_count DrawArraysIndirectCommands read from the buffer
+  //! bound to GL_DRAW_INDIRECT_BUFFER, starting at byte offset
+  //! indirect
+  //!
+  //! OpenGL 4.3 or ARB_multi_draw_indirect, check
+  //! supports(GLFeature::MultiDrawIndirect) first.
+  virtual void glMultiDrawArraysIndirect(GLenum mode, const void *indirect,
+                                         GLsizei draw_count, GLsizei stride);
+
+  //! Draw draw_count DrawElementsIndirectCommands read from the
+  //! buffer bound to GL_DRAW_INDIRECT_BUFFER, starting at byte offset
+  //! indirect
+  //!
+  //! OpenGL 4.3 or ARB_multi_draw_indirect, check
+  //! supports(GLFeature::MultiDrawIndirect) first.
+  virtual void glMultiDrawElementsIndirect(GLenum mode, GLenum type,
+                                           const void *indirect,
+                                           GLsizei draw_count,
+                                           GLsizei stride);
+
   virtual void glVertexPointer(GLint size, GLenum type, GLsizei stride,
                                const GLvoid *pointer);
 
@@ -332,10 +485,112 @@ public:
   // Virtual Buffer Object functions
   virtual void glGenBuffers(GLsizei n, GLuint *buffers);
   virtual void glBindBuffer(GLenum target, GLuint buffer);
+
+  //! Bind a whole buffer to binding point index of an indexed target
+  //!
+  //! target is GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+  //! GL_TRANSFORM_FEEDBACK_BUFFER or GL_ATOMIC_COUNTER_BUFFER.  The
+  //! buffer is also bound to the generic target.
+  virtual void glBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+  //! Bind size bytes of a buffer starting at offset to binding point
+  //! index of an indexed target
+  //!
+  //! For GL_UNIFORM_BUFFER the offset must be a multiple of
+  //! GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+  virtual void glBindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                                 GLintptr offset, GLsizeiptr size);
   virtual void glBufferData(GLenum target, GLsizeiptr size, const void *data,
                             GLenum usage);
   virtual void glDeleteBuffers(GLsizei n, const GLuint *buffers);
 
+  //! Create buffer objects, like glGenBuffers but the buffers exist
+  //! right away and can be used with the named buffer functions
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access, check
+  //! supports(GLFeature::DirectStateAccess) first.
+  virtual void glCreateBuffers(GLsizei n, GLuint *buffers);
+
+  //! glBufferData on a buffer by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glNamedBufferData(GLuint buffer, GLsizeiptr size,
+                                 const void *data, GLenum usage);
+
+  //! glBufferSubData on a buffer by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glNamedBufferSubData(GLuint buffer, GLintptr offset,
+                                    GLsizeiptr size, const void *data);
+
+  //! Replace size bytes of the data store of the buffer bound to
+  //! target, starting at offset, with data
+  //!
+  //! The buffer storage isn't reallocated, so this can be used to
+  //! update part or all of a buffer in place.
+  virtual void glBufferSubData(GLenum target, GLintptr offset,
+                               GLsizeiptr size, const void *data);
+
+  //! Create immutable storage for the buffer bound to target
+  //!
+  //! OpenGL 4.4 or ARB_buffer_storage, check
+  //! supports(GLFeature::BufferStorage) first.
+  //!
+  //! flags is a combination of GL_DYNAMIC_STORAGE_BIT,
+  //! GL_MAP_READ_BIT, GL_MAP_WRITE_BIT, GL_MAP_PERSISTENT_BIT,
+  //! GL_MAP_COHERENT_BIT and GL_CLIENT_STORAGE_BIT.
+  virtual void glBufferStorage(GLenum target, GLsizeiptr size,
+                               const void *data, GLbitfield flags);
+
+  //! Map a range of the buffer bound to target into client memory
+  //!
+  //! \returns a pointer to the mapped range or nullptr on error
+  virtual void *glMapBufferRange(GLenum target, GLintptr offset,
+                                 GLsizeiptr length, GLbitfield access);
+
+  //! Unmap the buffer bound to target
+  //!
+  //! \returns GL_FALSE if the buffer contents became corrupt while
+  //!          mapped, GL_TRUE otherwise
+  virtual GLboolean glUnmapBuffer(GLenum target);
+
+  //! Copy size bytes from the buffer bound to read_target to the
+  //! buffer bound to write_target
+  //!
+  //! The copy happens on the GPU, GL_COPY_READ_BUFFER and
+  //! GL_COPY_WRITE_BUFFER are the usual targets.  Source and
+  //! destination may be the same buffer if the ranges don't overlap.
+  virtual void glCopyBufferSubData(GLenum read_target, GLenum write_target,
+                                   GLintptr read_offset, GLintptr write_offset,
+                                   GLsizeiptr size);
+
+  //! Read a block of pixels from the current read framebuffer
+  //!
+  //! With a buffer bound to GL_PIXEL_PACK_BUFFER, pixels is a byte
+  //! offset into that buffer and the call doesn't wait for the GPU.
+  virtual void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height,
+                            GLenum format, GLenum type, GLvoid *pixels);
+
+  // Synchronization functions
+
+  //! Create a new sync object and insert it into the command stream
+  //!
+  //! condition must be GL_SYNC_GPU_COMMANDS_COMPLETE and flags must
+  //! be 0.
+  //!
+  //! \returns the new sync object or 0 on error
+  virtual GLsync glFenceSync(GLenum condition, GLbitfield flags);
+
+  //! Block and wait for a sync object to become signaled
+  //!
+  //! \returns GL_ALREADY_SIGNALED, GL_TIMEOUT_EXPIRED,
+  //!          GL_CONDITION_SATISFIED or GL_WAIT_FAILED
+  virtual GLenum glClientWaitSync(GLsync sync, GLbitfield flags,
+                                  GLuint64 timeout);
+
+  //! Delete a sync object
+  virtual void glDeleteSync(GLsync sync);
+
   // Virtual Array Object functions
   virtual void glGenVertexArrays(GLsizei n, GLuint *arrays);
   virtual void glBindVertexArray(GLuint array);
@@ -382,8 +637,117 @@ public:
   virtual void glVertexAttribPointer(GLuint index, GLint size, GLenum type,
                                      GLboolean normalized, GLsizei stride,
                                      const void *pointer);
+
+  //! Like glVertexAttribPointer, but the values stay integers in the
+  //! shader instead of being converted to floats
+  //!
+  //! type must be GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT,
+  //! GL_UNSIGNED_SHORT, GL_INT or GL_UNSIGNED_INT.
+  virtual void glVertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                                      GLsizei stride, const void *pointer);
+
+  //! Set how often the attribute at index advances during instanced
+  //! draws
+  //!
+  //! 0 advances once per vertex, N advances once every N instances.
+  virtual void glVertexAttribDivisor(GLuint index, GLuint divisor);
+
+  //! Set the format of attribute index of the bound vertex array
+  //! object, relative_offset bytes into a vertex
+  //!
+  //! OpenGL 4.3 or ARB_vertex_attrib_binding, check
+  //! supports(GLFeature::VertexAttribBinding) first.
+  virtual void glVertexAttribFormat(GLuint index, GLint size, GLenum type,
+                                    GLboolean normalized,
+                                    GLuint relative_offset);
+
+  //! Set the format of integer attribute index of the bound vertex
+  //! array object
+  //!
+  //! OpenGL 4.3 or ARB_vertex_attrib_binding.
+  virtual void glVertexAttribIFormat(GLuint index, GLint size, GLenum type,
+                                     GLuint relative_offset);
+
+  //! Source attribute index of the bound vertex array object from
+  //! vertex buffer binding binding_index
+  //!
+  //! OpenGL 4.3 or ARB_vertex_attrib_binding.
+  virtual void glVertexAttribBinding(GLuint index, GLuint binding_index);
+
+  //! Attach a buffer to vertex buffer binding binding_index of the
+  //! bound vertex array object
+  //!
+  //! Unlike glVertexAttribPointer a stride of 0 really is 0, every
+  //! vertex reads the same element.
+  //!
+  //! OpenGL 4.3 or ARB_vertex_attrib_binding.
+  virtual void glBindVertexBuffer(GLuint binding_index, GLuint buffer,
+                                  GLintptr offset, GLsizei stride);
+
+  //! Set the divisor of vertex buffer binding binding_index of the
+  //! bound vertex array object
+  //!
+  //! OpenGL 4.3 or ARB_vertex_attrib_binding.
+  virtual void glVertexBindingDivisor(GLuint binding_index, GLuint divisor);
   virtual void glDeleteVertexArrays(GLsizei n, const GLuint *arrays);
 
+  //! Create vertex array objects that can be set up by name
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access, check
+  //! supports(GLFeature::DirectStateAccess) first.
+  virtual void glCreateVertexArrays(GLsizei n, GLuint *arrays);
+
+  //! Enable attribute index of a vertex array object
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glEnableVertexArrayAttrib(GLuint vao, GLuint index);
+
+  //! Attach a buffer to vertex buffer binding binding_index of a
+  //! vertex array object
+  //!
+  //! Unlike glVertexAttribPointer a stride of 0 really is 0, every
+  //! vertex reads the same element.
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayVertexBuffer(GLuint vao, GLuint binding_index,
+                                         GLuint buffer, GLintptr offset,
+                                         GLsizei stride);
+
+  //! Attach the element array buffer of a vertex array object
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayElementBuffer(GLuint vao, GLuint buffer);
+
+  //! Set the format of attribute index of a vertex array object,
+  //! relative_offset bytes into a vertex
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayAttribFormat(GLuint vao, GLuint index, GLint size,
+                                         GLenum type, GLboolean normalized,
+                                         GLuint relative_offset);
+
+  //! Set the format of integer attribute index of a vertex array
+  //! object
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayAttribIFormat(GLuint vao, GLuint index,
+                                          GLint size, GLenum type,
+                                          GLuint relative_offset);
+
+  //! Source attribute index of a vertex array object from vertex
+  //! buffer binding binding_index
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayAttribBinding(GLuint vao, GLuint index,
+                                          GLuint binding_index);
+
+  //! Set the divisor of vertex buffer binding binding_index of a
+  //! vertex array object
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glVertexArrayBindingDivisor(GLuint vao, GLuint binding_index,
+                                           GLuint divisor);
+
   // Shader functions
   virtual GLuint glCreateShader(GLenum type);
   virtual void glShaderSource(GLuint shader, GLsizei count,
@@ -403,6 +767,16 @@ public:
                                    GLsizei *length, GLchar *infoLog);
   virtual void glUseProgram(GLuint program);
   virtual GLint glGetUniformLocation(GLuint program, const GLchar *name);
+
+  //! The index of a named uniform block, or GL_INVALID_INDEX
+  virtual GLuint glGetUniformBlockIndex(GLuint program,
+                                        const GLchar *uniform_block_name);
+
+  //! Connect a uniform block of a program to a uniform buffer binding
+  //! point
+  virtual void glUniformBlockBinding(GLuint program,
+                                     GLuint uniform_block_index,
+                                     GLuint uniform_block_binding);
   virtual void glGetAttachedShaders(GLuint program, GLsizei maxCount,
                                     GLsizei *count, GLuint *shaders);
   virtual void glDeleteProgram(GLuint program);
@@ -2078,14 +2452,75 @@ public:
 
   virtual void glTexParameteri(GLenum target, GLenum pname, GLint param);
 
+  //! Set a floating point parameter of the texture bound to target,
+  //! such as GL_TEXTURE_MAX_ANISOTROPY
+  virtual void glTexParameterf(GLenum target, GLenum pname, GLfloat param);
+
+  //! Allocate immutable storage for levels mipmap levels of the 2D
+  //! texture bound to target
+  //!
+  //! OpenGL 4.2 or ARB_texture_storage, check
+  //! supports(GLFeature::TextureStorage) first.
+  virtual void glTexStorage2D(GLenum target, GLsizei levels,
+                              GLenum internal_format, GLsizei width,
+                              GLsizei height);
+
+  //! Allocate immutable storage for levels mipmap levels of the
+  //! array or 3D texture bound to target
+  //!
+  //! OpenGL 4.2 or ARB_texture_storage, check
+  //! supports(GLFeature::TextureStorage) first.
+  virtual void glTexStorage3D(GLenum target, GLsizei levels,
+                              GLenum internal_format, GLsizei width,
+                              GLsizei height, GLsizei depth);
+
+  //! Fill every mipmap level of the texture bound to target from
+  //! level 0
+  virtual void glGenerateMipmap(GLenum target);
+
+  //! Select the texture unit later glBindTexture calls bind to,
+  //! GL_TEXTURE0 and up
+  virtual void glActiveTexture(GLenum texture);
+
+  //! Set how pixels are read from client memory by later uploads,
+  //! for example GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT
+  virtual void glPixelStorei(GLenum pname, GLint param);
+
   virtual void glTexImage2D(GLenum target, GLint level, GLint internalFormat,
                             GLsizei width, GLsizei height, GLint border,
                             GLenum format, GLenum type, const GLvoid *pixels);
 
+  //! Replace a rectangle of an existing texture image
+  //!
+  //! With a buffer bound to GL_PIXEL_UNPACK_BUFFER, pixels is a byte
+  //! offset into that buffer and the copy is done by the GPU.
+  virtual void glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                               GLint yoffset, GLsizei width, GLsizei height,
+                               GLenum format, GLenum type,
+                               const GLvoid *pixels);
+
+  //! Allocate one mipmap level of the array or 3D texture bound to
+  //! target, with depth layers
+  virtual void glTexImage3D(GLenum target, GLint level, GLint internalFormat,
+                            GLsizei width, GLsizei height, GLsizei depth,
+                            GLint border, GLenum format, GLenum type,
+                            const GLvoid *pixels);
+
+  //! Replace a box of an existing array or 3D texture image, for an
+  //! array texture zoffset is the first layer and depth the number
+  //! of layers
+  virtual void glTexSubImage3D(GLenum target, GLint level, GLint xoffset,
+                               GLint yoffset, GLint zoffset, GLsizei width,
+                               GLsizei height, GLsizei depth, GLenum format,
+                               GLenum type, const GLvoid *pixels);
+
   // 1.1 functions
 
   virtual void glGenTextures(GLsizei n, GLuint *textures);
 
+  //! Delete named textures, unused names are silently ignored
+  virtual void glDeleteTextures(GLsizei n, const GLuint *textures);
+
   //! Binds a named texture to a texturing target.
   //!
   //! Description
@@ -2162,6 +2597,64 @@ public:
   //!                      corresponding execution of glEnd
   virtual void glBindTexture(GLenum target, GLuint texture);
 
+  //! Create textures for target that can be set up by name
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access, check
+  //! supports(GLFeature::DirectStateAccess) first.
+  virtual void glCreateTextures(GLenum target, GLsizei n, GLuint *textures);
+
+  //! glTexParameteri on a texture by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureParameteri(GLuint texture, GLenum pname, GLint param);
+
+  //! glTexParameterf on a texture by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureParameterf(GLuint texture, GLenum pname,
+                                   GLfloat param);
+
+  //! glGenerateMipmap on a texture by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glGenerateTextureMipmap(GLuint texture);
+
+  //! Allocate immutable storage for levels mipmap levels of a 2D
+  //! texture
+  //!
+  //! The size and format can't change afterwards, only the contents
+  //! with glTextureSubImage2D.
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureStorage2D(GLuint texture, GLsizei levels,
+                                  GLenum internal_format, GLsizei width,
+                                  GLsizei height);
+
+  //! glTexSubImage2D on a texture by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureSubImage2D(GLuint texture, GLint level, GLint xoffset,
+                                   GLint yoffset, GLsizei width, GLsizei height,
+                                   GLenum format, GLenum type,
+                                   const void *pixels);
+
+  //! Allocate immutable storage for levels mipmap levels of an array
+  //! or 3D texture
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureStorage3D(GLuint texture, GLsizei levels,
+                                  GLenum internal_format, GLsizei width,
+                                  GLsizei height, GLsizei depth);
+
+  //! glTexSubImage3D on a texture by name, without binding it
+  //!
+  //! OpenGL 4.5 or ARB_direct_state_access.
+  virtual void glTextureSubImage3D(GLuint texture, GLint level, GLint xoffset,
+                                   GLint yoffset, GLint zoffset, GLsizei width,
+                                   GLsizei height, GLsizei depth,
+                                   GLenum format, GLenum type,
+                                   const void *pixels);
+
   // Transformation
 
   //! Pushes the current matrix stack.
@@ -2275,8 +2768,26 @@ public:
   virtual void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
 private:
+  // True if the context version is at least major.minor
+  bool version_at_least(int major, int minor);
+
+  // True if the context advertises the named extension
+  bool has_extension(const std::string &extension);
+
   // The OpenGL context this program uses
   std::shared_ptr<GL_Context> gl_context = nullptr;
+
+  // Cached context version, queried on first use by supports()
+  std::optional<std::pair<int, int>> version = std::nullopt;
+
+  // Cached answer of direct_state_access()
+  std::optional<bool> dsa = std::nullopt;
+
+  // Cached answer of vertex_attrib_binding()
+  std::optional<bool> attrib_binding = std::nullopt;
+
+  // Cached extension names, queried on first use by supports()
+  std::optional<std::unordered_set<std::string>> extensions = std::nullopt;
 };
 
 } // namespace sdl_opengl_cpp
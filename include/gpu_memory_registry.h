@@ -0,0 +1,198 @@
+#ifndef _SDL_OPENGL_CPP_GPU_MEMORY_REGISTRY_H_
+#define _SDL_OPENGL_CPP_GPU_MEMORY_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+//! What kind of OpenGL object an allocation belongs to
+//!
+//! OpenGL names are only unique within one kind of object, so the
+//! category is part of the key for every allocation.
+enum class GPUMemoryCategory {
+  //! Buffer objects created with glBufferData, including the buffers
+  //! owned by vertex array objects, index, uniform and shader
+  //! storage buffers
+  Buffer,
+
+  //! Immutable persistently mapped buffers created with
+  //! glBufferStorage
+  StreamingBuffer,
+
+  //! Textures, for example from SDLSurface::GL_LoadTexture
+  Texture,
+
+  //! Anything else the application wants to account for
+  Other,
+};
+
+//! One recorded allocation
+struct GPUAllocation {
+  GPUMemoryCategory category;
+
+  //! The OpenGL name of the object
+  GLuint id;
+
+  //! The debug name of the object
+  string name;
+
+  GLsizeiptr bytes;
+
+  //! True if the allocation has an evictor and can be freed to make
+  //! room
+  bool evictable;
+};
+
+//! A GPUMemoryRegistry records how much GPU memory each OpenGL
+//! object uses and keeps the total under a budget.
+//!
+//! The library records its own buffers automatically, and
+//! SDLSurface::GL_LoadTexture records the textures it creates until
+//! they are deleted with SDLSurface::GL_DeleteTexture.  Allocations
+//! are keyed by category and OpenGL name, so moving a wrapper object
+//! doesn't change its entry.
+//!
+//! Only resources with a caller registered evictor can be evicted,
+//! the library doesn't register any itself.  Application caches can
+//! register one for the resources they could recreate.  When an
+//! allocation would go over the budget, or the driver reports
+//! GL_OUT_OF_MEMORY, the least recently used evictable resources are
+//! freed first.  The library doesn't touch() its own objects, so
+//! call touch() when a cached resource is used or the eviction order
+//! is just the order the resources were recorded in.
+//!
+//! The registry isn't locked, use it from the thread that owns the
+//! OpenGL context like the rest of the library.
+class GPUMemoryRegistry {
+public:
+  //! An evictor frees the resource it was registered for, which
+  //! should release() its allocation
+  using Evictor = std::function<void()>;
+
+  //! The registry the library records into
+  static GPUMemoryRegistry &instance();
+
+  //! Record an allocation, replacing any existing one for the same
+  //! object
+  //!
+  //! \param category The kind of OpenGL object
+  //! \param id The OpenGL name of the object
+  //! \param name The debug name of the object
+  //! \param bytes The size of the allocation in bytes
+  void track(GPUMemoryCategory category, GLuint id, const string &name,
+             GLsizeiptr bytes);
+
+  //! Change the size of a recorded allocation, for example after
+  //! the buffer was respecified
+  //!
+  //! Unknown objects are ignored.
+  void resize(GPUMemoryCategory category, GLuint id, GLsizeiptr bytes);
+
+  //! Forget an allocation when its object is deleted
+  //!
+  //! Unknown objects are ignored.
+  void release(GPUMemoryCategory category, GLuint id);
+
+  //! Mark an allocation as used now, for the least recently used
+  //! eviction order
+  void touch(GPUMemoryCategory category, GLuint id);
+
+  //! Register a callback that frees a cached resource when memory is
+  //! needed
+  //!
+  //! \returns false if the object isn't recorded
+  bool set_evictor(GPUMemoryCategory category, GLuint id, Evictor evictor);
+
+  //! Make an allocation permanent again
+  void clear_evictor(GPUMemoryCategory category, GLuint id);
+
+  //! Make room for a new allocation
+  //!
+  //! Evicts least recently used resources until bytes more fit in
+  //! the budget.  Always succeeds without a budget, and fails without
+  //! evicting anything if bytes is more than the whole budget.
+  //!
+  //! \returns true if the allocation fits in the budget
+  bool reserve(GLsizeiptr bytes);
+
+  //! Evict least recently used resources until at least bytes have
+  //! been freed or nothing evictable is left
+  //!
+  //! \returns the number of bytes freed
+  GLsizeiptr evict(GLsizeiptr bytes);
+
+  //! Set the most bytes the recorded allocations may use
+  //!
+  //! Lowering the budget doesn't evict anything until the next
+  //! reserve().
+  //!
+  //! \param budget The budget in bytes, zero for no budget
+  void set_budget(GLsizeiptr budget);
+
+  //! The budget in bytes, zero if there is none
+  GLsizeiptr get_budget() const;
+
+  //! The bytes used by every recorded allocation
+  GLsizeiptr get_total_bytes() const;
+
+  //! The bytes used by one category of allocation
+  GLsizeiptr get_bytes(GPUMemoryCategory category) const;
+
+  //! The highest total seen since the registry was created
+  GLsizeiptr get_peak_bytes() const;
+
+  //! The number of recorded allocations
+  size_t get_allocation_count() const;
+
+  //! The number of resources evicted since the registry was created
+  size_t get_eviction_count() const;
+
+  //! Every recorded allocation, for debug overlays and logging
+  std::vector<GPUAllocation> get_allocations() const;
+
+private:
+  struct Entry {
+    string name;
+    GLsizeiptr bytes = 0;
+
+    // The tick the allocation was last touched
+    std::uint64_t last_used = 0;
+
+    Evictor evictor = nullptr;
+  };
+
+  using Key = std::pair<GPUMemoryCategory, GLuint>;
+
+  // Evict the least recently used evictable allocation
+  //
+  // Returns the bytes freed, or a negative value if there was
+  // nothing to evict
+  GLsizeiptr evict_one();
+
+  std::map<Key, Entry> entries;
+
+  // Incremented on every track and touch, orders the entries by use
+  std::uint64_t tick = 0;
+
+  GLsizeiptr budget = 0;
+
+  GLsizeiptr total_bytes = 0;
+
+  GLsizeiptr peak_bytes = 0;
+
+  size_t eviction_count = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,137 @@
+#ifndef _SDL_OPENGL_CPP_INDEX_BUFFER_OBJECT_H_
+#define _SDL_OPENGL_CPP_INDEX_BUFFER_OBJECT_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace index_buffer_object {
+
+#ifndef NO_EXCEPTIONS
+
+//! A IndexBufferObjectUnspecifiedStateError exception
+//!
+//! This exception is thrown when the IndexBufferObject is in an
+//! valid but unspecified state after a move operation.
+//!
+class IndexBufferObjectUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace index_buffer_object
+
+using namespace index_buffer_object;
+
+//! An IndexBufferObject owns an OpenGL element array buffer.
+//!
+//! Indices are given as 32-bit values and stored with the smallest
+//! type that can address every vertex: GL_UNSIGNED_SHORT when there
+//! are at most 65536 vertices, GL_UNSIGNED_INT otherwise.  Pass
+//! get_index_type() to glDrawElements.
+//!
+//! An IndexBufferObject is usually attached to a VertexArrayObject
+//! with VertexArrayObject::attach_index_buffer(), which takes
+//! ownership of it.
+//!
+//! Owned OpenGL resources are automatically cleaned up on object
+//! deletion.
+#ifndef NO_EXCEPTIONS
+class IndexBufferObject : private MoveChecker {
+#else
+class IndexBufferObject : public Errors {
+#endif
+public:
+  //! Construct an index buffer object
+  //!
+  //! \param name The name of the index buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param indices The indices to load into the buffer
+  //! \param vertex_count The number of vertices the indices refer
+  //!                     to, this picks the index type
+  //! \param usage The usage hint for the buffer
+  //!
+  //! \throws a BufferDataError if indices is empty or an index is
+  //!         not less than vertex_count.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new IndexBufferObject object
+  IndexBufferObject(const string &name, const std::shared_ptr<GLContext> &ctx,
+                    std::span<const GLuint> indices, size_t vertex_count,
+                    GLenum usage = GL_STATIC_DRAW);
+  ~IndexBufferObject();
+
+  //! Cleanup the index buffer object
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  IndexBufferObject(const IndexBufferObject &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  IndexBufferObject &operator=(const IndexBufferObject &) = delete;
+
+  // move constructor
+  IndexBufferObject(IndexBufferObject &&) noexcept;
+
+  // move assignment operator
+  IndexBufferObject &operator=(IndexBufferObject &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Bind the buffer to GL_ELEMENT_ARRAY_BUFFER
+  //!
+  //! The binding is part of the currently bound vertex array object.
+  void bind();
+
+  //! GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+  GLenum get_index_type() const;
+
+  //! The number of indices
+  GLsizei get_count() const;
+
+  //! The OpenGL name of the buffer, for direct state access calls
+  //! that take a buffer by name
+  GLuint get_buffer() const;
+
+private:
+  string name;
+
+  // The OpenGL context this buffer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // The buffer holding the packed indices
+  std::optional<VertexBufferObject> buffer = std::nullopt;
+
+  GLenum index_type = GL_UNSIGNED_INT;
+
+  GLsizei count = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
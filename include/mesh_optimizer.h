@@ -0,0 +1,228 @@
+#ifndef _SDL_OPENGL_CPP_MESH_OPTIMIZER_H_
+#define _SDL_OPENGL_CPP_MESH_OPTIMIZER_H_
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#include "opengl.h"
+
+namespace sdl_opengl_cpp {
+
+//! Reordering passes for indexed triangle meshes
+//!
+//! Run these on the vertices and indices before they are loaded into
+//! a VertexBufferObject and IndexBufferObject.  None of them change
+//! what is drawn, only the order it is drawn and fetched in:
+//!
+//!   1. optimize_vertex_cache() reorders triangles with Tipsify so
+//!      vertices are reused from the post-transform cache.
+//!   2. optimize_overdraw() splits that order into clusters and draws
+//!      the outward facing ones first, so the early depth test
+//!      rejects more hidden fragments, while keeping most of the
+//!      cache locality.
+//!   3. optimize_vertex_fetch() reorders the vertices into the order
+//!      the indices first use them, so vertex fetches walk memory
+//!      forwards, and drops unused vertices.
+//!
+//! optimize_mesh() runs all three.  Use analyze_vertex_cache() to
+//! compare the average cache miss ratio (ACMR) before and after.
+//!
+//! Indices are GL_TRIANGLES lists.  Functions return an empty vector
+//! if the number of indices isn't a multiple of three or an index is
+//! not less than vertex_count.
+namespace mesh_optimizer {
+
+//! The number of entries in the simulated post-transform cache
+//!
+//! Recent GPUs don't have a fixed FIFO cache, but ordering for one of
+//! about this size gets close to their best case.
+constexpr size_t default_cache_size = 16;
+
+//! How much worse than the cache optimized order a cluster may be
+//! before optimize_overdraw() stops splitting it
+constexpr float default_overdraw_threshold = 1.05f;
+
+//! The remap entry of a vertex no index uses
+constexpr GLuint unused_vertex = ~0u;
+
+//! Post-transform cache statistics of an index order
+struct VertexCacheStatistics {
+  //! The number of vertices transformed
+  size_t misses = 0;
+
+  //! Average cache miss ratio, transformed vertices per triangle
+  //!
+  //! Between 3 with no reuse and about 0.5 for a large regular grid.
+  float acmr = 0.0f;
+
+  //! Average transform to vertex ratio, transformed vertices per
+  //! vertex, 1 is ideal
+  float atvr = 0.0f;
+};
+
+//! Simulate a FIFO post-transform cache over an index order
+//!
+//! \param indices The triangle indices
+//! \param vertex_count The number of vertices the indices refer to
+//! \param cache_size The number of entries in the simulated cache
+VertexCacheStatistics
+analyze_vertex_cache(std::span<const GLuint> indices, size_t vertex_count,
+                     size_t cache_size = default_cache_size);
+
+//! Reorder triangles for the post-transform vertex cache
+//!
+//! This is Tipsify, from "Fast Triangle Reordering for Vertex
+//! Locality and Reduced Overdraw" by Sander, Nehab and Barczak.  It
+//! runs in time linear in the number of indices.
+//!
+//! \param indices The triangle indices
+//! \param vertex_count The number of vertices the indices refer to
+//! \param cache_size The number of entries in the cache to target
+//!
+//! \returns the reordered indices
+std::vector<GLuint> optimize_vertex_cache(std::span<const GLuint> indices,
+                                          size_t vertex_count,
+                                          size_t cache_size = default_cache_size);
+
+//! Reorder clusters of triangles to reduce overdraw
+//!
+//! The indices should already be ordered by optimize_vertex_cache().
+//! They are split into clusters where the cache order starts afresh,
+//! and further while a cluster's miss ratio stays within threshold of
+//! the whole cluster's.  Clusters facing away from the center of the
+//! mesh are drawn first, since they tend to occlude the rest.
+//!
+//! \param indices The triangle indices
+//! \param vertex_data The vertices
+//! \param vertex_count The number of vertices
+//! \param stride The size of one vertex in bytes
+//! \param position_offset The byte offset of the three float position
+//!                        in a vertex
+//! \param cache_size The number of entries in the cache to target
+//! \param threshold How many times worse the ACMR may get, 1 keeps
+//!                  the cache order
+//!
+//! \returns the reordered indices
+std::vector<GLuint> optimize_overdraw(
+    std::span<const GLuint> indices, const std::byte *vertex_data,
+    size_t vertex_count, size_t stride, size_t position_offset = 0,
+    size_t cache_size = default_cache_size,
+    float threshold = default_overdraw_threshold);
+
+//! Reorder clusters of triangles to reduce overdraw
+//!
+//! \param indices The triangle indices
+//! \param vertices The vertices
+//! \param position_offset The byte offset of the three float position
+//!                        in Vertex
+//!
+//! \returns the reordered indices
+template <typename Vertex>
+std::vector<GLuint>
+optimize_overdraw(std::span<const GLuint> indices,
+                  std::span<const Vertex> vertices,
+                  size_t position_offset = 0,
+                  size_t cache_size = default_cache_size,
+                  float threshold = default_overdraw_threshold) {
+  return optimize_overdraw(
+      indices, reinterpret_cast<const std::byte *>(vertices.data()),
+      vertices.size(), sizeof(Vertex), position_offset, cache_size,
+      threshold);
+}
+
+//! Generate a remap table that orders vertices by first use
+//!
+//! \param indices The triangle indices
+//! \param vertex_count The number of vertices the indices refer to
+//!
+//! \returns the new index of every vertex, unused_vertex for the
+//!          ones no index uses
+std::vector<GLuint> generate_vertex_fetch_remap(std::span<const GLuint> indices,
+                                                size_t vertex_count);
+
+//! Rewrite indices through a remap table
+//!
+//! \returns the new indices, empty if an index isn't in the table or
+//!          maps to unused_vertex
+std::vector<GLuint> remap_indices(std::span<const GLuint> indices,
+                                  std::span<const GLuint> remap);
+
+//! Move vertices to their place in a remap table, dropping unused
+//! ones
+template <typename Vertex>
+std::vector<Vertex> remap_vertices(std::span<const Vertex> vertices,
+                                   std::span<const GLuint> remap) {
+  size_t used = 0;
+  for (GLuint destination : remap)
+    used += (destination != unused_vertex);
+
+  std::vector<Vertex> result(used);
+  for (size_t i = 0; (i < vertices.size()) && (i < remap.size()); i++) {
+    if (remap[i] != unused_vertex)
+      result[remap[i]] = vertices[i];
+  }
+
+  return result;
+}
+
+//! Reorder vertices by first use and rewrite the indices to match
+//!
+//! \param vertices The vertices, replaced with the reordered ones
+//! \param indices The triangle indices, rewritten in place
+//!
+//! \returns false, leaving both unchanged, if the indices are invalid
+template <typename Vertex>
+bool optimize_vertex_fetch(std::vector<Vertex> &vertices,
+                           std::vector<GLuint> &indices) {
+  std::vector<GLuint> remap =
+      generate_vertex_fetch_remap(indices, vertices.size());
+  std::vector<GLuint> remapped = remap_indices(indices, remap);
+
+  if (remapped.size() != indices.size())
+    return false;
+
+  indices = std::move(remapped);
+  vertices = remap_vertices<Vertex>(vertices, remap);
+
+  return true;
+}
+
+//! Run every pass on a mesh, in the order described above
+//!
+//! \param vertices The vertices, replaced with the reordered ones
+//! \param indices The triangle indices, replaced with the reordered ones
+//! \param position_offset The byte offset of the three float position
+//!                        in Vertex
+//! \param cache_size The number of entries in the cache to target
+//!
+//! \returns false, leaving both unchanged, if the indices are invalid
+template <typename Vertex>
+bool optimize_mesh(std::vector<Vertex> &vertices, std::vector<GLuint> &indices,
+                   size_t position_offset = 0,
+                   size_t cache_size = default_cache_size) {
+  std::vector<GLuint> ordered =
+      optimize_vertex_cache(indices, vertices.size(), cache_size);
+
+  if (ordered.empty() && !indices.empty())
+    return false;
+
+  ordered = optimize_overdraw<Vertex>(ordered, vertices, position_offset,
+                                      cache_size);
+  if (!optimize_vertex_fetch(vertices, ordered))
+    return false;
+
+  indices = std::move(ordered);
+
+  return true;
+}
+
+} // namespace mesh_optimizer
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef _SDL_OPENGL_CPP_OFFSET_ALLOCATOR_H_
+#define _SDL_OPENGL_CPP_OFFSET_ALLOCATOR_H_
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace sdl_opengl_cpp {
+
+//! An OffsetAllocator hands out ranges of an abstract address space
+//!
+//! It doesn't own any memory, it only tracks offsets, so it can be
+//! used to sub-allocate GPU buffers.  The unit is up to the caller,
+//! BufferArena uses vertices so offsets can be used directly as base
+//! vertices.
+//!
+//! This is a two-level segregated fit (TLSF) allocator.  Free ranges
+//! are kept in 256 size bins, indexed by a small floating point
+//! encoding of the size with a 5 bit exponent and 3 bit mantissa.
+//! Two levels of bitmasks find the first non-empty bin that is large
+//! enough in constant time.  Freed ranges are merged with free
+//! neighbors immediately, so allocation and free are both O(1).
+//!
+//! Requests are rounded up to the next bin size when searching, so a
+//! free range that is only slightly larger than a request, and not
+//! itself a bin size, may be passed over.  When no larger bin has a
+//! free range, the request's own bin is scanned for one that is large
+//! enough, so a request for the whole of a free range always succeeds.
+//!
+//! The design follows Sebastian Aaltonen's OffsetAllocator.
+class OffsetAllocator {
+public:
+  //! Returned in Allocation::offset when an allocation fails
+  static constexpr uint32_t no_space = std::numeric_limits<uint32_t>::max();
+
+  //! A range handed out by allocate()
+  struct Allocation {
+    //! The start of the range, or no_space if the allocation failed
+    uint32_t offset = no_space;
+
+    //! Internal node index, needed to free the allocation
+    uint32_t metadata = no_space;
+  };
+
+  //! Summary of the free space
+  struct StorageReport {
+    //! Total free space, possibly fragmented
+    uint32_t total_free_space;
+
+    //! The size of the largest bin with free space, a lower bound
+    //! on the largest single allocation that will succeed
+    uint32_t largest_free_region;
+  };
+
+  //! Create an allocator managing the range [0, size)
+  //!
+  //! \param size The size of the address space
+  //! \param max_allocations The maximum number of live allocations
+  //!                        plus free ranges
+  OffsetAllocator(uint32_t size, uint32_t max_allocations = 128 * 1024);
+
+  //! Allocate size units
+  //!
+  //! \returns the allocation, with offset set to no_space if there
+  //!          isn't a large enough free range
+  Allocation allocate(uint32_t size);
+
+  //! Free an allocation returned by allocate()
+  void free(Allocation allocation);
+
+  //! The size of a live allocation
+  uint32_t allocation_size(Allocation allocation) const;
+
+  //! Summarize the free space
+  StorageReport storage_report() const;
+
+  //! Free every allocation
+  void reset();
+
+  //! The size of the address space
+  uint32_t get_size() const;
+
+private:
+  static constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+
+  struct Node {
+    uint32_t data_offset = 0;
+    uint32_t data_size = 0;
+    uint32_t bin_list_prev = unused;
+    uint32_t bin_list_next = unused;
+    uint32_t neighbor_prev = unused;
+    uint32_t neighbor_next = unused;
+    bool used = false;
+  };
+
+  uint32_t insert_node_into_bin(uint32_t size, uint32_t data_offset);
+  void remove_node_from_bin(uint32_t node_index);
+
+  // Take a free node out of its bin's list, keeping the node
+  void unlink_node_from_bin(uint32_t node_index);
+
+  // A free node of at least alloc_size, or unused if there is none
+  uint32_t find_free_node(uint32_t alloc_size) const;
+
+  uint32_t size;
+  uint32_t max_allocations;
+  uint32_t free_storage = 0;
+
+  // One bit per top level bin with any free nodes
+  uint32_t used_bins_top = 0;
+
+  // One bit per leaf bin with any free nodes, per top level bin
+  std::vector<uint8_t> used_bins;
+
+  // Head of the free node list for each bin
+  std::vector<uint32_t> bin_indices;
+
+  std::vector<Node> nodes;
+
+  // Stack of unused node indices
+  std::vector<uint32_t> free_nodes;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -42,6 +42,11 @@ class GetUniformLocationError : public runtime_error {
   using runtime_error::runtime_error;
 };
 
+class GetUniformBlockIndexError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
 class ProgramUnspecifiedStateError : public runtime_error {
   // Inherit constructors from runtime_error
   using runtime_error::runtime_error;
@@ -135,6 +140,20 @@ public:
 
   GLint getUniformLocation(const std::string &uniform_name_to_get);
 
+  //! Connect a uniform block to a uniform buffer binding point
+  //!
+  //! Every program that binds its block to the same binding point
+  //! reads the UniformBufferObject bound there, so shared data is
+  //! uploaded once.
+  //!
+  //! \param block_name The name of the uniform block in the shader
+  //! \param binding The binding point, as passed to
+  //!                UniformBufferObject::bind_base()
+  //!
+  //! \throws a GetUniformBlockIndexError if the program has no
+  //!         active uniform block called block_name.
+  void bind_uniform_block(const std::string &block_name, GLuint binding);
+
   bool is_in_unspecified_state() const override;
 
 private:
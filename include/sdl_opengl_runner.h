@@ -27,6 +27,8 @@
 #ifndef _SDL_OPENGL_H_
 #define _SDL_OPENGL_H_
 
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -44,6 +46,7 @@
 #endif
 
 #include "clipping_planes.h"
+#include "fence.h"
 #include "sdl_base.h"
 #include "sdl_window.h"
 
@@ -150,9 +153,34 @@ public:
 
   //! Update the window with GL rendering
   //!
-  //! \returns 0 on success
+  //! If a frames in flight limit is set, a Fence is inserted after
+  //! the swap, and the CPU blocks here once more than that many
+  //! frames are still queued on the GPU.
+  //!
+  //! \throws a FenceSyncError if the fence could not be created or
+  //!         waited on.
+  //!
+  //! \returns 0 on success, -1 on failure
   int swap_window();
 
+  //! Limit how many frames the CPU can run ahead of the GPU
+  //!
+  //! Drivers will often queue several frames, which adds latency
+  //! and makes it hard to know when per-frame resources are free.
+  //! Two or three frames keeps the CPU and GPU overlapped without
+  //! growing the queue.  Match it to the N of any FrameInFlight
+  //! rings so they never block on their own.
+  //!
+  //! \param frames The number of frames allowed in flight, zero
+  //!               disables the frame fences
+  void set_max_frames_in_flight(size_t frames);
+
+  //! The number of frames allowed in flight, zero if unlimited
+  size_t get_max_frames_in_flight() const;
+
+  //! The number of swapped frames the GPU may not have finished yet
+  size_t get_frames_in_flight() const;
+
   //! Log the swap interval
   void LogSwapInterval();
 
@@ -210,6 +238,14 @@ private:
 
   //! The clipping planes to use for glOrtho
   ClippingPlanes clipping_planes;
+
+  //! The most frames swap_window lets the CPU run ahead, zero if
+  //! unlimited
+  size_t max_frames_in_flight = 0;
+
+  //! One fence per swapped frame the GPU may still be working on,
+  //! oldest first
+  std::deque<Fence> frame_fences;
 };
 
 } // namespace sdl_opengl_cpp
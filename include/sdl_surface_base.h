@@ -1,11 +1,11 @@
 #ifndef _SDL_TTF_OPENGL_SDL_SURFACE_BASE_H_
 #define _SDL_TTF_OPENGL_SDL_SURFACE_BASE_H_
 
+#include <optional>
 #include <string>
 
 #ifdef NO_EXCEPTIONS
 #include "errors.h"
-#include <optional>
 #else
 #include "move_checker.h"
 #include "spdlog/spdlog.h"
@@ -21,7 +21,10 @@
 #include "SDL_opengl.h"
 
 #include "gl_context.h"
+#include "gpu_memory_registry.h"
 #include "sdl_base.h"
+#include "texture.h"
+#include "upload_queue.h"
 
 using namespace std;
 
@@ -70,6 +73,52 @@ class UnspecifiedStateError : public runtime_error {
 
 #endif
 
+//! How OpenGL reads the pixels of an SDL pixel format
+struct GLPixelFormat {
+  //! The components, for example GL_RGBA or GL_BGRA
+  GLenum format;
+
+  //! The type of the components, for example GL_UNSIGNED_BYTE or
+  //! GL_UNSIGNED_SHORT_5_6_5
+  GLenum type;
+
+  //! A sized internal format that holds the components, GL_RGB8 for
+  //! formats without alpha
+  GLenum internal_format;
+
+  //! The bytes of one pixel
+  GLsizei pixel_size;
+};
+
+//! Find how OpenGL can read pixels of an SDL pixel format in place
+//!
+//! Packed SDL formats are named from the most significant bit down,
+//! so they map to the packed OpenGL types rather than byte orders
+//! and read the same on either endianness.
+//!
+//! \param sdl_format The SDL_PixelFormatEnum of the pixels
+//! \param pixel_format Set to the format, type and internal format
+//!
+//! \returns false if OpenGL can't read the pixels, for example
+//!          palettized and YUV formats
+bool gl_pixel_format(Uint32 sdl_format, GLPixelFormat &pixel_format);
+
+//! Describe rows of pixels to glTexSubImage2D
+//!
+//! SDL pads rows to four bytes, the OpenGL default, so most surfaces
+//! only need the alignment.  Wider rows, for example of a surface
+//! made from a larger buffer, also need the row length.
+//!
+//! \param width The pixels in a row
+//! \param bytes_per_pixel The bytes of one pixel
+//! \param pitch The bytes from one row to the next
+//! \param row_length Set to GL_UNPACK_ROW_LENGTH, 0 for width
+//! \param alignment Set to GL_UNPACK_ALIGNMENT
+//!
+//! \returns false if the pitch can't be described
+bool gl_row_layout(int width, int bytes_per_pixel, int pitch,
+                   GLint &row_length, GLint &alignment);
+
 } // namespace sdl_surface
 
 #ifndef NO_EXCEPTIONS
@@ -149,23 +198,160 @@ public:
   //!          failure; call get_last_error() for more information.
   int h();
 
+  //! Returns the length of a row of pixels in bytes
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //!
+  //! \returns the pitch on success or a negative error code on
+  //!          failure; call get_last_error() for more information.
+  int pitch();
+
+  //! Returns the SDL_PixelFormatEnum of the surface
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //!
+  //! \returns the format on success or SDL_PIXELFORMAT_UNKNOWN on
+  //!          failure; call get_last_error() for more information.
+  Uint32 format();
+
+  //! Find how OpenGL can read the pixels of this surface in place
+  //!
+  //! \param pixel_format Set to the format, type and internal format
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //!
+  //! \returns false if the pixels have to be converted first, for
+  //!          palettized, YUV and RLE surfaces
+  bool GL_PixelFormat(sdl_surface::GLPixelFormat &pixel_format);
+
+  //! Copy the surface into a new RGBA32 surface of the same size
+  //!
+  //! Alpha is copied rather than blended, the alpha modulation and
+  //! blend mode are restored afterwards.
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //! \throws a CreationError if the new surface couldn't be created.
+  //!
+  //! \returns the new surface, or std::nullopt on failure with
+  //!          exceptions disabled; call get_last_error() for more
+  //!          information.
+  std::optional<SDLSurface> ConvertToRGBA32();
+
   //! Create an OpenGL texture from the pixel data on this surface
   //!
+  //! The surface is copied into a power of two RGBA32 surface first,
+  //! GL_CreateTexture uploads the pixels in place at their own size.
+  //!
   //! \param gl_context The OpenGL context to use for operations
   //! \param texcoord The texture coordinates that were written
   //!        to. The minimum X is 0, the minimum Y is 0, the maximum X
   //!        is the surface width and the maximum y is the surface
   //!        height.
+  //! \param name The name the texture is recorded under in the
+  //!        GPUMemoryRegistry
   //!
   //! \throws an UnspecifiedStateError if the surface is in an
   //!         unspecified state.
   //! \throws an SDLSurfaceLoadTextureError if there is an issue
   //!         loading the texture.
   //!
+  //! The texture is recorded in the GPUMemoryRegistry, delete it
+  //! with GL_DeleteTexture so the entry is released too.
+  //!
+  //! When GLContext::direct_state_access() is true the texture gets
+  //! immutable GL_RGBA8 storage with glTextureStorage2D and is left
+  //! unbound, bind it before drawing with it.  Otherwise it is left
+  //! bound to GL_TEXTURE_2D.
+  //!
   //! \returns The texture as an OpenGL handle
   //! TODO: Manage OpenGL textures as C++ classes
   GLuint GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
-                        GLfloat *texcoord);
+                        GLfloat *texcoord,
+                        const string &name = "sdl-surface-texture");
+
+  //! Create an OpenGL texture and queue the pixel data for upload
+  //!
+  //! The texture storage is created straight away, the pixels are
+  //! copied into queue and uploaded by later calls to
+  //! UploadQueue::flush().  The texture contents are undefined until
+  //! then.
+  //!
+  //! \param gl_context The OpenGL context to use for operations
+  //! \param texcoord The texture coordinates that were written to
+  //! \param queue The upload queue to upload the pixels with
+  //! \param name The name the texture is recorded under in the
+  //!        GPUMemoryRegistry
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //! \throws an SDLSurfaceLoadTextureError if there is an issue
+  //!         loading the texture.
+  //!
+  //! \returns The texture as an OpenGL handle, delete it with
+  //!          GL_DeleteTexture
+  GLuint GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
+                        GLfloat *texcoord, UploadQueue &queue,
+                        const string &name = "sdl-surface-texture");
+
+  //! Delete a texture created by GL_LoadTexture
+  //!
+  //! The texture is deleted and its GPUMemoryRegistry entry
+  //! released.
+  //!
+  //! \param gl_context The OpenGL context the texture was created in
+  //! \param texture The OpenGL handle GL_LoadTexture returned
+  static void GL_DeleteTexture(const std::shared_ptr<GLContext> &gl_context,
+                               GLuint texture);
+
+  //! Create a texture the size of this surface from its own pixels
+  //!
+  //! Unlike GL_LoadTexture, the size isn't rounded up to a power of
+  //! two and the pixels aren't copied first.  The internal format
+  //! follows the surface, so texture coordinates run from 0 to 1.
+  //! See GL_UpdateTexture.
+  //!
+  //! \param gl_context The OpenGL context to use for operations
+  //! \param name The name of the texture
+  //! \param levels The number of mipmap levels, 0 for a full chain.
+  //!               Levels after the first are generated from it.
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //! \throws an SDLSurfaceLoadTextureError if the surface had to be
+  //!         converted and couldn't be.
+  //! \throws the Texture errors if the texture couldn't be created.
+  //!
+  //! \returns the texture, or std::nullopt on failure with exceptions
+  //!          disabled; call get_last_error() for more information.
+  std::optional<Texture>
+  GL_CreateTexture(const std::shared_ptr<GLContext> &gl_context,
+                   const string &name, GLsizei levels = 0);
+
+  //! Upload this surface's pixels into a rectangle of a texture
+  //!
+  //! The pixels are read where SDL keeps them, with the OpenGL
+  //! format and type from sdl_surface::gl_pixel_format and the pitch
+  //! given as GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT.  Only
+  //! formats OpenGL can't read, and RLE surfaces, are converted to
+  //! RGBA32 first.
+  //!
+  //! \param texture The texture to upload to
+  //! \param x The left edge of the rectangle in the texture
+  //! \param y The bottom edge of the rectangle in the texture
+  //! \param level The mipmap level to upload to
+  //!
+  //! \throws an UnspecifiedStateError if the surface is in an
+  //!         unspecified state.
+  //! \throws an SDLSurfaceLoadTextureError if the surface had to be
+  //!         converted and couldn't be.
+  //! \throws a TextureDataError if the surface doesn't fit in the
+  //!         texture at x and y.
+  void GL_UpdateTexture(Texture &texture, GLint x = 0, GLint y = 0,
+                        GLint level = 0);
 
   //! Blit onto this surface from another surface
   //!
@@ -335,6 +521,16 @@ private:
   SDL_Surface *surface;
 
   constexpr int power_of_two(const int input) const;
+
+  //! Shared implementation of the GL_LoadTexture overloads, the
+  //! pixels are uploaded immediately if queue is nullptr
+  GLuint load_texture(const std::shared_ptr<GLContext> &gl_context,
+                      GLfloat *texcoord, UploadQueue *queue,
+                      const string &name);
+
+  //! Implementation of GL_UpdateTexture, returns false on error with
+  //! exceptions disabled
+  bool update_texture(Texture &texture, GLint x, GLint y, GLint level);
 };
 
 } // namespace sdl_opengl_cpp
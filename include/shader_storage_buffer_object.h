@@ -0,0 +1,218 @@
+#ifndef _SDL_OPENGL_CPP_SHADER_STORAGE_BUFFER_OBJECT_H_
+#define _SDL_OPENGL_CPP_SHADER_STORAGE_BUFFER_OBJECT_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace shader_storage_buffer_object {
+
+#ifndef NO_EXCEPTIONS
+
+//! A ShaderStorageNotSupportedError exception
+//!
+//! This exception is thrown when the OpenGL context doesn't support
+//! shader storage buffers (OpenGL 4.3 or
+//! ARB_shader_storage_buffer_object).
+//!
+class ShaderStorageNotSupportedError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A ShaderStorageBufferObjectUnspecifiedStateError exception
+//!
+//! This exception is thrown when the ShaderStorageBufferObject is in
+//! an valid but unspecified state after a move operation.
+//!
+class ShaderStorageBufferObjectUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace shader_storage_buffer_object
+
+using namespace shader_storage_buffer_object;
+
+//! A ShaderStorageBufferObject owns an OpenGL shader storage buffer.
+//!
+//! Shader storage blocks can be as large as the buffer, far beyond
+//! the 16KB uniform blocks are guaranteed, which makes them a good
+//! fit for per-object data such as tens of thousands of transforms.
+//! One instanced draw reads its element with gl_InstanceID instead
+//! of a uniform call per object:
+//!
+//!   layout(std430, binding = 0) readonly buffer Transforms {
+//!     mat4 model[];
+//!   };
+//!
+//! In the std430 layout arrays of vec4 and mat4 are tightly packed,
+//! so a vector of 16 float matrices can be uploaded as is.  The
+//! binding point in the shader matches bind_base() or bind_range().
+//!
+//! Needs OpenGL 4.3 or ARB_shader_storage_buffer_object, check
+//! GLContext::supports(GLFeature::ShaderStorageBufferObject).
+//!
+//! Owned OpenGL resources are automatically cleaned up on object
+//! deletion.
+#ifndef NO_EXCEPTIONS
+class ShaderStorageBufferObject : private MoveChecker {
+#else
+class ShaderStorageBufferObject : public Errors {
+#endif
+public:
+  //! Construct a shader storage buffer object with uninitialized
+  //! storage
+  //!
+  //! \param name The name of the shader storage buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param size The size of the buffer in bytes
+  //! \param usage The usage hint for the buffer
+  //!
+  //! \throws a ShaderStorageNotSupportedError if shader storage
+  //!         buffers aren't supported by the context.
+  //!
+  //! \throws a BufferDataError if the size isn't positive.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new ShaderStorageBufferObject object
+  ShaderStorageBufferObject(const string &name,
+                            const std::shared_ptr<GLContext> &ctx,
+                            GLsizeiptr size, GLenum usage = GL_DYNAMIC_DRAW);
+
+  //! Construct a shader storage buffer object filled with data
+  //!
+  //! \param name The name of the shader storage buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param data The bytes to load into the buffer
+  //! \param usage The usage hint for the buffer
+  //!
+  //! \throws a ShaderStorageNotSupportedError if shader storage
+  //!         buffers aren't supported by the context.
+  //!
+  //! \throws a BufferDataError if data is empty.
+  //!
+  //! \return A new ShaderStorageBufferObject object
+  ShaderStorageBufferObject(const string &name,
+                            const std::shared_ptr<GLContext> &ctx,
+                            std::span<const std::byte> data,
+                            GLenum usage = GL_DYNAMIC_DRAW);
+
+  //! Construct a shader storage buffer object from a typed span
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  ShaderStorageBufferObject(const string &buffer_name,
+                            const std::shared_ptr<GLContext> &ctx,
+                            std::span<const T> data,
+                            GLenum buffer_usage = GL_DYNAMIC_DRAW)
+      : ShaderStorageBufferObject(buffer_name, ctx, std::as_bytes(data),
+                                  buffer_usage) {}
+
+  ~ShaderStorageBufferObject();
+
+  //! Cleanup the shader storage buffer object
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  ShaderStorageBufferObject(const ShaderStorageBufferObject &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  ShaderStorageBufferObject &
+  operator=(const ShaderStorageBufferObject &) = delete;
+
+  // move constructor
+  ShaderStorageBufferObject(ShaderStorageBufferObject &&) noexcept;
+
+  // move assignment operator
+  ShaderStorageBufferObject &operator=(ShaderStorageBufferObject &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Update part of the buffer in place
+  //!
+  //! \param offset The byte offset to start writing at
+  //! \param data The bytes to write
+  //!
+  //! \throws a BufferDataError if the data doesn't fit in the buffer
+  //!         at offset.
+  void update(GLintptr offset, std::span<const std::byte> data);
+
+  //! Update part of the buffer in place
+  //!
+  //! \param offset The byte offset to start writing at
+  //! \param data The elements to write
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void update(GLintptr offset, std::span<const T> data) {
+    update(offset, std::as_bytes(data));
+  }
+
+  //! Bind the whole buffer to a shader storage binding point
+  void bind_base(GLuint binding);
+
+  //! Bind part of the buffer to a shader storage binding point
+  //!
+  //! \param binding The binding point
+  //! \param offset The byte offset of the range, a multiple of
+  //!               get_offset_alignment()
+  //! \param range_size The size of the range in bytes
+  //!
+  //! \throws a BufferDataError if the offset is misaligned or the
+  //!         range doesn't fit in the buffer.
+  void bind_range(GLuint binding, GLintptr offset, GLsizeiptr range_size);
+
+  //! The size of the buffer in bytes
+  GLsizeiptr get_size() const;
+
+  //! The alignment bind_range() offsets need,
+  //! GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+  GLint get_offset_alignment() const;
+
+private:
+  // Shared implementation for the public constructors, data may be
+  // empty for uninitialized storage
+  void create(GLsizeiptr size, std::span<const std::byte> data,
+              GLenum usage);
+
+  string name;
+
+  // The OpenGL context this buffer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // The buffer holding the data
+  std::optional<VertexBufferObject> buffer = std::nullopt;
+
+  // 256 is the largest alignment OpenGL allows, used if the query
+  // fails
+  GLint offset_alignment = 256;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,214 @@
+#ifndef _SDL_OPENGL_CPP_STD140_H_
+#define _SDL_OPENGL_CPP_STD140_H_
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#include "opengl.h"
+
+namespace sdl_opengl_cpp {
+
+//! Member types of a std140 uniform block
+//!
+//! Each type knows its std140 base alignment and size, the C++ value
+//! it is packed from, and how to write that value into a block.
+//! Vectors and matrices are packed from std::arrays of their
+//! components, matrices in column-major order.
+namespace std140 {
+
+constexpr size_t round_up(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+//! A scalar, vector or column-major matrix
+//!
+//! \tparam T The component type, GLfloat, GLint or GLuint
+//! \tparam Components The number of components, or rows of a matrix
+//! \tparam Columns The number of columns of a matrix, 1 otherwise
+template <typename T, size_t Components, size_t Columns = 1> struct Type {
+  static_assert(sizeof(T) == 4, "std140 components are four bytes");
+  static_assert((Components >= 1) && (Components <= 4),
+                "A std140 vector has between one and four components");
+
+  using value_type =
+      std::conditional_t<(Components == 1) && (Columns == 1), T,
+                         std::array<T, Components * Columns>>;
+
+  // Matrix columns are laid out like an array of vectors, each
+  // column starts on a 16 byte boundary
+  static constexpr size_t column_size = Components * sizeof(T);
+  static constexpr size_t column_stride =
+      (Columns == 1) ? column_size : round_up(column_size, 16);
+
+  //! The base alignment, a three component vector is aligned like a
+  //! four component one
+  static constexpr size_t alignment =
+      (Columns > 1) ? 16
+                    : ((Components == 3) ? 4 : Components) * sizeof(T);
+
+  //! The number of bytes the member occupies
+  static constexpr size_t size =
+      (Columns == 1) ? column_size : Columns * column_stride;
+
+  static void write(std::byte *destination, const value_type &value) {
+    const std::byte *source = reinterpret_cast<const std::byte *>(&value);
+
+    for (size_t column = 0; column < Columns; column++)
+      std::memcpy(destination + column * column_stride,
+                  source + column * column_size, column_size);
+  }
+};
+
+using scalar = Type<GLfloat, 1>;
+using int_scalar = Type<GLint, 1>;
+using uint_scalar = Type<GLuint, 1>;
+
+using vec2 = Type<GLfloat, 2>;
+using vec3 = Type<GLfloat, 3>;
+using vec4 = Type<GLfloat, 4>;
+using ivec2 = Type<GLint, 2>;
+using ivec3 = Type<GLint, 3>;
+using ivec4 = Type<GLint, 4>;
+using uvec2 = Type<GLuint, 2>;
+using uvec3 = Type<GLuint, 3>;
+using uvec4 = Type<GLuint, 4>;
+
+using mat2 = Type<GLfloat, 2, 2>;
+using mat3 = Type<GLfloat, 3, 3>;
+using mat4 = Type<GLfloat, 4, 4>;
+
+//! An array of Count elements
+//!
+//! Every element starts on a 16 byte boundary, so an array of
+//! scalars takes four times the space of the C++ array.
+template <typename Element, size_t Count> struct array_of {
+  static_assert(Count > 0, "A std140 array needs at least one element");
+
+  using value_type = std::array<typename Element::value_type, Count>;
+
+  static constexpr size_t stride = round_up(Element::size, 16);
+  static constexpr size_t alignment = round_up(Element::alignment, 16);
+  static constexpr size_t size = Count * stride;
+
+  static void write(std::byte *destination, const value_type &value) {
+    for (size_t i = 0; i < Count; i++)
+      Element::write(destination + i * stride, value[i]);
+  }
+};
+
+} // namespace std140
+
+namespace std140_detail {
+
+// Resolve the offset of each member, aligned in order
+template <typename... Members>
+constexpr std::array<size_t, sizeof...(Members)> make_offsets() {
+  std::array<size_t, sizeof...(Members)> result{};
+  size_t offset = 0;
+  size_t i = 0;
+
+  ((offset = std140::round_up(offset, Members::alignment),
+    result[i++] = offset, offset += Members::size),
+   ...);
+
+  return result;
+}
+
+template <typename... Members> constexpr size_t end_offset() {
+  constexpr std::array<size_t, sizeof...(Members)> offsets =
+      make_offsets<Members...>();
+  constexpr std::array<size_t, sizeof...(Members)> sizes = {Members::size...};
+
+  return offsets.back() + sizes.back();
+}
+
+} // namespace std140_detail
+
+//! A uniform block packed with the std140 layout rules
+//!
+//! The members are listed in the order they are declared in the
+//! shader, so
+//!
+//!   layout(std140) uniform Camera {
+//!     mat4 view_projection;
+//!     vec3 position;
+//!     float exposure;
+//!   };
+//!
+//! is
+//!
+//!   using CameraBlock =
+//!       Std140Block<std140::mat4, std140::vec3, std140::scalar>;
+//!
+//! with offsets 0, 64 and 76 and a size of 80 bytes.  The offsets
+//! and size are constants, so a hand written C++ struct can be
+//! checked against the layout with static_assert and offsetof:
+//!
+//!   static_assert(offsetof(Camera, exposure) == CameraBlock::offset<2>);
+//!
+//! pack() writes the members into a byte array with the padding
+//! std140 needs, ready to upload to a UniformBufferObject.  A block
+//! can also be a member of another block, as a nested struct.
+template <typename... Members> struct Std140Block {
+  static_assert(sizeof...(Members) > 0, "A uniform block needs a member");
+
+  //! The bytes of a packed block
+  using Storage =
+      std::array<std::byte,
+                 std140::round_up(
+                     std140_detail::end_offset<Members...>(), 16)>;
+
+  using value_type = Storage;
+
+  //! The type of the member at index I
+  template <size_t I>
+  using member = std::tuple_element_t<I, std::tuple<Members...>>;
+
+  //! The byte offset of each member
+  static constexpr std::array<size_t, sizeof...(Members)> offsets =
+      std140_detail::make_offsets<Members...>();
+
+  //! The byte offset of the member at index I
+  template <size_t I> static constexpr size_t offset = offsets[I];
+
+  //! The size of the block in bytes, a multiple of 16
+  static constexpr size_t size = std::tuple_size_v<Storage>;
+
+  //! Nested blocks are aligned like a vec4
+  static constexpr size_t alignment = 16;
+
+  //! True if Struct has the same size as the block
+  template <typename Struct>
+  static constexpr bool matches = (sizeof(Struct) == size);
+
+  //! Write the member at index I into a packed block
+  template <size_t I>
+  static void set(Storage &storage,
+                  const typename member<I>::value_type &value) {
+    member<I>::write(storage.data() + offset<I>, value);
+  }
+
+  //! Pack every member into a new block, padding is zeroed
+  static Storage pack(const typename Members::value_type &...values) {
+    Storage storage{};
+    size_t i = 0;
+
+    ((Members::write(storage.data() + offsets[i++], values)), ...);
+
+    return storage;
+  }
+
+  static void write(std::byte *destination, const Storage &value) {
+    std::memcpy(destination, value.data(), size);
+  }
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
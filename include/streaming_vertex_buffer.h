@@ -0,0 +1,211 @@
+#ifndef _SDL_OPENGL_CPP_STREAMING_VERTEX_BUFFER_H_
+#define _SDL_OPENGL_CPP_STREAMING_VERTEX_BUFFER_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "fence.h"
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace streaming_vertex_buffer {
+
+#ifndef NO_EXCEPTIONS
+
+//! A StreamingBufferNotSupportedError exception
+//!
+//! This exception is thrown when the OpenGL context doesn't support
+//! immutable buffer storage (OpenGL 4.4 or ARB_buffer_storage).
+//!
+class StreamingBufferNotSupportedError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A StreamingBufferMapError exception
+//!
+//! This exception is thrown when the buffer storage could not be
+//! persistently mapped.
+//!
+class StreamingBufferMapError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A StreamingVertexBufferUnspecifiedStateError exception
+//!
+//! This exception is thrown when the StreamingVertexBuffer is in an
+//! valid but unspecified state after a move operation.
+//!
+class StreamingVertexBufferUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace streaming_vertex_buffer
+
+using namespace streaming_vertex_buffer;
+
+//! A StreamingVertexBuffer owns a persistently mapped OpenGL vertex
+//! buffer used for per-frame dynamic geometry.
+//!
+//! The buffer is created once with glBufferStorage and mapped with
+//! GL_MAP_PERSISTENT_BIT and GL_MAP_COHERENT_BIT, so it never has to
+//! be remapped or reallocated.  It is split into region_count
+//! regions of region_size bytes each.  Every frame, the CPU writes
+//! into one region while the GPU can still be reading from the
+//! previous ones.  A fence is inserted after each region is
+//! submitted and waited on before the region is written to again.
+//!
+//! Typical use:
+//!
+//!   auto region = buffer.begin_region();
+//!   // write vertices into region
+//!   // draw with the vertex attribute offset at buffer.region_offset()
+//!   buffer.end_region();
+//!
+//! This requires OpenGL 4.4 or ARB_buffer_storage.
+#ifndef NO_EXCEPTIONS
+class StreamingVertexBuffer : private MoveChecker {
+#else
+class StreamingVertexBuffer : public Errors {
+#endif
+  // This is one way of allowing us to test private member variables
+  // and state.
+  friend class StreamingVertexBufferTester;
+
+public:
+  //! Construct a streaming vertex buffer
+  //!
+  //! \param name The name of the streaming vertex buffer
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param region_size The size of each region in bytes
+  //! \param region_count The number of regions in the ring, three is
+  //!                     enough for double buffering plus one frame
+  //!                     of driver latency
+  //!
+  //! \throws a StreamingBufferNotSupportedError if buffer storage
+  //!         isn't supported by the context.
+  //!
+  //! \throws a BufferDataError if the region size or count is invalid.
+  //!
+  //! \throws an OutOfMemoryError if the buffer doesn't fit in the
+  //!         GPU memory budget.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \throws a StreamingBufferMapError if the buffer could not be
+  //!         mapped.
+  //!
+  //! \return A new StreamingVertexBuffer object
+  StreamingVertexBuffer(const string &name,
+                        const std::shared_ptr<GLContext> &ctx,
+                        GLsizeiptr region_size, GLuint region_count = 3);
+  ~StreamingVertexBuffer();
+
+  //! Cleanup the streaming vertex buffer
+  //!
+  //! Deletes any outstanding fences and the buffer, which also
+  //! unmaps it.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  StreamingVertexBuffer(const StreamingVertexBuffer &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  StreamingVertexBuffer &operator=(const StreamingVertexBuffer &) = delete;
+
+  // move constructor
+  StreamingVertexBuffer(StreamingVertexBuffer &&) noexcept;
+
+  // move assignment operator
+  StreamingVertexBuffer &operator=(StreamingVertexBuffer &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Bind the buffer to GL_ARRAY_BUFFER
+  void bind();
+
+  //! Start writing the current region
+  //!
+  //! Blocks until the GPU has finished reading from the region the
+  //! last time it was submitted.
+  //!
+  //! \throws a FenceSyncError if waiting on the fence failed.
+  //!
+  //! \returns the writable mapped memory for the region, or an empty
+  //!          span on error
+  std::span<std::byte> begin_region();
+
+  //! Finish writing the current region
+  //!
+  //! Call this after the draw calls that read from the region have
+  //! been issued.  A fence is inserted so the region isn't
+  //! overwritten while the GPU is still reading it, and the ring
+  //! advances to the next region.
+  //!
+  //! \throws a FenceSyncError if the fence could not be created.
+  void end_region();
+
+  //! The byte offset of the current region from the start of the
+  //! buffer
+  //!
+  //! Use this as the attribute pointer offset, or divide it by the
+  //! vertex stride to get the first vertex for glDrawArrays.
+  GLintptr region_offset() const;
+
+  //! The size in bytes of each region
+  GLsizeiptr get_region_size() const;
+
+  //! The number of regions in the ring
+  GLuint get_region_count() const;
+
+private:
+  string name;
+
+  // The OpenGL context this buffer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // OpenGL Vertex Buffer Object
+  GLuint VBO = 0;
+
+  // The persistent mapping of the whole buffer
+  std::byte *mapped = nullptr;
+
+  GLsizeiptr region_size = 0;
+
+  GLuint region_count = 0;
+
+  // The region the CPU is currently writing
+  GLuint current_region = 0;
+
+  // One fence per region, empty if the region is free
+  std::vector<std::optional<Fence>> fences;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,413 @@
+#ifndef _SDL_OPENGL_CPP_TEXTURE_H_
+#define _SDL_OPENGL_CPP_TEXTURE_H_
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "gpu_memory_registry.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace texture {
+
+#ifndef NO_EXCEPTIONS
+
+//! A GenTexturesError exception
+//!
+//! This exception is thrown when there is a problem creating the
+//! texture or allocating its storage.
+//!
+class GenTexturesError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A TextureOutOfMemoryError exception
+//!
+//! This exception is thrown when a texture doesn't fit in the GPU
+//! memory budget, even after evicting cached resources.
+//!
+class TextureOutOfMemoryError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A TextureDataError exception
+//!
+//! This exception is thrown when pixels don't fit the texture, or
+//! there are too few of them for the rectangle being uploaded.
+//!
+class TextureDataError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A TextureUnspecifiedStateError exception
+//!
+//! This exception is thrown when the Texture is in an valid but
+//! unspecified state after a move operation.
+//!
+class TextureUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace texture
+
+using namespace texture;
+
+//! How a texture is sampled when it is drawn smaller or larger than
+//! its size
+enum class TextureFilter {
+  //! The nearest texel of the nearest mipmap level, for pixel art
+  Nearest,
+
+  //! Bilinear filtering of level 0 only, mipmaps are ignored
+  Linear,
+
+  //! Bilinear filtering of the nearest mipmap level
+  Bilinear,
+
+  //! Bilinear filtering of the two nearest mipmap levels, blended
+  Trilinear,
+};
+
+//! A Texture class owns and manages a 2D OpenGL texture.
+//!
+//! The texture gets immutable storage for all its mipmap levels up
+//! front, with glTexStorage2D when
+//! GLContext::supports(GLFeature::TextureStorage) is true.  Older
+//! contexts get each level allocated with glTexImage2D and
+//! GL_TEXTURE_MAX_LEVEL set to match, which samples the same way.
+//! The size and format never change, only the contents with upload().
+//!
+//! By default the texture has a full mipmap chain and trilinear
+//! filtering.  After uploading level 0 call generate_mipmaps(), so
+//! scaled down drawing reads a small level instead of skipping
+//! across a large one.  set_anisotropy() sharpens textures seen at
+//! an angle where the context supports it.
+//!
+//! The texture is recorded in the GPUMemoryRegistry under its name,
+//! and creating it first makes room in the memory budget.
+//!
+//! When GLContext::direct_state_access() is true the texture is
+//! created and edited by name and only bind() binds it.  Otherwise
+//! creating and editing it leaves it bound to GL_TEXTURE_2D of the
+//! active texture unit.
+//!
+//! Owned OpenGL resources are automatically cleaned up on object
+//! deletion.  It is up to the user to cleanup their own data.
+#ifndef NO_EXCEPTIONS
+class Texture : private MoveChecker {
+#else
+class Texture : public Errors {
+#endif
+public:
+  //! Construct a texture
+  //!
+  //! \param name The name of the texture
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param width The width of level 0 in texels
+  //! \param height The height of level 0 in texels
+  //! \param internal_format The sized format of the texels, for
+  //!                        example GL_RGBA8 or GL_SRGB8_ALPHA8
+  //! \param levels The number of mipmap levels, 0 for a full chain
+  //!               down to 1x1 and 1 for no mipmaps
+  //!
+  //! \throws a TextureDataError if the size or number of levels is
+  //!         out of range, or the internal format isn't a sized
+  //!         format it knows.
+  //!
+  //! \throws a TextureOutOfMemoryError if the texture doesn't fit in
+  //!         the GPU memory budget.
+  //!
+  //! \throws a GenTexturesError if there was an error creating the
+  //!         texture or its storage.
+  Texture(const string &name, const std::shared_ptr<GLContext> &ctx,
+          GLsizei width, GLsizei height, GLenum internal_format = GL_RGBA8,
+          GLsizei levels = 0);
+  ~Texture();
+
+  //! Cleanup the texture
+  //!
+  //! Deletes the texture and releases it in the GPUMemoryRegistry.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  Texture(const Texture &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  Texture &operator=(const Texture &) = delete;
+
+  // move constructor
+  Texture(Texture &&) noexcept;
+
+  // move assignment operator
+  Texture &operator=(Texture &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Bind the texture to GL_TEXTURE_2D of a texture unit
+  //!
+  //! \param unit The texture unit, 0 for GL_TEXTURE0.  The unit is
+  //!             left active.
+  void bind(GLuint unit = 0);
+
+  //! Replace all of level 0
+  //!
+  //! Rows are read tightly packed, each padded to
+  //! GL_UNPACK_ALIGNMENT bytes (4 unless it was changed).
+  //!
+  //! \param pixels The texels
+  //! \param format The components of pixels, for example GL_RGBA
+  //! \param type The type of each component, for example
+  //!             GL_UNSIGNED_BYTE
+  //!
+  //! \throws a TextureDataError if there are too few pixels.
+  void upload(std::span<const std::byte> pixels, GLenum format = GL_RGBA,
+              GLenum type = GL_UNSIGNED_BYTE);
+
+  //! Replace a rectangle of one mipmap level
+  //!
+  //! \param x The left edge of the rectangle
+  //! \param y The bottom edge of the rectangle
+  //! \param rect_width The width of the rectangle
+  //! \param rect_height The height of the rectangle
+  //! \param pixels The texels
+  //! \param format The components of pixels, for example GL_RGBA
+  //! \param type The type of each component, for example
+  //!             GL_UNSIGNED_BYTE
+  //! \param level The mipmap level
+  //! \param row_length The texels from one row of pixels to the next,
+  //!                   0 for rect_width.  Lets rows with padding, or
+  //!                   a rectangle inside a larger image, be read in
+  //!                   place.
+  //! \param alignment The byte alignment of each row, 1, 2, 4 or 8
+  //!
+  //! GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT are only changed
+  //! for the upload when they differ from 0 and 4, and are set back
+  //! afterwards.
+  //!
+  //! \throws a TextureDataError if the rectangle isn't inside the
+  //!         level or there are too few pixels.
+  void upload(GLint x, GLint y, GLsizei rect_width, GLsizei rect_height,
+              std::span<const std::byte> pixels, GLenum format, GLenum type,
+              GLint level = 0, GLint row_length = 0, GLint alignment = 4);
+
+  //! Replace a rectangle of one mipmap level from a pixel unpack
+  //! buffer
+  //!
+  //! The GPU copies the pixels out of buffer, so the call doesn't
+  //! wait for them.  The buffer is bound to GL_PIXEL_UNPACK_BUFFER
+  //! for the upload and unbound afterwards.  Rows are read tightly
+  //! packed, each padded to 4 bytes.
+  //!
+  //! \param x The left edge of the rectangle
+  //! \param y The bottom edge of the rectangle
+  //! \param rect_width The width of the rectangle
+  //! \param rect_height The height of the rectangle
+  //! \param buffer The buffer holding the texels
+  //! \param offset The byte offset of the texels in buffer
+  //! \param format The components of the texels, for example GL_RGBA
+  //! \param type The type of each component, for example
+  //!             GL_UNSIGNED_BYTE
+  //! \param level The mipmap level
+  //!
+  //! \throws a TextureDataError if the rectangle isn't inside the
+  //!         level or buffer holds too few texels after offset.
+  void upload(GLint x, GLint y, GLsizei rect_width, GLsizei rect_height,
+              VertexBufferObject &buffer, GLintptr offset, GLenum format,
+              GLenum type, GLint level = 0);
+
+  //! Fill every mipmap level from level 0 with glGenerateMipmap
+  //!
+  //! Does nothing for a texture with a single level.
+  void generate_mipmaps();
+
+  //! Set how the texture is sampled
+  //!
+  //! Mipmapped filters fall back to Linear for a texture with a
+  //! single level.
+  void set_filter(TextureFilter filter);
+
+  //! Set how coordinates outside 0 to 1 are handled
+  //!
+  //! \param wrap_s GL_REPEAT, GL_CLAMP_TO_EDGE or GL_MIRRORED_REPEAT
+  //!               horizontally
+  //! \param wrap_t The same vertically
+  void set_wrap(GLenum wrap_s, GLenum wrap_t);
+
+  //! Set the maximum anisotropy of the texture
+  //!
+  //! Anisotropic filtering takes more samples along the direction a
+  //! texture is squashed in, keeping floors and walls seen at an
+  //! angle sharp.  It works on top of the mipmapped filters.
+  //!
+  //! \param anisotropy The number of samples, clamped to 1 and the
+  //!                   context's maximum
+  //!
+  //! \returns the anisotropy that was set, 1 if the context doesn't
+  //!          support anisotropic filtering
+  GLfloat set_anisotropy(GLfloat anisotropy);
+
+  //! The number of mipmap levels of a full chain for a size, down to
+  //! 1x1
+  static GLsizei mip_levels(GLsizei width, GLsizei height);
+
+  //! The GL_TEXTURE_MIN_FILTER and GL_TEXTURE_MAG_FILTER values for
+  //! a filter
+  //!
+  //! \param texture_filter The filter
+  //! \param mipmapped False for a texture with a single level
+  //! \param min_filter Set to the minification filter
+  //! \param mag_filter Set to the magnification filter
+  static void filter_parameters(TextureFilter texture_filter, bool mipmapped,
+                                GLint &min_filter, GLint &mag_filter);
+
+  //! The bytes of one texel of a sized internal format, for memory
+  //! accounting, or 0 if the format isn't known.  Three component
+  //! formats count as four.
+  static GLsizeiptr texel_size(GLenum internal_format);
+
+  //! A format and type glTexImage2D accepts for an internal format
+  //! when allocating storage without pixels
+  static void storage_format(GLenum internal_format, GLenum &format,
+                             GLenum &type);
+
+  //! The bytes of one pixel of client pixel data, 0 if unknown
+  static size_t pixel_size(GLenum format, GLenum type);
+
+  //! The bytes glTexSubImage2D reads for a rectangle
+  //!
+  //! \param rect_width The width of the rectangle
+  //! \param rect_height The height of the rectangle
+  //! \param row_length The pixels from one row to the next
+  //! \param alignment The byte alignment of each row, the last row
+  //!                  isn't padded
+  //! \param pixel The bytes of one pixel
+  static size_t image_size(GLsizei rect_width, GLsizei rect_height,
+                           GLint row_length, GLint alignment, size_t pixel);
+
+  //! The OpenGL name of the texture
+  GLuint get_texture() const;
+
+  //! The width of level 0 in texels
+  GLsizei get_width() const;
+
+  //! The height of level 0 in texels
+  GLsizei get_height() const;
+
+  //! The number of mipmap levels
+  GLsizei get_levels() const;
+
+  //! The sized internal format
+  GLenum get_internal_format() const;
+
+  //! The filter set with set_filter()
+  TextureFilter get_filter() const;
+
+  //! The bytes of storage for every level
+  GLsizeiptr get_size() const;
+
+private:
+  // TextureArray shares the helpers below, keyed on its target
+  friend class TextureArray;
+
+  // Allocate every level of a GL_TEXTURE_2D, or of every layer of a
+  // GL_TEXTURE_2D_ARRAY, with glTexStorage when the context has it
+  // and glTexImage for each level otherwise.  Without direct state
+  // access this leaves the texture bound to target.
+  static void allocate_storage(GLContext &ctx, GLenum target,
+                               GLuint texture, GLsizei levels,
+                               GLenum internal_format, GLsizei width,
+                               GLsizei height, GLsizei layers);
+
+  // Set an integer parameter, by name with direct state access or
+  // bound to target otherwise
+  static void parameter(GLContext &ctx, GLenum target, GLuint texture,
+                        GLenum pname, GLint value);
+
+  // Set the minification and magnification filters for a filter
+  static void apply_filter(GLContext &ctx, GLenum target, GLuint texture,
+                           TextureFilter texture_filter, bool mipmapped);
+
+  // Set the wrap mode in both directions
+  static void apply_wrap(GLContext &ctx, GLenum target, GLuint texture,
+                         GLenum wrap_s, GLenum wrap_t);
+
+  // Fill every level from level 0, by name with direct state access
+  // or bound to target otherwise
+  static void generate_mipmap(GLContext &ctx, GLenum target,
+                              GLuint texture);
+
+  // Set GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT for an upload,
+  // only where they differ from the defaults of 0 and 4
+  static void set_unpack_rows(GLContext &ctx, GLint row_length,
+                              GLint alignment);
+
+  // Put back what set_unpack_rows() changed
+  static void reset_unpack_rows(GLContext &ctx, GLint row_length,
+                                GLint alignment);
+
+  // Check the texture can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  // Check a rectangle is inside a level and available bytes hold
+  // it, returns false on error in NO_EXCEPTIONS builds
+  bool check_upload(GLint x, GLint y, GLsizei rect_width,
+                    GLsizei rect_height, size_t available, GLenum format,
+                    GLenum type, GLint level, GLint row_length,
+                    GLint alignment);
+
+  // glTexSubImage2D, or glTextureSubImage2D with direct state access
+  void sub_image(GLint x, GLint y, GLsizei rect_width, GLsizei rect_height,
+                 const GLvoid *pixels, GLenum format, GLenum type,
+                 GLint level, GLint row_length, GLint alignment);
+
+  string name;
+
+  // The OpenGL context this texture uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // OpenGL texture
+  GLuint texture = 0;
+
+  GLsizei width = 0;
+
+  GLsizei height = 0;
+
+  GLsizei levels = 1;
+
+  GLenum internal_format = GL_RGBA8;
+
+  TextureFilter filter = TextureFilter::Trilinear;
+
+  // The bytes recorded in the GPUMemoryRegistry
+  GLsizeiptr size = 0;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
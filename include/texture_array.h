@@ -0,0 +1,288 @@
+#ifndef _SDL_OPENGL_CPP_TEXTURE_ARRAY_H_
+#define _SDL_OPENGL_CPP_TEXTURE_ARRAY_H_
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "gpu_memory_registry.h"
+#include "sdl_surface_base.h"
+#include "texture.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace texture_array {
+
+#ifndef NO_EXCEPTIONS
+
+//! A TextureArrayUnspecifiedStateError exception
+//!
+//! This exception is thrown when the TextureArray is in an valid but
+//! unspecified state after a move operation.
+//!
+class TextureArrayUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace texture_array
+
+using namespace texture_array;
+
+//! A TextureArray class owns and manages a 2D array OpenGL texture.
+//!
+//! A GL_TEXTURE_2D_ARRAY holds a number of layers that all share one
+//! size, format and set of mipmap levels.  Tiles, sprite frames and
+//! terrain materials of the same size put in one array draw with a
+//! single texture bound, the shader picking the layer with the third
+//! texture coordinate, so switching images costs nothing.  Unlike a
+//! TextureAtlas nothing is packed, and neighbouring images can't bleed
+//! into each other through filtering or mipmaps, since every layer has
+//! its own levels.
+//!
+//! Storage for every layer and level is allocated up front, with
+//! glTexStorage3D when GLContext::supports(GLFeature::TextureStorage)
+//! is true and with glTexImage3D for each level otherwise, the same
+//! way Texture does for 2D textures.
+//!
+//! Images are either uploaded to a layer by index with upload(), or
+//! added by key with add(), which hands out the next free layer and
+//! remembers it for find().
+//!
+//! The texture is recorded in the GPUMemoryRegistry under its name,
+//! and creating it first makes room in the memory budget.
+//!
+//! When GLContext::direct_state_access() is true the texture is
+//! created and edited by name and only bind() binds it.  Otherwise
+//! creating and editing it leaves it bound to GL_TEXTURE_2D_ARRAY of
+//! the active texture unit.
+//!
+//! Owned OpenGL resources are automatically cleaned up on object
+//! deletion.  It is up to the user to cleanup their own data.
+#ifndef NO_EXCEPTIONS
+class TextureArray : private MoveChecker {
+#else
+class TextureArray : public Errors {
+#endif
+public:
+  //! Construct a texture array
+  //!
+  //! \param name The name of the texture array
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param width The width of level 0 of each layer in texels
+  //! \param height The height of level 0 of each layer in texels
+  //! \param layers The number of layers
+  //! \param internal_format The sized format of the texels, for
+  //!                        example GL_RGBA8 or GL_SRGB8_ALPHA8
+  //! \param levels The number of mipmap levels, 0 for a full chain
+  //!               down to 1x1 and 1 for no mipmaps
+  //!
+  //! \throws a TextureDataError if the size, number of layers or
+  //!         number of levels is out of range, or the internal format
+  //!         isn't a sized format it knows.
+  //!
+  //! \throws a TextureOutOfMemoryError if the texture doesn't fit in
+  //!         the GPU memory budget.
+  //!
+  //! \throws a GenTexturesError if there was an error creating the
+  //!         texture or its storage.
+  TextureArray(const string &name, const std::shared_ptr<GLContext> &ctx,
+               GLsizei width, GLsizei height, GLsizei layers,
+               GLenum internal_format = GL_RGBA8, GLsizei levels = 0);
+  ~TextureArray();
+
+  //! Cleanup the texture array
+  //!
+  //! Deletes the texture and releases it in the GPUMemoryRegistry.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  TextureArray(const TextureArray &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  TextureArray &operator=(const TextureArray &) = delete;
+
+  // move constructor
+  TextureArray(TextureArray &&) noexcept;
+
+  // move assignment operator
+  TextureArray &operator=(TextureArray &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Bind the texture to GL_TEXTURE_2D_ARRAY of a texture unit
+  //!
+  //! \param unit The texture unit, 0 for GL_TEXTURE0.  The unit is
+  //!             left active.
+  void bind(GLuint unit = 0);
+
+  //! Replace one mipmap level of one layer
+  //!
+  //! \param layer The layer
+  //! \param pixels The texels
+  //! \param format The components of pixels, for example GL_RGBA
+  //! \param type The type of each component, for example
+  //!             GL_UNSIGNED_BYTE
+  //! \param level The mipmap level
+  //! \param row_length The texels from one row of pixels to the next,
+  //!                   0 for the width of the level
+  //! \param alignment The byte alignment of each row, 1, 2, 4 or 8
+  //!
+  //! GL_UNPACK_ROW_LENGTH and GL_UNPACK_ALIGNMENT are only changed
+  //! for the upload when they differ from 0 and 4, and are set back
+  //! afterwards.
+  //!
+  //! \throws a TextureDataError if the layer or level is out of range
+  //!         or there are too few pixels.
+  void upload(GLint layer, std::span<const std::byte> pixels,
+              GLenum format = GL_RGBA, GLenum type = GL_UNSIGNED_BYTE,
+              GLint level = 0, GLint row_length = 0, GLint alignment = 4);
+
+  //! Replace one mipmap level of one layer with a surface
+  //!
+  //! Surfaces OpenGL can read are uploaded in place, with their pitch
+  //! passed as the row length.  Anything else is converted to RGBA32
+  //! first.
+  //!
+  //! \param layer The layer
+  //! \param surface The surface, the size of the level
+  //! \param level The mipmap level
+  //!
+  //! \throws a TextureDataError if the layer or level is out of range
+  //!         or the surface isn't the size of the level.
+  //!
+  //! \throws a CreationError if the surface had to be converted and
+  //!         couldn't be.
+  void upload(GLint layer, SDLSurface &surface, GLint level = 0);
+
+  //! Upload a surface to the layer kept for a key
+  //!
+  //! A new key gets the next free layer, a key added before has its
+  //! layer replaced.  Only level 0 is uploaded, call
+  //! generate_mipmaps() once the layers are filled.
+  //!
+  //! \param key The key to find the layer by
+  //! \param surface The surface, the size of level 0
+  //!
+  //! \throws a TextureDataError if every layer is taken or the
+  //!         surface isn't the size of level 0.
+  //!
+  //! \returns the layer, or -1 on error with exceptions disabled
+  GLint add(const string &key, SDLSurface &surface);
+
+  //! The layer of a key passed to add()
+  //!
+  //! \returns the layer, or -1 if the key wasn't added
+  GLint find(const string &key) const;
+
+  //! Fill every mipmap level of every layer from level 0 with
+  //! glGenerateMipmap
+  //!
+  //! Does nothing for a texture with a single level.
+  void generate_mipmaps();
+
+  //! Set how the texture is sampled
+  //!
+  //! Mipmapped filters fall back to Linear for a texture with a
+  //! single level.
+  void set_filter(TextureFilter filter);
+
+  //! Set how coordinates outside 0 to 1 are handled
+  //!
+  //! \param wrap_s GL_REPEAT, GL_CLAMP_TO_EDGE or GL_MIRRORED_REPEAT
+  //!               horizontally
+  //! \param wrap_t The same vertically
+  void set_wrap(GLenum wrap_s, GLenum wrap_t);
+
+  //! The OpenGL name of the texture
+  GLuint get_texture() const;
+
+  //! The width of level 0 in texels
+  GLsizei get_width() const;
+
+  //! The height of level 0 in texels
+  GLsizei get_height() const;
+
+  //! The number of layers
+  GLsizei get_layers() const;
+
+  //! The number of layers handed out by add()
+  GLsizei get_used_layers() const;
+
+  //! The number of mipmap levels
+  GLsizei get_levels() const;
+
+  //! The sized internal format
+  GLenum get_internal_format() const;
+
+  //! The filter set with set_filter()
+  TextureFilter get_filter() const;
+
+  //! The bytes of storage for every layer and level
+  GLsizeiptr get_size() const;
+
+private:
+  // Check the texture can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  // Check a layer and level exist, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_layer(GLint layer, GLint level);
+
+  // glTexSubImage3D, or glTextureSubImage3D with direct state access,
+  // for a whole level of one layer
+  void sub_image(GLint layer, GLint level, const GLvoid *pixels,
+                 GLenum format, GLenum type, GLint row_length,
+                 GLint alignment);
+
+  string name;
+
+  // The OpenGL context this texture uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // OpenGL texture
+  GLuint texture = 0;
+
+  GLsizei width = 0;
+
+  GLsizei height = 0;
+
+  GLsizei layers = 0;
+
+  GLsizei levels = 1;
+
+  GLenum internal_format = GL_RGBA8;
+
+  TextureFilter filter = TextureFilter::Trilinear;
+
+  // The layers handed out by add()
+  std::map<string, GLint> keys;
+
+  // The bytes recorded in the GPUMemoryRegistry
+  GLsizeiptr size = 0;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
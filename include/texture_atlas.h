@@ -0,0 +1,278 @@
+#ifndef _SDL_OPENGL_CPP_TEXTURE_ATLAS_H_
+#define _SDL_OPENGL_CPP_TEXTURE_ATLAS_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "sdl_surface_base.h"
+#include "texture.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace texture_atlas {
+
+#ifndef NO_EXCEPTIONS
+
+//! A TextureAtlasUnspecifiedStateError exception
+//!
+//! This exception is thrown when the TextureAtlas is in an valid but
+//! unspecified state after a move operation.
+//!
+class TextureAtlasUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace texture_atlas
+
+using namespace texture_atlas;
+
+//! A SkylinePacker places rectangles in a fixed size area, one at a
+//! time.
+//!
+//! The free space is tracked as a skyline, the top edge of
+//! everything placed so far seen from below.  Each rectangle goes
+//! where its bottom edge is lowest, the bottom left rule, which keeps
+//! the skyline flat and wastes little space for sprites and glyphs of
+//! similar heights.  Rectangles are never removed.
+//!
+//! y grows downwards, the way SDL surface rows do.
+class SkylinePacker {
+public:
+  //! Construct an empty packer
+  //!
+  //! \param width The width of the area
+  //! \param height The height of the area
+  SkylinePacker(GLsizei width, GLsizei height);
+
+  //! Place a rectangle
+  //!
+  //! \param rect_width The width of the rectangle
+  //! \param rect_height The height of the rectangle
+  //! \param x Set to the left edge of the rectangle
+  //! \param y Set to the top edge of the rectangle
+  //!
+  //! \returns false if the rectangle doesn't fit anywhere
+  bool insert(GLsizei rect_width, GLsizei rect_height, GLint &x, GLint &y);
+
+  //! The width of the area
+  GLsizei get_width() const;
+
+  //! The height of the area
+  GLsizei get_height() const;
+
+  //! The area covered by rectangles placed so far
+  GLsizeiptr get_used_area() const;
+
+private:
+  // A horizontal run of the skyline
+  struct Segment {
+    GLint x;
+    GLint y;
+    GLsizei width;
+  };
+
+  // The lowest top edge a rectangle starting at segment index can
+  // have, or -1 if it runs past the right edge
+  GLint fit(size_t index, GLsizei rect_width) const;
+
+  GLsizei width = 0;
+
+  GLsizei height = 0;
+
+  // Ordered left to right, covering the whole width
+  std::vector<Segment> skyline;
+
+  GLsizeiptr used_area = 0;
+};
+
+//! Where an image was placed in a TextureAtlas
+struct AtlasRegion {
+  //! The page holding the image, see TextureAtlas::get_page()
+  size_t page;
+
+  //! The left edge in texels
+  GLint x;
+
+  //! The top edge in texels
+  GLint y;
+
+  //! The width in texels
+  GLsizei width;
+
+  //! The height in texels
+  GLsizei height;
+
+  //! The texture coordinates of the image
+  //!
+  //! The same layout as the texcoord array GL_LoadTexture fills in,
+  //! minimum u, minimum v, maximum u and maximum v, with v running
+  //! down from the top row of the image.
+  GLfloat texcoord[4];
+};
+
+//! A TextureAtlas packs many small surfaces into a few large
+//! textures.
+//!
+//! Sprites and icons added with add() share pages, so a batch of them
+//! draws with one texture bound instead of a bind each, and none is
+//! padded up to a power of two.  Pages are GL_RGBA8 textures without
+//! mipmaps, created as they fill up.
+//!
+//! Each page keeps an RGBA copy of its texels.  add() only writes
+//! that copy and grows the page's dirty rectangle, flush() uploads
+//! the dirty rectangle of each page with one glTexSubImage2D, so
+//! adding images a few at a time costs one upload per page touched
+//! per flush rather than one per image.
+//!
+//! Images are placed with a SkylinePacker, surrounded by a gutter of
+//! transparent texels so linear filtering doesn't bleed neighbours
+//! into each other.
+#ifndef NO_EXCEPTIONS
+class TextureAtlas : private MoveChecker {
+#else
+class TextureAtlas : public Errors {
+#endif
+public:
+  //! Construct an empty texture atlas
+  //!
+  //! \param name The name of the texture atlas, pages are named after
+  //!             it
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param page_width The width of each page in texels
+  //! \param page_height The height of each page in texels
+  //! \param gutter The transparent texels kept around each image
+  //!
+  //! \throws a TextureDataError if the gutter is negative or a page
+  //!         has no room inside two gutters.
+  TextureAtlas(const string &name, const std::shared_ptr<GLContext> &ctx,
+               GLsizei page_width = 1024, GLsizei page_height = 1024,
+               GLsizei gutter = 1);
+  ~TextureAtlas();
+
+  //! Cleanup the texture atlas
+  //!
+  //! Deletes every page.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  TextureAtlas(const TextureAtlas &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  TextureAtlas &operator=(const TextureAtlas &) = delete;
+
+  // move constructor
+  TextureAtlas(TextureAtlas &&) noexcept;
+
+  // move assignment operator
+  TextureAtlas &operator=(TextureAtlas &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Pack a surface into the atlas
+  //!
+  //! The pixels are copied, the surface can be freed straight away.
+  //! They reach the page texture on the next flush().
+  //!
+  //! \param surface The surface to add, converted to RGBA32 unless it
+  //!                already is
+  //!
+  //! \throws a TextureDataError if the surface with its gutter is
+  //!         larger than a page.
+  //!
+  //! \throws a CreationError if the surface had to be converted and
+  //!         couldn't be.
+  //!
+  //! \throws the Texture errors if a new page couldn't be created.
+  //!
+  //! \returns where the surface was placed, or std::nullopt on error
+  //!          with exceptions disabled
+  std::optional<AtlasRegion> add(SDLSurface &surface);
+
+  //! Upload the dirty rectangle of every page
+  //!
+  //! Call after adding images and before drawing with them.
+  //!
+  //! \returns the number of bytes uploaded
+  GLsizeiptr flush();
+
+  //! The texture of a page
+  //!
+  //! \param page The page, AtlasRegion::page
+  //!
+  //! \throws a TextureDataError if there is no such page.
+  //!
+  //! \returns the texture, or nullptr on error with exceptions
+  //!          disabled
+  Texture *get_page(size_t page);
+
+  //! The number of pages
+  size_t get_page_count() const;
+
+  //! The width of each page in texels
+  GLsizei get_page_width() const;
+
+  //! The height of each page in texels
+  GLsizei get_page_height() const;
+
+  //! The texels covered by images and their gutters, over all pages
+  GLsizeiptr get_used_area() const;
+
+private:
+  struct Page {
+    Texture texture;
+
+    SkylinePacker packer;
+
+    // RGBA texels, page_width by page_height, top row first
+    std::vector<std::byte> pixels;
+
+    // The rectangle flush() has to upload, empty if x0 == x1
+    GLint dirty_x0 = 0;
+    GLint dirty_y0 = 0;
+    GLint dirty_x1 = 0;
+    GLint dirty_y1 = 0;
+  };
+
+  // Check the atlas can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  string name;
+
+  // The OpenGL context this atlas uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  GLsizei page_width = 0;
+
+  GLsizei page_height = 0;
+
+  GLsizei gutter = 0;
+
+  std::vector<Page> pages;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
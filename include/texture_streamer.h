@@ -0,0 +1,391 @@
+#ifndef _SDL_OPENGL_CPP_TEXTURE_STREAMER_H_
+#define _SDL_OPENGL_CPP_TEXTURE_STREAMER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "sdl_surface_base.h"
+#include "texture.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace texture_streamer {
+
+#ifndef NO_EXCEPTIONS
+
+//! A TextureStreamerMapError exception
+//!
+//! This exception is thrown when a pixel unpack buffer could not be
+//! mapped.
+//!
+class TextureStreamerMapError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A TextureStreamerUnspecifiedStateError exception
+//!
+//! This exception is thrown when the TextureStreamer is in an valid
+//! but unspecified state after a move operation.
+//!
+class TextureStreamerUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace texture_streamer
+
+using namespace texture_streamer;
+
+//! How far a streamed texture has got
+enum class StreamStatus {
+  //! Waiting for a worker, being decoded or being uploaded
+  Pending,
+
+  //! Every row is uploaded and the mipmaps are generated
+  Ready,
+
+  //! The decoder returned no surface, or the texture couldn't be
+  //! created or uploaded
+  Failed,
+};
+
+//! A texture requested from a TextureStreamer
+//!
+//! The streamer updates it from TextureStreamer::update(), so it is
+//! only read on the thread that owns the OpenGL context.
+class StreamedTexture {
+public:
+  //! Construct a pending texture
+  //!
+  //! \param source The source passed to the decoder
+  StreamedTexture(const string &source);
+
+  //! The source passed to the decoder
+  const string &get_source() const;
+
+  //! How far the texture has got
+  StreamStatus get_status() const;
+
+  //! True once the texture can be drawn with
+  bool is_ready() const;
+
+  //! The texture once it is ready, nullptr before then or on failure
+  Texture *get_texture();
+
+private:
+  friend class TextureStreamer;
+
+  string source;
+
+  StreamStatus status = StreamStatus::Pending;
+
+  // Created when the first rows arrive and the size is known
+  std::optional<Texture> texture = std::nullopt;
+
+  GLsizei rows_uploaded = 0;
+};
+
+//! The handle TextureStreamer::request() returns
+using TextureStreamHandle = std::shared_ptr<StreamedTexture>;
+
+//! A TextureStreamer loads textures in the background without
+//! stalling the render loop.
+//!
+//! Worker threads call a decoder to turn each requested source into
+//! an SDLSurface, then copy its rows into a ring of mapped pixel
+//! unpack buffers.  Only copying is done on the workers, they never
+//! call OpenGL.  Once a frame, update() on the OpenGL thread uploads
+//! the filled buffers with glTexSubImage2D from their offsets, so the
+//! driver copies from GPU visible memory instead of blocking on the
+//! pixels, then maps the buffers again for the workers.
+//!
+//! Typical use:
+//!
+//!   TextureStreamer streamer("textures", gl_context,
+//!                            [&sdl](const string &path) {
+//!                              return load_image(sdl, path);
+//!                            },
+//!                            4 * 1024 * 1024);
+//!   TextureStreamHandle wall = streamer.request("wall.png");
+//!
+//!   // once per frame
+//!   streamer.update();
+//!   if (wall->is_ready())
+//!     wall->get_texture()->bind();
+//!
+//! An image larger than one buffer is split into bands of rows over
+//! several buffers, and the frame budget spreads large images over
+//! several frames.  Rows are uploaded top row first, the way
+//! SDLSurface::GL_CreateTexture uploads them.
+//!
+//! Surfaces OpenGL can't read in place, for example palettized
+//! ones, are converted to RGBA32 on the worker.
+#ifndef NO_EXCEPTIONS
+class TextureStreamer : private MoveChecker {
+#else
+class TextureStreamer : public Errors {
+#endif
+public:
+  //! Decode a source into a surface, on a worker thread
+  //!
+  //! Called from every worker at once, so it must be thread safe.
+  //! Returning std::nullopt fails the request.
+  using Decoder = std::function<std::optional<SDLSurface>(const string &)>;
+
+  //! Construct a texture streamer
+  //!
+  //! \param name The name of the texture streamer
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param decoder Decodes a requested source into a surface
+  //! \param slot_size The size in bytes of each pixel unpack buffer,
+  //!                  it must hold at least one row of an image
+  //! \param slot_count The number of pixel unpack buffers in the ring
+  //! \param frame_budget The most bytes update() uploads, zero for
+  //!                     no limit
+  //! \param worker_count The number of worker threads
+  //! \param levels The mipmap levels of each texture, 0 for a full
+  //!               chain generated after the last rows arrive
+  //!
+  //! \throws a BufferDataError if a size or count isn't positive or
+  //!         the frame budget is negative.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         pixel unpack buffers.
+  //!
+  //! \throws a TextureStreamerMapError if the pixel unpack buffers
+  //!         couldn't be mapped.
+  TextureStreamer(const string &name, const std::shared_ptr<GLContext> &ctx,
+                  Decoder decoder, GLsizeiptr slot_size, GLuint slot_count = 4,
+                  GLsizeiptr frame_budget = 0, unsigned worker_count = 1,
+                  GLsizei levels = 0);
+  ~TextureStreamer();
+
+  //! Cleanup the texture streamer
+  //!
+  //! Stops and joins the workers, dropping requests that haven't
+  //! finished, and deletes the pixel unpack buffers.  Textures that
+  //! are ready belong to their handles and are kept.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  TextureStreamer(const TextureStreamer &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+  // move constructor
+  TextureStreamer(TextureStreamer &&) noexcept;
+
+  // move assignment operator
+  TextureStreamer &operator=(TextureStreamer &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Queue a source to be decoded and uploaded
+  //!
+  //! \param source The source to pass to the decoder, for example a
+  //!               file name
+  //!
+  //! \returns the handle of the texture, nullptr on error with
+  //!          exceptions disabled
+  TextureStreamHandle request(const string &source);
+
+  //! Upload decoded rows, up to the frame budget
+  //!
+  //! Call once per frame on the OpenGL thread.  Bands are uploaded
+  //! in the order the workers filled them, at least one even if it
+  //! is larger than the budget, so streaming always makes progress.
+  //!
+  //! \throws a TextureStreamerMapError if a pixel unpack buffer
+  //!         couldn't be mapped again.
+  //!
+  //! \returns the number of bytes uploaded
+  GLsizeiptr update();
+
+  //! Wait for every request to be ready or failed, ignoring the
+  //! frame budget
+  //!
+  //! Use it on loading screens.
+  //!
+  //! \throws a TextureStreamerMapError if a pixel unpack buffer
+  //!         couldn't be mapped again.
+  void finish();
+
+  //! Set the most bytes update() uploads
+  //!
+  //! \param budget The budget in bytes, zero for no limit
+  //!
+  //! \throws a BufferDataError if the budget is negative.
+  void set_frame_budget(GLsizeiptr budget);
+
+  //! The most bytes update() uploads, zero if unlimited
+  GLsizeiptr get_frame_budget() const;
+
+  //! The size in bytes of each pixel unpack buffer
+  GLsizeiptr get_slot_size() const;
+
+  //! The number of pixel unpack buffers in the ring
+  GLuint get_slot_count() const;
+
+  //! The number of requests that are neither ready nor failed
+  size_t get_pending_count() const;
+
+  //! The bytes the workers have copied that are waiting for update()
+  GLsizeiptr get_decoded_bytes() const;
+
+  //! The number of bytes uploaded by the last update()
+  GLsizeiptr get_bytes_uploaded_last_update() const;
+
+  //! The number of bytes uploaded since the streamer was created
+  GLsizeiptr get_total_bytes_uploaded() const;
+
+private:
+  // A run of rows of one image copied into a slot
+  struct Band {
+    std::uint64_t request = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    sdl_surface::GLPixelFormat pixel_format = {};
+    GLint first_row = 0;
+    GLsizei rows = 0;
+    GLsizeiptr bytes = 0;
+  };
+
+  enum class SlotState {
+    // Owned by the OpenGL thread, waiting to be mapped
+    Unmapped,
+
+    // Mapped and free for a worker
+    Mapped,
+
+    // A worker is copying rows into it
+    Writing,
+
+    // Holds a band waiting for update()
+    Filled,
+  };
+
+  // One pixel unpack buffer of the ring
+  struct Slot {
+    std::byte *mapped = nullptr;
+    SlotState state = SlotState::Unmapped;
+    Band band;
+  };
+
+  // The state shared with the workers, on the heap so the streamer
+  // can be moved while they run
+  struct Shared {
+    std::mutex mutex;
+
+    // Signalled when a request is queued or the workers must stop
+    std::condition_variable requests_queued;
+
+    // Signalled when a slot is mapped or the workers must stop
+    std::condition_variable slot_mapped;
+
+    // Signalled when a slot is filled or a request fails
+    std::condition_variable progress;
+
+    Decoder decoder;
+
+    GLsizeiptr slot_size = 0;
+
+    std::deque<std::pair<std::uint64_t, string>> requests;
+
+    std::vector<Slot> slots;
+
+    // Filled slots, in the order they were filled
+    std::deque<size_t> filled;
+
+    GLsizeiptr filled_bytes = 0;
+
+    // Requests whose source couldn't be decoded
+    std::deque<std::uint64_t> failed;
+
+    bool stop = false;
+  };
+
+  // The body of each worker thread
+  static void work(Shared &shared);
+
+  // Decode one request and copy it into slots, returns false if the
+  // workers were stopped
+  static bool stream(Shared &shared, std::uint64_t request,
+                     const string &source);
+
+  // Check the streamer can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  // Map every unmapped slot for the workers, returns false on error
+  // in NO_EXCEPTIONS builds
+  bool map_slots();
+
+  // Upload filled bands up to budget, zero for no limit
+  GLsizeiptr upload(GLsizeiptr budget);
+
+  // Unmap a filled slot and upload its band
+  void upload_band(size_t slot, const Band &band);
+
+  // Mark a request failed and drop it
+  void fail(std::uint64_t request);
+
+  string name;
+
+  // The OpenGL context this streamer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  std::unique_ptr<Shared> shared = nullptr;
+
+  std::vector<std::thread> workers;
+
+  // The pixel unpack buffers, one per slot
+  std::vector<VertexBufferObject> buffers;
+
+  // Requests that are neither ready nor failed, by request number
+  std::map<std::uint64_t, TextureStreamHandle> streaming;
+
+  std::uint64_t next_request = 0;
+
+  GLsizeiptr frame_budget = 0;
+
+  GLsizei levels = 0;
+
+  GLsizeiptr bytes_uploaded_last_update = 0;
+
+  GLsizeiptr total_bytes_uploaded = 0;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -0,0 +1,169 @@
+#ifndef _SDL_OPENGL_CPP_UNIFORM_BUFFER_OBJECT_H_
+#define _SDL_OPENGL_CPP_UNIFORM_BUFFER_OBJECT_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "std140.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace uniform_buffer_object {
+
+#ifndef NO_EXCEPTIONS
+
+//! A UniformBufferObjectUnspecifiedStateError exception
+//!
+//! This exception is thrown when the UniformBufferObject is in an
+//! valid but unspecified state after a move operation.
+//!
+class UniformBufferObjectUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace uniform_buffer_object
+
+using namespace uniform_buffer_object;
+
+//! A UniformBufferObject owns an OpenGL uniform buffer.
+//!
+//! Uniform blocks are packed on the CPU with Std140Block and uploaded
+//! with update().  The buffer is attached to a numbered binding
+//! point with bind_base() or bind_range(), and programs are connected
+//! to the same binding point with Program::bind_uniform_block().
+//! Data shared by many programs, such as the camera, is then
+//! uploaded once per frame instead of once per program.
+//!
+//! One buffer can hold several blocks, for example one per draw.
+//! Place them at multiples of get_offset_alignment() and select one
+//! with bind_range().
+//!
+//! Owned OpenGL resources are automatically cleaned up on object
+//! deletion.
+#ifndef NO_EXCEPTIONS
+class UniformBufferObject : private MoveChecker {
+#else
+class UniformBufferObject : public Errors {
+#endif
+public:
+  //! Construct a uniform buffer object with uninitialized storage
+  //!
+  //! \param name The name of the uniform buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param size The size of the buffer in bytes
+  //! \param usage The usage hint for the buffer
+  //!
+  //! \throws a BufferDataError if the size isn't positive.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new UniformBufferObject object
+  UniformBufferObject(const string &name,
+                      const std::shared_ptr<GLContext> &ctx, GLsizeiptr size,
+                      GLenum usage = GL_DYNAMIC_DRAW);
+  ~UniformBufferObject();
+
+  //! Cleanup the uniform buffer object
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  UniformBufferObject(const UniformBufferObject &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  UniformBufferObject &operator=(const UniformBufferObject &) = delete;
+
+  // move constructor
+  UniformBufferObject(UniformBufferObject &&) noexcept;
+
+  // move assignment operator
+  UniformBufferObject &operator=(UniformBufferObject &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Write bytes into the buffer
+  //!
+  //! \param offset The byte offset to start writing at
+  //! \param data The bytes to write
+  //!
+  //! \throws a BufferDataError if the data doesn't fit in the buffer
+  //!         at offset.
+  void update(GLintptr offset, std::span<const std::byte> data);
+
+  //! Write a packed block into the buffer
+  //!
+  //! \param offset The byte offset to start writing at
+  //! \param block A Std140Block<...>::Storage, or a struct already
+  //!              laid out to match the block
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void update(GLintptr offset, const T &block) {
+    update(offset, std::span<const std::byte>(
+                       std::as_bytes(std::span<const T, 1>(&block, 1))));
+  }
+
+  //! Bind the whole buffer to a uniform buffer binding point
+  void bind_base(GLuint binding);
+
+  //! Bind part of the buffer to a uniform buffer binding point
+  //!
+  //! \param binding The binding point
+  //! \param offset The byte offset of the block, a multiple of
+  //!               get_offset_alignment()
+  //! \param range_size The size of the block in bytes
+  //!
+  //! \throws a BufferDataError if the offset is misaligned or the
+  //!         range doesn't fit in the buffer.
+  void bind_range(GLuint binding, GLintptr offset, GLsizeiptr range_size);
+
+  //! The size of the buffer in bytes
+  GLsizeiptr get_size() const;
+
+  //! The alignment bind_range() offsets need,
+  //! GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+  GLint get_offset_alignment() const;
+
+  //! The distance between blocks of block_size bytes placed back to
+  //! back in one buffer
+  GLsizeiptr aligned_stride(GLsizeiptr block_size) const;
+
+private:
+  string name;
+
+  // The OpenGL context this buffer uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // The buffer holding the packed blocks
+  std::optional<VertexBufferObject> buffer = std::nullopt;
+
+  // 256 is the largest alignment OpenGL allows, used if the query
+  // fails
+  GLint offset_alignment = 256;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -0,0 +1,280 @@
+#ifndef _SDL_OPENGL_CPP_UPLOAD_QUEUE_H_
+#define _SDL_OPENGL_CPP_UPLOAD_QUEUE_H_
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "vertex_buffer_object.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace upload_queue {
+
+#ifndef NO_EXCEPTIONS
+
+//! A UploadQueueMapError exception
+//!
+//! This exception is thrown when the staging buffer could not be
+//! mapped, or its contents were lost while mapped.
+//!
+class UploadQueueMapError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+//! A UploadQueueUnspecifiedStateError exception
+//!
+//! This exception is thrown when the UploadQueue is in an valid but
+//! unspecified state after a move operation.
+//!
+class UploadQueueUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+} // namespace upload_queue
+
+using namespace upload_queue;
+
+//! An UploadQueue batches buffer and texture uploads through one
+//! staging buffer and spreads them over frames.
+//!
+//! Uploads are copied into the queue when they are enqueued, so the
+//! caller's memory can be freed straight away.  Each call to flush()
+//! maps the staging buffer once, packs pending uploads into it up to
+//! the frame budget, and issues GPU side copies from it with
+//! glCopyBufferSubData or glTexSubImage2D through
+//! GL_PIXEL_UNPACK_BUFFER.  Many small uploads cost one map instead
+//! of a bind, upload and glGetError each, and a large upload is
+//! split across as many frames as the budget needs instead of
+//! blocking one.
+//!
+//! Typical use, once per frame:
+//!
+//!   queue.enqueue_buffer(mesh, 0, std::as_bytes(std::span(vertices)));
+//!   // ...
+//!   queue.flush();
+//!   sdl_opengl.swap_window();
+//!
+//! The staging buffer is mapped with GL_MAP_INVALIDATE_BUFFER_BIT so
+//! the driver can hand back fresh storage while the GPU is still
+//! copying from the previous frame's batch.
+//!
+//! Destination buffers and textures must stay alive, and buffers
+//! must not be moved, until their uploads have been flushed.
+#ifndef NO_EXCEPTIONS
+class UploadQueue : private MoveChecker {
+#else
+class UploadQueue : public Errors {
+#endif
+public:
+  //! Construct an upload queue
+  //!
+  //! \param name The name of the upload queue
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param staging_size The size of the staging buffer in bytes, the
+  //!                     most that can be uploaded in one flush
+  //! \param frame_budget The most bytes flush() uploads, zero to
+  //!                     only be limited by the staging size
+  //!
+  //! \throws a BufferDataError if the staging size isn't positive or
+  //!         the frame budget is negative.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         staging buffer.
+  //!
+  //! \return A new UploadQueue object
+  UploadQueue(const string &name, const std::shared_ptr<GLContext> &ctx,
+              GLsizeiptr staging_size, GLsizeiptr frame_budget = 0);
+  ~UploadQueue();
+
+  //! Cleanup the upload queue
+  //!
+  //! Drops any pending uploads and deletes the staging buffer.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  UploadQueue(const UploadQueue &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  UploadQueue &operator=(const UploadQueue &) = delete;
+
+  // move constructor
+  UploadQueue(UploadQueue &&) noexcept;
+
+  // move assignment operator
+  UploadQueue &operator=(UploadQueue &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Queue an update of part of a buffer
+  //!
+  //! \param destination The buffer to write to
+  //! \param offset The byte offset into destination to start writing at
+  //! \param data The bytes to write
+  //!
+  //! \throws a BufferDataError if data is empty or doesn't fit in
+  //!         destination at offset.
+  void enqueue_buffer(VertexBufferObject &destination, GLintptr offset,
+                      std::span<const std::byte> data);
+
+  //! Queue an update of part of a buffer
+  //!
+  //! \param destination The buffer to write to
+  //! \param offset The byte offset into destination to start writing at
+  //! \param data The elements to write
+  //!
+  //! \throws a BufferDataError if data is empty or doesn't fit in
+  //!         destination at offset.
+  template <typename T>
+  void enqueue_buffer(VertexBufferObject &destination, GLintptr offset,
+                      std::span<const T> data) {
+    enqueue_buffer(destination, offset, std::as_bytes(data));
+  }
+
+  //! Queue an update of a rectangle of a 2D texture
+  //!
+  //! The texture storage must already exist, for example from a
+  //! glTexImage2D with null pixels.  Rows are padded to the default
+  //! GL_UNPACK_ALIGNMENT of 4.  Large images are uploaded a band of
+  //! rows at a time.
+  //!
+  //! \param texture The texture to write to
+  //! \param x The left edge of the rectangle in texels
+  //! \param y The bottom edge of the rectangle in texels
+  //! \param width The width of the rectangle in texels
+  //! \param height The height of the rectangle in texels
+  //! \param format The pixel format, e.g. GL_RGBA
+  //! \param type The pixel type, e.g. GL_UNSIGNED_BYTE
+  //! \param pixels The pixel data, bottom row first
+  //!
+  //! \throws a BufferDataError if the format or type is unknown,
+  //!         pixels has the wrong size for the rectangle, or one row
+  //!         doesn't fit in the staging buffer.
+  void enqueue_texture(GLuint texture, GLint x, GLint y, GLsizei width,
+                       GLsizei height, GLenum format, GLenum type,
+                       std::span<const std::byte> pixels);
+
+  //! Upload pending data, up to the frame budget
+  //!
+  //! Uploads are done in the order they were enqueued.  At least one
+  //! texture row is uploaded even if it is larger than the budget,
+  //! so the queue always makes progress.
+  //!
+  //! \throws a UploadQueueMapError if the staging buffer could not be
+  //!         mapped.
+  //!
+  //! \returns the number of bytes uploaded
+  GLsizeiptr flush();
+
+  //! Upload everything that is pending, ignoring the frame budget
+  //!
+  //! This takes as many flushes as the staging size needs, use it
+  //! on loading screens.
+  //!
+  //! \throws a UploadQueueMapError if the staging buffer could not be
+  //!         mapped.
+  void flush_all();
+
+  //! Set the most bytes flush() uploads
+  //!
+  //! \param budget The budget in bytes, zero to only be limited by
+  //!               the staging size
+  //!
+  //! \throws a BufferDataError if the budget is negative.
+  void set_frame_budget(GLsizeiptr budget);
+
+  //! The most bytes flush() uploads, zero if unlimited
+  GLsizeiptr get_frame_budget() const;
+
+  //! The size of the staging buffer in bytes
+  GLsizeiptr get_staging_size() const;
+
+  //! The number of uploads that haven't finished
+  size_t get_queue_depth() const;
+
+  //! The number of bytes waiting to be uploaded
+  GLsizeiptr get_pending_bytes() const;
+
+  //! The number of bytes uploaded by the last flush()
+  GLsizeiptr get_bytes_uploaded_last_flush() const;
+
+  //! The number of bytes uploaded since the queue was created
+  GLsizeiptr get_total_bytes_uploaded() const;
+
+private:
+  // One enqueued upload, with the bytes still to be uploaded
+  struct Upload {
+    // The destination buffer, nullptr for texture uploads
+    VertexBufferObject *buffer = nullptr;
+    GLintptr offset = 0;
+
+    // The destination texture and rectangle for texture uploads
+    GLuint texture = 0;
+    GLint x = 0;
+    GLint y = 0;
+    GLsizei width = 0;
+    GLsizei height = 0;
+    GLenum format = GL_NONE;
+    GLenum type = GL_NONE;
+
+    // The size of one padded row of pixels, texture uploads are
+    // split on row boundaries
+    GLsizeiptr row_size = 0;
+
+    std::vector<std::byte> data;
+
+    // How many bytes of data have been uploaded
+    GLsizeiptr uploaded = 0;
+  };
+
+  // Check the queue can be used, returns false on error in
+  // NO_EXCEPTIONS builds
+  bool check_state();
+
+  string name;
+
+  // The OpenGL context this queue uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  // The buffer each flush packs its uploads into
+  std::optional<VertexBufferObject> staging = std::nullopt;
+
+  GLsizeiptr staging_size = 0;
+
+  GLsizeiptr frame_budget = 0;
+
+  std::deque<Upload> pending;
+
+  GLsizeiptr pending_bytes = 0;
+
+  GLsizeiptr bytes_uploaded_last_flush = 0;
+
+  GLsizeiptr total_bytes_uploaded = 0;
+};
+
+} // namespace sdl_opengl_cpp
+#endif
@@ -2,10 +2,8 @@
 #define _SDL_OPENGL_CPP_VERTEX_ARRAY_OBJECT_H_
 
 #include <memory>
-
-#ifdef NO_EXCEPTIONS
 #include <optional>
-#endif
+#include <span>
 
 #include <stdexcept>
 #include <vector>
@@ -21,7 +19,9 @@
 
 #include "gl_context.h"
 
+#include "index_buffer_object.h"
 #include "vertex_buffer_object.h"
+#include "vertex_layout.h"
 
 using namespace std;
 
@@ -86,6 +86,29 @@ using namespace vertex_array_object;
 //! Tke VertexBufferObject is in an "valid but unspecified state"
 //! after constructing the VertexArrayObject with it.
 //!
+//! More vertex buffers can be added with attach_buffer(), which takes
+//! ownership, or reference_buffer(), which doesn't.  Giving their
+//! attributes a divisor makes them per-instance streams for
+//! draw_arrays_instanced() and draw_elements_instanced().
+//!
+//! An IndexBufferObject can be attached for indexed drawing with
+//! draw_elements().  The VertexArrayObject takes ownership of it too.
+//!
+//! When GLContext::direct_state_access() is true the vertex array
+//! object is created with glCreateVertexArrays and every buffer is
+//! given its own vertex buffer binding by name, so it is only bound
+//! to draw.
+//!
+//! Every buffer gets a vertex buffer binding, numbered in the order
+//! they were added starting with 0 for the buffer the vertex array
+//! object was constructed with.  bind_vertex_buffer() points a
+//! binding at another buffer with the same layout, so one vertex
+//! array object per vertex format can draw many meshes.  With
+//! direct state access or GLContext::vertex_attrib_binding() the
+//! attribute formats are separate from the bindings and only the
+//! buffer changes, otherwise the attributes are specified again with
+//! glVertexAttribPointer.
+//!
 //! Owned OpenGL resources are automatically cleaned up on object
 //! deletion.  The owned VertexBufferObject is also cleaned up.
 //!
@@ -100,8 +123,50 @@ class VertexArrayObject : public Errors {
   friend class VertexArrayObjectTester;
 
 public:
+  //! Construct a vertex array object for tightly packed positions
+  //!
+  //! The buffer is bound to attribute location 0 as three floats per
+  //! vertex.
+  //!
+  //! \param name The name of the vertex array object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param vbo The vertex buffer, the VertexArrayObject takes
+  //!            ownership of it
   VertexArrayObject(const string &name, const std::shared_ptr<GLContext> &ctx,
                     VertexBufferObject &&vbo);
+
+  //! Construct a vertex array object with a compile time layout
+  //!
+  //! Every attribute of the layout is enabled and pointed at the
+  //! buffer with the offsets and stride computed by the layout.  The
+  //! layout is passed as an empty tag value, e.g.
+  //! VertexLayout<Attr<vec3, 0>, Attr<vec2, 1>>{}
+  //!
+  //! \param array_name The name of the vertex array object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param vbo_ The vertex buffer, the VertexArrayObject takes
+  //!             ownership of it
+  template <typename... Attrs>
+  VertexArrayObject(const string &array_name,
+                    const std::shared_ptr<GLContext> &ctx,
+                    VertexBufferObject &&vbo_, VertexLayout<Attrs...>)
+      : VertexArrayObject(array_name, ctx, std::move(vbo_),
+                          VertexLayout<Attrs...>::attributes,
+                          VertexLayout<Attrs...>::stride) {}
+
+  //! Construct a vertex array object from an attribute table
+  //!
+  //! \param name The name of the vertex array object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param vbo The vertex buffer, the VertexArrayObject takes
+  //!            ownership of it
+  //! \param attributes The attributes, with byte offsets into a vertex
+  //! \param stride The size of one vertex in bytes, or 0 for a
+  //!               single tightly packed attribute
+  VertexArrayObject(const string &name, const std::shared_ptr<GLContext> &ctx,
+                    VertexBufferObject &&vbo,
+                    std::span<const VertexAttribute> attributes,
+                    GLsizei stride);
   ~VertexArrayObject();
 
   //! Cleanup the vertex array object
@@ -128,7 +193,149 @@ public:
 
   void bind();
 
+  //! Attach an index buffer
+  //!
+  //! The index buffer is bound to GL_ELEMENT_ARRAY_BUFFER while this
+  //! vertex array object is bound, so the binding is recorded in the
+  //! vertex array object.  Any previously attached index buffer is
+  //! released.
+  //!
+  //! \param ibo The index buffer, the VertexArrayObject takes
+  //!            ownership of it
+  void attach_index_buffer(IndexBufferObject &&ibo);
+
+  //! Draw with the attached index buffer
+  //!
+  //! Binds this vertex array object and issues glDrawElements, or
+  //! glDrawElementsBaseVertex when base_vertex isn't zero.
+  //!
+  //! \param mode The primitive type, for example GL_TRIANGLES
+  //! \param base_vertex A constant added to every index, for meshes
+  //!                    sub-allocated from a shared vertex buffer
+  //!
+  //! \throws an InvalidOperationError if no index buffer is
+  //!         attached.
+  void draw_elements(GLenum mode, GLint base_vertex = 0);
+
+  //! Add a vertex buffer and take ownership of it
+  //!
+  //! \param vbo_ The vertex buffer
+  //! \param attributes The attributes sourced from this buffer
+  //! \param stride The size of one element of the buffer in bytes
+  //! \param divisor 0 for per-vertex attributes, N to advance once
+  //!                every N instances
+  //!
+  //! \throws an InvalidOperationError if the attributes couldn't be
+  //!         set up.
+  void attach_buffer(VertexBufferObject &&vbo_,
+                     std::span<const VertexAttribute> attributes,
+                     GLsizei stride, GLuint divisor = 0);
+
+  //! Add a vertex buffer with a compile time layout and take
+  //! ownership of it
+  template <typename... Attrs>
+  void attach_buffer(VertexBufferObject &&vbo_, VertexLayout<Attrs...>,
+                     GLuint divisor = 0) {
+    attach_buffer(std::move(vbo_), VertexLayout<Attrs...>::attributes,
+                  VertexLayout<Attrs...>::stride, divisor);
+  }
+
+  //! Add a vertex buffer owned by someone else
+  //!
+  //! The buffer must outlive this VertexArrayObject, or at least
+  //! every draw with it.  This is for buffers shared between vertex
+  //! array objects, such as BufferArena pages.
+  //!
+  //! \param buffer The vertex buffer
+  //! \param attributes The attributes sourced from this buffer
+  //! \param stride The size of one element of the buffer in bytes
+  //! \param divisor 0 for per-vertex attributes, N to advance once
+  //!                every N instances
+  void reference_buffer(const VertexBufferObject &buffer,
+                        std::span<const VertexAttribute> attributes,
+                        GLsizei stride, GLuint divisor = 0);
+
+  //! Add a vertex buffer owned by someone else with a compile time
+  //! layout
+  template <typename... Attrs>
+  void reference_buffer(const VertexBufferObject &buffer,
+                        VertexLayout<Attrs...>, GLuint divisor = 0) {
+    reference_buffer(buffer, VertexLayout<Attrs...>::attributes,
+                     VertexLayout<Attrs...>::stride, divisor);
+  }
+
+  //! Point a vertex buffer binding at another buffer
+  //!
+  //! The buffer is read with the attributes, stride and divisor the
+  //! binding was set up with.  It isn't owned and must outlive every
+  //! draw with it, the buffer the binding was set up with stays owned
+  //! by this VertexArrayObject.
+  //!
+  //! Unless direct state access is used this leaves the vertex array
+  //! object bound, so drawing many meshes is one buffer bind and one
+  //! draw call each.
+  //!
+  //! \param binding_index The binding, 0 for the buffer the vertex
+  //!                      array object was constructed with and 1 and
+  //!                      up for added buffers in the order they were
+  //!                      added
+  //! \param buffer The vertex buffer
+  //! \param offset The byte offset of the first vertex in buffer
+  //!
+  //! \throws an InvalidOperationError if there is no binding
+  //!         binding_index.
+  void bind_vertex_buffer(GLuint binding_index,
+                          const VertexBufferObject &buffer,
+                          GLintptr offset = 0);
+
+  //! The number of vertex buffer bindings, one per buffer
+  GLuint get_binding_count() const;
+
+  //! Draw count vertices starting at first
+  void draw_arrays(GLenum mode, GLint first, GLsizei count);
+
+  //! Draw instance_count instances of count vertices starting at
+  //! first
+  void draw_arrays_instanced(GLenum mode, GLint first, GLsizei count,
+                             GLsizei instance_count);
+
+  //! Draw instance_count instances with the attached index buffer
+  //!
+  //! \throws an InvalidOperationError if no index buffer is
+  //!         attached.
+  void draw_elements_instanced(GLenum mode, GLsizei instance_count);
+
 private:
+  // What a vertex buffer binding reads, kept to swap its buffer
+  struct VertexBinding {
+    std::vector<VertexAttribute> attributes;
+    GLsizei stride;
+    GLuint divisor;
+  };
+
+  // Point attributes at the buffer bound to GL_ARRAY_BUFFER, offset
+  // bytes in, with the VAO bound
+  void set_attribute_pointers(std::span<const VertexAttribute> attributes,
+                              GLsizei stride, GLuint divisor,
+                              GLintptr offset);
+
+  // Give buffer the next vertex buffer binding and set up the
+  // attribute formats separately, by name with direct state access
+  // or with the VAO bound otherwise
+  void set_attribute_formats(const VertexBufferObject &buffer,
+                             std::span<const VertexAttribute> attributes,
+                             GLsizei stride, GLuint divisor);
+
+  // Bind the VAO, set up attributes for buffer, check for errors and
+  // unbind.  Returns false on error in NO_EXCEPTIONS builds.
+  bool add_buffer(const VertexBufferObject &buffer,
+                  std::span<const VertexAttribute> attributes, GLsizei stride,
+                  GLuint divisor);
+
+  // Common checks before a draw call.  Returns false on error in
+  // NO_EXCEPTIONS builds.
+  bool prepare_draw(bool indexed);
+
   string name;
 
   // The OpenGL context this program uses
@@ -136,6 +343,15 @@ private:
 
   VertexBufferObject vbo;
 
+  std::optional<IndexBufferObject> index_buffer = std::nullopt;
+
+  // Additional buffers added with attach_buffer()
+  std::vector<VertexBufferObject> attached_buffers;
+
+  // One vertex buffer binding per buffer, in the order they were
+  // added
+  std::vector<VertexBinding> bindings;
+
   // OpenGL Vertex Array Object
   GLuint VAO = 0;
 };
@@ -2,9 +2,13 @@
 #define _SDL_OPENGL_CPP_VERTEX_BUFFER_OBJECT_H_
 
 #include <functional>
+#include <cstddef>
 #include <memory>
+#include <ranges>
+#include <span>
 
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include "SDL_opengl.h"
@@ -19,6 +23,7 @@
 #include "opengl.h"
 
 #include "gl_context.h"
+#include "gpu_memory_registry.h"
 
 using namespace std;
 
@@ -61,6 +66,17 @@ public:
   const char *what() const noexcept { return runtime_error::what(); }
 };
 
+//! A OutOfMemoryError exception
+//!
+//! This exception is thrown when a buffer doesn't fit in the GPU
+//! memory budget, or OpenGL ran out of memory, even after evicting
+//! cached resources.
+//!
+class OutOfMemoryError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
 //! A InvalidOperation exception
 //!
 //! TODO: This should probably be a library-specific exception.  We
@@ -112,9 +128,25 @@ using namespace vertex_buffer_object;
 //! Vertex Buffer Objects allow you to tie and upload local program
 //! data to OpenGL hardware.
 //!
-//! This class lets you use C++ Standard Template Library data
-//! structures like vector to store OpenGL floats (GLfloat) and
-//! upload them to the OpenGL hardware easily.
+//! The buffer can be filled from any contiguous range of trivially
+//! copyable elements: vectors of GLfloat, std::arrays of packed or
+//! interleaved vertex structs, spans over memory mapped files or
+//! arenas.  The data is uploaded straight from that memory with no
+//! intermediate copy.
+//!
+//! Buffers that change after construction can be created with a
+//! GL_DYNAMIC_DRAW or GL_STREAM_DRAW usage hint and updated in place
+//! with update() or orphan_and_refill(), keeping the same OpenGL
+//! buffer name.
+//!
+//! The buffer is recorded in the GPUMemoryRegistry under its name.
+//! Creating it first makes room in the memory budget, and retries
+//! once after evicting cached resources if OpenGL runs out of memory.
+//!
+//! When GLContext::direct_state_access() is true the buffer is
+//! created and written by name with glCreateBuffers and the
+//! glNamedBuffer functions, and the GL_ARRAY_BUFFER binding is left
+//! alone.
 //!
 //! Owned OpenGL resources are automatically cleaned up on object
 //! deletion.  It is up to the user to cleanup their own data.
@@ -139,6 +171,34 @@ public:
   //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
   //! \param data A vector of GLfloats containing the data to load
   //!             into the vertex buffer object
+  //! \param usage The usage hint for the buffer, GL_STATIC_DRAW for
+  //!              data that is specified once, GL_DYNAMIC_DRAW for
+  //!              data that is updated repeatedly and GL_STREAM_DRAW
+  //!              for data that is respecified every frame
+  //!
+  //! \throws a BufferDataError if the data is too large to store in
+  //!         the buffer.
+  //!
+  //! \throws an OutOfMemoryError if the buffer doesn't fit in the
+  //!         GPU memory budget.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new VertexBufferObject object which owns the data
+  VertexBufferObject(const string &name, const std::shared_ptr<GLContext> &ctx,
+                     const vector<GLfloat> &data,
+                     GLenum usage = GL_STATIC_DRAW);
+
+  //! Construct a vertex buffer object from raw bytes
+  //!
+  //! The bytes are uploaded directly from data, the layout is up to
+  //! the vertex array object that uses the buffer.
+  //!
+  //! \param name The name of the vertex buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param data The bytes to load into the vertex buffer object
+  //! \param usage The usage hint for the buffer
   //!
   //! \throws a BufferDataError if the data is too large to store in
   //!         the buffer.
@@ -148,7 +208,68 @@ public:
   //!
   //! \return A new VertexBufferObject object which owns the data
   VertexBufferObject(const string &name, const std::shared_ptr<GLContext> &ctx,
-                     const vector<GLfloat> &data);
+                     std::span<const std::byte> data,
+                     GLenum usage = GL_STATIC_DRAW);
+
+  //! Construct a vertex buffer object from a typed span
+  //!
+  //! \param buffer_name The name of the vertex buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param data The elements to load into the vertex buffer object
+  //! \param buffer_usage The usage hint for the buffer
+  //!
+  //! \return A new VertexBufferObject object which owns the data
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  VertexBufferObject(const string &buffer_name,
+                     const std::shared_ptr<GLContext> &ctx,
+                     std::span<const T> data,
+                     GLenum buffer_usage = GL_STATIC_DRAW)
+      : VertexBufferObject(buffer_name, ctx, std::as_bytes(data),
+                           buffer_usage) {}
+
+  //! Construct a vertex buffer object from any contiguous range
+  //!
+  //! Accepts std::array, std::vector, std::span and other contiguous
+  //! ranges of trivially copyable elements, such as interleaved
+  //! vertex structs.
+  //!
+  //! \param buffer_name The name of the vertex buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param data The elements to load into the vertex buffer object
+  //! \param buffer_usage The usage hint for the buffer
+  //!
+  //! \return A new VertexBufferObject object which owns the data
+  template <std::ranges::contiguous_range R>
+    requires std::ranges::sized_range<R> &&
+                 std::is_trivially_copyable_v<std::ranges::range_value_t<R>>
+  VertexBufferObject(const string &buffer_name,
+                     const std::shared_ptr<GLContext> &ctx, const R &data,
+                     GLenum buffer_usage = GL_STATIC_DRAW)
+      : VertexBufferObject(buffer_name, ctx,
+                           std::as_bytes(std::span(std::ranges::data(data),
+                                                   std::ranges::size(data))),
+                           buffer_usage) {}
+
+  //! Construct a vertex buffer object with uninitialized storage
+  //!
+  //! The contents are undefined until they are written with update()
+  //! or a buffer copy.
+  //!
+  //! \param name The name of the vertex buffer object
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param size The size of the buffer in bytes
+  //! \param usage The usage hint for the buffer
+  //!
+  //! \throws a BufferDataError if the size is negative.
+  //!
+  //! \throws a GenBuffersError if there was an error generating the
+  //!         buffer.
+  //!
+  //! \return A new VertexBufferObject object
+  VertexBufferObject(const string &name, const std::shared_ptr<GLContext> &ctx,
+                     GLsizeiptr size, GLenum usage = GL_STATIC_DRAW);
+
   ~VertexBufferObject();
 
   //! Cleanup the vertex buffer object
@@ -177,9 +298,105 @@ public:
 
   bool is_in_unspecified_state() const override;
 
-  void bind();
+  void bind() const;
+
+  //! Bind the buffer to a specific target
+  //!
+  //! Buffer objects aren't typed in OpenGL, the same buffer can be
+  //! bound as GL_COPY_READ_BUFFER, GL_ELEMENT_ARRAY_BUFFER and so on.
+  //!
+  //! \param target The binding target
+  void bind(GLenum target) const;
+
+  //! Bind the whole buffer to an indexed binding point
+  //!
+  //! \param target An indexed target, e.g. GL_UNIFORM_BUFFER
+  //! \param index The binding point index
+  void bind_base(GLenum target, GLuint index) const;
+
+  //! Bind part of the buffer to an indexed binding point
+  //!
+  //! \param target An indexed target, e.g. GL_UNIFORM_BUFFER
+  //! \param index The binding point index
+  //! \param offset The byte offset of the range
+  //! \param range_size The size of the range in bytes
+  //!
+  //! \throws a BufferDataError if the range is empty or doesn't fit
+  //!         in the buffer.
+  void bind_range(GLenum target, GLuint index, GLintptr offset,
+                  GLsizeiptr range_size) const;
+
+  //! Update part of the buffer in place with glBufferSubData
+  //!
+  //! The buffer isn't reallocated, so the update must fit in the
+  //! current buffer size.
+  //!
+  //! \param offset The byte offset into the buffer to start writing at
+  //! \param data The bytes to write
+  //!
+  //! \throws a BufferDataError if the data doesn't fit in the buffer
+  //!         at offset.
+  void update(GLintptr offset, std::span<const std::byte> data);
+
+  //! Update part of the buffer in place with glBufferSubData
+  //!
+  //! \param offset The byte offset into the buffer to start writing at
+  //! \param data The elements to write
+  //!
+  //! \throws a BufferDataError if the data doesn't fit in the buffer
+  //!         at offset.
+  template <typename T> void update(GLintptr offset, std::span<const T> data) {
+    update(offset, std::as_bytes(data));
+  }
+
+  //! Orphan the current storage and refill the buffer
+  //!
+  //! Respecifies the buffer with glBufferData(NULL) before writing
+  //! the new data.  The driver can hand back fresh storage instead
+  //! of waiting for draws still reading the old contents, which
+  //! avoids a stall when the whole buffer changes every frame.  The
+  //! buffer takes the size of data.
+  //!
+  //! \param data The new contents of the buffer
+  //!
+  //! \throws a BufferDataError if data is empty.
+  //!
+  //! \throws an OutOfMemoryError if a larger buffer doesn't fit in
+  //!         the GPU memory budget, or OpenGL runs out of memory even
+  //!         after evicting cached resources.
+  void orphan_and_refill(std::span<const std::byte> data);
+
+  //! Orphan the current storage and refill the buffer
+  //!
+  //! \param data The new contents of the buffer
+  //!
+  //! \throws a BufferDataError if data is empty.
+  template <typename T> void orphan_and_refill(std::span<const T> data) {
+    orphan_and_refill(std::as_bytes(data));
+  }
+
+  //! The size of the buffer in bytes
+  GLsizeiptr get_size() const;
+
+  //! The usage hint the buffer was created with
+  GLenum get_usage() const;
+
+  //! The OpenGL name of the buffer, for direct state access calls
+  //! that take a buffer by name
+  GLuint get_buffer() const;
 
 private:
+  // Shared implementation for the public constructors, data may be
+  // nullptr for uninitialized storage
+  VertexBufferObject(const string &name, const std::shared_ptr<GLContext> &ctx,
+                     const void *data, size_t size, GLenum usage);
+
+  // glBufferData, or glNamedBufferData with direct state access.
+  // Without it the buffer must already be bound to GL_ARRAY_BUFFER.
+  // On GL_OUT_OF_MEMORY cached resources are evicted and the call
+  // made once more.  Returns the glGetError after the last call.
+  GLenum buffer_data(GLsizeiptr data_size, const void *data);
+
   string name;
 
   // The OpenGL context this program uses
@@ -188,6 +405,12 @@ private:
   // OpenGL Vertex Buffer Object
   GLuint VBO = 0;
 
+  // The size of the buffer data store in bytes
+  GLsizeiptr size = 0;
+
+  // The usage hint passed to glBufferData
+  GLenum usage = GL_STATIC_DRAW;
+
   // mutex vbo_mutex {};
   // scoped_lock lck { vbo_mutex };
 };
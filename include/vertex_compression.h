@@ -0,0 +1,126 @@
+#ifndef _SDL_OPENGL_CPP_VERTEX_COMPRESSION_H_
+#define _SDL_OPENGL_CPP_VERTEX_COMPRESSION_H_
+
+#include <cstddef>
+#include <span>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#include "opengl.h"
+
+namespace sdl_opengl_cpp {
+
+//! Encoders from 32-bit floats to the compressed attribute formats in
+//! vertex_layout.h
+//!
+//! Normals, colors and texture coordinates rarely need full floats.
+//! Encoding them to half floats, normalized 8 or 16-bit integers or
+//! GL_INT_2_10_10_10_REV cuts their size by two to four times, and
+//! the vertex fetch bandwidth with it.
+//!
+//! The array encoders use AVX2 (with F16C for half floats) when the
+//! CPU supports it, SSE2 on other x86 CPUs, and plain C++ elsewhere.
+//! Every path gives the same bits as the single value encoders:
+//! values are clamped to the format's range, NaN becomes the lowest
+//! value, and results are rounded to nearest, ties to even.
+//!
+//!   std::vector<GLshort> uvs(float_uvs.size());
+//!   vertex_compression::encode_snorm16(float_uvs, uvs);
+//!   // Upload uvs and describe them with Attr<snorm16x2, 2>
+namespace vertex_compression {
+
+//! The instruction sets the array encoders can use
+enum class SIMDLevel {
+  Scalar,
+  SSE2,
+  //! AVX2 and F16C
+  AVX2,
+};
+
+//! The instruction set the array encoders use
+SIMDLevel get_simd_level();
+
+//! Limit the instruction set the array encoders use, for testing and
+//! benchmarking
+//!
+//! \param level The highest instruction set to use, capped to what
+//!              this CPU and build support
+//!
+//! \returns the instruction set now in use
+SIMDLevel set_simd_level(SIMDLevel level);
+
+//! Encode one float as an IEEE half float
+//!
+//! Values too large for a half become infinity, NaNs stay NaNs.
+GLhalf float_to_half(GLfloat value);
+
+//! Decode an IEEE half float
+GLfloat half_to_float(GLhalf value);
+
+//! Encode one float in [-1, 1] as a normalized signed byte
+GLbyte float_to_snorm8(GLfloat value);
+
+//! Encode one float in [0, 1] as a normalized unsigned byte
+GLubyte float_to_unorm8(GLfloat value);
+
+//! Encode one float in [-1, 1] as a normalized signed short
+GLshort float_to_snorm16(GLfloat value);
+
+//! Encode one float in [0, 1] as a normalized unsigned short
+GLushort float_to_unorm16(GLfloat value);
+
+//! Pack a vector with components in [-1, 1] as GL_INT_2_10_10_10_REV
+//!
+//! x, y and z get ten bits each, w gets two bits so it can only be
+//! -1, 0 or 1, e.g. the handedness of a tangent.
+GLuint pack_snorm_2_10_10_10(GLfloat x, GLfloat y, GLfloat z,
+                             GLfloat w = 0.0f);
+
+//! Encode floats as half floats
+//!
+//! \param source The values to encode
+//! \param destination Where to write the encoded values
+//!
+//! \returns the number of values encoded, the smaller of the two sizes
+size_t encode_half(std::span<const GLfloat> source,
+                   std::span<GLhalf> destination);
+
+//! Encode floats in [-1, 1] as normalized signed bytes
+//!
+//! \returns the number of values encoded, the smaller of the two sizes
+size_t encode_snorm8(std::span<const GLfloat> source,
+                     std::span<GLbyte> destination);
+
+//! Encode floats in [0, 1] as normalized unsigned bytes
+//!
+//! \returns the number of values encoded, the smaller of the two sizes
+size_t encode_unorm8(std::span<const GLfloat> source,
+                     std::span<GLubyte> destination);
+
+//! Encode floats in [-1, 1] as normalized signed shorts
+//!
+//! \returns the number of values encoded, the smaller of the two sizes
+size_t encode_snorm16(std::span<const GLfloat> source,
+                      std::span<GLshort> destination);
+
+//! Encode floats in [0, 1] as normalized unsigned shorts
+//!
+//! \returns the number of values encoded, the smaller of the two sizes
+size_t encode_unorm16(std::span<const GLfloat> source,
+                      std::span<GLushort> destination);
+
+//! Pack four component vectors as GL_INT_2_10_10_10_REV
+//!
+//! \param source The vectors to encode, four floats each
+//! \param destination Where to write one packed word per vector
+//!
+//! \returns the number of vectors encoded
+size_t encode_snorm_2_10_10_10(std::span<const GLfloat> source,
+                               std::span<GLuint> destination);
+
+} // namespace vertex_compression
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef _SDL_OPENGL_CPP_VERTEX_LAYOUT_H_
+#define _SDL_OPENGL_CPP_VERTEX_LAYOUT_H_
+
+#include <array>
+#include <cstddef>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#include "opengl.h"
+
+namespace sdl_opengl_cpp {
+
+//! The format of one vertex attribute
+//!
+//! \tparam Components The number of components, 1 to 4
+//! \tparam Type The OpenGL component type, e.g. GL_FLOAT
+//! \tparam ComponentType The matching C++ type, used for sizes
+//! \tparam Normalized Integer components are mapped to [0, 1] or
+//!                    [-1, 1] floats in the shader
+//! \tparam Integer Integer components stay integers in the shader,
+//!                 the attribute is set up with glVertexAttribIPointer
+template <GLint Components, GLenum Type, typename ComponentType,
+          bool Normalized = false, bool Integer = false>
+struct AttributeFormat {
+  static_assert((Components >= 1) && (Components <= 4),
+                "An attribute has between one and four components");
+  static_assert(!(Normalized && Integer),
+                "Integer attributes can't be normalized");
+
+  static constexpr GLint components = Components;
+  static constexpr GLenum type = Type;
+  static constexpr GLboolean normalized = Normalized ? GL_TRUE : GL_FALSE;
+  static constexpr bool integer = Integer;
+  static constexpr GLsizei component_size = sizeof(ComponentType);
+  static constexpr GLsizei size = Components * sizeof(ComponentType);
+};
+
+// Floating point attributes
+using vec1 = AttributeFormat<1, GL_FLOAT, GLfloat>;
+using vec2 = AttributeFormat<2, GL_FLOAT, GLfloat>;
+using vec3 = AttributeFormat<3, GL_FLOAT, GLfloat>;
+using vec4 = AttributeFormat<4, GL_FLOAT, GLfloat>;
+
+// Integer attributes, read as int or uint in the shader
+using ivec1 = AttributeFormat<1, GL_INT, GLint, false, true>;
+using ivec2 = AttributeFormat<2, GL_INT, GLint, false, true>;
+using ivec3 = AttributeFormat<3, GL_INT, GLint, false, true>;
+using ivec4 = AttributeFormat<4, GL_INT, GLint, false, true>;
+using uvec1 = AttributeFormat<1, GL_UNSIGNED_INT, GLuint, false, true>;
+using uvec2 = AttributeFormat<2, GL_UNSIGNED_INT, GLuint, false, true>;
+using uvec3 = AttributeFormat<3, GL_UNSIGNED_INT, GLuint, false, true>;
+using uvec4 = AttributeFormat<4, GL_UNSIGNED_INT, GLuint, false, true>;
+
+// Packed colors, four bytes read as a vec4 in [0, 1]
+using rgba8_norm = AttributeFormat<4, GL_UNSIGNED_BYTE, GLubyte, true>;
+
+// Four bytes read as a uvec4, e.g. bone indices
+using u8vec4 = AttributeFormat<4, GL_UNSIGNED_BYTE, GLubyte, false, true>;
+
+//! The format of a packed vertex attribute, four components in one
+//! 32-bit word
+//!
+//! \tparam Type The OpenGL packed type, e.g. GL_INT_2_10_10_10_REV
+//! \tparam Normalized Components are mapped to [-1, 1] or [0, 1]
+//!                    floats in the shader
+template <GLenum Type, bool Normalized = true> struct PackedAttributeFormat {
+  static constexpr GLint components = 4;
+  static constexpr GLenum type = Type;
+  static constexpr GLboolean normalized = Normalized ? GL_TRUE : GL_FALSE;
+  static constexpr bool integer = false;
+  static constexpr GLsizei component_size = sizeof(GLuint);
+  static constexpr GLsizei size = sizeof(GLuint);
+};
+
+// Compressed attributes, read as floats in the shader.  The encoders
+// in vertex_compression.h produce data for these.
+
+// Half floats, e.g. texture coordinates
+using half2 = AttributeFormat<2, GL_HALF_FLOAT, GLhalf>;
+using half3 = AttributeFormat<3, GL_HALF_FLOAT, GLhalf>;
+using half4 = AttributeFormat<4, GL_HALF_FLOAT, GLhalf>;
+
+// Normalized integers, read in [-1, 1] (snorm) or [0, 1] (unorm)
+using snorm8x4 = AttributeFormat<4, GL_BYTE, GLbyte, true>;
+using unorm8x4 = AttributeFormat<4, GL_UNSIGNED_BYTE, GLubyte, true>;
+using snorm16x2 = AttributeFormat<2, GL_SHORT, GLshort, true>;
+using snorm16x4 = AttributeFormat<4, GL_SHORT, GLshort, true>;
+using unorm16x2 = AttributeFormat<2, GL_UNSIGNED_SHORT, GLushort, true>;
+using unorm16x4 = AttributeFormat<4, GL_UNSIGNED_SHORT, GLushort, true>;
+
+// Normals and tangents, three 10-bit and one 2-bit signed normalized
+// components in four bytes
+using snorm_2_10_10_10 = PackedAttributeFormat<GL_INT_2_10_10_10_REV>;
+
+//! An attribute of a VertexLayout
+//!
+//! \tparam Format The attribute format, e.g. vec3 or rgba8_norm
+//! \tparam Location The shader attribute location,
+//!                  "layout(location = Location) in ..."
+template <typename Format, GLuint Location> struct Attr {
+  using format = Format;
+  static constexpr GLuint location = Location;
+};
+
+//! One attribute of a layout, with its byte offset resolved
+struct VertexAttribute {
+  GLuint location;
+  GLint components;
+  GLenum type;
+  GLboolean normalized;
+  bool integer;
+  GLsizei offset;
+};
+
+namespace vertex_layout_detail {
+
+// Resolve the offset of each attribute, packed in order
+template <typename... Attrs>
+constexpr std::array<VertexAttribute, sizeof...(Attrs)> make_attributes() {
+  std::array<VertexAttribute, sizeof...(Attrs)> result{};
+  GLsizei offset = 0;
+  size_t i = 0;
+
+  ((result[i++] = VertexAttribute{Attrs::location, Attrs::format::components,
+                                  Attrs::format::type,
+                                  Attrs::format::normalized,
+                                  Attrs::format::integer, offset},
+    offset += Attrs::format::size),
+   ...);
+
+  return result;
+}
+
+template <typename... Attrs> constexpr bool unique_locations() {
+  constexpr std::array<GLuint, sizeof...(Attrs)> locations = {
+      Attrs::location...};
+
+  for (size_t i = 0; i < locations.size(); i++)
+    for (size_t j = i + 1; j < locations.size(); j++)
+      if (locations[i] == locations[j])
+        return false;
+
+  return true;
+}
+
+// Every attribute starts at a multiple of its component size
+template <typename... Attrs> constexpr bool aligned() {
+  constexpr std::array<GLsizei, sizeof...(Attrs)> component_sizes = {
+      Attrs::format::component_size...};
+  constexpr std::array<VertexAttribute, sizeof...(Attrs)> table =
+      make_attributes<Attrs...>();
+
+  for (size_t i = 0; i < table.size(); i++)
+    if (table[i].offset % component_sizes[i] != 0)
+      return false;
+
+  return true;
+}
+
+} // namespace vertex_layout_detail
+
+//! An interleaved vertex layout described at compile time
+//!
+//! Attributes are laid out in order with no padding, so
+//!
+//!   VertexLayout<Attr<vec3, 0>, Attr<rgba8_norm, 1>, Attr<vec2, 2>>
+//!
+//! matches
+//!
+//!   struct Vertex { GLfloat position[3]; GLubyte color[4];
+//!                   GLfloat uv[2]; };
+//!
+//! with a stride of 24 bytes and offsets 0, 12 and 16.  The stride,
+//! the offsets and the attribute table are all constants, and
+//! invalid layouts (duplicate locations, misaligned attributes) fail
+//! to compile.  Use matches<Vertex> in a static_assert to check a
+//! vertex struct against the layout.
+//!
+//! Pass a layout to the VertexArrayObject constructor to configure
+//! every attribute in one pass.
+template <typename... Attrs> struct VertexLayout {
+  static_assert(sizeof...(Attrs) > 0, "A vertex layout needs an attribute");
+
+  //! The size of one vertex in bytes
+  static constexpr GLsizei stride = (Attrs::format::size + ...);
+
+  //! The number of attributes
+  static constexpr size_t size = sizeof...(Attrs);
+
+  //! The attributes in order, with their byte offsets
+  static constexpr std::array<VertexAttribute, sizeof...(Attrs)> attributes =
+      vertex_layout_detail::make_attributes<Attrs...>();
+
+  //! The byte offset of the attribute at index I
+  template <size_t I> static constexpr GLsizei offset = attributes[I].offset;
+
+  //! True if Vertex has the same size as the layout stride
+  template <typename Vertex>
+  static constexpr bool matches = (sizeof(Vertex) == stride);
+
+  // OpenGL guarantees at least 16 attribute locations
+  static_assert(((Attrs::location < 16) && ...),
+                "Attribute locations must be less than 16");
+  static_assert(vertex_layout_detail::unique_locations<Attrs...>(),
+                "Each attribute in a layout needs its own location");
+  static_assert(vertex_layout_detail::aligned<Attrs...>(),
+                "Each attribute must be aligned to the size of "
+                "its components, reorder or pad the layout");
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef _SDL_OPENGL_CPP_VERTEX_PULLING_H_
+#define _SDL_OPENGL_CPP_VERTEX_PULLING_H_
+
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "SDL_opengl.h"
+#include <SDL.h>
+
+#ifdef NO_EXCEPTIONS
+#include "errors.h"
+#else
+#include "move_checker.h"
+#endif
+
+#include "opengl.h"
+
+#include "gl_context.h"
+#include "index_buffer_object.h"
+#include "shader_storage_buffer_object.h"
+#include "vertex_array_object.h"
+#include "vertex_layout.h"
+
+using namespace std;
+
+namespace sdl_opengl_cpp {
+
+// nested namespaces added in C++17
+namespace vertex_pulling {
+
+#ifndef NO_EXCEPTIONS
+
+//! A VertexPullerUnspecifiedStateError exception
+//!
+//! This exception is thrown when the VertexPuller is in an valid but
+//! unspecified state after a move operation.
+//!
+class VertexPullerUnspecifiedStateError : public runtime_error {
+  // Inherit constructors from runtime_error
+  using runtime_error::runtime_error;
+};
+
+#endif
+
+//! Generate GLSL that reads vertices from a shader storage buffer
+//!
+//! The source declares a read-only std430 buffer of words at binding
+//! and, for every attribute, two functions named after prefix and the
+//! attribute location:
+//!
+//!   vec3 pulled_0(uint vertex);  // read any vertex
+//!   vec3 pulled_0();             // read vertex gl_VertexID
+//!
+//! The return type is what a vertex shader input for the attribute
+//! would be, vecN for float and normalized attributes, ivecN or uvecN
+//! for integer ones.  Values are converted the way
+//! glVertexAttribPointer would convert them.
+//!
+//! Paste the source after a "#version 430" line or later, in place
+//! of the vertex shader inputs.
+//!
+//! \param attributes The attributes, with byte offsets into a vertex
+//! \param stride The size of one vertex in bytes
+//! \param binding The shader storage binding the vertices are bound to
+//! \param prefix Prefix for the generated names, unique per shader
+//!
+//! \returns the source, or an empty string if stride isn't a
+//!          multiple of four, an attribute isn't aligned to its
+//!          component size or its type can't be pulled (GL_DOUBLE,
+//!          GL_FIXED, and integer packed types)
+string fetch_source(std::span<const VertexAttribute> attributes,
+                    GLsizei stride, GLuint binding,
+                    const string &prefix = "pulled");
+
+//! Generate GLSL that reads vertices with a VertexLayout
+//!
+//! \param binding The shader storage binding the vertices are bound to
+//! \param prefix Prefix for the generated names, unique per shader
+template <typename Layout>
+string fetch_source(GLuint binding, const string &prefix = "pulled") {
+  static_assert(Layout::stride % 4 == 0,
+                "Pulled vertices are read as 32-bit words, pad the layout "
+                "to a multiple of four bytes");
+
+  return fetch_source(Layout::attributes, Layout::stride, binding, prefix);
+}
+
+} // namespace vertex_pulling
+
+using namespace vertex_pulling;
+
+//! A VertexPuller draws meshes whose vertices are read by the vertex
+//! shader instead of the fixed function vertex fetch.
+//!
+//! Every mesh normally needs its own VertexArrayObject, and switching
+//! between them is one of the more expensive state changes.  With
+//! vertex pulling the vertices live in a ShaderStorageBufferObject
+//! and the shader reads them with functions from fetch_source(),
+//! indexed by gl_VertexID.  The VertexPuller owns one empty vertex
+//! array object that is used for every draw, so meshes with
+//! different layouts only change a buffer binding.
+//!
+//! gl_VertexID includes first and base_vertex, so meshes can share
+//! one buffer and be drawn with base vertices, or batched with a
+//! DrawIndirectBuffer after bind() and bind_vertices().
+//!
+//! Shader storage buffers need OpenGL 4.3, check
+//! GLContext::supports(GLFeature::ShaderStorageBufferObject) first.
+#ifndef NO_EXCEPTIONS
+class VertexPuller : private MoveChecker {
+#else
+class VertexPuller : public Errors {
+#endif
+public:
+  //! Construct a vertex puller
+  //!
+  //! \param name The name of the vertex puller
+  //! \param ctx A pointer to the OpenGL context to use for OpenGL operations
+  //! \param binding The shader storage binding vertices are bound to,
+  //!                the binding passed to fetch_source()
+  //!
+  //! \throws a GenVertexArraysError if the empty vertex array object
+  //!         couldn't be generated.
+  VertexPuller(const string &name, const std::shared_ptr<GLContext> &ctx,
+               GLuint binding = 0);
+  ~VertexPuller();
+
+  //! Cleanup the vertex puller
+  //!
+  //! Deletes the empty vertex array object.
+  void cleanup() noexcept;
+
+  // Explicitly delete the generated default copy constructor
+  VertexPuller(const VertexPuller &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  VertexPuller &operator=(const VertexPuller &) = delete;
+
+  // move constructor
+  VertexPuller(VertexPuller &&) noexcept;
+
+  // move assignment operator
+  VertexPuller &operator=(VertexPuller &&) noexcept;
+
+  bool is_in_unspecified_state() const override;
+
+  //! Bind the empty vertex array object
+  //!
+  //! The draw functions do this themselves, call it before drawing
+  //! with something else such as a DrawIndirectBuffer.
+  void bind();
+
+  //! Bind the vertices of the next draws
+  //!
+  //! \param vertices The buffer holding the vertices
+  void bind_vertices(ShaderStorageBufferObject &vertices);
+
+  //! Bind part of a buffer as the vertices of the next draws
+  //!
+  //! \param vertices The buffer holding the vertices
+  //! \param offset The byte offset of the first vertex, a multiple of
+  //!               the buffer's offset alignment
+  //! \param size The size of the vertices in bytes
+  void bind_vertices(ShaderStorageBufferObject &vertices, GLintptr offset,
+                     GLsizeiptr size);
+
+  //! Draw count vertices starting at first
+  void draw_arrays(GLenum mode, GLint first, GLsizei count);
+
+  //! Draw instance_count instances of count vertices starting at
+  //! first
+  void draw_arrays_instanced(GLenum mode, GLint first, GLsizei count,
+                             GLsizei instance_count);
+
+  //! Draw with an index buffer
+  //!
+  //! The index buffer is bound to the empty vertex array object, the
+  //! shader reads the vertex each index selects.
+  //!
+  //! \param indices The index buffer
+  //! \param mode The primitive type, for example GL_TRIANGLES
+  //! \param base_vertex A constant added to every index
+  void draw_elements(IndexBufferObject &indices, GLenum mode,
+                     GLint base_vertex = 0);
+
+  //! The shader storage binding vertices are bound to
+  GLuint get_binding() const;
+
+private:
+  // Check the puller can be used and bind the vertex array object.
+  // Returns false on error in NO_EXCEPTIONS builds.
+  bool prepare_draw();
+
+  string name;
+
+  // The OpenGL context this puller uses
+  std::shared_ptr<GLContext> gl_context = nullptr;
+
+  GLuint binding = 0;
+
+  // The vertex array object with no attributes
+  GLuint VAO = 0;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -0,0 +1,452 @@
+#include <cstdint>
+#include <cstring>
+
+#include "async_readback.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::async_readback;
+
+// The row alignment glReadPixels uses unless GL_PACK_ALIGNMENT is
+// changed
+static constexpr GLsizeiptr pack_alignment = 4;
+
+AsyncReadback::AsyncReadback(const string &readback_name,
+                             const std::shared_ptr<GLContext> &ctx,
+                             GLsizeiptr capacity_)
+    : name{readback_name}, gl_context{ctx}, capacity{capacity_} {
+  if (capacity <= 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::ASYNC_READBACK::BUFFER_DATA_ERROR::INVALID_SIZE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  // GL_STREAM_READ, written by the GPU once and read back by the CPU
+  buffer.emplace(name, ctx, capacity, GL_STREAM_READ);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    cleanup();
+    return;
+  }
+#endif
+}
+
+AsyncReadback::~AsyncReadback() { cleanup(); }
+
+void AsyncReadback::cleanup() noexcept {
+  // Deleting the fence deletes its sync object
+  fence.reset();
+
+  // The VertexBufferObject deletes the OpenGL buffer
+  buffer.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+AsyncReadback::AsyncReadback(AsyncReadback &&readback) noexcept
+    : name{readback.name}, gl_context{readback.gl_context},
+      buffer{std::move(readback.buffer)}, fence{std::move(readback.fence)},
+      capacity{readback.capacity}, result_size{readback.result_size} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = readback.last_operation_failed;
+  last_error = readback.last_error;
+#endif
+
+  readback.gl_context = nullptr;
+  readback.buffer.reset();
+  readback.fence.reset();
+}
+
+// move assignment operator
+AsyncReadback &AsyncReadback::operator=(AsyncReadback &&readback) noexcept {
+  if (&readback != this) {
+    cleanup();
+
+    name = readback.name;
+    gl_context = readback.gl_context;
+    buffer = std::move(readback.buffer);
+    fence = std::move(readback.fence);
+    capacity = readback.capacity;
+    result_size = readback.result_size;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = readback.last_operation_failed;
+    last_error = readback.last_error;
+#endif
+
+    readback.gl_context = nullptr;
+    readback.buffer.reset();
+    readback.fence.reset();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool AsyncReadback::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || !buffer)
+    return true;
+  else
+    return false;
+}
+
+GLsizeiptr AsyncReadback::pixel_data_size(GLsizei width, GLsizei height,
+                                          GLenum format, GLenum type) {
+  if ((width < 0) || (height < 0))
+    return 0;
+
+  GLsizeiptr components = 0;
+  switch (format) {
+  case GL_RED:
+  case GL_GREEN:
+  case GL_BLUE:
+  case GL_RED_INTEGER:
+  case GL_DEPTH_COMPONENT:
+  case GL_STENCIL_INDEX:
+  case GL_DEPTH_STENCIL:
+    components = 1;
+    break;
+  case GL_RG:
+  case GL_RG_INTEGER:
+    components = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+  case GL_RGB_INTEGER:
+  case GL_BGR_INTEGER:
+    components = 3;
+    break;
+  case GL_RGBA:
+  case GL_BGRA:
+  case GL_RGBA_INTEGER:
+  case GL_BGRA_INTEGER:
+    components = 4;
+    break;
+  default:
+    return 0;
+  }
+
+  GLsizeiptr pixel_size = 0;
+  switch (type) {
+  case GL_UNSIGNED_BYTE:
+  case GL_BYTE:
+    pixel_size = components;
+    break;
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    pixel_size = components * 2;
+    break;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    pixel_size = components * 4;
+    break;
+  // Packed types hold a whole pixel
+  case GL_UNSIGNED_BYTE_3_3_2:
+  case GL_UNSIGNED_BYTE_2_3_3_REV:
+    pixel_size = 1;
+    break;
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_5_6_5_REV:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+  case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+    pixel_size = 2;
+    break;
+  case GL_UNSIGNED_INT_8_8_8_8:
+  case GL_UNSIGNED_INT_8_8_8_8_REV:
+  case GL_UNSIGNED_INT_10_10_10_2:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_24_8:
+  case GL_UNSIGNED_INT_10F_11F_11F_REV:
+  case GL_UNSIGNED_INT_5_9_9_9_REV:
+    pixel_size = 4;
+    break;
+  case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+    pixel_size = 8;
+    break;
+  default:
+    return 0;
+  }
+
+  GLsizeiptr row_size = static_cast<GLsizeiptr>(width) * pixel_size;
+  row_size = (row_size + pack_alignment - 1) / pack_alignment * pack_alignment;
+
+  return row_size * height;
+}
+
+bool AsyncReadback::fence_read(GLsizeiptr read_size) {
+  result_size = 0;
+
+#ifndef NO_EXCEPTIONS
+  try {
+    fence.emplace(gl_context);
+  } catch (const FenceSyncError &) {
+    throw ReadbackFenceError("ERROR::ASYNC_READBACK::FENCE_SYNC_FAILED");
+  }
+#else
+  fence.emplace(gl_context);
+
+  if (!fence->valid()) {
+    set_error(fence->get_last_error());
+    fence.reset();
+    return false;
+  }
+#endif
+
+  result_size = read_size;
+
+  return true;
+}
+
+void AsyncReadback::read_pixels(GLint x, GLint y, GLsizei width,
+                                GLsizei height, GLenum format, GLenum type) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw AsyncReadbackUnspecifiedStateError(
+        "Async Readback is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  GLsizeiptr read_size = pixel_data_size(width, height, format, type);
+
+  if ((read_size == 0) || (read_size > capacity)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::ASYNC_READBACK::BUFFER_DATA_ERROR::INVALID_PIXELS");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  // Discard any pending read, its result would be overwritten
+  fence.reset();
+
+  // With a pixel pack buffer bound the pixels pointer is an offset
+  // into the buffer and glReadPixels returns without waiting
+  buffer->bind(GL_PIXEL_PACK_BUFFER);
+  gl_context->glReadPixels(x, y, width, height, format, type, nullptr);
+  gl_context->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (!fence_read(read_size))
+    return;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void AsyncReadback::read_buffer(VertexBufferObject &source, GLintptr offset,
+                                GLsizeiptr read_size) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw AsyncReadbackUnspecifiedStateError(
+        "Async Readback is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if ((offset < 0) || (read_size <= 0) || (read_size > capacity) ||
+      (offset > source.get_size() - read_size)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::ASYNC_READBACK::BUFFER_DATA_ERROR::INVALID_RANGE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  fence.reset();
+
+  // A GPU side copy, glGetBufferSubData on source would wait for
+  // every command writing it
+  source.bind(GL_COPY_READ_BUFFER);
+  buffer->bind(GL_COPY_WRITE_BUFFER);
+  gl_context->glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                  offset, 0, read_size);
+  gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  gl_context->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  if (!fence_read(read_size))
+    return;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+bool AsyncReadback::wait_for_fence() {
+  if (!fence)
+    return true;
+
+  bool waited = true;
+
+#ifndef NO_EXCEPTIONS
+  try {
+    fence->wait();
+  } catch (const FenceSyncError &) {
+    waited = false;
+  }
+#else
+  fence->wait();
+  waited = fence->valid();
+#endif
+
+  fence.reset();
+
+  return waited;
+}
+
+bool AsyncReadback::is_ready() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw AsyncReadbackUnspecifiedStateError(
+        "Async Readback is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  if (result_size == 0)
+    return false;
+
+  if (!fence)
+    return true;
+
+  bool signaled = false;
+  bool failed = false;
+
+#ifndef NO_EXCEPTIONS
+  try {
+    signaled = fence->is_signaled();
+  } catch (const FenceSyncError &) {
+    failed = true;
+  }
+#else
+  signaled = fence->is_signaled();
+  failed = !fence->valid();
+#endif
+
+  if (!signaled && !failed)
+    return false;
+
+  fence.reset();
+
+  if (failed) {
+    result_size = 0;
+#ifndef NO_EXCEPTIONS
+    throw ReadbackFenceError("ERROR::ASYNC_READBACK::CLIENT_WAIT_SYNC_FAILED");
+#else
+    set_error(std::optional<error>(error::FenceSyncError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void AsyncReadback::wait() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw AsyncReadbackUnspecifiedStateError(
+        "Async Readback is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if (result_size == 0) {
+#ifndef NO_EXCEPTIONS
+    throw ReadbackNotStartedError("ERROR::ASYNC_READBACK::NOT_STARTED");
+#else
+    set_error(std::optional<error>(error::ReadbackNotStartedError));
+    return;
+#endif
+  }
+
+  if (!wait_for_fence()) {
+    result_size = 0;
+#ifndef NO_EXCEPTIONS
+    throw ReadbackFenceError("ERROR::ASYNC_READBACK::CLIENT_WAIT_SYNC_FAILED");
+#else
+    set_error(std::optional<error>(error::FenceSyncError));
+    return;
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+std::span<std::byte> AsyncReadback::get(std::span<std::byte> destination) {
+  wait();
+
+#ifdef NO_EXCEPTIONS
+  if (!valid())
+    return {};
+#endif
+
+  if (destination.size() < static_cast<size_t>(result_size)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::ASYNC_READBACK::BUFFER_DATA_ERROR::DESTINATION_TOO_SMALL");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return {};
+#endif
+  }
+
+  // GL_COPY_READ_BUFFER leaves the pixel pack state alone
+  buffer->bind(GL_COPY_READ_BUFFER);
+
+  const void *mapped = gl_context->glMapBufferRange(
+      GL_COPY_READ_BUFFER, 0, result_size, GL_MAP_READ_BIT);
+
+  bool copied = false;
+  if (mapped != nullptr) {
+    std::memcpy(destination.data(), mapped, static_cast<size_t>(result_size));
+    copied = (gl_context->glUnmapBuffer(GL_COPY_READ_BUFFER) == GL_TRUE);
+  }
+
+  gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+  if (!copied) {
+#ifndef NO_EXCEPTIONS
+    throw ReadbackMapError("ERROR::ASYNC_READBACK::MAP_BUFFER_FAILED");
+#else
+    set_error(std::optional<error>(error::MapBufferError));
+    return {};
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return destination.first(static_cast<size_t>(result_size));
+}
+
+GLsizeiptr AsyncReadback::get_result_size() const { return result_size; }
+
+GLsizeiptr AsyncReadback::get_capacity() const { return capacity; }
@@ -0,0 +1,418 @@
+#include <algorithm>
+
+#include "buffer_arena.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::buffer_arena;
+
+// Limit the allocator bookkeeping for very large pages.  Every node
+// covers at least one vertex, so pages smaller than this can never
+// run out of nodes.
+static constexpr uint32_t max_allocations_per_page = 64 * 1024;
+
+BufferArena::BufferArena(const string &arena_name,
+                         const std::shared_ptr<GLContext> &ctx,
+                         GLsizei vertex_stride_, uint32_t page_vertices_,
+                         GLenum usage_)
+    : name{arena_name}, gl_context{ctx}, vertex_stride{vertex_stride_},
+      page_vertices{page_vertices_}, usage{usage_} {
+  if ((vertex_stride <= 0) || (page_vertices == 0) ||
+      (page_vertices > static_cast<uint32_t>(
+                           std::numeric_limits<GLint>::max())) ||
+      (static_cast<GLsizeiptr>(page_vertices) >
+       std::numeric_limits<GLsizeiptr>::max() / vertex_stride)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::BUFFER_ARENA::BUFFER_DATA_ERROR::INVALID_SIZE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+}
+
+BufferArena::~BufferArena() { cleanup(); }
+
+void BufferArena::cleanup() noexcept {
+  // The page buffers delete their OpenGL buffers
+  pages.clear();
+  slots.clear();
+  free_slots.clear();
+  gl_context = nullptr;
+}
+
+// move constructor
+BufferArena::BufferArena(BufferArena &&arena) noexcept
+    : name{arena.name}, gl_context{arena.gl_context},
+      vertex_stride{arena.vertex_stride}, page_vertices{arena.page_vertices},
+      usage{arena.usage}, pages{std::move(arena.pages)},
+      slots{std::move(arena.slots)}, free_slots{std::move(arena.free_slots)} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = arena.last_operation_failed;
+  last_error = arena.last_error;
+#endif
+
+  arena.gl_context = nullptr;
+  arena.pages.clear();
+  arena.slots.clear();
+  arena.free_slots.clear();
+}
+
+// move assignment operator
+BufferArena &BufferArena::operator=(BufferArena &&arena) noexcept {
+  if (&arena != this) {
+    cleanup();
+
+    name = arena.name;
+    gl_context = arena.gl_context;
+    vertex_stride = arena.vertex_stride;
+    page_vertices = arena.page_vertices;
+    usage = arena.usage;
+    pages = std::move(arena.pages);
+    slots = std::move(arena.slots);
+    free_slots = std::move(arena.free_slots);
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = arena.last_operation_failed;
+    last_error = arena.last_error;
+#endif
+
+    arena.gl_context = nullptr;
+    arena.pages.clear();
+    arena.slots.clear();
+    arena.free_slots.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool BufferArena::is_in_unspecified_state() const {
+  if (gl_context == nullptr)
+    return true;
+  else
+    return false;
+}
+
+BufferArena::Handle BufferArena::allocate(std::span<const std::byte> vertices) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferArenaUnspecifiedStateError(
+        "Buffer Arena is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return {};
+#endif
+  }
+
+  if (vertices.empty() ||
+      (vertices.size() % static_cast<size_t>(vertex_stride) != 0)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::BUFFER_ARENA::BUFFER_DATA_ERROR::PARTIAL_VERTEX");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return {};
+#endif
+  }
+
+  size_t vertex_count = vertices.size() / static_cast<size_t>(vertex_stride);
+
+  if (vertex_count > page_vertices) {
+#ifndef NO_EXCEPTIONS
+    throw ArenaAllocationError("ERROR::BUFFER_ARENA::ALLOCATION_TOO_LARGE");
+#else
+    set_error(std::optional<error>(error::ArenaAllocationError));
+    return {};
+#endif
+  }
+
+  // First fit over the pages, each allocator is O(1)
+  GLuint page_index = 0;
+  OffsetAllocator::Allocation allocation;
+  for (; page_index < pages.size(); page_index++) {
+    allocation = pages[page_index]->allocator.allocate(
+        static_cast<uint32_t>(vertex_count));
+    if (allocation.offset != OffsetAllocator::no_space)
+      break;
+  }
+
+  if (page_index == pages.size()) {
+    // Allocated from before the page buffer is created, so a mesh the
+    // allocator can't serve doesn't leave an empty page behind
+    OffsetAllocator allocator(
+        page_vertices, std::min(page_vertices, max_allocations_per_page));
+    allocation = allocator.allocate(static_cast<uint32_t>(vertex_count));
+
+    if (allocation.offset == OffsetAllocator::no_space) {
+#ifndef NO_EXCEPTIONS
+      throw ArenaAllocationError("ERROR::BUFFER_ARENA::ALLOCATION_TOO_LARGE");
+#else
+      set_error(std::optional<error>(error::ArenaAllocationError));
+      return {};
+#endif
+    }
+
+    GLsizeiptr page_size =
+        static_cast<GLsizeiptr>(page_vertices) * vertex_stride;
+
+    auto page = std::make_unique<Page>(Page{
+        VertexBufferObject(name + "-page-" + std::to_string(page_index),
+                           gl_context, page_size, usage),
+        std::move(allocator)});
+
+#ifdef NO_EXCEPTIONS
+    if (!page->buffer.valid()) {
+      set_error(page->buffer.get_last_error());
+      return {};
+    }
+#endif
+
+    pages.push_back(std::move(page));
+  }
+
+  Page &page = *pages[page_index];
+
+  page.buffer.update(static_cast<GLintptr>(allocation.offset) * vertex_stride,
+                     vertices);
+
+#ifdef NO_EXCEPTIONS
+  if (!page.buffer.valid()) {
+    page.allocator.free(allocation);
+    set_error(page.buffer.get_last_error());
+    return {};
+  }
+#endif
+
+  page.live_allocations++;
+
+  uint32_t slot_index;
+  if (!free_slots.empty()) {
+    slot_index = free_slots.back();
+    free_slots.pop_back();
+  } else {
+    slot_index = static_cast<uint32_t>(slots.size());
+    slots.emplace_back();
+  }
+
+  Slot &slot = slots[slot_index];
+  slot.page = page_index;
+  slot.allocation = allocation;
+  slot.vertex_count = static_cast<uint32_t>(vertex_count);
+  slot.live = true;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return {slot_index, slot.generation};
+}
+
+const BufferArena::Slot *BufferArena::find_slot(Handle handle) const {
+  if (handle.index >= slots.size())
+    return nullptr;
+
+  const Slot &slot = slots[handle.index];
+
+  if (!slot.live || (slot.generation != handle.generation))
+    return nullptr;
+
+  return &slot;
+}
+
+void BufferArena::free(Handle handle) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferArenaUnspecifiedStateError(
+        "Buffer Arena is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if (find_slot(handle) == nullptr) {
+#ifndef NO_EXCEPTIONS
+    throw InvalidArenaHandleError("ERROR::BUFFER_ARENA::INVALID_HANDLE");
+#else
+    set_error(std::optional<error>(error::InvalidHandleError));
+    return;
+#endif
+  }
+
+  Slot &slot = slots[handle.index];
+  Page &page = *pages[slot.page];
+
+  page.allocator.free(slot.allocation);
+  page.live_allocations--;
+
+  // Bump the generation so stale copies of the handle are rejected
+  slot.live = false;
+  slot.generation++;
+  free_slots.push_back(handle.index);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+std::optional<BufferArena::Range> BufferArena::get(Handle handle) const {
+  const Slot *slot = find_slot(handle);
+
+  if (slot == nullptr)
+    return std::nullopt;
+
+  return Range{slot->page, static_cast<GLint>(slot->allocation.offset),
+               static_cast<GLsizei>(slot->vertex_count)};
+}
+
+VertexBufferObject *BufferArena::page_buffer(GLuint page) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferArenaUnspecifiedStateError(
+        "Buffer Arena is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return nullptr;
+#endif
+  }
+
+  if (page >= pages.size()) {
+#ifndef NO_EXCEPTIONS
+    throw InvalidArenaHandleError("ERROR::BUFFER_ARENA::INVALID_PAGE");
+#else
+    set_error(std::optional<error>(error::InvalidHandleError));
+    return nullptr;
+#endif
+  }
+
+  return &pages[page]->buffer;
+}
+
+size_t BufferArena::page_count() const { return pages.size(); }
+
+GLsizei BufferArena::get_vertex_stride() const { return vertex_stride; }
+
+void BufferArena::defragment() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferArenaUnspecifiedStateError(
+        "Buffer Arena is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  for (GLuint page = 0; page < pages.size(); page++) {
+    defragment_page(page);
+
+#ifdef NO_EXCEPTIONS
+    if (last_operation_failed)
+      return;
+#endif
+  }
+
+  // Release empty pages at the end, earlier ones keep their index
+  while (!pages.empty() && (pages.back()->live_allocations == 0))
+    pages.pop_back();
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void BufferArena::defragment_page(GLuint page_index) {
+  Page &page = *pages[page_index];
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  // Live slots in this page, in offset order
+  std::vector<uint32_t> live;
+  for (uint32_t i = 0; i < slots.size(); i++) {
+    if (slots[i].live && (slots[i].page == page_index))
+      live.push_back(i);
+  }
+
+  std::sort(live.begin(), live.end(), [this](uint32_t a, uint32_t b) {
+    return slots[a].allocation.offset < slots[b].allocation.offset;
+  });
+
+  // Already packed at the start of the page?
+  uint32_t packed_vertices = 0;
+  bool packed = true;
+  for (uint32_t i : live) {
+    if (slots[i].allocation.offset != packed_vertices)
+      packed = false;
+    packed_vertices += slots[i].vertex_count;
+  }
+
+  if (packed)
+    return;
+
+  GLsizeiptr used_bytes =
+      static_cast<GLsizeiptr>(packed_vertices) * vertex_stride;
+
+  // glCopyBufferSubData can't copy between overlapping ranges of the
+  // same buffer, so pack into a staging buffer and copy back
+  VertexBufferObject staging(name + "-defragment", gl_context, used_bytes,
+                             GL_STREAM_COPY);
+
+#ifdef NO_EXCEPTIONS
+  if (!staging.valid()) {
+    set_error(staging.get_last_error());
+    return;
+  }
+#endif
+
+  page.buffer.bind(GL_COPY_READ_BUFFER);
+  staging.bind(GL_COPY_WRITE_BUFFER);
+
+  GLintptr write_offset = 0;
+  for (uint32_t i : live) {
+    GLsizeiptr bytes =
+        static_cast<GLsizeiptr>(slots[i].vertex_count) * vertex_stride;
+
+    gl_context->glCopyBufferSubData(
+        GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+        static_cast<GLintptr>(slots[i].allocation.offset) * vertex_stride,
+        write_offset, bytes);
+
+    write_offset += bytes;
+  }
+
+  staging.bind(GL_COPY_READ_BUFFER);
+  page.buffer.bind(GL_COPY_WRITE_BUFFER);
+
+  gl_context->glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                                  0, used_bytes);
+
+  gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  gl_context->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  // Allocating from an empty allocator in order hands out
+  // consecutive offsets from 0, matching the packed layout
+  page.allocator.reset();
+  for (uint32_t i : live)
+    slots[i].allocation = page.allocator.allocate(slots[i].vertex_count);
+}
+
+BufferArena::Stats BufferArena::stats() const {
+  Stats result{pages.size(), slots.size() - free_slots.size(), 0, 0};
+
+  for (const std::unique_ptr<Page> &page : pages) {
+    GLsizeiptr free_bytes =
+        static_cast<GLsizeiptr>(page->allocator.storage_report()
+                                    .total_free_space) *
+        vertex_stride;
+    GLsizeiptr page_bytes = static_cast<GLsizeiptr>(page_vertices) *
+                            vertex_stride;
+
+    result.free_bytes += free_bytes;
+    result.used_bytes += page_bytes - free_bytes;
+  }
+
+  return result;
+}
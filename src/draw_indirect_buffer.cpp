@@ -0,0 +1,344 @@
+#include <cstdint>
+
+#include "draw_indirect_buffer.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::draw_indirect_buffer;
+
+DrawIndirectBuffer::DrawIndirectBuffer(const string &buffer_name,
+                                       const std::shared_ptr<GLContext> &ctx,
+                                       size_t command_capacity)
+    : name{buffer_name}, gl_context{ctx}, capacity{command_capacity} {
+  if (capacity == 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::DRAW_INDIRECT_BUFFER::BUFFER_DATA_ERROR::NO_CAPACITY");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  arrays_commands.reserve(capacity);
+  elements_commands.reserve(capacity);
+
+  if (gl_context->supports(GLFeature::MultiDrawIndirect)) {
+    size_t command_size =
+        sizeof(DrawArraysIndirectCommand) + sizeof(DrawElementsIndirectCommand);
+    GLsizeiptr size = static_cast<GLsizeiptr>(capacity * command_size);
+
+    buffer.emplace(name, ctx, size, GL_DYNAMIC_DRAW);
+
+#ifdef NO_EXCEPTIONS
+    if (!buffer->valid()) {
+      set_error(buffer->get_last_error());
+      cleanup();
+      return;
+    }
+#endif
+  } else {
+    fallback_firsts.reserve(capacity);
+    fallback_counts.reserve(capacity);
+    fallback_indices.reserve(capacity);
+    fallback_base_vertices.reserve(capacity);
+  }
+}
+
+DrawIndirectBuffer::~DrawIndirectBuffer() { cleanup(); }
+
+void DrawIndirectBuffer::cleanup() noexcept {
+  // The VertexBufferObject deletes the OpenGL buffer
+  buffer.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+DrawIndirectBuffer::DrawIndirectBuffer(DrawIndirectBuffer &&dib) noexcept
+    : name{dib.name}, gl_context{dib.gl_context}, capacity{dib.capacity},
+      buffer{std::move(dib.buffer)},
+      arrays_commands{std::move(dib.arrays_commands)},
+      elements_commands{std::move(dib.elements_commands)},
+      arrays_dirty{dib.arrays_dirty}, elements_dirty{dib.elements_dirty},
+      fallback_firsts{std::move(dib.fallback_firsts)},
+      fallback_counts{std::move(dib.fallback_counts)},
+      fallback_indices{std::move(dib.fallback_indices)},
+      fallback_base_vertices{std::move(dib.fallback_base_vertices)} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = dib.last_operation_failed;
+  last_error = dib.last_error;
+#endif
+
+  dib.gl_context = nullptr;
+  dib.buffer.reset();
+}
+
+// move assignment operator
+DrawIndirectBuffer &
+DrawIndirectBuffer::operator=(DrawIndirectBuffer &&dib) noexcept {
+  if (&dib != this) {
+    cleanup();
+
+    name = dib.name;
+    gl_context = dib.gl_context;
+    capacity = dib.capacity;
+    buffer = std::move(dib.buffer);
+    arrays_commands = std::move(dib.arrays_commands);
+    elements_commands = std::move(dib.elements_commands);
+    arrays_dirty = dib.arrays_dirty;
+    elements_dirty = dib.elements_dirty;
+    fallback_firsts = std::move(dib.fallback_firsts);
+    fallback_counts = std::move(dib.fallback_counts);
+    fallback_indices = std::move(dib.fallback_indices);
+    fallback_base_vertices = std::move(dib.fallback_base_vertices);
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = dib.last_operation_failed;
+    last_error = dib.last_error;
+#endif
+
+    dib.gl_context = nullptr;
+    dib.buffer.reset();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool DrawIndirectBuffer::is_in_unspecified_state() const {
+  if (gl_context == nullptr)
+    return true;
+  else
+    return false;
+}
+
+void DrawIndirectBuffer::add(const DrawArraysIndirectCommand &command) {
+  if (arrays_commands.size() >= capacity) {
+#ifndef NO_EXCEPTIONS
+    throw CommandBufferFullError("ERROR::DRAW_INDIRECT_BUFFER::FULL");
+#else
+    set_error(std::optional<error>(error::CommandBufferFullError));
+    return;
+#endif
+  }
+
+  arrays_commands.push_back(command);
+  arrays_dirty = true;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void DrawIndirectBuffer::add(const DrawElementsIndirectCommand &command) {
+  if (elements_commands.size() >= capacity) {
+#ifndef NO_EXCEPTIONS
+    throw CommandBufferFullError("ERROR::DRAW_INDIRECT_BUFFER::FULL");
+#else
+    set_error(std::optional<error>(error::CommandBufferFullError));
+    return;
+#endif
+  }
+
+  elements_commands.push_back(command);
+  elements_dirty = true;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void DrawIndirectBuffer::clear() {
+  arrays_commands.clear();
+  elements_commands.clear();
+  arrays_dirty = true;
+  elements_dirty = true;
+}
+
+void DrawIndirectBuffer::upload(GLintptr offset,
+                                std::span<const std::byte> commands,
+                                bool &dirty) {
+  // Static command lists are uploaded once
+  if (dirty) {
+    buffer->update(offset, commands);
+    dirty = false;
+  }
+
+  buffer->bind(GL_DRAW_INDIRECT_BUFFER);
+}
+
+bool DrawIndirectBuffer::check_base_instance(GLuint base_instance) {
+  // glDrawArraysInstancedBaseInstance is OpenGL 4.2, the fallback
+  // has no way to offset instanced attributes
+  if (base_instance != 0) {
+#ifndef NO_EXCEPTIONS
+    throw BaseInstanceNotSupportedError(
+        "ERROR::DRAW_INDIRECT_BUFFER::BASE_INSTANCE_NOT_SUPPORTED");
+#else
+    set_error(std::optional<error>(error::FeatureNotSupportedError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void DrawIndirectBuffer::draw_arrays(GLenum mode) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw DrawIndirectBufferUnspecifiedStateError(
+        "Draw Indirect Buffer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  GLsizei draw_count = static_cast<GLsizei>(arrays_commands.size());
+
+  if (draw_count == 0)
+    return;
+
+  if (buffer) {
+    upload(0, std::as_bytes(std::span(arrays_commands)), arrays_dirty);
+
+    gl_context->glMultiDrawArraysIndirect(mode, nullptr, draw_count, 0);
+    gl_context->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+    return;
+  }
+
+  fallback_firsts.clear();
+  fallback_counts.clear();
+  bool single_instances = true;
+
+  for (const DrawArraysIndirectCommand &command : arrays_commands) {
+    if (!check_base_instance(command.base_instance))
+      return;
+
+    if (command.instance_count > 1)
+      single_instances = false;
+
+    // A command with no instances draws nothing
+    if (command.instance_count == 0)
+      continue;
+
+    fallback_firsts.push_back(static_cast<GLint>(command.first));
+    fallback_counts.push_back(static_cast<GLsizei>(command.count));
+  }
+
+  if (single_instances) {
+    gl_context->glMultiDrawArrays(
+        mode, fallback_firsts.data(), fallback_counts.data(),
+        static_cast<GLsizei>(fallback_counts.size()));
+  } else {
+    for (const DrawArraysIndirectCommand &command : arrays_commands)
+      if (command.instance_count != 0)
+        gl_context->glDrawArraysInstanced(
+            mode, static_cast<GLint>(command.first),
+            static_cast<GLsizei>(command.count),
+            static_cast<GLsizei>(command.instance_count));
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void DrawIndirectBuffer::draw_elements(GLenum mode, GLenum index_type) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw DrawIndirectBufferUnspecifiedStateError(
+        "Draw Indirect Buffer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  GLsizei draw_count = static_cast<GLsizei>(elements_commands.size());
+
+  if (draw_count == 0)
+    return;
+
+  if (buffer) {
+    // The indexed commands follow capacity non-indexed ones
+    GLintptr offset =
+        static_cast<GLintptr>(capacity * sizeof(DrawArraysIndirectCommand));
+
+    upload(offset, std::as_bytes(std::span(elements_commands)),
+           elements_dirty);
+
+    gl_context->glMultiDrawElementsIndirect(
+        mode, index_type,
+        reinterpret_cast<const void *>(static_cast<std::uintptr_t>(offset)),
+        draw_count, 0);
+    gl_context->glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+    return;
+  }
+
+  size_t index_size =
+      (index_type == GL_UNSIGNED_SHORT) ? sizeof(GLushort) : sizeof(GLuint);
+
+  fallback_counts.clear();
+  fallback_indices.clear();
+  fallback_base_vertices.clear();
+  bool single_instances = true;
+
+  for (const DrawElementsIndirectCommand &command : elements_commands) {
+    if (!check_base_instance(command.base_instance))
+      return;
+
+    if (command.instance_count > 1)
+      single_instances = false;
+
+    if (command.instance_count == 0)
+      continue;
+
+    fallback_counts.push_back(static_cast<GLsizei>(command.count));
+    fallback_indices.push_back(reinterpret_cast<const void *>(
+        static_cast<std::uintptr_t>(command.first_index * index_size)));
+    fallback_base_vertices.push_back(command.base_vertex);
+  }
+
+  if (single_instances) {
+    gl_context->glMultiDrawElementsBaseVertex(
+        mode, fallback_counts.data(), index_type, fallback_indices.data(),
+        static_cast<GLsizei>(fallback_counts.size()),
+        fallback_base_vertices.data());
+  } else {
+    for (const DrawElementsIndirectCommand &command : elements_commands)
+      if (command.instance_count != 0)
+        gl_context->glDrawElementsInstancedBaseVertex(
+            mode, static_cast<GLsizei>(command.count), index_type,
+            reinterpret_cast<const void *>(
+                static_cast<std::uintptr_t>(command.first_index * index_size)),
+            static_cast<GLsizei>(command.instance_count), command.base_vertex);
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+std::span<const DrawArraysIndirectCommand>
+DrawIndirectBuffer::get_arrays_commands() const {
+  return arrays_commands;
+}
+
+std::span<const DrawElementsIndirectCommand>
+DrawIndirectBuffer::get_elements_commands() const {
+  return elements_commands;
+}
+
+size_t DrawIndirectBuffer::get_capacity() const { return capacity; }
+
+bool DrawIndirectBuffer::uses_indirect_buffer() const {
+  return buffer.has_value();
+}
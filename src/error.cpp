@@ -17,6 +17,9 @@ std::string sdl_opengl_cpp::error_as_string(const error &e) {
   case error::UnspecifiedStateError:
     error_string = "UnspecifiedStateError";
     break;
+  case error::FeatureNotSupportedError:
+    error_string = "FeatureNotSupportedError";
+    break;
 
   case error::BufferDataError:
     error_string = "BufferDataError";
@@ -24,6 +27,21 @@ std::string sdl_opengl_cpp::error_as_string(const error &e) {
   case error::GenBuffersError:
     error_string = "GenBuffersError";
     break;
+  case error::OutOfMemoryError:
+    error_string = "OutOfMemoryError";
+    break;
+  case error::MapBufferError:
+    error_string = "MapBufferError";
+    break;
+  case error::ArenaAllocationError:
+    error_string = "ArenaAllocationError";
+    break;
+  case error::InvalidHandleError:
+    error_string = "InvalidHandleError";
+    break;
+  case error::CommandBufferFullError:
+    error_string = "CommandBufferFullError";
+    break;
   case error::InvalidOperationError:
     error_string = "InvalidOperationError";
     break;
@@ -32,6 +50,21 @@ std::string sdl_opengl_cpp::error_as_string(const error &e) {
     error_string = "GenVertexArraysError";
     break;
 
+  case error::GenTexturesError:
+    error_string = "GenTexturesError";
+    break;
+  case error::TextureDataError:
+    error_string = "TextureDataError";
+    break;
+
+  case error::FenceSyncError:
+    error_string = "FenceSyncError";
+    break;
+
+  case error::ReadbackNotStartedError:
+    error_string = "ReadbackNotStartedError";
+    break;
+
   case error::ShaderCreationError:
     error_string = "ShaderCreationError";
     break;
@@ -48,6 +81,9 @@ std::string sdl_opengl_cpp::error_as_string(const error &e) {
   case error::GetUniformLocationError:
     error_string = "GetUniformLocationError";
     break;
+  case error::GetUniformBlockIndexError:
+    error_string = "GetUniformBlockIndexError";
+    break;
 
   default:
     error_string = "Unknown error type";
@@ -8,7 +8,7 @@ using namespace sdl_opengl_cpp;
 
 Errors::Errors() {}
 
-bool Errors::valid() {
+bool Errors::valid() const {
   // Here, ! is operating on the std::optional to test if it has been
   // set or is std::nullopt
   // if (!last_operation_failed) {
@@ -25,7 +25,7 @@ bool Errors::valid() {
   return !last_operation_failed;
 }
 
-std::optional<error> Errors::get_last_error() {
+std::optional<error> Errors::get_last_error() const {
   if (is_in_unspecified_state()) {
     if (!last_error) {
       // last_error hasn't been set yet.  There wasn't an error that
@@ -40,7 +40,7 @@ std::optional<error> Errors::get_last_error() {
   return last_error;
 }
 
-bool Errors::set_error(const std::optional<error> &error) {
+bool Errors::set_error(const std::optional<error> &error) const {
   bool state_changed = false;
 
   if (last_error != error) {
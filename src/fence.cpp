@@ -0,0 +1,127 @@
+#include "fence.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::fence;
+
+// How long to block in each glClientWaitSync call made by wait(), in
+// nanoseconds.  We keep waiting after a timeout, the GPU will
+// eventually finish.
+static constexpr GLuint64 fence_wait_timeout = 1000000000;
+
+Fence::Fence(const std::shared_ptr<GLContext> &ctx) : gl_context{ctx} {
+  sync = gl_context->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  if (sync == nullptr) {
+#ifndef NO_EXCEPTIONS
+    cleanup();
+    throw FenceSyncError("ERROR::FENCE::FENCE_SYNC_FAILED");
+#else
+    set_error(std::optional<error>(error::FenceSyncError));
+    cleanup();
+    return;
+#endif
+  }
+}
+
+Fence::~Fence() { cleanup(); }
+
+void Fence::cleanup() noexcept {
+  if ((gl_context != nullptr) && (sync != nullptr))
+    gl_context->glDeleteSync(sync);
+
+  sync = nullptr;
+  gl_context = nullptr;
+}
+
+// move constructor
+Fence::Fence(Fence &&fence) noexcept
+    : gl_context{fence.gl_context}, sync{fence.sync}, flushed{fence.flushed},
+      signaled{fence.signaled} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = fence.last_operation_failed;
+  last_error = fence.last_error;
+#endif
+
+  fence.gl_context = nullptr;
+  fence.sync = nullptr;
+}
+
+// move assignment operator
+Fence &Fence::operator=(Fence &&fence) noexcept {
+  if (&fence != this) {
+    cleanup();
+
+    gl_context = fence.gl_context;
+    sync = fence.sync;
+    flushed = fence.flushed;
+    signaled = fence.signaled;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = fence.last_operation_failed;
+    last_error = fence.last_error;
+#endif
+
+    fence.gl_context = nullptr;
+    fence.sync = nullptr;
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool Fence::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (sync == nullptr))
+    return true;
+  else
+    return false;
+}
+
+bool Fence::client_wait(GLuint64 timeout) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw FenceUnspecifiedStateError("Fence is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  if (signaled)
+    return true;
+
+  // Flush on the first wait so the fence is guaranteed to be
+  // submitted, otherwise we could wait forever
+  GLbitfield flags = flushed ? 0 : GL_SYNC_FLUSH_COMMANDS_BIT;
+  GLenum result = gl_context->glClientWaitSync(sync, flags, timeout);
+  flushed = true;
+
+  if (result == GL_WAIT_FAILED) {
+#ifndef NO_EXCEPTIONS
+    throw FenceSyncError("ERROR::FENCE::CLIENT_WAIT_SYNC_FAILED");
+#else
+    set_error(std::optional<error>(error::FenceSyncError));
+    return false;
+#endif
+  }
+
+  signaled = (result != GL_TIMEOUT_EXPIRED);
+
+  return signaled;
+}
+
+bool Fence::is_signaled() {
+  // A zero timeout only polls
+  return client_wait(0);
+}
+
+void Fence::wait() {
+  while (!client_wait(fence_wait_timeout)) {
+#ifdef NO_EXCEPTIONS
+    if (!valid())
+      return;
+#endif
+  }
+}
@@ -0,0 +1,269 @@
+#include <cstring>
+#include <vector>
+
+#include "geometry_cache.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::geometry_cache;
+
+// XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+namespace {
+
+constexpr std::uint64_t prime1 = 0x9e3779b185ebca87ULL;
+constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4fULL;
+constexpr std::uint64_t prime3 = 0x165667b19e3779f9ULL;
+constexpr std::uint64_t prime4 = 0x85ebca77c2b2ae63ULL;
+constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5ULL;
+
+inline std::uint64_t rotl(std::uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline std::uint64_t read64(const std::byte *p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline std::uint32_t read32(const std::byte *p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline std::uint64_t mix_round(std::uint64_t accumulator,
+                               std::uint64_t input) {
+  accumulator += input * prime2;
+  accumulator = rotl(accumulator, 31);
+  return accumulator * prime1;
+}
+
+inline std::uint64_t merge(std::uint64_t accumulator, std::uint64_t value) {
+  accumulator ^= mix_round(0, value);
+  return accumulator * prime1 + prime4;
+}
+
+} // namespace
+
+GeometryCache::GeometryCache(const string &cache_name,
+                             const std::shared_ptr<GLContext> &ctx,
+                             GLenum usage_)
+    : name{cache_name}, gl_context{ctx}, usage{usage_} {}
+
+GeometryCache::~GeometryCache() { cleanup(); }
+
+void GeometryCache::cleanup() noexcept {
+  // Handles own the buffers, only the table goes
+  entries.clear();
+  gl_context = nullptr;
+}
+
+// move constructor
+GeometryCache::GeometryCache(GeometryCache &&cache) noexcept
+    : name{cache.name}, gl_context{cache.gl_context}, usage{cache.usage},
+      entries{std::move(cache.entries)}, hit_count{cache.hit_count},
+      miss_count{cache.miss_count}, bytes_saved{cache.bytes_saved} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = cache.last_operation_failed;
+  last_error = cache.last_error;
+#endif
+
+  cache.gl_context = nullptr;
+  cache.entries.clear();
+}
+
+// move assignment operator
+GeometryCache &GeometryCache::operator=(GeometryCache &&cache) noexcept {
+  if (&cache != this) {
+    cleanup();
+
+    name = cache.name;
+    gl_context = cache.gl_context;
+    usage = cache.usage;
+    entries = std::move(cache.entries);
+    hit_count = cache.hit_count;
+    miss_count = cache.miss_count;
+    bytes_saved = cache.bytes_saved;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = cache.last_operation_failed;
+    last_error = cache.last_error;
+#endif
+
+    cache.gl_context = nullptr;
+    cache.entries.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool GeometryCache::is_in_unspecified_state() const {
+  if (gl_context == nullptr)
+    return true;
+  else
+    return false;
+}
+
+bool GeometryCache::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw GeometryCacheUnspecifiedStateError(
+        "Geometry Cache is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+GeometryCache::Handle
+GeometryCache::acquire(const string &buffer_name,
+                       std::span<const std::byte> vertices,
+                       std::uint64_t layout_key) {
+  if (!check_state())
+    return nullptr;
+
+  if (vertices.empty()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::GEOMETRY_CACHE::BUFFER_DATA_ERROR::EMPTY_VERTICES");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return nullptr;
+#endif
+  }
+
+  GLsizeiptr size = static_cast<GLsizeiptr>(vertices.size());
+  Key key{hash(vertices), hash(vertices, check_seed), layout_key, size};
+
+  auto it = entries.find(key);
+  if (it != entries.end()) {
+    if (Handle buffer = it->second.lock()) {
+      hit_count++;
+      bytes_saved += size;
+
+#ifdef NO_EXCEPTIONS
+      last_operation_failed = false;
+#endif
+
+      return buffer;
+    }
+  }
+
+  std::shared_ptr<VertexBufferObject> buffer =
+      std::make_shared<VertexBufferObject>(buffer_name, gl_context, vertices,
+                                           usage);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    return nullptr;
+  }
+#endif
+
+  entries[key] = buffer;
+  miss_count++;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return buffer;
+}
+
+void GeometryCache::purge() {
+  std::erase_if(entries,
+                [](const auto &entry) { return entry.second.expired(); });
+}
+
+GeometryCache::Stats GeometryCache::stats() const {
+  Stats result{0, hit_count, miss_count, 0, bytes_saved};
+
+  for (const auto &[key, buffer] : entries) {
+    if (!buffer.expired()) {
+      result.entry_count++;
+      result.unique_bytes += key.size;
+    }
+  }
+
+  return result;
+}
+
+GLsizeiptr GeometryCache::get_bytes_saved() const { return bytes_saved; }
+
+std::uint64_t GeometryCache::hash(std::span<const std::byte> data,
+                                  std::uint64_t seed) {
+  const std::byte *p = data.data();
+  const std::byte *end = p + data.size();
+  std::uint64_t h;
+
+  if (data.size() >= 32) {
+    std::uint64_t v1 = seed + prime1 + prime2;
+    std::uint64_t v2 = seed + prime2;
+    std::uint64_t v3 = seed;
+    std::uint64_t v4 = seed - prime1;
+
+    for (; end - p >= 32; p += 32) {
+      v1 = mix_round(v1, read64(p));
+      v2 = mix_round(v2, read64(p + 8));
+      v3 = mix_round(v3, read64(p + 16));
+      v4 = mix_round(v4, read64(p + 24));
+    }
+
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = merge(h, v1);
+    h = merge(h, v2);
+    h = merge(h, v3);
+    h = merge(h, v4);
+  } else {
+    h = seed + prime5;
+  }
+
+  h += static_cast<std::uint64_t>(data.size());
+
+  for (; end - p >= 8; p += 8) {
+    h ^= mix_round(0, read64(p));
+    h = rotl(h, 27) * prime1 + prime4;
+  }
+
+  if (end - p >= 4) {
+    h ^= static_cast<std::uint64_t>(read32(p)) * prime1;
+    h = rotl(h, 23) * prime2 + prime3;
+    p += 4;
+  }
+
+  for (; p < end; p++) {
+    h ^= static_cast<std::uint64_t>(*p) * prime5;
+    h = rotl(h, 11) * prime1;
+  }
+
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+
+  return h;
+}
+
+std::uint64_t
+GeometryCache::layout_key(std::span<const VertexAttribute> attributes,
+                          GLsizei stride) {
+  // Hash the fields, not the structs, so padding doesn't matter
+  std::vector<std::uint32_t> fields;
+  fields.reserve(attributes.size() * 6 + 1);
+
+  fields.push_back(static_cast<std::uint32_t>(stride));
+  for (const VertexAttribute &attribute : attributes) {
+    fields.push_back(attribute.location);
+    fields.push_back(static_cast<std::uint32_t>(attribute.components));
+    fields.push_back(attribute.type);
+    fields.push_back(attribute.normalized);
+    fields.push_back(attribute.integer);
+    fields.push_back(static_cast<std::uint32_t>(attribute.offset));
+  }
+
+  return hash(std::as_bytes(std::span(fields)));
+}
@@ -1,3 +1,7 @@
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
 #include "SDL_opengl.h"
 #include <SDL.h>
 
@@ -6,6 +10,124 @@
 
 using namespace sdl_opengl_cpp;
 
+bool GLContext::supports(GLFeature feature) {
+  switch (feature) {
+  case GLFeature::BufferStorage:
+    return (gl_context->glBufferStorage != nullptr) &&
+           (version_at_least(4, 4) || has_extension("GL_ARB_buffer_storage"));
+  case GLFeature::MultiDrawIndirect:
+    return (gl_context->glMultiDrawArraysIndirect != nullptr) &&
+           (gl_context->glMultiDrawElementsIndirect != nullptr) &&
+           (version_at_least(4, 3) ||
+            has_extension("GL_ARB_multi_draw_indirect"));
+  case GLFeature::ShaderStorageBufferObject:
+    // No new entry points, glBindBufferBase and glBindBufferRange are
+    // core since OpenGL 3.0
+    return version_at_least(4, 3) ||
+           has_extension("GL_ARB_shader_storage_buffer_object");
+  case GLFeature::DirectStateAccess:
+    // Only the functions the library uses are checked
+    return (gl_context->glCreateBuffers != nullptr) &&
+           (gl_context->glNamedBufferData != nullptr) &&
+           (gl_context->glNamedBufferSubData != nullptr) &&
+           (gl_context->glCreateVertexArrays != nullptr) &&
+           (gl_context->glEnableVertexArrayAttrib != nullptr) &&
+           (gl_context->glVertexArrayVertexBuffer != nullptr) &&
+           (gl_context->glVertexArrayElementBuffer != nullptr) &&
+           (gl_context->glVertexArrayAttribFormat != nullptr) &&
+           (gl_context->glVertexArrayAttribIFormat != nullptr) &&
+           (gl_context->glVertexArrayAttribBinding != nullptr) &&
+           (gl_context->glVertexArrayBindingDivisor != nullptr) &&
+           (gl_context->glCreateTextures != nullptr) &&
+           (gl_context->glTextureParameteri != nullptr) &&
+           (gl_context->glTextureStorage2D != nullptr) &&
+           (gl_context->glTextureSubImage2D != nullptr) &&
+           (gl_context->glTextureStorage3D != nullptr) &&
+           (gl_context->glTextureSubImage3D != nullptr) &&
+           (gl_context->glTextureParameterf != nullptr) &&
+           (gl_context->glGenerateTextureMipmap != nullptr) &&
+           (version_at_least(4, 5) ||
+            has_extension("GL_ARB_direct_state_access"));
+  case GLFeature::VertexAttribBinding:
+    return (gl_context->glVertexAttribFormat != nullptr) &&
+           (gl_context->glVertexAttribIFormat != nullptr) &&
+           (gl_context->glVertexAttribBinding != nullptr) &&
+           (gl_context->glBindVertexBuffer != nullptr) &&
+           (gl_context->glVertexBindingDivisor != nullptr) &&
+           (version_at_least(4, 3) ||
+            has_extension("GL_ARB_vertex_attrib_binding"));
+  case GLFeature::TextureStorage:
+    return (gl_context->glTexStorage2D != nullptr) &&
+           (gl_context->glTexStorage3D != nullptr) &&
+           (version_at_least(4, 2) || has_extension("GL_ARB_texture_storage"));
+  case GLFeature::AnisotropicFiltering:
+    // Only a texture parameter, no new entry points
+    return version_at_least(4, 6) ||
+           has_extension("GL_ARB_texture_filter_anisotropic") ||
+           has_extension("GL_EXT_texture_filter_anisotropic");
+  }
+
+  return false;
+}
+
+bool GLContext::direct_state_access() {
+  if (!dsa.has_value())
+    dsa = supports(GLFeature::DirectStateAccess);
+
+  return *dsa;
+}
+
+bool GLContext::vertex_attrib_binding() {
+  if (!attrib_binding.has_value())
+    attrib_binding = supports(GLFeature::VertexAttribBinding);
+
+  return *attrib_binding;
+}
+
+bool GLContext::version_at_least(int major, int minor) {
+  if (!version.has_value()) {
+    int context_major = 0, context_minor = 0;
+
+    const char *str =
+        reinterpret_cast<const char *>(gl_context->glGetString(GL_VERSION));
+
+    if (str != nullptr) {
+      // The version string is "major.minor[.release] vendor-info",
+      // OpenGL ES contexts prefix it with "OpenGL ES "
+      while ((*str != '\0') && !std::isdigit(static_cast<unsigned char>(*str)))
+        str++;
+
+      const char *end = str + std::strlen(str);
+      auto [ptr, ec] = std::from_chars(str, end, context_major);
+      if ((ec == std::errc()) && (ptr != end) && (*ptr == '.'))
+        std::from_chars(ptr + 1, end, context_minor);
+    }
+
+    version = std::make_pair(context_major, context_minor);
+  }
+
+  return (version->first > major) ||
+         ((version->first == major) && (version->second >= minor));
+}
+
+bool GLContext::has_extension(const std::string &extension) {
+  if (!extensions.has_value()) {
+    extensions.emplace();
+
+    GLint count = 0;
+    gl_context->glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+    for (GLint i = 0; i < count; i++) {
+      const GLubyte *name =
+          gl_context->glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+      if (name != nullptr)
+        extensions->emplace(reinterpret_cast<const char *>(name));
+    }
+  }
+
+  return extensions->contains(extension);
+}
+
 void GLContext::glPushAttrib(GLbitfield mask) {
   return gl_context->glPushAttrib(mask);
 }
@@ -16,6 +138,14 @@ void GLContext::glClear(GLbitfield mask) { return gl_context->glClear(mask); }
 
 GLenum GLContext::glGetError() { return gl_context->glGetError(); }
 
+void GLContext::glGetIntegerv(GLenum pname, GLint *params) {
+  return gl_context->glGetIntegerv(pname, params);
+}
+
+void GLContext::glGetFloatv(GLenum pname, GLfloat *params) {
+  return gl_context->glGetFloatv(pname, params);
+}
+
 void GLContext::glFlush() { return gl_context->glFlush(); }
 
 void GLContext::glEnableClientState(GLenum array) {
@@ -30,6 +160,68 @@ void GLContext::glDrawArrays(GLenum mode, GLint first, GLsizei count) {
   return gl_context->glDrawArrays(mode, first, count);
 }
 
+void GLContext::glDrawElements(GLenum mode, GLsizei count, GLenum type,
+                               const GLvoid *indices) {
+  return gl_context->glDrawElements(mode, count, type, indices);
+}
+
+void GLContext::glDrawElementsBaseVertex(GLenum mode, GLsizei count,
+                                         GLenum type, const GLvoid *indices,
+                                         GLint base_vertex) {
+  return gl_context->glDrawElementsBaseVertex(mode, count, type, indices,
+                                              base_vertex);
+}
+
+void GLContext::glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count,
+                                      GLsizei instance_count) {
+  return gl_context->glDrawArraysInstanced(mode, first, count, instance_count);
+}
+
+void GLContext::glDrawElementsInstanced(GLenum mode, GLsizei count,
+                                        GLenum type, const void *indices,
+                                        GLsizei instance_count) {
+  return gl_context->glDrawElementsInstanced(mode, count, type, indices,
+                                             instance_count);
+}
+
+void GLContext::glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count,
+                                                  GLenum type,
+                                                  const void *indices,
+                                                  GLsizei instance_count,
+                                                  GLint base_vertex) {
+  return gl_context->glDrawElementsInstancedBaseVertex(
+      mode, count, type, indices, instance_count, base_vertex);
+}
+
+void GLContext::glMultiDrawArrays(GLenum mode, const GLint *first,
+                                  const GLsizei *count, GLsizei draw_count) {
+  return gl_context->glMultiDrawArrays(mode, first, count, draw_count);
+}
+
+void GLContext::glMultiDrawElementsBaseVertex(GLenum mode,
+                                              const GLsizei *count,
+                                              GLenum type,
+                                              const void *const *indices,
+                                              GLsizei draw_count,
+                                              const GLint *base_vertex) {
+  return gl_context->glMultiDrawElementsBaseVertex(mode, count, type, indices,
+                                                   draw_count, base_vertex);
+}
+
+void GLContext::glMultiDrawArraysIndirect(GLenum mode, const void *indirect,
+                                          GLsizei draw_count, GLsizei stride) {
+  return gl_context->glMultiDrawArraysIndirect(mode, indirect, draw_count,
+                                               stride);
+}
+
+void GLContext::glMultiDrawElementsIndirect(GLenum mode, GLenum type,
+                                            const void *indirect,
+                                            GLsizei draw_count,
+                                            GLsizei stride) {
+  return gl_context->glMultiDrawElementsIndirect(mode, type, indirect,
+                                                 draw_count, stride);
+}
+
 void GLContext::glVertexPointer(GLint size, GLenum type, GLsizei stride,
                                 const GLvoid *pointer) {
   return gl_context->glVertexPointer(size, type, stride, pointer);
@@ -54,6 +246,15 @@ void GLContext::glBindBuffer(GLenum target, GLuint buffer) {
   return gl_context->glBindBuffer(target, buffer);
 }
 
+void GLContext::glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+  return gl_context->glBindBufferBase(target, index, buffer);
+}
+
+void GLContext::glBindBufferRange(GLenum target, GLuint index, GLuint buffer,
+                                  GLintptr offset, GLsizeiptr size) {
+  return gl_context->glBindBufferRange(target, index, buffer, offset, size);
+}
+
 void GLContext::glBufferData(GLenum target, GLsizeiptr size, const void *data,
                              GLenum usage) {
   return gl_context->glBufferData(target, size, data, usage);
@@ -63,6 +264,65 @@ void GLContext::glDeleteBuffers(GLsizei n, const GLuint *buffers) {
   return gl_context->glDeleteBuffers(n, buffers);
 }
 
+void GLContext::glCreateBuffers(GLsizei n, GLuint *buffers) {
+  return gl_context->glCreateBuffers(n, buffers);
+}
+
+void GLContext::glNamedBufferData(GLuint buffer, GLsizeiptr size,
+                                  const void *data, GLenum usage) {
+  return gl_context->glNamedBufferData(buffer, size, data, usage);
+}
+
+void GLContext::glNamedBufferSubData(GLuint buffer, GLintptr offset,
+                                     GLsizeiptr size, const void *data) {
+  return gl_context->glNamedBufferSubData(buffer, offset, size, data);
+}
+
+void GLContext::glBufferSubData(GLenum target, GLintptr offset,
+                                GLsizeiptr size, const void *data) {
+  return gl_context->glBufferSubData(target, offset, size, data);
+}
+
+void GLContext::glBufferStorage(GLenum target, GLsizeiptr size,
+                                const void *data, GLbitfield flags) {
+  return gl_context->glBufferStorage(target, size, data, flags);
+}
+
+void *GLContext::glMapBufferRange(GLenum target, GLintptr offset,
+                                  GLsizeiptr length, GLbitfield access) {
+  return gl_context->glMapBufferRange(target, offset, length, access);
+}
+
+GLboolean GLContext::glUnmapBuffer(GLenum target) {
+  return gl_context->glUnmapBuffer(target);
+}
+
+void GLContext::glCopyBufferSubData(GLenum read_target, GLenum write_target,
+                                    GLintptr read_offset,
+                                    GLintptr write_offset, GLsizeiptr size) {
+  return gl_context->glCopyBufferSubData(read_target, write_target,
+                                         read_offset, write_offset, size);
+}
+
+void GLContext::glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height,
+                             GLenum format, GLenum type, GLvoid *pixels) {
+  return gl_context->glReadPixels(x, y, width, height, format, type, pixels);
+}
+
+// Synchronization functions
+GLsync GLContext::glFenceSync(GLenum condition, GLbitfield flags) {
+  return gl_context->glFenceSync(condition, flags);
+}
+
+GLenum GLContext::glClientWaitSync(GLsync sync, GLbitfield flags,
+                                   GLuint64 timeout) {
+  return gl_context->glClientWaitSync(sync, flags, timeout);
+}
+
+void GLContext::glDeleteSync(GLsync sync) {
+  return gl_context->glDeleteSync(sync);
+}
+
 void GLContext::glGenVertexArrays(GLsizei n, GLuint *arrays) {
   return gl_context->glGenVertexArrays(n, arrays);
 }
@@ -82,10 +342,91 @@ void GLContext::glVertexAttribPointer(GLuint index, GLint size, GLenum type,
                                            stride, pointer);
 }
 
+void GLContext::glVertexAttribIPointer(GLuint index, GLint size, GLenum type,
+                                       GLsizei stride, const void *pointer) {
+  return gl_context->glVertexAttribIPointer(index, size, type, stride,
+                                            pointer);
+}
+
+void GLContext::glVertexAttribDivisor(GLuint index, GLuint divisor) {
+  return gl_context->glVertexAttribDivisor(index, divisor);
+}
+
+void GLContext::glVertexAttribFormat(GLuint index, GLint size, GLenum type,
+                                     GLboolean normalized,
+                                     GLuint relative_offset) {
+  return gl_context->glVertexAttribFormat(index, size, type, normalized,
+                                          relative_offset);
+}
+
+void GLContext::glVertexAttribIFormat(GLuint index, GLint size, GLenum type,
+                                      GLuint relative_offset) {
+  return gl_context->glVertexAttribIFormat(index, size, type,
+                                           relative_offset);
+}
+
+void GLContext::glVertexAttribBinding(GLuint index, GLuint binding_index) {
+  return gl_context->glVertexAttribBinding(index, binding_index);
+}
+
+void GLContext::glBindVertexBuffer(GLuint binding_index, GLuint buffer,
+                                   GLintptr offset, GLsizei stride) {
+  return gl_context->glBindVertexBuffer(binding_index, buffer, offset,
+                                        stride);
+}
+
+void GLContext::glVertexBindingDivisor(GLuint binding_index, GLuint divisor) {
+  return gl_context->glVertexBindingDivisor(binding_index, divisor);
+}
+
 void GLContext::glDeleteVertexArrays(GLsizei n, const GLuint *arrays) {
   return gl_context->glDeleteVertexArrays(n, arrays);
 }
 
+void GLContext::glCreateVertexArrays(GLsizei n, GLuint *arrays) {
+  return gl_context->glCreateVertexArrays(n, arrays);
+}
+
+void GLContext::glEnableVertexArrayAttrib(GLuint vao, GLuint index) {
+  return gl_context->glEnableVertexArrayAttrib(vao, index);
+}
+
+void GLContext::glVertexArrayVertexBuffer(GLuint vao, GLuint binding_index,
+                                          GLuint buffer, GLintptr offset,
+                                          GLsizei stride) {
+  return gl_context->glVertexArrayVertexBuffer(vao, binding_index, buffer,
+                                               offset, stride);
+}
+
+void GLContext::glVertexArrayElementBuffer(GLuint vao, GLuint buffer) {
+  return gl_context->glVertexArrayElementBuffer(vao, buffer);
+}
+
+void GLContext::glVertexArrayAttribFormat(GLuint vao, GLuint index,
+                                          GLint size, GLenum type,
+                                          GLboolean normalized,
+                                          GLuint relative_offset) {
+  return gl_context->glVertexArrayAttribFormat(vao, index, size, type,
+                                               normalized, relative_offset);
+}
+
+void GLContext::glVertexArrayAttribIFormat(GLuint vao, GLuint index,
+                                           GLint size, GLenum type,
+                                           GLuint relative_offset) {
+  return gl_context->glVertexArrayAttribIFormat(vao, index, size, type,
+                                                relative_offset);
+}
+
+void GLContext::glVertexArrayAttribBinding(GLuint vao, GLuint index,
+                                           GLuint binding_index) {
+  return gl_context->glVertexArrayAttribBinding(vao, index, binding_index);
+}
+
+void GLContext::glVertexArrayBindingDivisor(GLuint vao, GLuint binding_index,
+                                            GLuint divisor) {
+  return gl_context->glVertexArrayBindingDivisor(vao, binding_index, divisor);
+}
+
 GLuint GLContext::glCreateShader(GLenum type) {
   return gl_context->glCreateShader(type);
 }
@@ -140,6 +481,18 @@ GLint GLContext::glGetUniformLocation(GLuint program, const GLchar *name) {
   return gl_context->glGetUniformLocation(program, name);
 }
 
+GLuint GLContext::glGetUniformBlockIndex(GLuint program,
+                                         const GLchar *uniform_block_name) {
+  return gl_context->glGetUniformBlockIndex(program, uniform_block_name);
+}
+
+void GLContext::glUniformBlockBinding(GLuint program,
+                                      GLuint uniform_block_index,
+                                      GLuint uniform_block_binding) {
+  return gl_context->glUniformBlockBinding(program, uniform_block_index,
+                                           uniform_block_binding);
+}
+
 void GLContext::glGetAttachedShaders(GLuint program, GLsizei maxCount,
                                      GLsizei *count, GLuint *shaders) {
   return gl_context->glGetAttachedShaders(program, maxCount, count, shaders);
@@ -209,6 +562,36 @@ void GLContext::glTexParameteri(GLenum target, GLenum pname, GLint param) {
   return gl_context->glTexParameteri(target, pname, param);
 }
 
+void GLContext::glTexParameterf(GLenum target, GLenum pname, GLfloat param) {
+  return gl_context->glTexParameterf(target, pname, param);
+}
+
+void GLContext::glTexStorage2D(GLenum target, GLsizei levels,
+                               GLenum internal_format, GLsizei width,
+                               GLsizei height) {
+  return gl_context->glTexStorage2D(target, levels, internal_format, width,
+                                    height);
+}
+
+void GLContext::glTexStorage3D(GLenum target, GLsizei levels,
+                               GLenum internal_format, GLsizei width,
+                               GLsizei height, GLsizei depth) {
+  return gl_context->glTexStorage3D(target, levels, internal_format, width,
+                                    height, depth);
+}
+
+void GLContext::glGenerateMipmap(GLenum target) {
+  return gl_context->glGenerateMipmap(target);
+}
+
+void GLContext::glActiveTexture(GLenum texture) {
+  return gl_context->glActiveTexture(texture);
+}
+
+void GLContext::glPixelStorei(GLenum pname, GLint param) {
+  return gl_context->glPixelStorei(pname, param);
+}
+
 void GLContext::glTexImage2D(GLenum target, GLint level, GLint internalFormat,
                              GLsizei width, GLsizei height, GLint border,
                              GLenum format, GLenum type, const GLvoid *pixels) {
@@ -216,16 +599,97 @@ void GLContext::glTexImage2D(GLenum target, GLint level, GLint internalFormat,
                                   border, format, type, pixels);
 }
 
+void GLContext::glTexSubImage2D(GLenum target, GLint level, GLint xoffset,
+                                GLint yoffset, GLsizei width, GLsizei height,
+                                GLenum format, GLenum type,
+                                const GLvoid *pixels) {
+  return gl_context->glTexSubImage2D(target, level, xoffset, yoffset, width,
+                                     height, format, type, pixels);
+}
+
+void GLContext::glTexImage3D(GLenum target, GLint level, GLint internalFormat,
+                             GLsizei width, GLsizei height, GLsizei depth,
+                             GLint border, GLenum format, GLenum type,
+                             const GLvoid *pixels) {
+  return gl_context->glTexImage3D(target, level, internalFormat, width, height,
+                                  depth, border, format, type, pixels);
+}
+
+void GLContext::glTexSubImage3D(GLenum target, GLint level, GLint xoffset,
+                                GLint yoffset, GLint zoffset, GLsizei width,
+                                GLsizei height, GLsizei depth, GLenum format,
+                                GLenum type, const GLvoid *pixels) {
+  return gl_context->glTexSubImage3D(target, level, xoffset, yoffset, zoffset,
+                                     width, height, depth, format, type,
+                                     pixels);
+}
+
 // 1.1 functions
 
 void GLContext::glGenTextures(GLsizei n, GLuint *textures) {
   return gl_context->glGenTextures(n, textures);
 }
 
+void GLContext::glDeleteTextures(GLsizei n, const GLuint *textures) {
+  return gl_context->glDeleteTextures(n, textures);
+}
+
 void GLContext::glBindTexture(GLenum target, GLuint texture) {
   return gl_context->glBindTexture(target, texture);
 }
 
+void GLContext::glCreateTextures(GLenum target, GLsizei n, GLuint *textures) {
+  return gl_context->glCreateTextures(target, n, textures);
+}
+
+void GLContext::glTextureParameteri(GLuint texture, GLenum pname,
+                                    GLint param) {
+  return gl_context->glTextureParameteri(texture, pname, param);
+}
+
+void GLContext::glTextureParameterf(GLuint texture, GLenum pname,
+                                    GLfloat param) {
+  return gl_context->glTextureParameterf(texture, pname, param);
+}
+
+void GLContext::glGenerateTextureMipmap(GLuint texture) {
+  return gl_context->glGenerateTextureMipmap(texture);
+}
+
+void GLContext::glTextureStorage2D(GLuint texture, GLsizei levels,
+                                   GLenum internal_format, GLsizei width,
+                                   GLsizei height) {
+  return gl_context->glTextureStorage2D(texture, levels, internal_format,
+                                        width, height);
+}
+
+void GLContext::glTextureSubImage2D(GLuint texture, GLint level,
+                                    GLint xoffset, GLint yoffset,
+                                    GLsizei width, GLsizei height,
+                                    GLenum format, GLenum type,
+                                    const void *pixels) {
+  return gl_context->glTextureSubImage2D(texture, level, xoffset, yoffset,
+                                         width, height, format, type, pixels);
+}
+
+void GLContext::glTextureStorage3D(GLuint texture, GLsizei levels,
+                                   GLenum internal_format, GLsizei width,
+                                   GLsizei height, GLsizei depth) {
+  return gl_context->glTextureStorage3D(texture, levels, internal_format,
+                                        width, height, depth);
+}
+
+void GLContext::glTextureSubImage3D(GLuint texture, GLint level,
+                                    GLint xoffset, GLint yoffset,
+                                    GLint zoffset, GLsizei width,
+                                    GLsizei height, GLsizei depth,
+                                    GLenum format, GLenum type,
+                                    const void *pixels) {
+  return gl_context->glTextureSubImage3D(texture, level, xoffset, yoffset,
+                                         zoffset, width, height, depth, format,
+                                         type, pixels);
+}
+
 // Transformation
 
 void GLContext::glPushMatrix() { return gl_context->glPushMatrix(); }
@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "gpu_memory_registry.h"
+
+using namespace sdl_opengl_cpp;
+
+GPUMemoryRegistry &GPUMemoryRegistry::instance() {
+  static GPUMemoryRegistry registry;
+
+  return registry;
+}
+
+void GPUMemoryRegistry::track(GPUMemoryCategory category, GLuint id,
+                              const string &name, GLsizeiptr bytes) {
+  Entry &entry = entries[Key(category, id)];
+
+  total_bytes += bytes - entry.bytes;
+  peak_bytes = std::max(peak_bytes, total_bytes);
+
+  entry.name = name;
+  entry.bytes = bytes;
+  entry.last_used = ++tick;
+  entry.evictor = nullptr;
+}
+
+void GPUMemoryRegistry::resize(GPUMemoryCategory category, GLuint id,
+                               GLsizeiptr bytes) {
+  auto it = entries.find(Key(category, id));
+
+  if (it == entries.end())
+    return;
+
+  total_bytes += bytes - it->second.bytes;
+  peak_bytes = std::max(peak_bytes, total_bytes);
+  it->second.bytes = bytes;
+}
+
+void GPUMemoryRegistry::release(GPUMemoryCategory category, GLuint id) {
+  auto it = entries.find(Key(category, id));
+
+  if (it == entries.end())
+    return;
+
+  total_bytes -= it->second.bytes;
+  entries.erase(it);
+}
+
+void GPUMemoryRegistry::touch(GPUMemoryCategory category, GLuint id) {
+  auto it = entries.find(Key(category, id));
+
+  if (it != entries.end())
+    it->second.last_used = ++tick;
+}
+
+bool GPUMemoryRegistry::set_evictor(GPUMemoryCategory category, GLuint id,
+                                    Evictor evictor) {
+  auto it = entries.find(Key(category, id));
+
+  if (it == entries.end())
+    return false;
+
+  it->second.evictor = std::move(evictor);
+
+  return true;
+}
+
+void GPUMemoryRegistry::clear_evictor(GPUMemoryCategory category, GLuint id) {
+  auto it = entries.find(Key(category, id));
+
+  if (it != entries.end())
+    it->second.evictor = nullptr;
+}
+
+GLsizeiptr GPUMemoryRegistry::evict_one() {
+  auto victim = entries.end();
+
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->second.evictor &&
+        ((victim == entries.end()) ||
+         (it->second.last_used < victim->second.last_used)))
+      victim = it;
+  }
+
+  if (victim == entries.end())
+    return -1;
+
+  Key key = victim->first;
+  GLsizeiptr before = total_bytes;
+
+  // Move the callback out first, it is expected to release the
+  // entry and that destroys the stored copy
+  Evictor evictor = std::move(victim->second.evictor);
+  victim->second.evictor = nullptr;
+  evictor();
+
+  eviction_count++;
+
+  // An evictor that didn't release its allocation is treated as
+  // having freed it, so we don't count the same bytes twice
+  release(key.first, key.second);
+
+  return before - total_bytes;
+}
+
+bool GPUMemoryRegistry::reserve(GLsizeiptr bytes) {
+  if (budget == 0)
+    return true;
+
+  // Evicting can't make room for more than the whole budget
+  if (bytes > budget)
+    return false;
+
+  while (total_bytes + bytes > budget) {
+    if (evict_one() < 0)
+      return false;
+  }
+
+  return true;
+}
+
+GLsizeiptr GPUMemoryRegistry::evict(GLsizeiptr bytes) {
+  GLsizeiptr freed = 0;
+
+  while (freed < bytes) {
+    GLsizeiptr evicted = evict_one();
+
+    if (evicted < 0)
+      break;
+
+    freed += evicted;
+  }
+
+  return freed;
+}
+
+void GPUMemoryRegistry::set_budget(GLsizeiptr budget_) { budget = budget_; }
+
+GLsizeiptr GPUMemoryRegistry::get_budget() const { return budget; }
+
+GLsizeiptr GPUMemoryRegistry::get_total_bytes() const { return total_bytes; }
+
+GLsizeiptr GPUMemoryRegistry::get_bytes(GPUMemoryCategory category) const {
+  GLsizeiptr bytes = 0;
+
+  for (const auto &[key, entry] : entries) {
+    if (key.first == category)
+      bytes += entry.bytes;
+  }
+
+  return bytes;
+}
+
+GLsizeiptr GPUMemoryRegistry::get_peak_bytes() const { return peak_bytes; }
+
+size_t GPUMemoryRegistry::get_allocation_count() const {
+  return entries.size();
+}
+
+size_t GPUMemoryRegistry::get_eviction_count() const { return eviction_count; }
+
+std::vector<GPUAllocation> GPUMemoryRegistry::get_allocations() const {
+  std::vector<GPUAllocation> allocations;
+  allocations.reserve(entries.size());
+
+  for (const auto &[key, entry] : entries) {
+    allocations.push_back({key.first, key.second, entry.name, entry.bytes,
+                           static_cast<bool>(entry.evictor)});
+  }
+
+  return allocations;
+}
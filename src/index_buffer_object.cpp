@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "index_buffer_object.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::index_buffer_object;
+
+// The largest vertex count that 16-bit indices can address
+static constexpr size_t max_short_index_vertices =
+    static_cast<size_t>(std::numeric_limits<GLushort>::max()) + 1;
+
+IndexBufferObject::IndexBufferObject(const string &buffer_name,
+                                     const std::shared_ptr<GLContext> &ctx,
+                                     std::span<const GLuint> indices,
+                                     size_t vertex_count, GLenum usage)
+    : name{buffer_name}, gl_context{ctx} {
+  if (indices.empty()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError("ERROR::INDEX_BUFFER::BUFFER_DATA_ERROR::NO_DATA");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if ((indices.size() >
+       static_cast<size_t>(std::numeric_limits<GLsizei>::max())) ||
+      (*std::ranges::max_element(indices) >= vertex_count)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::INDEX_BUFFER::BUFFER_DATA_ERROR::INDEX_OUT_OF_RANGE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  count = static_cast<GLsizei>(indices.size());
+
+  // The buffer is filled through GL_ARRAY_BUFFER, buffer objects
+  // aren't typed and this avoids changing the element array binding
+  // of whatever vertex array object is currently bound
+  if (vertex_count <= max_short_index_vertices) {
+    index_type = GL_UNSIGNED_SHORT;
+
+    std::vector<GLushort> short_indices(indices.begin(), indices.end());
+    buffer.emplace(name, ctx, std::span<const GLushort>(short_indices),
+                   usage);
+  } else {
+    index_type = GL_UNSIGNED_INT;
+
+    buffer.emplace(name, ctx, indices, usage);
+  }
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    cleanup();
+    return;
+  }
+#endif
+}
+
+IndexBufferObject::~IndexBufferObject() { cleanup(); }
+
+void IndexBufferObject::cleanup() noexcept {
+  // The VertexBufferObject deletes the OpenGL buffer
+  buffer.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+IndexBufferObject::IndexBufferObject(IndexBufferObject &&ibo) noexcept
+    : name{ibo.name}, gl_context{ibo.gl_context},
+      buffer{std::move(ibo.buffer)}, index_type{ibo.index_type},
+      count{ibo.count} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = ibo.last_operation_failed;
+  last_error = ibo.last_error;
+#endif
+
+  ibo.gl_context = nullptr;
+  ibo.buffer.reset();
+}
+
+// move assignment operator
+IndexBufferObject &
+IndexBufferObject::operator=(IndexBufferObject &&ibo) noexcept {
+  if (&ibo != this) {
+    cleanup();
+
+    name = ibo.name;
+    gl_context = ibo.gl_context;
+    buffer = std::move(ibo.buffer);
+    index_type = ibo.index_type;
+    count = ibo.count;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = ibo.last_operation_failed;
+    last_error = ibo.last_error;
+#endif
+
+    ibo.gl_context = nullptr;
+    ibo.buffer.reset();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool IndexBufferObject::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || !buffer)
+    return true;
+  else
+    return false;
+}
+
+void IndexBufferObject::bind() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw IndexBufferObjectUnspecifiedStateError(
+        "Index Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  buffer->bind(GL_ELEMENT_ARRAY_BUFFER);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLenum IndexBufferObject::get_index_type() const { return index_type; }
+
+GLsizei IndexBufferObject::get_count() const { return count; }
+
+GLuint IndexBufferObject::get_buffer() const {
+  return buffer ? buffer->get_buffer() : 0;
+}
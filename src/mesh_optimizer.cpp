@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "mesh_optimizer.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::mesh_optimizer;
+
+namespace {
+
+bool valid_indices(std::span<const GLuint> indices, size_t vertex_count) {
+  if (indices.size() % 3 != 0)
+    return false;
+
+  return std::all_of(indices.begin(), indices.end(),
+                     [vertex_count](GLuint index) {
+                       return static_cast<size_t>(index) < vertex_count;
+                     });
+}
+
+// A FIFO post-transform cache
+//
+// Each vertex remembers when it was loaded, counted in misses.  It is
+// still cached until size more vertices have been loaded after it.
+class FIFOCache {
+public:
+  FIFOCache(size_t vertex_count, size_t size_)
+      : loaded_at(vertex_count, never), size(size_) {}
+
+  // Returns true on a miss
+  bool access(GLuint vertex) {
+    if ((loaded_at[vertex] != never) && (time - loaded_at[vertex] <= size))
+      return false;
+
+    loaded_at[vertex] = time++;
+    return true;
+  }
+
+  // Flush every entry, as if size unrelated vertices were loaded
+  void clear() { time += size; }
+
+private:
+  static constexpr size_t never = std::numeric_limits<size_t>::max();
+
+  std::vector<size_t> loaded_at;
+  size_t size;
+  size_t time = 0;
+};
+
+using Vec3 = std::array<GLfloat, 3>;
+
+Vec3 subtract(const Vec3 &a, const Vec3 &b) {
+  return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+Vec3 cross(const Vec3 &a, const Vec3 &b) {
+  return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2],
+          a[0] * b[1] - a[1] * b[0]};
+}
+
+GLfloat dot(const Vec3 &a, const Vec3 &b) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// The area weighted centroid and normal of a run of triangles
+struct ClusterShape {
+  Vec3 centroid = {0.0f, 0.0f, 0.0f};
+  Vec3 normal = {0.0f, 0.0f, 0.0f};
+  GLfloat area = 0.0f;
+};
+
+} // namespace
+
+VertexCacheStatistics
+mesh_optimizer::analyze_vertex_cache(std::span<const GLuint> indices,
+                                     size_t vertex_count, size_t cache_size) {
+  VertexCacheStatistics statistics;
+
+  if (!valid_indices(indices, vertex_count) || indices.empty())
+    return statistics;
+
+  FIFOCache cache(vertex_count, cache_size);
+  std::vector<bool> used(vertex_count, false);
+  size_t used_count = 0;
+
+  for (GLuint index : indices) {
+    statistics.misses += cache.access(index);
+
+    if (!used[index]) {
+      used[index] = true;
+      used_count++;
+    }
+  }
+
+  statistics.acmr = static_cast<float>(statistics.misses) /
+                    static_cast<float>(indices.size() / 3);
+  statistics.atvr = static_cast<float>(statistics.misses) /
+                    static_cast<float>(used_count);
+
+  return statistics;
+}
+
+std::vector<GLuint>
+mesh_optimizer::optimize_vertex_cache(std::span<const GLuint> indices,
+                                      size_t vertex_count, size_t cache_size) {
+  if (!valid_indices(indices, vertex_count))
+    return {};
+
+  size_t triangle_count = indices.size() / 3;
+
+  // The triangles using each vertex, in compressed rows
+  std::vector<size_t> live(vertex_count, 0);
+  for (GLuint index : indices)
+    live[index]++;
+
+  std::vector<size_t> adjacency_offsets(vertex_count + 1, 0);
+  for (size_t v = 0; v < vertex_count; v++)
+    adjacency_offsets[v + 1] = adjacency_offsets[v] + live[v];
+
+  std::vector<size_t> adjacency(indices.size());
+  std::vector<size_t> fill(adjacency_offsets.begin(),
+                           adjacency_offsets.end() - 1);
+  for (size_t i = 0; i < indices.size(); i++)
+    adjacency[fill[indices[i]]++] = i / 3;
+
+  // Cache timestamps, a vertex is cached if it was loaded fewer than
+  // cache_size loads ago
+  std::vector<size_t> cache_time(vertex_count, 0);
+  size_t time = cache_size + 1;
+
+  std::vector<bool> emitted(triangle_count, false);
+  std::vector<GLuint> dead_end;
+  std::vector<GLuint> candidates;
+  std::vector<GLuint> result;
+  result.reserve(indices.size());
+
+  // The next vertex in input order to restart from
+  size_t cursor = 0;
+
+  auto skip_dead_end = [&]() -> long {
+    while (!dead_end.empty()) {
+      GLuint vertex = dead_end.back();
+      dead_end.pop_back();
+
+      if (live[vertex] > 0)
+        return vertex;
+    }
+
+    for (; cursor < vertex_count; cursor++) {
+      if (live[cursor] > 0)
+        return static_cast<long>(cursor);
+    }
+
+    return -1;
+  };
+
+  long fanning = skip_dead_end();
+
+  while (fanning >= 0) {
+    candidates.clear();
+
+    // Emit every remaining triangle around the fanning vertex
+    for (size_t a = adjacency_offsets[fanning];
+         a < adjacency_offsets[fanning + 1]; a++) {
+      size_t triangle = adjacency[a];
+
+      if (emitted[triangle])
+        continue;
+
+      for (size_t corner = 0; corner < 3; corner++) {
+        GLuint vertex = indices[triangle * 3 + corner];
+
+        result.push_back(vertex);
+        dead_end.push_back(vertex);
+        candidates.push_back(vertex);
+        live[vertex]--;
+
+        if (time - cache_time[vertex] > cache_size)
+          cache_time[vertex] = time++;
+      }
+
+      emitted[triangle] = true;
+    }
+
+    // Continue from the candidate that will still be in the cache
+    // after its remaining triangles are emitted, preferring the one
+    // that entered the cache first
+    long next = -1;
+    long best_priority = -1;
+
+    for (GLuint vertex : candidates) {
+      if (live[vertex] == 0)
+        continue;
+
+      long priority = 0;
+      if (time - cache_time[vertex] + 2 * live[vertex] <= cache_size)
+        priority = static_cast<long>(time - cache_time[vertex]);
+
+      if (priority > best_priority) {
+        best_priority = priority;
+        next = vertex;
+      }
+    }
+
+    fanning = (next >= 0) ? next : skip_dead_end();
+  }
+
+  return result;
+}
+
+std::vector<GLuint> mesh_optimizer::optimize_overdraw(
+    std::span<const GLuint> indices, const std::byte *vertex_data,
+    size_t vertex_count, size_t stride, size_t position_offset,
+    size_t cache_size, float threshold) {
+  if (!valid_indices(indices, vertex_count))
+    return {};
+
+  size_t triangle_count = indices.size() / 3;
+
+  if (triangle_count == 0)
+    return {};
+
+  auto position = [&](GLuint vertex) {
+    Vec3 p;
+    std::memcpy(p.data(), vertex_data + vertex * stride + position_offset,
+                sizeof(p));
+    return p;
+  };
+
+  // Hard boundaries, where every vertex of a triangle misses the cache
+  // and the cache order started afresh
+  std::vector<size_t> hard;
+  {
+    FIFOCache cache(vertex_count, cache_size);
+
+    for (size_t t = 0; t < triangle_count; t++) {
+      size_t misses = cache.access(indices[t * 3]) +
+                      cache.access(indices[t * 3 + 1]) +
+                      cache.access(indices[t * 3 + 2]);
+
+      if ((t == 0) || (misses == 3))
+        hard.push_back(t);
+    }
+    hard.push_back(triangle_count);
+  }
+
+  // Soft boundaries, split each cluster as soon as the part so far is
+  // within threshold of the cluster's miss ratio
+  std::vector<size_t> clusters;
+  {
+    FIFOCache cache(vertex_count, cache_size);
+
+    for (size_t c = 0; c + 1 < hard.size(); c++) {
+      size_t begin = hard[c];
+      size_t end = hard[c + 1];
+
+      cache.clear();
+      size_t cluster_misses = 0;
+      for (size_t i = begin * 3; i < end * 3; i++)
+        cluster_misses += cache.access(indices[i]);
+
+      float limit = static_cast<float>(cluster_misses) /
+                    static_cast<float>(end - begin) * threshold;
+
+      cache.clear();
+      size_t start = begin;
+      size_t misses = 0;
+      clusters.push_back(begin);
+
+      for (size_t t = begin; t + 1 < end; t++) {
+        misses += cache.access(indices[t * 3]) +
+                  cache.access(indices[t * 3 + 1]) +
+                  cache.access(indices[t * 3 + 2]);
+
+        if (static_cast<float>(misses) / static_cast<float>(t + 1 - start) <=
+            limit) {
+          start = t + 1;
+          misses = 0;
+          cache.clear();
+          clusters.push_back(start);
+        }
+      }
+    }
+    clusters.push_back(triangle_count);
+  }
+
+  // Measure each cluster and the whole mesh
+  size_t cluster_count = clusters.size() - 1;
+  std::vector<ClusterShape> shapes(cluster_count);
+  ClusterShape mesh;
+
+  for (size_t c = 0; c < cluster_count; c++) {
+    ClusterShape &shape = shapes[c];
+
+    for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+      Vec3 p0 = position(indices[t * 3]);
+      Vec3 p1 = position(indices[t * 3 + 1]);
+      Vec3 p2 = position(indices[t * 3 + 2]);
+
+      // The cross product is twice the area along the normal
+      Vec3 normal = cross(subtract(p1, p0), subtract(p2, p0));
+      GLfloat area = std::sqrt(dot(normal, normal)) * 0.5f;
+
+      for (size_t k = 0; k < 3; k++) {
+        GLfloat center = (p0[k] + p1[k] + p2[k]) / 3.0f;
+
+        shape.centroid[k] += center * area;
+        shape.normal[k] += normal[k];
+        mesh.centroid[k] += center * area;
+      }
+      shape.area += area;
+      mesh.area += area;
+    }
+
+    if (shape.area > 0.0f) {
+      for (size_t k = 0; k < 3; k++)
+        shape.centroid[k] /= shape.area;
+    }
+  }
+
+  if (mesh.area > 0.0f) {
+    for (size_t k = 0; k < 3; k++)
+      mesh.centroid[k] /= mesh.area;
+  }
+
+  // Clusters that face away from the center are on the outside of
+  // the mesh, draw them first
+  std::vector<GLfloat> sort_key(cluster_count, 0.0f);
+  for (size_t c = 0; c < cluster_count; c++) {
+    GLfloat length = std::sqrt(dot(shapes[c].normal, shapes[c].normal));
+
+    if (length > 0.0f)
+      sort_key[c] =
+          dot(subtract(shapes[c].centroid, mesh.centroid), shapes[c].normal) /
+          length;
+  }
+
+  std::vector<size_t> order(cluster_count);
+  for (size_t c = 0; c < cluster_count; c++)
+    order[c] = c;
+
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return sort_key[a] > sort_key[b];
+  });
+
+  std::vector<GLuint> result;
+  result.reserve(indices.size());
+
+  for (size_t c : order)
+    result.insert(result.end(), indices.begin() + clusters[c] * 3,
+                  indices.begin() + clusters[c + 1] * 3);
+
+  return result;
+}
+
+std::vector<GLuint>
+mesh_optimizer::generate_vertex_fetch_remap(std::span<const GLuint> indices,
+                                            size_t vertex_count) {
+  if (!valid_indices(indices, vertex_count))
+    return {};
+
+  std::vector<GLuint> remap(vertex_count, unused_vertex);
+  GLuint next = 0;
+
+  for (GLuint index : indices) {
+    if (remap[index] == unused_vertex)
+      remap[index] = next++;
+  }
+
+  return remap;
+}
+
+std::vector<GLuint>
+mesh_optimizer::remap_indices(std::span<const GLuint> indices,
+                              std::span<const GLuint> remap) {
+  std::vector<GLuint> result;
+  result.reserve(indices.size());
+
+  for (GLuint index : indices) {
+    if ((index >= remap.size()) || (remap[index] == unused_vertex))
+      return {};
+
+    result.push_back(remap[index]);
+  }
+
+  return result;
+}
@@ -0,0 +1,337 @@
+#include <bit>
+
+#include "offset_allocator.h"
+
+using namespace sdl_opengl_cpp;
+
+namespace {
+
+constexpr uint32_t num_top_bins = 32;
+constexpr uint32_t bins_per_leaf = 8;
+constexpr uint32_t top_bins_index_shift = 3;
+constexpr uint32_t leaf_bins_index_mask = 0x7;
+constexpr uint32_t num_leaf_bins = num_top_bins * bins_per_leaf;
+
+constexpr uint32_t mantissa_bits = 3;
+constexpr uint32_t mantissa_value = 1 << mantissa_bits;
+constexpr uint32_t mantissa_mask = mantissa_value - 1;
+
+constexpr uint32_t no_bit = 0xffffffff;
+
+// Sizes are binned with a small float: 5 bit exponent, 3 bit
+// mantissa.  Sizes below 8 are stored exactly (denormals).
+
+// Bin for a size, rounding up, used when allocating so any node in
+// the bin is large enough.
+uint32_t uint_to_float_round_up(uint32_t size) {
+  uint32_t exp = 0;
+  uint32_t mantissa = 0;
+
+  if (size < mantissa_value) {
+    mantissa = size;
+  } else {
+    uint32_t highest_set_bit = 31 - std::countl_zero(size);
+    uint32_t mantissa_start_bit = highest_set_bit - mantissa_bits;
+    exp = mantissa_start_bit + 1;
+    mantissa = (size >> mantissa_start_bit) & mantissa_mask;
+
+    uint32_t low_bits_mask = (1u << mantissa_start_bit) - 1;
+
+    // Round up, a mantissa overflow carries into the exponent
+    if ((size & low_bits_mask) != 0)
+      mantissa++;
+  }
+
+  return (exp << mantissa_bits) + mantissa;
+}
+
+// Bin for a size, rounding down, used when inserting free nodes so
+// a node is never in a bin larger than itself.
+uint32_t uint_to_float_round_down(uint32_t size) {
+  uint32_t exp = 0;
+  uint32_t mantissa = 0;
+
+  if (size < mantissa_value) {
+    mantissa = size;
+  } else {
+    uint32_t highest_set_bit = 31 - std::countl_zero(size);
+    uint32_t mantissa_start_bit = highest_set_bit - mantissa_bits;
+    exp = mantissa_start_bit + 1;
+    mantissa = (size >> mantissa_start_bit) & mantissa_mask;
+  }
+
+  return (exp << mantissa_bits) | mantissa;
+}
+
+uint32_t float_to_uint(uint32_t float_value) {
+  uint32_t exponent = float_value >> mantissa_bits;
+  uint32_t mantissa = float_value & mantissa_mask;
+
+  if (exponent == 0)
+    return mantissa;
+  else
+    return (mantissa | mantissa_value) << (exponent - 1);
+}
+
+uint32_t find_lowest_set_bit_after(uint32_t bit_mask, uint32_t start_bit) {
+  if (start_bit >= 32)
+    return no_bit;
+
+  uint32_t mask_before_start = (1u << start_bit) - 1;
+  uint32_t mask_after_start = bit_mask & ~mask_before_start;
+
+  if (mask_after_start == 0)
+    return no_bit;
+
+  return std::countr_zero(mask_after_start);
+}
+
+} // namespace
+
+OffsetAllocator::OffsetAllocator(uint32_t size_, uint32_t max_allocations_)
+    : size{size_}, max_allocations{max_allocations_} {
+  reset();
+}
+
+void OffsetAllocator::reset() {
+  free_storage = 0;
+  used_bins_top = 0;
+  used_bins.assign(num_top_bins, 0);
+  bin_indices.assign(num_leaf_bins, unused);
+
+  nodes.assign(max_allocations, Node{});
+
+  // Pop from the back, so node 0 is handed out first
+  free_nodes.resize(max_allocations);
+  for (uint32_t i = 0; i < max_allocations; i++)
+    free_nodes[i] = max_allocations - i - 1;
+
+  // Start with one free node covering everything
+  if ((size > 0) && !free_nodes.empty())
+    insert_node_into_bin(size, 0);
+}
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(uint32_t alloc_size) {
+  // Out of nodes, or a zero size request which we can't hand out a
+  // unique offset for
+  if (free_nodes.empty() || (alloc_size == 0))
+    return {};
+
+  uint32_t node_index = find_free_node(alloc_size);
+
+  if (node_index == unused)
+    return {};
+
+  Node &node = nodes[node_index];
+  uint32_t node_total_size = node.data_size;
+  unlink_node_from_bin(node_index);
+  free_storage -= node_total_size;
+  node.data_size = alloc_size;
+  node.used = true;
+
+  // Put the remainder back as a new free node after this one
+  uint32_t remainder_size = node_total_size - alloc_size;
+  if (remainder_size > 0) {
+    uint32_t new_node_index =
+        insert_node_into_bin(remainder_size, node.data_offset + alloc_size);
+
+    if (node.neighbor_next != unused)
+      nodes[node.neighbor_next].neighbor_prev = new_node_index;
+    nodes[new_node_index].neighbor_prev = node_index;
+    nodes[new_node_index].neighbor_next = node.neighbor_next;
+    node.neighbor_next = new_node_index;
+  }
+
+  return {node.data_offset, node_index};
+}
+
+void OffsetAllocator::free(Allocation allocation) {
+  if ((allocation.metadata == no_space) ||
+      (allocation.metadata >= max_allocations))
+    return;
+
+  uint32_t node_index = allocation.metadata;
+  Node &node = nodes[node_index];
+
+  // Double free
+  if (!node.used)
+    return;
+
+  uint32_t offset = node.data_offset;
+  uint32_t merged_size = node.data_size;
+
+  // Merge with the previous range if it's free
+  if ((node.neighbor_prev != unused) && !nodes[node.neighbor_prev].used) {
+    Node &prev_node = nodes[node.neighbor_prev];
+    offset = prev_node.data_offset;
+    merged_size += prev_node.data_size;
+
+    remove_node_from_bin(node.neighbor_prev);
+
+    node.neighbor_prev = prev_node.neighbor_prev;
+  }
+
+  // Merge with the next range if it's free
+  if ((node.neighbor_next != unused) && !nodes[node.neighbor_next].used) {
+    Node &next_node = nodes[node.neighbor_next];
+    merged_size += next_node.data_size;
+
+    remove_node_from_bin(node.neighbor_next);
+
+    node.neighbor_next = next_node.neighbor_next;
+  }
+
+  uint32_t neighbor_next = node.neighbor_next;
+  uint32_t neighbor_prev = node.neighbor_prev;
+
+  // Release this node and insert the merged range
+  node = Node{};
+  free_nodes.push_back(node_index);
+
+  uint32_t combined_node_index = insert_node_into_bin(merged_size, offset);
+
+  if (neighbor_next != unused) {
+    nodes[combined_node_index].neighbor_next = neighbor_next;
+    nodes[neighbor_next].neighbor_prev = combined_node_index;
+  }
+  if (neighbor_prev != unused) {
+    nodes[combined_node_index].neighbor_prev = neighbor_prev;
+    nodes[neighbor_prev].neighbor_next = combined_node_index;
+  }
+}
+
+uint32_t OffsetAllocator::insert_node_into_bin(uint32_t node_size,
+                                               uint32_t data_offset) {
+  uint32_t bin_index = uint_to_float_round_down(node_size);
+  uint32_t top_bin_index = bin_index >> top_bins_index_shift;
+  uint32_t leaf_bin_index = bin_index & leaf_bins_index_mask;
+
+  // First node in the bin?
+  if (bin_indices[bin_index] == unused) {
+    used_bins[top_bin_index] |= 1u << leaf_bin_index;
+    used_bins_top |= 1u << top_bin_index;
+  }
+
+  uint32_t top_node_index = bin_indices[bin_index];
+  uint32_t node_index = free_nodes.back();
+  free_nodes.pop_back();
+
+  nodes[node_index] = Node{};
+  nodes[node_index].data_offset = data_offset;
+  nodes[node_index].data_size = node_size;
+  nodes[node_index].bin_list_next = top_node_index;
+  if (top_node_index != unused)
+    nodes[top_node_index].bin_list_prev = node_index;
+  bin_indices[bin_index] = node_index;
+
+  free_storage += node_size;
+
+  return node_index;
+}
+
+uint32_t OffsetAllocator::find_free_node(uint32_t alloc_size) const {
+  uint32_t min_bin_index = uint_to_float_round_up(alloc_size);
+  uint32_t min_top_bin_index = min_bin_index >> top_bins_index_shift;
+  uint32_t min_leaf_bin_index = min_bin_index & leaf_bins_index_mask;
+
+  if (min_top_bin_index < num_top_bins) {
+    uint32_t top_bin_index = min_top_bin_index;
+    uint32_t leaf_bin_index = no_bit;
+
+    // Look in the same top bin first, from the minimum leaf bin
+    if (used_bins_top & (1u << top_bin_index)) {
+      leaf_bin_index = find_lowest_set_bit_after(used_bins[top_bin_index],
+                                                 min_leaf_bin_index);
+    }
+
+    // Otherwise take the smallest leaf of the next larger top bin
+    if (leaf_bin_index == no_bit) {
+      top_bin_index =
+          find_lowest_set_bit_after(used_bins_top, min_top_bin_index + 1);
+
+      if (top_bin_index != no_bit)
+        leaf_bin_index = std::countr_zero(used_bins[top_bin_index]);
+    }
+
+    if (leaf_bin_index != no_bit)
+      return bin_indices[(top_bin_index << top_bins_index_shift) |
+                         leaf_bin_index];
+  }
+
+  // Nodes are filed rounding down, so a node that isn't itself a bin
+  // size, such as a whole page of 1000, sits in the bin below the one
+  // searched above.  The request's own rounded down bin may still hold
+  // one that is large enough.
+  uint32_t bin_index = uint_to_float_round_down(alloc_size);
+  for (uint32_t node_index = bin_indices[bin_index]; node_index != unused;
+       node_index = nodes[node_index].bin_list_next) {
+    if (nodes[node_index].data_size >= alloc_size)
+      return node_index;
+  }
+
+  return unused;
+}
+
+void OffsetAllocator::unlink_node_from_bin(uint32_t node_index) {
+  Node &node = nodes[node_index];
+
+  if (node.bin_list_prev != unused) {
+    // Easy case, not the head of the list
+    nodes[node.bin_list_prev].bin_list_next = node.bin_list_next;
+    if (node.bin_list_next != unused)
+      nodes[node.bin_list_next].bin_list_prev = node.bin_list_prev;
+  } else {
+    // Head of the list, update the bin
+    uint32_t bin_index = uint_to_float_round_down(node.data_size);
+    uint32_t top_bin_index = bin_index >> top_bins_index_shift;
+    uint32_t leaf_bin_index = bin_index & leaf_bins_index_mask;
+
+    bin_indices[bin_index] = node.bin_list_next;
+    if (node.bin_list_next != unused)
+      nodes[node.bin_list_next].bin_list_prev = unused;
+
+    if (bin_indices[bin_index] == unused) {
+      used_bins[top_bin_index] &= ~(1u << leaf_bin_index);
+
+      if (used_bins[top_bin_index] == 0)
+        used_bins_top &= ~(1u << top_bin_index);
+    }
+  }
+
+  node.bin_list_prev = unused;
+  node.bin_list_next = unused;
+}
+
+void OffsetAllocator::remove_node_from_bin(uint32_t node_index) {
+  unlink_node_from_bin(node_index);
+
+  free_storage -= nodes[node_index].data_size;
+
+  free_nodes.push_back(node_index);
+}
+
+uint32_t OffsetAllocator::allocation_size(Allocation allocation) const {
+  if ((allocation.metadata == no_space) ||
+      (allocation.metadata >= max_allocations))
+    return 0;
+
+  return nodes[allocation.metadata].data_size;
+}
+
+OffsetAllocator::StorageReport OffsetAllocator::storage_report() const {
+  uint32_t largest_free_region = 0;
+
+  // Nodes are only in bins no larger than themselves, so the
+  // highest non-empty bin is a lower bound on the largest free range
+  if (!free_nodes.empty() && (used_bins_top != 0)) {
+    uint32_t top_bin_index = 31 - std::countl_zero(used_bins_top);
+    uint32_t leaf_bin_index =
+        31 - std::countl_zero(static_cast<uint32_t>(used_bins[top_bin_index]));
+    largest_free_region = float_to_uint(
+        (top_bin_index << top_bins_index_shift) | leaf_bin_index);
+  }
+
+  return {free_storage, largest_free_region};
+}
+
+uint32_t OffsetAllocator::get_size() const { return size; }
@@ -225,6 +225,38 @@ GLint Program::getUniformLocation(const std::string &uniform_name_to_get) {
   return location;
 }
 
+void Program::bind_uniform_block(const std::string &block_name,
+                                 GLuint binding) {
+  // This check is needed because we use move constructors and
+  // assignment operators
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw ProgramUnspecifiedStateError("Program is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  GLuint index =
+      gl_context->glGetUniformBlockIndex(program, block_name.c_str());
+  if (index == GL_INVALID_INDEX) {
+#ifndef NO_EXCEPTIONS
+    spdlog::error("Couldn't get index of uniform block {}", block_name);
+    throw GetUniformBlockIndexError("Couldn't get index of uniform block");
+#else
+    set_error(std::optional<error>(error::GetUniformBlockIndexError));
+    return;
+#endif
+  }
+
+  gl_context->glUniformBlockBinding(program, index, binding);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
 // Implement checking for an unspecified state
 bool Program::is_in_unspecified_state() const {
   if ((gl_context == nullptr) || (program == 0))
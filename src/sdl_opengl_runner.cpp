@@ -50,6 +50,7 @@ int SDLOpenGL::load_context() {
 // TODO: Get SDL_GL_GetProcAddress wrapped up somehow
 #if defined __SDL_NOGETPROCADDR__
 #define SDL_PROC(ret, func, params) gl_context.func = func;
+#define SDL_PROC_OPTIONAL(ret, func, params) gl_context.func = nullptr;
 #else
 #define SDL_PROC(ret, func, params)                                            \
   do {                                                                         \
@@ -60,10 +61,16 @@ int SDLOpenGL::load_context() {
                           SDL_GetError());                                     \
     }                                                                          \
   } while (0);
+// Optional functions are left as nullptr if they aren't available,
+// GLContext::supports() checks for them before they are used
+#define SDL_PROC_OPTIONAL(ret, func, params)                                   \
+  gl_context.func =                                                            \
+      reinterpret_cast<ret(*) params>(SDL_GL_GetProcAddress(#func));
 #endif /* __SDL_NOGETPROCADDR__ */
 
 #include "SDL_glfuncs.h"
 #undef SDL_PROC
+#undef SDL_PROC_OPTIONAL
   return 0;
 }
 
@@ -241,12 +248,62 @@ int SDLOpenGL::make_current() {
 int SDLOpenGL::swap_window() {
   window->GL_SwapWindow();
 
+  if (max_frames_in_flight == 0)
+    return 0;
+
+  // Drop fences for frames that have already finished, so we only
+  // hold the ones the GPU is still working on
+  while (!frame_fences.empty() && frame_fences.front().is_signaled())
+    frame_fences.pop_front();
+
+  frame_fences.emplace_back(glcontext);
+
+#ifdef NO_EXCEPTIONS
+  if (!frame_fences.back().valid()) {
+    set_error(frame_fences.back().get_last_error());
+    frame_fences.pop_back();
+    return -1;
+  }
+#endif
+
+  // Only block when the GPU is a full max_frames_in_flight frames
+  // behind
+  while (frame_fences.size() > max_frames_in_flight) {
+    frame_fences.front().wait();
+
+#ifdef NO_EXCEPTIONS
+    if (!frame_fences.front().valid()) {
+      set_error(frame_fences.front().get_last_error());
+      return -1;
+    }
+#endif
+
+    frame_fences.pop_front();
+  }
+
   return 0;
 }
 
+void SDLOpenGL::set_max_frames_in_flight(size_t frames) {
+  max_frames_in_flight = frames;
+
+  // Without a limit there is nothing to wait for
+  if (max_frames_in_flight == 0)
+    frame_fences.clear();
+}
+
+size_t SDLOpenGL::get_max_frames_in_flight() const {
+  return max_frames_in_flight;
+}
+
+size_t SDLOpenGL::get_frames_in_flight() const { return frame_fences.size(); }
+
 SDLOpenGL::~SDLOpenGL() { cleanup(); }
 
 void SDLOpenGL::cleanup() noexcept {
+  // The sync objects belong to the GL context, delete them first
+  frame_fences.clear();
+
   if (sdl_gl_context) {
     /* SDL_GL_MakeCurrent(0, NULL); */ /* doesn't do anything */
     sdl->GL_DeleteContext(sdl_gl_context);
@@ -264,6 +321,8 @@ SDLOpenGL::SDLOpenGL(SDLOpenGL &&sgl) noexcept
   gl_context = sgl.gl_context;
   sdl_gl_context = sgl.sdl_gl_context;
   window = std::move(sgl.window);
+  max_frames_in_flight = sgl.max_frames_in_flight;
+  frame_fences = std::move(sgl.frame_fences);
 
 #ifdef NO_EXCEPTIONS
   last_operation_failed = sgl.last_operation_failed;
@@ -272,6 +331,7 @@ SDLOpenGL::SDLOpenGL(SDLOpenGL &&sgl) noexcept
 
   sgl.sdl_gl_context = nullptr;
   sgl.window = nullptr;
+  sgl.frame_fences.clear();
 }
 
 // move assignment operator
@@ -281,6 +341,8 @@ SDLOpenGL &SDLOpenGL::operator=(SDLOpenGL &&sgl) noexcept {
     sdl_gl_context = sgl.sdl_gl_context;
     window = std::move(sgl.window);
     clipping_planes = sgl.clipping_planes;
+    max_frames_in_flight = sgl.max_frames_in_flight;
+    frame_fences = std::move(sgl.frame_fences);
 
 #ifdef NO_EXCEPTIONS
     last_operation_failed = sgl.last_operation_failed;
@@ -289,6 +351,7 @@ SDLOpenGL &SDLOpenGL::operator=(SDLOpenGL &&sgl) noexcept {
 
     sgl.sdl_gl_context = nullptr;
     sgl.window = nullptr;
+    sgl.frame_fences.clear();
   }
 
   return *this;
@@ -2,6 +2,113 @@
 
 using namespace sdl_opengl_cpp;
 
+bool sdl_surface::gl_pixel_format(Uint32 sdl_format,
+                                  GLPixelFormat &pixel_format) {
+  switch (sdl_format) {
+  case SDL_PIXELFORMAT_ARGB8888:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, GL_RGBA8, 4};
+    return true;
+  case SDL_PIXELFORMAT_XRGB8888:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, GL_RGB8, 4};
+    return true;
+  case SDL_PIXELFORMAT_ABGR8888:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, GL_RGBA8, 4};
+    return true;
+  case SDL_PIXELFORMAT_XBGR8888:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, GL_RGB8, 4};
+    return true;
+  case SDL_PIXELFORMAT_RGBA8888:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GL_RGBA8, 4};
+    return true;
+  case SDL_PIXELFORMAT_RGBX8888:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_INT_8_8_8_8, GL_RGB8, 4};
+    return true;
+  case SDL_PIXELFORMAT_BGRA8888:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_INT_8_8_8_8, GL_RGBA8, 4};
+    return true;
+  case SDL_PIXELFORMAT_BGRX8888:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_INT_8_8_8_8, GL_RGB8, 4};
+    return true;
+  case SDL_PIXELFORMAT_ARGB2101010:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_INT_2_10_10_10_REV, GL_RGB10_A2, 4};
+    return true;
+  case SDL_PIXELFORMAT_RGB24:
+    pixel_format = {GL_RGB, GL_UNSIGNED_BYTE, GL_RGB8, 3};
+    return true;
+  case SDL_PIXELFORMAT_BGR24:
+    pixel_format = {GL_BGR, GL_UNSIGNED_BYTE, GL_RGB8, 3};
+    return true;
+  case SDL_PIXELFORMAT_RGB565:
+    pixel_format = {GL_RGB, GL_UNSIGNED_SHORT_5_6_5, GL_RGB8, 2};
+    return true;
+  case SDL_PIXELFORMAT_BGR565:
+    pixel_format = {GL_RGB, GL_UNSIGNED_SHORT_5_6_5_REV, GL_RGB8, 2};
+    return true;
+  case SDL_PIXELFORMAT_RGBA4444:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_BGRA4444:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_ARGB4444:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4_REV, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_ABGR4444:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4_REV, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_XRGB4444:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_4_4_4_4_REV, GL_RGB8, 2};
+    return true;
+  case SDL_PIXELFORMAT_XBGR4444:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4_REV, GL_RGB8, 2};
+    return true;
+  case SDL_PIXELFORMAT_RGBA5551:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_BGRA5551:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_5_5_5_1, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_ARGB1555:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_ABGR1555:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, GL_RGBA8, 2};
+    return true;
+  case SDL_PIXELFORMAT_XRGB1555:
+    pixel_format = {GL_BGRA, GL_UNSIGNED_SHORT_1_5_5_5_REV, GL_RGB8, 2};
+    return true;
+  case SDL_PIXELFORMAT_XBGR1555:
+    pixel_format = {GL_RGBA, GL_UNSIGNED_SHORT_1_5_5_5_REV, GL_RGB8, 2};
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool sdl_surface::gl_row_layout(int width, int bytes_per_pixel, int pitch,
+                                GLint &row_length, GLint &alignment) {
+  int row = width * bytes_per_pixel;
+
+  row_length = 0;
+
+  // SDL pads rows to four bytes, the OpenGL default
+  for (GLint a : {4, 8, 2, 1}) {
+    if ((row + a - 1) / a * a == pitch) {
+      alignment = a;
+      return true;
+    }
+  }
+
+  // Wider rows, for example a surface made from a larger buffer
+  if ((bytes_per_pixel > 0) && (pitch % bytes_per_pixel == 0)) {
+    row_length = pitch / bytes_per_pixel;
+    alignment = (pitch % 4 == 0) ? 4 : ((pitch % 2 == 0) ? 2 : 1);
+    return true;
+  }
+
+  return false;
+}
+
 SDLSurface::SDLSurface(const std::shared_ptr<SDL> &sdl_, SDL_Surface *s)
     : sdl{sdl_}, surface{s} {}
 
@@ -102,8 +209,116 @@ int SDLSurface::h() {
   return -1;
 }
 
+int SDLSurface::pitch() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return -1;
+#endif
+  }
+
+  return surface->pitch;
+}
+
+Uint32 SDLSurface::format() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return SDL_PIXELFORMAT_UNKNOWN;
+#endif
+  }
+
+  return surface->format->format;
+}
+
+bool SDLSurface::GL_PixelFormat(sdl_surface::GLPixelFormat &pixel_format) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  // RLE pixels can only be read after locking, a blit decodes them
+  return !SDL_MUSTLOCK(surface) &&
+         sdl_surface::gl_pixel_format(surface->format->format, pixel_format);
+}
+
+std::optional<SDLSurface> SDLSurface::ConvertToRGBA32() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return std::nullopt;
+#endif
+  }
+
+  Uint8 saved_alpha;
+  SDL_BlendMode saved_mode;
+  SDL_Rect area = {0, 0, surface->w, surface->h};
+
+  std::optional<SDLSurface> image;
+  image.emplace(sdl, 0, surface->w, surface->h, 0, SDL_PIXELFORMAT_RGBA32);
+
+#ifdef NO_EXCEPTIONS
+  if (!image->valid()) {
+    set_error(image->get_last_error());
+    return std::nullopt;
+  }
+#endif
+
+  GetAlphaMod(&saved_alpha);
+  SetAlphaMod(0xFF);
+  GetBlendMode(&saved_mode);
+  SetBlendMode(SDL_BLENDMODE_NONE);
+
+  BlitSurfaceTo(&area, *image, &area);
+
+  SetAlphaMod(saved_alpha);
+  SetBlendMode(saved_mode);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return image;
+}
+
 GLuint SDLSurface::GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
-                                  GLfloat *texcoord) {
+                                  GLfloat *texcoord, const string &name) {
+  return load_texture(gl_context, texcoord, nullptr, name);
+}
+
+GLuint SDLSurface::GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
+                                  GLfloat *texcoord, UploadQueue &queue,
+                                  const string &name) {
+  return load_texture(gl_context, texcoord, &queue, name);
+}
+
+void SDLSurface::GL_DeleteTexture(const std::shared_ptr<GLContext> &gl_context,
+                                  GLuint texture) {
+  gl_context->glDeleteTextures(1, &texture);
+  GPUMemoryRegistry::instance().release(GPUMemoryCategory::Texture, texture);
+}
+
+GLuint SDLSurface::load_texture(const std::shared_ptr<GLContext> &gl_context,
+                                GLfloat *texcoord, UploadQueue *queue,
+                                const string &name) {
   if (is_in_unspecified_state()) {
 #ifndef NO_EXCEPTIONS
     throw sdl_surface::UnspecifiedStateError(
@@ -115,6 +330,18 @@ GLuint SDLSurface::GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
 #endif
   }
 
+  // Check the queue before creating anything, so a moved from queue
+  // doesn't leave a texture behind
+  if ((queue != nullptr) && queue->is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::LoadTextureError("Error trying to load texture");
+#else
+    set_error(std::optional<error>(
+        sdl_opengl_cpp::error::SDLSurfaceLoadTextureError));
+    return -1;
+#endif
+  }
+
   GLuint texture;
   int w, h;
   SDL_Rect area;
@@ -161,16 +388,85 @@ GLuint SDLSurface::GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
     SetAlphaMod(saved_alpha);
     SetBlendMode(saved_mode);
 
+    // Make room in the GPU memory budget, a full texture is just
+    // reported as a load error
+    GLsizeiptr texture_size = static_cast<GLsizeiptr>(w) * h * 4;
+    if (!GPUMemoryRegistry::instance().reserve(texture_size)) {
+#ifndef NO_EXCEPTIONS
+      throw sdl_surface::LoadTextureError("Error trying to load texture");
+#else
+      set_error(std::optional<error>(
+          sdl_opengl_cpp::error::SDLSurfaceLoadTextureError));
+      return -1;
+#endif
+    }
+
     /* Create an OpenGL texture for the image */
-    gl_context->glGenTextures(1, &texture);
-    gl_context->glBindTexture(GL_TEXTURE_2D, texture);
-    gl_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
-                                GL_NEAREST);
-    gl_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-                                GL_NEAREST);
+    bool dsa = gl_context->direct_state_access();
+
+    if (dsa) {
+      // Immutable storage, created and set up by name without
+      // binding
+      gl_context->glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+      gl_context->glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER,
+                                      GL_NEAREST);
+      gl_context->glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER,
+                                      GL_NEAREST);
+      gl_context->glTextureStorage2D(texture, 1, GL_RGBA8, w, h);
+    } else {
+      gl_context->glGenTextures(1, &texture);
+      gl_context->glBindTexture(GL_TEXTURE_2D, texture);
+      gl_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                                  GL_NEAREST);
+      gl_context->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                  GL_NEAREST);
+    }
+
     // TODO: Figure out / design and implement visibility issues
-    gl_context->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
-                             GL_UNSIGNED_BYTE, image.pixels());
+    if (queue == nullptr) {
+      if (dsa)
+        gl_context->glTextureSubImage2D(texture, 0, 0, 0, w, h, GL_RGBA,
+                                        GL_UNSIGNED_BYTE, image.pixels());
+      else
+        gl_context->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
+                                 GL_UNSIGNED_BYTE, image.pixels());
+    } else {
+      // Allocate the storage now, the pixels are copied into the
+      // queue and uploaded by a later flush
+      if (!dsa) {
+        gl_context->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
+                                 GL_UNSIGNED_BYTE, nullptr);
+        gl_context->glBindTexture(GL_TEXTURE_2D, 0);
+      }
+
+      // RGBA32 rows are already four byte aligned
+      std::span<const std::byte> pixels(
+          static_cast<const std::byte *>(image.pixels()),
+          static_cast<size_t>(w) * h * 4);
+
+#ifndef NO_EXCEPTIONS
+      try {
+        queue->enqueue_texture(texture, 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE,
+                               pixels);
+      } catch (BufferDataError &e) {
+        gl_context->glDeleteTextures(1, &texture);
+        throw sdl_surface::LoadTextureError("Error trying to load texture");
+      }
+#else
+      queue->enqueue_texture(texture, 0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE,
+                             pixels);
+
+      if (!queue->valid()) {
+        gl_context->glDeleteTextures(1, &texture);
+        set_error(std::optional<error>(
+            sdl_opengl_cpp::error::SDLSurfaceLoadTextureError));
+        return -1;
+      }
+#endif
+    }
+
+    GPUMemoryRegistry::instance().track(GPUMemoryCategory::Texture, texture,
+                                        name, texture_size);
 
 #ifndef NO_EXCEPTIONS
   } catch (sdl_surface::CreationError &e) {
@@ -180,6 +476,113 @@ GLuint SDLSurface::GL_LoadTexture(const std::shared_ptr<GLContext> &gl_context,
   return texture;
 }
 
+std::optional<Texture>
+SDLSurface::GL_CreateTexture(const std::shared_ptr<GLContext> &gl_context,
+                             const string &name, GLsizei levels) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return std::nullopt;
+#endif
+  }
+
+  // Converted surfaces are RGBA32
+  sdl_surface::GLPixelFormat pixel_format;
+  GLenum internal_format = GL_RGBA8;
+  if (GL_PixelFormat(pixel_format))
+    internal_format = pixel_format.internal_format;
+
+  std::optional<Texture> texture;
+  texture.emplace(name, gl_context, surface->w, surface->h, internal_format,
+                  levels);
+
+#ifdef NO_EXCEPTIONS
+  if (!texture->valid()) {
+    set_error(texture->get_last_error());
+    return std::nullopt;
+  }
+#endif
+
+  if (!update_texture(*texture, 0, 0, 0))
+    return std::nullopt;
+
+  texture->generate_mipmaps();
+
+  return texture;
+}
+
+void SDLSurface::GL_UpdateTexture(Texture &texture, GLint x, GLint y,
+                                  GLint level) {
+  update_texture(texture, x, y, level);
+}
+
+bool SDLSurface::update_texture(Texture &texture, GLint x, GLint y,
+                                GLint level) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw sdl_surface::UnspecifiedStateError(
+        "SDLSurface is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  sdl_surface::GLPixelFormat pixel_format;
+  GLint row_length = 0;
+  GLint alignment = 4;
+
+  if (GL_PixelFormat(pixel_format) &&
+      sdl_surface::gl_row_layout(surface->w, surface->format->BytesPerPixel,
+                                 surface->pitch, row_length, alignment)) {
+    std::span<const std::byte> pixels(
+        static_cast<const std::byte *>(surface->pixels),
+        static_cast<size_t>(surface->pitch) * surface->h);
+
+    texture.upload(x, y, surface->w, surface->h, pixels, pixel_format.format,
+                   pixel_format.type, level, row_length, alignment);
+
+#ifdef NO_EXCEPTIONS
+    if (!texture.valid()) {
+      set_error(texture.get_last_error());
+      return false;
+    }
+
+    last_operation_failed = false;
+#endif
+
+    return true;
+  }
+
+  // Palettized, YUV and RLE surfaces are the only ones copied
+#ifndef NO_EXCEPTIONS
+  try {
+    std::optional<SDLSurface> image = ConvertToRGBA32();
+
+    return image->update_texture(texture, x, y, level);
+  } catch (sdl_surface::CreationError &e) {
+    throw sdl_surface::LoadTextureError("Error trying to load texture");
+  }
+#else
+  std::optional<SDLSurface> image = ConvertToRGBA32();
+
+  if (!image || !image->update_texture(texture, x, y, level)) {
+    set_error(std::optional<error>(
+        sdl_opengl_cpp::error::SDLSurfaceLoadTextureError));
+    return false;
+  }
+
+  last_operation_failed = false;
+
+  return true;
+#endif
+}
+
 int SDLSurface::BlitSurfaceFrom(const SDLSurface &src, const SDL_Rect *srcrect,
                                 SDL_Rect *dstrect) {
   if (is_in_unspecified_state()) {
@@ -0,0 +1,203 @@
+#include "shader_storage_buffer_object.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::shader_storage_buffer_object;
+
+ShaderStorageBufferObject::ShaderStorageBufferObject(
+    const string &buffer_name, const std::shared_ptr<GLContext> &ctx,
+    GLsizeiptr size, GLenum usage)
+    : name{buffer_name}, gl_context{ctx} {
+  create(size, {}, usage);
+}
+
+ShaderStorageBufferObject::ShaderStorageBufferObject(
+    const string &buffer_name, const std::shared_ptr<GLContext> &ctx,
+    std::span<const std::byte> data, GLenum usage)
+    : name{buffer_name}, gl_context{ctx} {
+  create(static_cast<GLsizeiptr>(data.size()), data, usage);
+}
+
+void ShaderStorageBufferObject::create(GLsizeiptr size,
+                                       std::span<const std::byte> data,
+                                       GLenum usage) {
+  if (!gl_context->supports(GLFeature::ShaderStorageBufferObject)) {
+#ifndef NO_EXCEPTIONS
+    cleanup();
+    throw ShaderStorageNotSupportedError(
+        "ERROR::SHADER_STORAGE_BUFFER::NOT_SUPPORTED");
+#else
+    set_error(std::optional<error>(error::FeatureNotSupportedError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if (size <= 0) {
+#ifndef NO_EXCEPTIONS
+    cleanup();
+    throw BufferDataError(
+        "ERROR::SHADER_STORAGE_BUFFER::BUFFER_DATA_ERROR::NO_DATA");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  GLint alignment = 0;
+  gl_context->glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT,
+                            &alignment);
+  if (alignment > 0)
+    offset_alignment = alignment;
+
+  // The storage is created through GL_ARRAY_BUFFER by the
+  // VertexBufferObject, buffer objects aren't typed
+  if (data.empty())
+    buffer.emplace(name, gl_context, size, usage);
+  else
+    buffer.emplace(name, gl_context, data, usage);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    cleanup();
+    return;
+  }
+#endif
+}
+
+ShaderStorageBufferObject::~ShaderStorageBufferObject() { cleanup(); }
+
+void ShaderStorageBufferObject::cleanup() noexcept {
+  // The VertexBufferObject deletes the OpenGL buffer
+  buffer.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+ShaderStorageBufferObject::ShaderStorageBufferObject(
+    ShaderStorageBufferObject &&ssbo) noexcept
+    : name{ssbo.name}, gl_context{ssbo.gl_context},
+      buffer{std::move(ssbo.buffer)}, offset_alignment{ssbo.offset_alignment} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = ssbo.last_operation_failed;
+  last_error = ssbo.last_error;
+#endif
+
+  ssbo.gl_context = nullptr;
+  ssbo.buffer.reset();
+}
+
+// move assignment operator
+ShaderStorageBufferObject &ShaderStorageBufferObject::operator=(
+    ShaderStorageBufferObject &&ssbo) noexcept {
+  if (&ssbo != this) {
+    cleanup();
+
+    name = ssbo.name;
+    gl_context = ssbo.gl_context;
+    buffer = std::move(ssbo.buffer);
+    offset_alignment = ssbo.offset_alignment;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = ssbo.last_operation_failed;
+    last_error = ssbo.last_error;
+#endif
+
+    ssbo.gl_context = nullptr;
+    ssbo.buffer.reset();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool ShaderStorageBufferObject::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || !buffer)
+    return true;
+  else
+    return false;
+}
+
+void ShaderStorageBufferObject::update(GLintptr offset,
+                                       std::span<const std::byte> data) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw ShaderStorageBufferObjectUnspecifiedStateError(
+        "Shader Storage Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  buffer->update(offset, data);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+void ShaderStorageBufferObject::bind_base(GLuint binding) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw ShaderStorageBufferObjectUnspecifiedStateError(
+        "Shader Storage Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  buffer->bind_base(GL_SHADER_STORAGE_BUFFER, binding);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void ShaderStorageBufferObject::bind_range(GLuint binding, GLintptr offset,
+                                           GLsizeiptr range_size) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw ShaderStorageBufferObjectUnspecifiedStateError(
+        "Shader Storage Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if (offset % offset_alignment != 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::SHADER_STORAGE_BUFFER::BUFFER_DATA_ERROR::MISALIGNED_OFFSET");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  buffer->bind_range(GL_SHADER_STORAGE_BUFFER, binding, offset, range_size);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr ShaderStorageBufferObject::get_size() const {
+  return buffer ? buffer->get_size() : 0;
+}
+
+GLint ShaderStorageBufferObject::get_offset_alignment() const {
+  return offset_alignment;
+}
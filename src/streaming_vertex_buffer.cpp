@@ -0,0 +1,257 @@
+#include <limits>
+
+#ifndef NO_EXCEPTIONS
+#include "spdlog/spdlog.h"
+#endif
+
+#include "streaming_vertex_buffer.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::streaming_vertex_buffer;
+
+StreamingVertexBuffer::StreamingVertexBuffer(
+    const string &buffer_name, const std::shared_ptr<GLContext> &ctx,
+    GLsizeiptr region_size_, GLuint region_count_)
+    : name{buffer_name}, gl_context{ctx}, region_size{region_size_},
+      region_count{region_count_} {
+  if (!ctx->supports(GLFeature::BufferStorage)) {
+#ifndef NO_EXCEPTIONS
+    throw StreamingBufferNotSupportedError(
+        "ERROR::STREAMING_VERTEX_BUFFER::BUFFER_STORAGE_NOT_SUPPORTED");
+#else
+    set_error(std::optional<error>(error::FeatureNotSupportedError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if ((region_size <= 0) || (region_count == 0) ||
+      (region_size > std::numeric_limits<GLsizeiptr>::max() / region_count)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::STREAMING_VERTEX_BUFFER::BUFFER_DATA_ERROR::INVALID_SIZE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if (!GPUMemoryRegistry::instance().reserve(region_size * region_count)) {
+#ifndef NO_EXCEPTIONS
+    throw OutOfMemoryError("ERROR::STREAMING_VERTEX_BUFFER::OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    cleanup();
+    return;
+#endif
+  }
+
+  ctx->glGenBuffers(1, &VBO);
+
+  GLenum error = gl_context->glGetError();
+
+  if ((error == GL_OUT_OF_MEMORY) || (VBO == 0)) {
+#ifndef NO_EXCEPTIONS
+    throw GenBuffersError("ERROR::STREAMING_VERTEX_BUFFER::GEN_BUFFERS_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::GenBuffersError));
+    cleanup();
+    return;
+#endif
+  }
+
+  GLsizeiptr buffer_size = region_size * region_count;
+
+  // Persistent and coherent, so writes through the mapping are
+  // visible to the GPU without explicit flushes or remapping
+  GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  ctx->glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  ctx->glBufferStorage(GL_ARRAY_BUFFER, buffer_size, nullptr, flags);
+  mapped = static_cast<std::byte *>(
+      ctx->glMapBufferRange(GL_ARRAY_BUFFER, 0, buffer_size, flags));
+  ctx->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (mapped == nullptr) {
+#ifndef NO_EXCEPTIONS
+    cleanup();
+    throw StreamingBufferMapError(
+        "ERROR::STREAMING_VERTEX_BUFFER::MAP_BUFFER_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::MapBufferError));
+    cleanup();
+    return;
+#endif
+  }
+
+  fences.resize(region_count);
+
+  GPUMemoryRegistry::instance().track(GPUMemoryCategory::StreamingBuffer, VBO,
+                                      name, buffer_size);
+}
+
+StreamingVertexBuffer::~StreamingVertexBuffer() { cleanup(); }
+
+void StreamingVertexBuffer::cleanup() noexcept {
+  // Deleting the fences deletes their sync objects
+  fences.clear();
+
+  // Deleting a mapped buffer implicitly unmaps it
+  if ((gl_context != nullptr) && (VBO != 0)) {
+    gl_context->glDeleteBuffers(1, &VBO);
+    GPUMemoryRegistry::instance().release(GPUMemoryCategory::StreamingBuffer,
+                                          VBO);
+  }
+
+  mapped = nullptr;
+  VBO = 0;
+  gl_context = nullptr;
+}
+
+// move constructor
+StreamingVertexBuffer::StreamingVertexBuffer(
+    StreamingVertexBuffer &&buffer) noexcept
+    : name{buffer.name}, gl_context{buffer.gl_context}, VBO{buffer.VBO},
+      mapped{buffer.mapped}, region_size{buffer.region_size},
+      region_count{buffer.region_count},
+      current_region{buffer.current_region},
+      fences{std::move(buffer.fences)} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = buffer.last_operation_failed;
+  last_error = buffer.last_error;
+#endif
+
+  buffer.gl_context = nullptr;
+  buffer.VBO = 0;
+  buffer.mapped = nullptr;
+  buffer.fences.clear();
+}
+
+// move assignment operator
+StreamingVertexBuffer &
+StreamingVertexBuffer::operator=(StreamingVertexBuffer &&buffer) noexcept {
+  if (&buffer != this) {
+    cleanup();
+
+    name = buffer.name;
+    gl_context = buffer.gl_context;
+    VBO = buffer.VBO;
+    mapped = buffer.mapped;
+    region_size = buffer.region_size;
+    region_count = buffer.region_count;
+    current_region = buffer.current_region;
+    fences = std::move(buffer.fences);
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = buffer.last_operation_failed;
+    last_error = buffer.last_error;
+#endif
+
+    buffer.gl_context = nullptr;
+    buffer.VBO = 0;
+    buffer.mapped = nullptr;
+    buffer.fences.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool StreamingVertexBuffer::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (VBO == 0) || (mapped == nullptr))
+    return true;
+  else
+    return false;
+}
+
+void StreamingVertexBuffer::bind() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw StreamingVertexBufferUnspecifiedStateError(
+        "Streaming Vertex Buffer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  gl_context->glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+std::span<std::byte> StreamingVertexBuffer::begin_region() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw StreamingVertexBufferUnspecifiedStateError(
+        "Streaming Vertex Buffer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return {};
+#endif
+  }
+
+  std::optional<Fence> &fence = fences[current_region];
+
+  if (fence) {
+    fence->wait();
+
+#ifdef NO_EXCEPTIONS
+    if (!fence->valid()) {
+      set_error(fence->get_last_error());
+      return {};
+    }
+#endif
+
+    fence.reset();
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return std::span<std::byte>(mapped + region_offset(),
+                              static_cast<size_t>(region_size));
+}
+
+void StreamingVertexBuffer::end_region() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw StreamingVertexBufferUnspecifiedStateError(
+        "Streaming Vertex Buffer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  std::optional<Fence> &fence = fences[current_region];
+  fence.emplace(gl_context);
+
+#ifdef NO_EXCEPTIONS
+  if (!fence->valid()) {
+    set_error(fence->get_last_error());
+    fence.reset();
+    return;
+  }
+#endif
+
+  current_region = (current_region + 1) % region_count;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLintptr StreamingVertexBuffer::region_offset() const {
+  return static_cast<GLintptr>(current_region) * region_size;
+}
+
+GLsizeiptr StreamingVertexBuffer::get_region_size() const {
+  return region_size;
+}
+
+GLuint StreamingVertexBuffer::get_region_count() const { return region_count; }
@@ -0,0 +1,869 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "texture.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::texture;
+
+// Bytes per texel of a sized internal format, for memory accounting,
+// 0 if unknown.  Three component formats are usually padded to four
+// components.
+GLsizeiptr Texture::texel_size(GLenum internal_format) {
+  switch (internal_format) {
+  case GL_R8:
+  case GL_R8_SNORM:
+  case GL_R8UI:
+  case GL_R8I:
+    return 1;
+  case GL_RG8:
+  case GL_RG8_SNORM:
+  case GL_RG8UI:
+  case GL_RG8I:
+  case GL_R16:
+  case GL_R16_SNORM:
+  case GL_R16F:
+  case GL_R16UI:
+  case GL_R16I:
+  case GL_RGB565:
+  case GL_RGBA4:
+  case GL_RGB5_A1:
+  case GL_DEPTH_COMPONENT16:
+    return 2;
+  case GL_RGB8:
+  case GL_RGB8_SNORM:
+  case GL_SRGB8:
+  case GL_RGB8UI:
+  case GL_RGB8I:
+  case GL_RGBA8:
+  case GL_RGBA8_SNORM:
+  case GL_SRGB8_ALPHA8:
+  case GL_RGBA8UI:
+  case GL_RGBA8I:
+  case GL_RGB10_A2:
+  case GL_RGB10_A2UI:
+  case GL_R11F_G11F_B10F:
+  case GL_RGB9_E5:
+  case GL_RG16:
+  case GL_RG16_SNORM:
+  case GL_RG16F:
+  case GL_RG16UI:
+  case GL_RG16I:
+  case GL_R32F:
+  case GL_R32UI:
+  case GL_R32I:
+  case GL_DEPTH_COMPONENT24:
+  case GL_DEPTH_COMPONENT32F:
+  case GL_DEPTH24_STENCIL8:
+    return 4;
+  case GL_RGB16:
+  case GL_RGB16_SNORM:
+  case GL_RGB16F:
+  case GL_RGB16UI:
+  case GL_RGB16I:
+  case GL_RGBA16:
+  case GL_RGBA16_SNORM:
+  case GL_RGBA16F:
+  case GL_RGBA16UI:
+  case GL_RGBA16I:
+  case GL_RG32F:
+  case GL_RG32UI:
+  case GL_RG32I:
+  case GL_DEPTH32F_STENCIL8:
+    return 8;
+  case GL_RGB32F:
+  case GL_RGB32UI:
+  case GL_RGB32I:
+  case GL_RGBA32F:
+  case GL_RGBA32UI:
+  case GL_RGBA32I:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+// A format and type glTexImage2D accepts for an internal format when
+// allocating storage without pixels.  Integer formats need an integer
+// format, and OpenGL ES wants a type matching the internal format.
+void Texture::storage_format(GLenum internal_format, GLenum &format,
+                             GLenum &type) {
+  switch (internal_format) {
+  case GL_R8:
+  case GL_R8_SNORM:
+  case GL_R16:
+  case GL_R16_SNORM:
+  case GL_R16F:
+  case GL_R32F:
+    format = GL_RED;
+    break;
+  case GL_R8UI:
+  case GL_R8I:
+  case GL_R16UI:
+  case GL_R16I:
+  case GL_R32UI:
+  case GL_R32I:
+    format = GL_RED_INTEGER;
+    break;
+  case GL_RG8:
+  case GL_RG8_SNORM:
+  case GL_RG16:
+  case GL_RG16_SNORM:
+  case GL_RG16F:
+  case GL_RG32F:
+    format = GL_RG;
+    break;
+  case GL_RG8UI:
+  case GL_RG8I:
+  case GL_RG16UI:
+  case GL_RG16I:
+  case GL_RG32UI:
+  case GL_RG32I:
+    format = GL_RG_INTEGER;
+    break;
+  case GL_RGB8:
+  case GL_RGB8_SNORM:
+  case GL_SRGB8:
+  case GL_RGB565:
+  case GL_R11F_G11F_B10F:
+  case GL_RGB9_E5:
+  case GL_RGB16:
+  case GL_RGB16_SNORM:
+  case GL_RGB16F:
+  case GL_RGB32F:
+    format = GL_RGB;
+    break;
+  case GL_RGB8UI:
+  case GL_RGB8I:
+  case GL_RGB16UI:
+  case GL_RGB16I:
+  case GL_RGB32UI:
+  case GL_RGB32I:
+    format = GL_RGB_INTEGER;
+    break;
+  case GL_RGBA8UI:
+  case GL_RGBA8I:
+  case GL_RGB10_A2UI:
+  case GL_RGBA16UI:
+  case GL_RGBA16I:
+  case GL_RGBA32UI:
+  case GL_RGBA32I:
+    format = GL_RGBA_INTEGER;
+    break;
+  case GL_DEPTH_COMPONENT16:
+  case GL_DEPTH_COMPONENT24:
+  case GL_DEPTH_COMPONENT32F:
+    format = GL_DEPTH_COMPONENT;
+    break;
+  case GL_DEPTH24_STENCIL8:
+  case GL_DEPTH32F_STENCIL8:
+    format = GL_DEPTH_STENCIL;
+    break;
+  default:
+    format = GL_RGBA;
+    break;
+  }
+
+  switch (internal_format) {
+  case GL_R8_SNORM:
+  case GL_RG8_SNORM:
+  case GL_RGB8_SNORM:
+  case GL_RGBA8_SNORM:
+  case GL_R8I:
+  case GL_RG8I:
+  case GL_RGB8I:
+  case GL_RGBA8I:
+    type = GL_BYTE;
+    break;
+  case GL_R16:
+  case GL_RG16:
+  case GL_RGB16:
+  case GL_RGBA16:
+  case GL_R16UI:
+  case GL_RG16UI:
+  case GL_RGB16UI:
+  case GL_RGBA16UI:
+  case GL_DEPTH_COMPONENT16:
+    type = GL_UNSIGNED_SHORT;
+    break;
+  case GL_R16_SNORM:
+  case GL_RG16_SNORM:
+  case GL_RGB16_SNORM:
+  case GL_RGBA16_SNORM:
+  case GL_R16I:
+  case GL_RG16I:
+  case GL_RGB16I:
+  case GL_RGBA16I:
+    type = GL_SHORT;
+    break;
+  case GL_R32UI:
+  case GL_RG32UI:
+  case GL_RGB32UI:
+  case GL_RGBA32UI:
+  case GL_DEPTH_COMPONENT24:
+    type = GL_UNSIGNED_INT;
+    break;
+  case GL_R32I:
+  case GL_RG32I:
+  case GL_RGB32I:
+  case GL_RGBA32I:
+    type = GL_INT;
+    break;
+  case GL_R16F:
+  case GL_RG16F:
+  case GL_RGB16F:
+  case GL_RGBA16F:
+    type = GL_HALF_FLOAT;
+    break;
+  case GL_R32F:
+  case GL_RG32F:
+  case GL_RGB32F:
+  case GL_RGBA32F:
+  case GL_R11F_G11F_B10F:
+  case GL_RGB9_E5:
+  case GL_DEPTH_COMPONENT32F:
+    type = GL_FLOAT;
+    break;
+  case GL_RGB565:
+    type = GL_UNSIGNED_SHORT_5_6_5;
+    break;
+  case GL_RGB10_A2:
+  case GL_RGB10_A2UI:
+    type = GL_UNSIGNED_INT_2_10_10_10_REV;
+    break;
+  case GL_DEPTH24_STENCIL8:
+    type = GL_UNSIGNED_INT_24_8;
+    break;
+  case GL_DEPTH32F_STENCIL8:
+    type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV;
+    break;
+  default:
+    type = GL_UNSIGNED_BYTE;
+    break;
+  }
+}
+
+// Bytes per pixel of client pixel data, 0 if unknown
+size_t Texture::pixel_size(GLenum format, GLenum type) {
+  switch (type) {
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_5_6_5_REV:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+  case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+    return 2;
+  case GL_UNSIGNED_INT_8_8_8_8:
+  case GL_UNSIGNED_INT_8_8_8_8_REV:
+  case GL_UNSIGNED_INT_10_10_10_2:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_24_8:
+    return 4;
+  }
+
+  size_t components = 0;
+  switch (format) {
+  case GL_RED:
+  case GL_DEPTH_COMPONENT:
+    components = 1;
+    break;
+  case GL_RG:
+    components = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+    components = 3;
+    break;
+  case GL_RGBA:
+  case GL_BGRA:
+    components = 4;
+    break;
+  default:
+    return 0;
+  }
+
+  switch (type) {
+  case GL_BYTE:
+  case GL_UNSIGNED_BYTE:
+    return components;
+  case GL_SHORT:
+  case GL_UNSIGNED_SHORT:
+  case GL_HALF_FLOAT:
+    return components * 2;
+  case GL_INT:
+  case GL_UNSIGNED_INT:
+  case GL_FLOAT:
+    return components * 4;
+  default:
+    return 0;
+  }
+}
+
+// The bytes glTexSubImage2D reads for a rectangle, rows row_length
+// texels apart and padded to alignment.  The last row isn't padded.
+size_t Texture::image_size(GLsizei rect_width, GLsizei rect_height,
+                           GLint row_length, GLint alignment, size_t pixel) {
+  size_t row = static_cast<size_t>(rect_width) * pixel;
+  size_t stride = static_cast<size_t>(row_length) * pixel;
+  size_t align = static_cast<size_t>(alignment);
+  size_t padded_stride = (stride + align - 1) / align * align;
+
+  return padded_stride * static_cast<size_t>(rect_height - 1) + row;
+}
+
+Texture::Texture(const string &texture_name,
+                 const std::shared_ptr<GLContext> &ctx, GLsizei width_,
+                 GLsizei height_, GLenum internal_format_, GLsizei levels_)
+    : name{texture_name}, gl_context{ctx}, width{width_}, height{height_},
+      internal_format{internal_format_} {
+  if ((width <= 0) || (height <= 0) || (levels_ < 0) ||
+      (levels_ > mip_levels(width, height))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError("ERROR::TEXTURE::TEXTURE_DATA_ERROR::BAD_SIZE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  // Without the size of a texel the memory can't be accounted for,
+  // and without a matching format the storage can't be allocated
+  if (texel_size(internal_format) == 0) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError("ERROR::TEXTURE::TEXTURE_DATA_ERROR::BAD_FORMAT");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  levels = (levels_ == 0) ? mip_levels(width, height) : levels_;
+
+  GLsizeiptr texture_size = 0;
+  for (GLsizei level = 0; level < levels; level++)
+    texture_size += static_cast<GLsizeiptr>(std::max(width >> level, 1)) *
+                    std::max(height >> level, 1) *
+                    texel_size(internal_format);
+
+  GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+  // Evict cached resources first if the texture would go over the
+  // memory budget
+  if (!registry.reserve(texture_size)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureOutOfMemoryError("ERROR::TEXTURE::OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if (gl_context->direct_state_access())
+    gl_context->glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+  else
+    gl_context->glGenTextures(1, &texture);
+
+  GLenum error = gl_context->glGetError();
+
+  if ((error == GL_OUT_OF_MEMORY) || (texture == 0)) {
+#ifndef NO_EXCEPTIONS
+    throw GenTexturesError("ERROR::TEXTURE::GEN_TEXTURES_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::GenTexturesError));
+    cleanup();
+    return;
+#endif
+  }
+
+  // Every level is allocated now, so the texture is complete however
+  // it is filled and sampled
+  allocate_storage(*gl_context, GL_TEXTURE_2D, texture, levels,
+                   internal_format, width, height, 1);
+
+  error = gl_context->glGetError();
+
+  // GL_OUT_OF_MEMORY, or GL_INVALID_ENUM for an internal format the
+  // context doesn't have
+  if (error != GL_NO_ERROR) {
+    cleanup();
+#ifndef NO_EXCEPTIONS
+    throw GenTexturesError("ERROR::TEXTURE::TEX_STORAGE_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::GenTexturesError));
+    return;
+#endif
+  }
+
+  size = texture_size;
+  registry.track(GPUMemoryCategory::Texture, texture, name, size);
+
+  set_filter(filter);
+}
+
+Texture::~Texture() { cleanup(); }
+
+void Texture::cleanup() noexcept {
+  if (texture != 0) {
+    if (gl_context != nullptr) {
+      gl_context->glDeleteTextures(1, &texture);
+      GPUMemoryRegistry::instance().release(GPUMemoryCategory::Texture,
+                                            texture);
+    }
+
+    texture = 0;
+  }
+
+  gl_context = nullptr;
+}
+
+// move constructor
+Texture::Texture(Texture &&other) noexcept
+    : name{other.name}, gl_context{other.gl_context}, texture{other.texture},
+      width{other.width}, height{other.height}, levels{other.levels},
+      internal_format{other.internal_format}, filter{other.filter},
+      size{other.size} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = other.last_operation_failed;
+  last_error = other.last_error;
+#endif
+
+  other.gl_context = nullptr;
+  other.texture = 0;
+}
+
+// move assignment operator
+Texture &Texture::operator=(Texture &&other) noexcept {
+  if (&other != this) {
+    cleanup();
+
+    name = other.name;
+    gl_context = other.gl_context;
+    texture = other.texture;
+    width = other.width;
+    height = other.height;
+    levels = other.levels;
+    internal_format = other.internal_format;
+    filter = other.filter;
+    size = other.size;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = other.last_operation_failed;
+    last_error = other.last_error;
+#endif
+
+    other.gl_context = nullptr;
+    other.texture = 0;
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool Texture::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (texture == 0))
+    return true;
+  else
+    return false;
+}
+
+bool Texture::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw TextureUnspecifiedStateError("Texture is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void Texture::bind(GLuint unit) {
+  if (!check_state())
+    return;
+
+  gl_context->glActiveTexture(GL_TEXTURE0 + unit);
+  gl_context->glBindTexture(GL_TEXTURE_2D, texture);
+
+  GPUMemoryRegistry::instance().touch(GPUMemoryCategory::Texture, texture);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void Texture::upload(std::span<const std::byte> pixels, GLenum format,
+                     GLenum type) {
+  upload(0, 0, width, height, pixels, format, type);
+}
+
+void Texture::upload(GLint x, GLint y, GLsizei rect_width,
+                     GLsizei rect_height, std::span<const std::byte> pixels,
+                     GLenum format, GLenum type, GLint level,
+                     GLint row_length, GLint alignment) {
+  if (!check_state())
+    return;
+
+  if (!check_upload(x, y, rect_width, rect_height, pixels.size(), format,
+                    type, level, row_length, alignment))
+    return;
+
+  sub_image(x, y, rect_width, rect_height, pixels.data(), format, type, level,
+            row_length, alignment);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void Texture::upload(GLint x, GLint y, GLsizei rect_width,
+                     GLsizei rect_height, VertexBufferObject &buffer,
+                     GLintptr offset, GLenum format, GLenum type,
+                     GLint level) {
+  if (!check_state())
+    return;
+
+  if ((offset < 0) || (offset > buffer.get_size())) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE::TEXTURE_DATA_ERROR::BAD_BUFFER_OFFSET");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return;
+#endif
+  }
+
+  // Checked before binding, so a bad rectangle can't leave the
+  // buffer bound for later uploads from client memory
+  if (!check_upload(x, y, rect_width, rect_height,
+                    static_cast<size_t>(buffer.get_size() - offset), format,
+                    type, level, 0, 4))
+    return;
+
+  buffer.bind(GL_PIXEL_UNPACK_BUFFER);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer.valid()) {
+    set_error(buffer.get_last_error());
+    return;
+  }
+#endif
+
+  // With a pixel unpack buffer bound the pixels pointer is an offset
+  // into the buffer
+  sub_image(x, y, rect_width, rect_height,
+            reinterpret_cast<const GLvoid *>(
+                static_cast<std::uintptr_t>(offset)),
+            format, type, level, 0, 4);
+
+  gl_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+bool Texture::check_upload(GLint x, GLint y, GLsizei rect_width,
+                           GLsizei rect_height, size_t available,
+                           GLenum format, GLenum type, GLint level,
+                           GLint row_length, GLint alignment) {
+  if ((level < 0) || (level >= levels)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError("ERROR::TEXTURE::TEXTURE_DATA_ERROR::BAD_LEVEL");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return false;
+#endif
+  }
+
+  GLsizei level_width = std::max(width >> level, 1);
+  GLsizei level_height = std::max(height >> level, 1);
+
+  if ((x < 0) || (y < 0) || (rect_width <= 0) || (rect_height <= 0) ||
+      (rect_width > level_width - x) || (rect_height > level_height - y)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE::TEXTURE_DATA_ERROR::RECT_OUT_OF_BOUNDS");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return false;
+#endif
+  }
+
+  if (((row_length != 0) && (row_length < rect_width)) ||
+      ((alignment != 1) && (alignment != 2) && (alignment != 4) &&
+       (alignment != 8))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE::TEXTURE_DATA_ERROR::BAD_ROW_LAYOUT");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return false;
+#endif
+  }
+
+  // Formats the check doesn't know are passed through to OpenGL
+  size_t pixel = pixel_size(format, type);
+  GLint row = (row_length == 0) ? rect_width : row_length;
+
+  if ((pixel != 0) &&
+      (available <
+       image_size(rect_width, rect_height, row, alignment, pixel))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE::TEXTURE_DATA_ERROR::TOO_FEW_PIXELS");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void Texture::sub_image(GLint x, GLint y, GLsizei rect_width,
+                        GLsizei rect_height, const GLvoid *pixels,
+                        GLenum format, GLenum type, GLint level,
+                        GLint row_length, GLint alignment) {
+  set_unpack_rows(*gl_context, row_length, alignment);
+
+  if (gl_context->direct_state_access()) {
+    gl_context->glTextureSubImage2D(texture, level, x, y, rect_width,
+                                    rect_height, format, type, pixels);
+  } else {
+    gl_context->glBindTexture(GL_TEXTURE_2D, texture);
+    gl_context->glTexSubImage2D(GL_TEXTURE_2D, level, x, y, rect_width,
+                                rect_height, format, type, pixels);
+  }
+
+  reset_unpack_rows(*gl_context, row_length, alignment);
+}
+
+void Texture::generate_mipmaps() {
+  if (!check_state())
+    return;
+
+  if (levels > 1)
+    generate_mipmap(*gl_context, GL_TEXTURE_2D, texture);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void Texture::set_filter(TextureFilter filter_) {
+  if (!check_state())
+    return;
+
+  apply_filter(*gl_context, GL_TEXTURE_2D, texture, filter_, levels > 1);
+
+  filter = filter_;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void Texture::set_wrap(GLenum wrap_s, GLenum wrap_t) {
+  if (!check_state())
+    return;
+
+  apply_wrap(*gl_context, GL_TEXTURE_2D, texture, wrap_s, wrap_t);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLfloat Texture::set_anisotropy(GLfloat anisotropy) {
+  if (!check_state())
+    return 1.0f;
+
+  // Anisotropy is a quality setting, without it the texture is just
+  // sampled with its filter
+  if (!gl_context->supports(GLFeature::AnisotropicFiltering)) {
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+    return 1.0f;
+  }
+
+  GLfloat max_anisotropy = 1.0f;
+  gl_context->glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &max_anisotropy);
+
+  anisotropy = std::clamp(anisotropy, 1.0f, std::max(max_anisotropy, 1.0f));
+
+  if (gl_context->direct_state_access()) {
+    gl_context->glTextureParameterf(texture, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                                    anisotropy);
+  } else {
+    gl_context->glBindTexture(GL_TEXTURE_2D, texture);
+    gl_context->glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                                anisotropy);
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return anisotropy;
+}
+
+void Texture::filter_parameters(TextureFilter texture_filter, bool mipmapped,
+                                GLint &min_filter, GLint &mag_filter) {
+  min_filter = GL_LINEAR;
+  mag_filter = GL_LINEAR;
+
+  switch (texture_filter) {
+  case TextureFilter::Nearest:
+    min_filter = mipmapped ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+    mag_filter = GL_NEAREST;
+    break;
+  case TextureFilter::Linear:
+    break;
+  case TextureFilter::Bilinear:
+    if (mipmapped)
+      min_filter = GL_LINEAR_MIPMAP_NEAREST;
+    break;
+  case TextureFilter::Trilinear:
+    if (mipmapped)
+      min_filter = GL_LINEAR_MIPMAP_LINEAR;
+    break;
+  }
+}
+
+void Texture::allocate_storage(GLContext &ctx, GLenum target,
+                               GLuint texture_, GLsizei levels_,
+                               GLenum internal_format_, GLsizei width_,
+                               GLsizei height_, GLsizei layers) {
+  bool array = (target == GL_TEXTURE_2D_ARRAY);
+
+  if (ctx.direct_state_access()) {
+    if (array)
+      ctx.glTextureStorage3D(texture_, levels_, internal_format_, width_,
+                             height_, layers);
+    else
+      ctx.glTextureStorage2D(texture_, levels_, internal_format_, width_,
+                             height_);
+    return;
+  }
+
+  ctx.glBindTexture(target, texture_);
+
+  if (ctx.supports(GLFeature::TextureStorage)) {
+    if (array)
+      ctx.glTexStorage3D(target, levels_, internal_format_, width_, height_,
+                         layers);
+    else
+      ctx.glTexStorage2D(target, levels_, internal_format_, width_, height_);
+    return;
+  }
+
+  GLenum format;
+  GLenum type;
+  storage_format(internal_format_, format, type);
+
+  // Levels shrink in width and height, every level of an array keeps
+  // all the layers
+  for (GLsizei level = 0; level < levels_; level++) {
+    GLsizei level_width = std::max(width_ >> level, 1);
+    GLsizei level_height = std::max(height_ >> level, 1);
+
+    if (array)
+      ctx.glTexImage3D(target, level, static_cast<GLint>(internal_format_),
+                       level_width, level_height, layers, 0, format, type,
+                       nullptr);
+    else
+      ctx.glTexImage2D(target, level, static_cast<GLint>(internal_format_),
+                       level_width, level_height, 0, format, type, nullptr);
+  }
+
+  // Without this the texture is incomplete until the levels below a
+  // 1x1 level exist, which they never do
+  ctx.glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, levels_ - 1);
+}
+
+void Texture::parameter(GLContext &ctx, GLenum target, GLuint texture_,
+                        GLenum pname, GLint value) {
+  if (ctx.direct_state_access()) {
+    ctx.glTextureParameteri(texture_, pname, value);
+  } else {
+    ctx.glBindTexture(target, texture_);
+    ctx.glTexParameteri(target, pname, value);
+  }
+}
+
+void Texture::apply_filter(GLContext &ctx, GLenum target, GLuint texture_,
+                           TextureFilter texture_filter, bool mipmapped) {
+  GLint min_filter;
+  GLint mag_filter;
+  filter_parameters(texture_filter, mipmapped, min_filter, mag_filter);
+
+  parameter(ctx, target, texture_, GL_TEXTURE_MIN_FILTER, min_filter);
+  parameter(ctx, target, texture_, GL_TEXTURE_MAG_FILTER, mag_filter);
+}
+
+void Texture::apply_wrap(GLContext &ctx, GLenum target, GLuint texture_,
+                         GLenum wrap_s, GLenum wrap_t) {
+  parameter(ctx, target, texture_, GL_TEXTURE_WRAP_S,
+            static_cast<GLint>(wrap_s));
+  parameter(ctx, target, texture_, GL_TEXTURE_WRAP_T,
+            static_cast<GLint>(wrap_t));
+}
+
+void Texture::generate_mipmap(GLContext &ctx, GLenum target,
+                              GLuint texture_) {
+  if (ctx.direct_state_access()) {
+    ctx.glGenerateTextureMipmap(texture_);
+  } else {
+    ctx.glBindTexture(target, texture_);
+    ctx.glGenerateMipmap(target);
+  }
+}
+
+void Texture::set_unpack_rows(GLContext &ctx, GLint row_length,
+                              GLint alignment) {
+  // Everything else leaves the pixel store at its defaults, so only
+  // pay for the state changes when the rows aren't the default
+  if (row_length != 0)
+    ctx.glPixelStorei(GL_UNPACK_ROW_LENGTH, row_length);
+  if (alignment != 4)
+    ctx.glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+void Texture::reset_unpack_rows(GLContext &ctx, GLint row_length,
+                                GLint alignment) {
+  if (row_length != 0)
+    ctx.glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  if (alignment != 4)
+    ctx.glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+GLsizei Texture::mip_levels(GLsizei texture_width, GLsizei texture_height) {
+  GLsizei largest = std::max(texture_width, texture_height);
+  GLsizei count = 1;
+
+  while (largest > 1) {
+    largest >>= 1;
+    count++;
+  }
+
+  return count;
+}
+
+GLuint Texture::get_texture() const { return texture; }
+
+GLsizei Texture::get_width() const { return width; }
+
+GLsizei Texture::get_height() const { return height; }
+
+GLsizei Texture::get_levels() const { return levels; }
+
+GLenum Texture::get_internal_format() const { return internal_format; }
+
+TextureFilter Texture::get_filter() const { return filter; }
+
+GLsizeiptr Texture::get_size() const { return size; }
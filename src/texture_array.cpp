@@ -0,0 +1,425 @@
+#include <algorithm>
+
+#include "texture_array.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::texture_array;
+
+TextureArray::TextureArray(const string &texture_name,
+                           const std::shared_ptr<GLContext> &ctx,
+                           GLsizei width_, GLsizei height_, GLsizei layers_,
+                           GLenum internal_format_, GLsizei levels_)
+    : name{texture_name}, gl_context{ctx}, width{width_}, height{height_},
+      layers{layers_}, internal_format{internal_format_} {
+  if ((width <= 0) || (height <= 0) || (layers <= 0) || (levels_ < 0) ||
+      (levels_ > Texture::mip_levels(width, height))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::BAD_SIZE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if (Texture::texel_size(internal_format) == 0) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::BAD_FORMAT");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  levels = (levels_ == 0) ? Texture::mip_levels(width, height) : levels_;
+
+  GLsizeiptr texture_size = 0;
+  for (GLsizei level = 0; level < levels; level++)
+    texture_size += static_cast<GLsizeiptr>(std::max(width >> level, 1)) *
+                    std::max(height >> level, 1) * layers *
+                    Texture::texel_size(internal_format);
+
+  GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+  // Evict cached resources first if the texture would go over the
+  // memory budget
+  if (!registry.reserve(texture_size)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureOutOfMemoryError("ERROR::TEXTURE_ARRAY::OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    cleanup();
+    return;
+#endif
+  }
+
+  if (gl_context->direct_state_access())
+    gl_context->glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &texture);
+  else
+    gl_context->glGenTextures(1, &texture);
+
+  GLenum error = gl_context->glGetError();
+
+  if ((error == GL_OUT_OF_MEMORY) || (texture == 0)) {
+#ifndef NO_EXCEPTIONS
+    throw GenTexturesError("ERROR::TEXTURE_ARRAY::GEN_TEXTURES_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::GenTexturesError));
+    cleanup();
+    return;
+#endif
+  }
+
+  // Layers are never resized, so every layer and level is allocated
+  // in one go
+  Texture::allocate_storage(*gl_context, GL_TEXTURE_2D_ARRAY, texture,
+                            levels, internal_format, width, height, layers);
+
+  error = gl_context->glGetError();
+
+  // GL_OUT_OF_MEMORY, GL_INVALID_VALUE for more layers than
+  // GL_MAX_ARRAY_TEXTURE_LAYERS, or GL_INVALID_ENUM for an internal
+  // format the context doesn't have
+  if (error != GL_NO_ERROR) {
+    cleanup();
+#ifndef NO_EXCEPTIONS
+    throw GenTexturesError("ERROR::TEXTURE_ARRAY::TEX_STORAGE_FAILED");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::GenTexturesError));
+    return;
+#endif
+  }
+
+  size = texture_size;
+  registry.track(GPUMemoryCategory::Texture, texture, name, size);
+
+  set_filter(filter);
+}
+
+TextureArray::~TextureArray() { cleanup(); }
+
+void TextureArray::cleanup() noexcept {
+  if (texture != 0) {
+    if (gl_context != nullptr) {
+      gl_context->glDeleteTextures(1, &texture);
+      GPUMemoryRegistry::instance().release(GPUMemoryCategory::Texture,
+                                            texture);
+    }
+
+    texture = 0;
+  }
+
+  keys.clear();
+  gl_context = nullptr;
+}
+
+// move constructor
+TextureArray::TextureArray(TextureArray &&other) noexcept
+    : name{other.name}, gl_context{other.gl_context}, texture{other.texture},
+      width{other.width}, height{other.height}, layers{other.layers},
+      levels{other.levels}, internal_format{other.internal_format},
+      filter{other.filter}, keys{std::move(other.keys)}, size{other.size} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = other.last_operation_failed;
+  last_error = other.last_error;
+#endif
+
+  other.gl_context = nullptr;
+  other.texture = 0;
+  other.keys.clear();
+}
+
+// move assignment operator
+TextureArray &TextureArray::operator=(TextureArray &&other) noexcept {
+  if (&other != this) {
+    cleanup();
+
+    name = other.name;
+    gl_context = other.gl_context;
+    texture = other.texture;
+    width = other.width;
+    height = other.height;
+    layers = other.layers;
+    levels = other.levels;
+    internal_format = other.internal_format;
+    filter = other.filter;
+    keys = std::move(other.keys);
+    size = other.size;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = other.last_operation_failed;
+    last_error = other.last_error;
+#endif
+
+    other.gl_context = nullptr;
+    other.texture = 0;
+    other.keys.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool TextureArray::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (texture == 0))
+    return true;
+  else
+    return false;
+}
+
+bool TextureArray::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw TextureArrayUnspecifiedStateError(
+        "Texture Array is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+bool TextureArray::check_layer(GLint layer, GLint level) {
+  if ((layer < 0) || (layer >= layers) || (level < 0) || (level >= levels)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::BAD_LAYER");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void TextureArray::bind(GLuint unit) {
+  if (!check_state())
+    return;
+
+  gl_context->glActiveTexture(GL_TEXTURE0 + unit);
+  gl_context->glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+  GPUMemoryRegistry::instance().touch(GPUMemoryCategory::Texture, texture);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void TextureArray::upload(GLint layer, std::span<const std::byte> pixels,
+                          GLenum format, GLenum type, GLint level,
+                          GLint row_length, GLint alignment) {
+  if (!check_state())
+    return;
+
+  if (!check_layer(layer, level))
+    return;
+
+  GLsizei level_width = std::max(width >> level, 1);
+  GLsizei level_height = std::max(height >> level, 1);
+
+  if (((row_length != 0) && (row_length < level_width)) ||
+      ((alignment != 1) && (alignment != 2) && (alignment != 4) &&
+       (alignment != 8))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::BAD_ROW_LAYOUT");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return;
+#endif
+  }
+
+  // Formats the check doesn't know are passed through to OpenGL
+  size_t pixel = Texture::pixel_size(format, type);
+  GLint row = (row_length == 0) ? level_width : row_length;
+
+  if ((pixel != 0) &&
+      (pixels.size() < Texture::image_size(level_width, level_height, row,
+                                           alignment, pixel))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::TOO_FEW_PIXELS");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return;
+#endif
+  }
+
+  sub_image(layer, level, pixels.data(), format, type, row_length,
+            alignment);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void TextureArray::upload(GLint layer, SDLSurface &surface, GLint level) {
+  if (!check_state())
+    return;
+
+  if (!check_layer(layer, level))
+    return;
+
+  if ((surface.w() != std::max(width >> level, 1)) ||
+      (surface.h() != std::max(height >> level, 1))) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::BAD_IMAGE_SIZE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return;
+#endif
+  }
+
+  sdl_surface::GLPixelFormat pixel_format = {};
+  GLint row_length = 0;
+  GLint alignment = 4;
+
+  // Read in place where OpenGL understands the pixels and the pitch
+  if (surface.GL_PixelFormat(pixel_format) &&
+      sdl_surface::gl_row_layout(surface.w(), pixel_format.pixel_size,
+                                 surface.pitch(), row_length, alignment)) {
+    std::span<const std::byte> pixels(
+        static_cast<const std::byte *>(surface.pixels()),
+        static_cast<size_t>(surface.pitch()) * surface.h());
+
+    upload(layer, pixels, pixel_format.format, pixel_format.type, level,
+           row_length, alignment);
+    return;
+  }
+
+  // Palettized, YUV and RLE surfaces are the only ones copied
+  std::optional<SDLSurface> converted = surface.ConvertToRGBA32();
+
+#ifdef NO_EXCEPTIONS
+  if (!converted) {
+    set_error(surface.get_last_error());
+    return;
+  }
+#endif
+
+  upload(layer, *converted, level);
+}
+
+GLint TextureArray::add(const string &key, SDLSurface &surface) {
+  if (!check_state())
+    return -1;
+
+  auto found = keys.find(key);
+  GLint layer = (found != keys.end()) ? found->second
+                                      : static_cast<GLint>(keys.size());
+
+  if (layer >= layers) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError("ERROR::TEXTURE_ARRAY::TEXTURE_DATA_ERROR::FULL");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return -1;
+#endif
+  }
+
+  upload(layer, surface);
+
+#ifdef NO_EXCEPTIONS
+  if (last_operation_failed)
+    return -1;
+#endif
+
+  // Only kept once the upload worked, so a bad surface doesn't use
+  // up a layer
+  keys.emplace(key, layer);
+
+  return layer;
+}
+
+GLint TextureArray::find(const string &key) const {
+  auto found = keys.find(key);
+
+  return (found != keys.end()) ? found->second : -1;
+}
+
+void TextureArray::sub_image(GLint layer, GLint level, const GLvoid *pixels,
+                             GLenum format, GLenum type, GLint row_length,
+                             GLint alignment) {
+  GLsizei level_width = std::max(width >> level, 1);
+  GLsizei level_height = std::max(height >> level, 1);
+
+  Texture::set_unpack_rows(*gl_context, row_length, alignment);
+
+  // A layer is one slice deep at its z offset
+  if (gl_context->direct_state_access()) {
+    gl_context->glTextureSubImage3D(texture, level, 0, 0, layer, level_width,
+                                    level_height, 1, format, type, pixels);
+  } else {
+    gl_context->glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    gl_context->glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+                                level_width, level_height, 1, format, type,
+                                pixels);
+  }
+
+  Texture::reset_unpack_rows(*gl_context, row_length, alignment);
+}
+
+void TextureArray::generate_mipmaps() {
+  if (!check_state())
+    return;
+
+  if (levels > 1)
+    Texture::generate_mipmap(*gl_context, GL_TEXTURE_2D_ARRAY, texture);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void TextureArray::set_filter(TextureFilter filter_) {
+  if (!check_state())
+    return;
+
+  Texture::apply_filter(*gl_context, GL_TEXTURE_2D_ARRAY, texture, filter_,
+                        levels > 1);
+
+  filter = filter_;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void TextureArray::set_wrap(GLenum wrap_s, GLenum wrap_t) {
+  if (!check_state())
+    return;
+
+  Texture::apply_wrap(*gl_context, GL_TEXTURE_2D_ARRAY, texture, wrap_s,
+                      wrap_t);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLuint TextureArray::get_texture() const { return texture; }
+
+GLsizei TextureArray::get_width() const { return width; }
+
+GLsizei TextureArray::get_height() const { return height; }
+
+GLsizei TextureArray::get_layers() const { return layers; }
+
+GLsizei TextureArray::get_used_layers() const {
+  return static_cast<GLsizei>(keys.size());
+}
+
+GLsizei TextureArray::get_levels() const { return levels; }
+
+GLenum TextureArray::get_internal_format() const { return internal_format; }
+
+TextureFilter TextureArray::get_filter() const { return filter; }
+
+GLsizeiptr TextureArray::get_size() const { return size; }
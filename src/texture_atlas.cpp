@@ -0,0 +1,388 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#include "texture_atlas.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::texture_atlas;
+
+// Bytes per texel of the pages and their copies, RGBA32
+static constexpr size_t texel_size = 4;
+
+SkylinePacker::SkylinePacker(GLsizei width_, GLsizei height_)
+    : width{width_}, height{height_} {
+  skyline.push_back({0, 0, width});
+}
+
+GLint SkylinePacker::fit(size_t index, GLsizei rect_width) const {
+  if (skyline[index].x + rect_width > width)
+    return -1;
+
+  // The rectangle rests on the highest segment it spans
+  GLint top = 0;
+  GLsizei remaining = rect_width;
+  for (size_t i = index; remaining > 0; i++) {
+    top = std::max(top, skyline[i].y);
+    remaining -= skyline[i].width;
+  }
+
+  return top;
+}
+
+bool SkylinePacker::insert(GLsizei rect_width, GLsizei rect_height, GLint &x,
+                           GLint &y) {
+  if ((rect_width <= 0) || (rect_height <= 0))
+    return false;
+
+  size_t best = skyline.size();
+  GLint best_top = 0;
+  GLint best_bottom = std::numeric_limits<GLint>::max();
+  GLsizei best_width = std::numeric_limits<GLsizei>::max();
+
+  // Lowest bottom edge first, then the narrowest segment so wide
+  // runs are left for wide rectangles
+  for (size_t i = 0; i < skyline.size(); i++) {
+    GLint top = fit(i, rect_width);
+    if ((top < 0) || (top + rect_height > height))
+      continue;
+
+    GLint bottom = top + rect_height;
+    if ((bottom < best_bottom) ||
+        ((bottom == best_bottom) && (skyline[i].width < best_width))) {
+      best = i;
+      best_top = top;
+      best_bottom = bottom;
+      best_width = skyline[i].width;
+    }
+  }
+
+  if (best == skyline.size())
+    return false;
+
+  x = skyline[best].x;
+  y = best_top;
+
+  skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(best),
+                 {x, best_bottom, rect_width});
+
+  // Shorten or drop the segments the rectangle now covers
+  size_t next = best + 1;
+  while (next < skyline.size()) {
+    GLint covered_to = skyline[next - 1].x + skyline[next - 1].width;
+    Segment &segment = skyline[next];
+
+    if (segment.x >= covered_to)
+      break;
+
+    GLsizei overlap = covered_to - segment.x;
+    if (segment.width <= overlap) {
+      skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(next));
+      continue;
+    }
+
+    segment.x += overlap;
+    segment.width -= overlap;
+    break;
+  }
+
+  // Merge neighbours at the same height
+  for (size_t i = 0; i + 1 < skyline.size();) {
+    if (skyline[i].y == skyline[i + 1].y) {
+      skyline[i].width += skyline[i + 1].width;
+      skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i + 1));
+    } else {
+      i++;
+    }
+  }
+
+  used_area += static_cast<GLsizeiptr>(rect_width) * rect_height;
+
+  return true;
+}
+
+GLsizei SkylinePacker::get_width() const { return width; }
+
+GLsizei SkylinePacker::get_height() const { return height; }
+
+GLsizeiptr SkylinePacker::get_used_area() const { return used_area; }
+
+TextureAtlas::TextureAtlas(const string &atlas_name,
+                           const std::shared_ptr<GLContext> &ctx,
+                           GLsizei page_width_, GLsizei page_height_,
+                           GLsizei gutter_)
+    : name{atlas_name}, gl_context{ctx}, page_width{page_width_},
+      page_height{page_height_}, gutter{gutter_} {
+  if ((gutter < 0) || (page_width <= 2 * gutter) ||
+      (page_height <= 2 * gutter)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ATLAS::TEXTURE_DATA_ERROR::BAD_PAGE_SIZE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    cleanup();
+    return;
+#endif
+  }
+}
+
+TextureAtlas::~TextureAtlas() { cleanup(); }
+
+void TextureAtlas::cleanup() noexcept {
+  // The Textures delete the OpenGL textures
+  pages.clear();
+  gl_context = nullptr;
+}
+
+// move constructor
+TextureAtlas::TextureAtlas(TextureAtlas &&atlas) noexcept
+    : name{atlas.name}, gl_context{atlas.gl_context},
+      page_width{atlas.page_width}, page_height{atlas.page_height},
+      gutter{atlas.gutter}, pages{std::move(atlas.pages)} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = atlas.last_operation_failed;
+  last_error = atlas.last_error;
+#endif
+
+  atlas.gl_context = nullptr;
+  atlas.pages.clear();
+}
+
+// move assignment operator
+TextureAtlas &TextureAtlas::operator=(TextureAtlas &&atlas) noexcept {
+  if (&atlas != this) {
+    cleanup();
+
+    name = atlas.name;
+    gl_context = atlas.gl_context;
+    page_width = atlas.page_width;
+    page_height = atlas.page_height;
+    gutter = atlas.gutter;
+    pages = std::move(atlas.pages);
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = atlas.last_operation_failed;
+    last_error = atlas.last_error;
+#endif
+
+    atlas.gl_context = nullptr;
+    atlas.pages.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool TextureAtlas::is_in_unspecified_state() const {
+  if (gl_context == nullptr)
+    return true;
+  else
+    return false;
+}
+
+bool TextureAtlas::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw TextureAtlasUnspecifiedStateError(
+        "Texture Atlas is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+std::optional<AtlasRegion> TextureAtlas::add(SDLSurface &surface) {
+  if (!check_state())
+    return std::nullopt;
+
+  GLsizei image_width = surface.w();
+  GLsizei image_height = surface.h();
+
+  if ((image_width <= 0) || (image_height <= 0) ||
+      (image_width > page_width - 2 * gutter) ||
+      (image_height > page_height - 2 * gutter)) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ATLAS::TEXTURE_DATA_ERROR::BAD_IMAGE_SIZE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return std::nullopt;
+#endif
+  }
+
+  // RGBA32 pixels are copied as they are, anything else is
+  // converted first
+  std::optional<SDLSurface> converted = std::nullopt;
+  SDLSurface *source = &surface;
+  sdl_surface::GLPixelFormat pixel_format = {};
+
+  if ((surface.format() != SDL_PIXELFORMAT_RGBA32) ||
+      !surface.GL_PixelFormat(pixel_format)) {
+    converted = surface.ConvertToRGBA32();
+
+#ifdef NO_EXCEPTIONS
+    if (!converted) {
+      set_error(surface.get_last_error());
+      return std::nullopt;
+    }
+#endif
+
+    source = &*converted;
+  }
+
+  GLsizei packed_width = image_width + 2 * gutter;
+  GLsizei packed_height = image_height + 2 * gutter;
+  GLint x = 0;
+  GLint y = 0;
+
+  size_t page = 0;
+  while ((page < pages.size()) &&
+         !pages[page].packer.insert(packed_width, packed_height, x, y))
+    page++;
+
+  if (page == pages.size()) {
+    // Without mipmaps, smaller levels would mix neighbouring images
+    Texture texture(name + "-page-" + std::to_string(page), gl_context,
+                    page_width, page_height, GL_RGBA8, 1);
+
+#ifdef NO_EXCEPTIONS
+    if (!texture.valid()) {
+      set_error(texture.get_last_error());
+      return std::nullopt;
+    }
+#endif
+
+    pages.push_back({std::move(texture),
+                     SkylinePacker(page_width, page_height),
+                     std::vector<std::byte>(static_cast<size_t>(page_width) *
+                                            page_height * texel_size)});
+
+    // Checked against the page size above, so it always fits
+    pages.back().packer.insert(packed_width, packed_height, x, y);
+  }
+
+  Page &target = pages[page];
+
+  const std::byte *pixels = static_cast<const std::byte *>(source->pixels());
+  size_t pitch = static_cast<size_t>(source->pitch());
+  size_t row = static_cast<size_t>(image_width) * texel_size;
+  size_t stride = static_cast<size_t>(page_width) * texel_size;
+
+  for (GLsizei r = 0; r < image_height; r++)
+    std::memcpy(target.pixels.data() +
+                    static_cast<size_t>(y + gutter + r) * stride +
+                    static_cast<size_t>(x + gutter) * texel_size,
+                pixels + static_cast<size_t>(r) * pitch, row);
+
+  // The gutter is uploaded with the image, the page texture starts
+  // out undefined
+  if (target.dirty_x0 == target.dirty_x1) {
+    target.dirty_x0 = x;
+    target.dirty_y0 = y;
+    target.dirty_x1 = x + packed_width;
+    target.dirty_y1 = y + packed_height;
+  } else {
+    target.dirty_x0 = std::min(target.dirty_x0, x);
+    target.dirty_y0 = std::min(target.dirty_y0, y);
+    target.dirty_x1 = std::max(target.dirty_x1, x + packed_width);
+    target.dirty_y1 = std::max(target.dirty_y1, y + packed_height);
+  }
+
+  AtlasRegion region = {page,
+                        x + gutter,
+                        y + gutter,
+                        image_width,
+                        image_height,
+                        {static_cast<GLfloat>(x + gutter) / page_width,
+                         static_cast<GLfloat>(y + gutter) / page_height,
+                         static_cast<GLfloat>(x + gutter + image_width) /
+                             page_width,
+                         static_cast<GLfloat>(y + gutter + image_height) /
+                             page_height}};
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return region;
+}
+
+GLsizeiptr TextureAtlas::flush() {
+  if (!check_state())
+    return 0;
+
+  GLsizeiptr uploaded = 0;
+
+  for (Page &page : pages) {
+    if (page.dirty_x0 == page.dirty_x1)
+      continue;
+
+    GLsizei dirty_width = page.dirty_x1 - page.dirty_x0;
+    GLsizei dirty_height = page.dirty_y1 - page.dirty_y0;
+    size_t offset = (static_cast<size_t>(page.dirty_y0) * page_width +
+                     static_cast<size_t>(page.dirty_x0)) *
+                    texel_size;
+
+    // Read in place from the page copy, rows page_width texels apart
+    page.texture.upload(page.dirty_x0, page.dirty_y0, dirty_width,
+                        dirty_height,
+                        std::span<const std::byte>(page.pixels).subspan(offset),
+                        GL_RGBA, GL_UNSIGNED_BYTE, 0,
+                        (dirty_width == page_width) ? 0 : page_width);
+
+#ifdef NO_EXCEPTIONS
+    if (!page.texture.valid()) {
+      set_error(page.texture.get_last_error());
+      return uploaded;
+    }
+#endif
+
+    uploaded += static_cast<GLsizeiptr>(dirty_width) * dirty_height *
+                static_cast<GLsizeiptr>(texel_size);
+
+    page.dirty_x0 = 0;
+    page.dirty_y0 = 0;
+    page.dirty_x1 = 0;
+    page.dirty_y1 = 0;
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return uploaded;
+}
+
+Texture *TextureAtlas::get_page(size_t page) {
+  if (!check_state())
+    return nullptr;
+
+  if (page >= get_page_count()) {
+#ifndef NO_EXCEPTIONS
+    throw TextureDataError(
+        "ERROR::TEXTURE_ATLAS::TEXTURE_DATA_ERROR::BAD_PAGE");
+#else
+    set_error(std::optional<error>(error::TextureDataError));
+    return nullptr;
+#endif
+  }
+
+  return &pages[page].texture;
+}
+
+size_t TextureAtlas::get_page_count() const { return pages.size(); }
+
+GLsizei TextureAtlas::get_page_width() const { return page_width; }
+
+GLsizei TextureAtlas::get_page_height() const { return page_height; }
+
+GLsizeiptr TextureAtlas::get_used_area() const {
+  GLsizeiptr used = 0;
+  for (const Page &page : pages)
+    used += page.packer.get_used_area();
+
+  return used;
+}
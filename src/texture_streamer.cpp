@@ -0,0 +1,585 @@
+#include <algorithm>
+#include <cstring>
+
+#include "texture_streamer.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::texture_streamer;
+
+// Rows are copied into the slots padded to this, the default
+// GL_UNPACK_ALIGNMENT
+static constexpr size_t row_alignment = 4;
+
+StreamedTexture::StreamedTexture(const string &source_) : source{source_} {}
+
+const string &StreamedTexture::get_source() const { return source; }
+
+StreamStatus StreamedTexture::get_status() const { return status; }
+
+bool StreamedTexture::is_ready() const {
+  return status == StreamStatus::Ready;
+}
+
+Texture *StreamedTexture::get_texture() {
+  if ((status != StreamStatus::Ready) || !texture)
+    return nullptr;
+
+  return &*texture;
+}
+
+TextureStreamer::TextureStreamer(const string &streamer_name,
+                                 const std::shared_ptr<GLContext> &ctx,
+                                 Decoder decoder, GLsizeiptr slot_size,
+                                 GLuint slot_count, GLsizeiptr frame_budget_,
+                                 unsigned worker_count, GLsizei levels_)
+    : name{streamer_name}, gl_context{ctx},
+      shared{std::make_unique<Shared>()}, frame_budget{frame_budget_},
+      levels{levels_} {
+  if ((slot_size <= 0) || (slot_count == 0) || (frame_budget < 0) ||
+      (worker_count == 0) || (levels < 0)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::TEXTURE_STREAMER::BUFFER_DATA_ERROR::INVALID_SIZE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  shared->decoder = std::move(decoder);
+  shared->slot_size = slot_size;
+  shared->slots.resize(slot_count);
+
+  // GL_STREAM_DRAW, written by a worker once and read by the GPU once
+  buffers.reserve(slot_count);
+  for (GLuint slot = 0; slot < slot_count; slot++) {
+    buffers.emplace_back(name + "-" + std::to_string(slot), ctx, slot_size,
+                         GL_STREAM_DRAW);
+
+#ifdef NO_EXCEPTIONS
+    if (!buffers.back().valid()) {
+      set_error(buffers.back().get_last_error());
+      cleanup();
+      return;
+    }
+#endif
+  }
+
+  if (!map_slots()) {
+    cleanup();
+    return;
+  }
+
+  // Started last, nothing can fail once they are running
+  workers.reserve(worker_count);
+  for (unsigned worker = 0; worker < worker_count; worker++)
+    workers.emplace_back(work, std::ref(*shared));
+}
+
+TextureStreamer::~TextureStreamer() { cleanup(); }
+
+void TextureStreamer::cleanup() noexcept {
+  if (shared != nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      shared->stop = true;
+    }
+    shared->requests_queued.notify_all();
+    shared->slot_mapped.notify_all();
+  }
+
+  for (std::thread &worker : workers)
+    worker.join();
+  workers.clear();
+
+  // Every slot a worker could see is still mapped
+  if ((shared != nullptr) && (gl_context != nullptr)) {
+    for (size_t slot = 0; slot < buffers.size(); slot++) {
+      if (shared->slots[slot].state == SlotState::Unmapped)
+        continue;
+
+      buffers[slot].bind(GL_PIXEL_UNPACK_BUFFER);
+      gl_context->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+      gl_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+  }
+
+  // The VertexBufferObjects delete the OpenGL buffers
+  buffers.clear();
+
+  // Nothing will finish these now
+  for (auto &[request, handle] : streaming) {
+    handle->status = StreamStatus::Failed;
+    handle->texture.reset();
+  }
+  streaming.clear();
+
+  shared.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+TextureStreamer::TextureStreamer(TextureStreamer &&streamer) noexcept
+    : name{streamer.name}, gl_context{streamer.gl_context},
+      shared{std::move(streamer.shared)}, workers{std::move(streamer.workers)},
+      buffers{std::move(streamer.buffers)},
+      streaming{std::move(streamer.streaming)},
+      next_request{streamer.next_request},
+      frame_budget{streamer.frame_budget}, levels{streamer.levels},
+      bytes_uploaded_last_update{streamer.bytes_uploaded_last_update},
+      total_bytes_uploaded{streamer.total_bytes_uploaded} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = streamer.last_operation_failed;
+  last_error = streamer.last_error;
+#endif
+
+  streamer.gl_context = nullptr;
+  streamer.workers.clear();
+  streamer.buffers.clear();
+  streamer.streaming.clear();
+}
+
+// move assignment operator
+TextureStreamer &
+TextureStreamer::operator=(TextureStreamer &&streamer) noexcept {
+  if (&streamer != this) {
+    cleanup();
+
+    name = streamer.name;
+    gl_context = streamer.gl_context;
+    shared = std::move(streamer.shared);
+    workers = std::move(streamer.workers);
+    buffers = std::move(streamer.buffers);
+    streaming = std::move(streamer.streaming);
+    next_request = streamer.next_request;
+    frame_budget = streamer.frame_budget;
+    levels = streamer.levels;
+    bytes_uploaded_last_update = streamer.bytes_uploaded_last_update;
+    total_bytes_uploaded = streamer.total_bytes_uploaded;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = streamer.last_operation_failed;
+    last_error = streamer.last_error;
+#endif
+
+    streamer.gl_context = nullptr;
+    streamer.workers.clear();
+    streamer.buffers.clear();
+    streamer.streaming.clear();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool TextureStreamer::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (shared == nullptr))
+    return true;
+  else
+    return false;
+}
+
+bool TextureStreamer::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw TextureStreamerUnspecifiedStateError(
+        "Texture Streamer is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void TextureStreamer::work(Shared &shared) {
+  std::unique_lock<std::mutex> lock(shared.mutex);
+
+  while (true) {
+    shared.requests_queued.wait(
+        lock, [&shared] { return shared.stop || !shared.requests.empty(); });
+
+    if (shared.stop)
+      return;
+
+    auto [request, source] = std::move(shared.requests.front());
+    shared.requests.pop_front();
+
+    // Decoding and copying run unlocked, so other workers and
+    // update() carry on meanwhile
+    lock.unlock();
+    bool running = stream(shared, request, source);
+    lock.lock();
+
+    if (!running)
+      return;
+  }
+}
+
+bool TextureStreamer::stream(Shared &shared, std::uint64_t request,
+                             const string &source) {
+  std::optional<SDLSurface> surface = std::nullopt;
+  sdl_surface::GLPixelFormat pixel_format = {};
+
+#ifndef NO_EXCEPTIONS
+  try {
+#endif
+    surface = shared.decoder(source);
+
+    // Converted here so update() never has to
+    if (surface && !surface->GL_PixelFormat(pixel_format)) {
+      surface = surface->ConvertToRGBA32();
+
+      if (surface && !surface->GL_PixelFormat(pixel_format))
+        surface = std::nullopt;
+    }
+#ifndef NO_EXCEPTIONS
+  } catch (const std::exception &) {
+    surface = std::nullopt;
+  }
+#endif
+
+  GLsizei width = 0;
+  GLsizei height = 0;
+  int pitch = 0;
+  const std::byte *pixels = nullptr;
+
+  if (surface) {
+    width = surface->w();
+    height = surface->h();
+    pitch = surface->pitch();
+    pixels = static_cast<const std::byte *>(surface->pixels());
+  }
+
+  size_t row = static_cast<size_t>(std::max(width, 0)) *
+               static_cast<size_t>(pixel_format.pixel_size);
+  size_t padded_row = (row + row_alignment - 1) / row_alignment * row_alignment;
+
+  // Every band needs at least one row
+  if ((width <= 0) || (height <= 0) || (pitch <= 0) || (pixels == nullptr) ||
+      (padded_row > static_cast<size_t>(shared.slot_size))) {
+    {
+      std::lock_guard<std::mutex> lock(shared.mutex);
+      shared.failed.push_back(request);
+    }
+    shared.progress.notify_all();
+    return true;
+  }
+
+  GLsizei slot_rows = static_cast<GLsizei>(
+      std::min(static_cast<size_t>(shared.slot_size) / padded_row,
+               static_cast<size_t>(height)));
+
+  for (GLint first_row = 0; first_row < height; first_row += slot_rows) {
+    GLsizei rows = std::min(slot_rows, height - first_row);
+    size_t slot = 0;
+    std::byte *mapped = nullptr;
+
+    {
+      std::unique_lock<std::mutex> lock(shared.mutex);
+
+      auto is_mapped = [](const Slot &s) {
+        return s.state == SlotState::Mapped;
+      };
+      shared.slot_mapped.wait(lock, [&shared, &is_mapped] {
+        return shared.stop || std::ranges::any_of(shared.slots, is_mapped);
+      });
+
+      if (shared.stop)
+        return false;
+
+      slot = static_cast<size_t>(
+          std::ranges::find_if(shared.slots, is_mapped) -
+          shared.slots.begin());
+      shared.slots[slot].state = SlotState::Writing;
+      mapped = shared.slots[slot].mapped;
+    }
+
+    // Written unlocked, the slot is this worker's until it's filled
+    for (GLsizei r = 0; r < rows; r++)
+      std::memcpy(mapped + static_cast<size_t>(r) * padded_row,
+                  pixels + static_cast<size_t>(first_row + r) *
+                               static_cast<size_t>(pitch),
+                  row);
+
+    GLsizeiptr bytes = static_cast<GLsizeiptr>(padded_row) * rows;
+
+    {
+      std::lock_guard<std::mutex> lock(shared.mutex);
+      Slot &filled = shared.slots[slot];
+      filled.band = {request, width, height, pixel_format, first_row, rows,
+                     bytes};
+      filled.state = SlotState::Filled;
+      shared.filled.push_back(slot);
+      shared.filled_bytes += bytes;
+    }
+    shared.progress.notify_all();
+  }
+
+  return true;
+}
+
+bool TextureStreamer::map_slots() {
+  bool mapped_any = false;
+
+  for (size_t slot = 0; slot < buffers.size(); slot++) {
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      if (shared->slots[slot].state != SlotState::Unmapped)
+        continue;
+    }
+
+    // Invalidating lets the driver hand back new storage instead of
+    // waiting for the upload from the last map to finish
+    buffers[slot].bind(GL_PIXEL_UNPACK_BUFFER);
+    std::byte *mapped = static_cast<std::byte *>(gl_context->glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, 0, shared->slot_size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    gl_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (mapped == nullptr) {
+      if (mapped_any)
+        shared->slot_mapped.notify_all();
+#ifndef NO_EXCEPTIONS
+      throw TextureStreamerMapError(
+          "ERROR::TEXTURE_STREAMER::MAP_BUFFER_FAILED");
+#else
+      set_error(std::optional<error>(error::MapBufferError));
+      return false;
+#endif
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+      shared->slots[slot].mapped = mapped;
+      shared->slots[slot].state = SlotState::Mapped;
+    }
+    mapped_any = true;
+  }
+
+  if (mapped_any)
+    shared->slot_mapped.notify_all();
+
+  return true;
+}
+
+TextureStreamHandle TextureStreamer::request(const string &source) {
+  if (!check_state())
+    return nullptr;
+
+  TextureStreamHandle handle = std::make_shared<StreamedTexture>(source);
+  std::uint64_t id = next_request++;
+  streaming.emplace(id, handle);
+
+  {
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    shared->requests.emplace_back(id, source);
+  }
+  shared->requests_queued.notify_one();
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return handle;
+}
+
+GLsizeiptr TextureStreamer::update() { return upload(frame_budget); }
+
+void TextureStreamer::finish() {
+  if (!check_state())
+    return;
+
+  while (!streaming.empty()) {
+    {
+      std::unique_lock<std::mutex> lock(shared->mutex);
+      shared->progress.wait(lock, [this] {
+        return !shared->filled.empty() || !shared->failed.empty();
+      });
+    }
+
+    upload(0);
+
+#ifdef NO_EXCEPTIONS
+    if (last_operation_failed)
+      return;
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr TextureStreamer::upload(GLsizeiptr budget) {
+  if (!check_state())
+    return 0;
+
+  std::deque<std::uint64_t> failed;
+  {
+    std::lock_guard<std::mutex> lock(shared->mutex);
+    failed.swap(shared->failed);
+  }
+
+  for (std::uint64_t request : failed)
+    fail(request);
+
+  GLsizeiptr uploaded = 0;
+
+  while (true) {
+    size_t slot = 0;
+    Band band;
+
+    {
+      std::lock_guard<std::mutex> lock(shared->mutex);
+
+      if (shared->filled.empty())
+        break;
+
+      slot = shared->filled.front();
+      band = shared->slots[slot].band;
+
+      // The first band always goes, so a band larger than the budget
+      // can't stall streaming
+      if ((budget > 0) && (uploaded > 0) && (uploaded + band.bytes > budget))
+        break;
+
+      shared->filled.pop_front();
+      shared->filled_bytes -= band.bytes;
+      shared->slots[slot].state = SlotState::Unmapped;
+      shared->slots[slot].mapped = nullptr;
+    }
+
+    upload_band(slot, band);
+    uploaded += band.bytes;
+  }
+
+  bytes_uploaded_last_update = uploaded;
+  total_bytes_uploaded += uploaded;
+
+  if (!map_slots())
+    return uploaded;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return uploaded;
+}
+
+void TextureStreamer::upload_band(size_t slot, const Band &band) {
+  buffers[slot].bind(GL_PIXEL_UNPACK_BUFFER);
+  GLboolean unmapped = gl_context->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+  gl_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  auto found = streaming.find(band.request);
+
+  // The rest of a request that already failed
+  if (found == streaming.end())
+    return;
+
+  StreamedTexture &streamed = *found->second;
+
+  // The contents were lost, for example on a display mode change
+  if (unmapped == GL_FALSE) {
+    fail(band.request);
+    return;
+  }
+
+  if (!streamed.texture) {
+    // A small image can't have as many levels as asked for
+    GLsizei texture_levels =
+        std::min(levels, Texture::mip_levels(band.width, band.height));
+
+#ifndef NO_EXCEPTIONS
+    try {
+      streamed.texture.emplace(streamed.source, gl_context, band.width,
+                               band.height, band.pixel_format.internal_format,
+                               texture_levels);
+    } catch (const std::runtime_error &) {
+      fail(band.request);
+      return;
+    }
+#else
+    streamed.texture.emplace(streamed.source, gl_context, band.width,
+                             band.height, band.pixel_format.internal_format,
+                             texture_levels);
+
+    if (!streamed.texture->valid()) {
+      fail(band.request);
+      return;
+    }
+#endif
+  }
+
+  // The rows were copied top row first, the way
+  // SDLSurface::GL_CreateTexture uploads them
+  streamed.texture->upload(0, band.first_row, band.width, band.rows,
+                           buffers[slot], 0, band.pixel_format.format,
+                           band.pixel_format.type);
+
+  streamed.rows_uploaded += band.rows;
+
+  if (streamed.rows_uploaded == band.height) {
+    streamed.texture->generate_mipmaps();
+    streamed.status = StreamStatus::Ready;
+    streaming.erase(found);
+  }
+}
+
+void TextureStreamer::fail(std::uint64_t request) {
+  auto found = streaming.find(request);
+  if (found == streaming.end())
+    return;
+
+  found->second->status = StreamStatus::Failed;
+  found->second->texture.reset();
+  streaming.erase(found);
+}
+
+void TextureStreamer::set_frame_budget(GLsizeiptr budget) {
+  if (budget < 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::TEXTURE_STREAMER::BUFFER_DATA_ERROR::INVALID_BUDGET");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  frame_budget = budget;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr TextureStreamer::get_frame_budget() const { return frame_budget; }
+
+GLsizeiptr TextureStreamer::get_slot_size() const {
+  return (shared != nullptr) ? shared->slot_size : 0;
+}
+
+GLuint TextureStreamer::get_slot_count() const {
+  return static_cast<GLuint>(buffers.size());
+}
+
+size_t TextureStreamer::get_pending_count() const { return streaming.size(); }
+
+GLsizeiptr TextureStreamer::get_decoded_bytes() const {
+  if (shared == nullptr)
+    return 0;
+
+  std::lock_guard<std::mutex> lock(shared->mutex);
+  return shared->filled_bytes;
+}
+
+GLsizeiptr TextureStreamer::get_bytes_uploaded_last_update() const {
+  return bytes_uploaded_last_update;
+}
+
+GLsizeiptr TextureStreamer::get_total_bytes_uploaded() const {
+  return total_bytes_uploaded;
+}
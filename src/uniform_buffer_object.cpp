@@ -0,0 +1,176 @@
+#include "uniform_buffer_object.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::uniform_buffer_object;
+
+UniformBufferObject::UniformBufferObject(const string &buffer_name,
+                                         const std::shared_ptr<GLContext> &ctx,
+                                         GLsizeiptr size, GLenum usage)
+    : name{buffer_name}, gl_context{ctx} {
+  if (size <= 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError("ERROR::UNIFORM_BUFFER::BUFFER_DATA_ERROR::NO_DATA");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  GLint alignment = 0;
+  gl_context->glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  if (alignment > 0)
+    offset_alignment = alignment;
+
+  buffer.emplace(name, ctx, size, usage);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    cleanup();
+    return;
+  }
+#endif
+}
+
+UniformBufferObject::~UniformBufferObject() { cleanup(); }
+
+void UniformBufferObject::cleanup() noexcept {
+  // The VertexBufferObject deletes the OpenGL buffer
+  buffer.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+UniformBufferObject::UniformBufferObject(UniformBufferObject &&ubo) noexcept
+    : name{ubo.name}, gl_context{ubo.gl_context},
+      buffer{std::move(ubo.buffer)}, offset_alignment{ubo.offset_alignment} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = ubo.last_operation_failed;
+  last_error = ubo.last_error;
+#endif
+
+  ubo.gl_context = nullptr;
+  ubo.buffer.reset();
+}
+
+// move assignment operator
+UniformBufferObject &
+UniformBufferObject::operator=(UniformBufferObject &&ubo) noexcept {
+  if (&ubo != this) {
+    cleanup();
+
+    name = ubo.name;
+    gl_context = ubo.gl_context;
+    buffer = std::move(ubo.buffer);
+    offset_alignment = ubo.offset_alignment;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = ubo.last_operation_failed;
+    last_error = ubo.last_error;
+#endif
+
+    ubo.gl_context = nullptr;
+    ubo.buffer.reset();
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool UniformBufferObject::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || !buffer)
+    return true;
+  else
+    return false;
+}
+
+void UniformBufferObject::update(GLintptr offset,
+                                 std::span<const std::byte> data) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw UniformBufferObjectUnspecifiedStateError(
+        "Uniform Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  buffer->update(offset, data);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+void UniformBufferObject::bind_base(GLuint binding) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw UniformBufferObjectUnspecifiedStateError(
+        "Uniform Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  buffer->bind_base(GL_UNIFORM_BUFFER, binding);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void UniformBufferObject::bind_range(GLuint binding, GLintptr offset,
+                                     GLsizeiptr range_size) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw UniformBufferObjectUnspecifiedStateError(
+        "Uniform Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  // A misaligned offset is a GL_INVALID_VALUE that silently leaves
+  // the old binding in place, catch it here instead
+  if (offset % offset_alignment != 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::UNIFORM_BUFFER::BUFFER_DATA_ERROR::MISALIGNED_OFFSET");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  buffer->bind_range(GL_UNIFORM_BUFFER, binding, offset, range_size);
+
+#ifdef NO_EXCEPTIONS
+  if (!buffer->valid()) {
+    set_error(buffer->get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr UniformBufferObject::get_size() const {
+  return buffer ? buffer->get_size() : 0;
+}
+
+GLint UniformBufferObject::get_offset_alignment() const {
+  return offset_alignment;
+}
+
+GLsizeiptr UniformBufferObject::aligned_stride(GLsizeiptr block_size) const {
+  return (block_size + offset_alignment - 1) / offset_alignment *
+         offset_alignment;
+}
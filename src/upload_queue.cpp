@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "async_readback.h"
+#include "upload_queue.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::upload_queue;
+
+// Uploads are packed into the staging buffer at offsets that are a
+// multiple of this, the default GL_UNPACK_ALIGNMENT
+static constexpr GLsizeiptr staging_alignment = 4;
+
+UploadQueue::UploadQueue(const string &queue_name,
+                         const std::shared_ptr<GLContext> &ctx,
+                         GLsizeiptr staging_size_, GLsizeiptr frame_budget_)
+    : name{queue_name}, gl_context{ctx}, staging_size{staging_size_},
+      frame_budget{frame_budget_} {
+  if ((staging_size <= 0) || (frame_budget < 0)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_SIZE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    cleanup();
+    return;
+#endif
+  }
+
+  // GL_STREAM_DRAW, written by the CPU once and read by the GPU once
+  staging.emplace(name, ctx, staging_size, GL_STREAM_DRAW);
+
+#ifdef NO_EXCEPTIONS
+  if (!staging->valid()) {
+    set_error(staging->get_last_error());
+    cleanup();
+    return;
+  }
+#endif
+}
+
+UploadQueue::~UploadQueue() { cleanup(); }
+
+void UploadQueue::cleanup() noexcept {
+  pending.clear();
+  pending_bytes = 0;
+
+  // The VertexBufferObject deletes the OpenGL buffer
+  staging.reset();
+  gl_context = nullptr;
+}
+
+// move constructor
+UploadQueue::UploadQueue(UploadQueue &&queue) noexcept
+    : name{queue.name}, gl_context{queue.gl_context},
+      staging{std::move(queue.staging)}, staging_size{queue.staging_size},
+      frame_budget{queue.frame_budget}, pending{std::move(queue.pending)},
+      pending_bytes{queue.pending_bytes},
+      bytes_uploaded_last_flush{queue.bytes_uploaded_last_flush},
+      total_bytes_uploaded{queue.total_bytes_uploaded} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = queue.last_operation_failed;
+  last_error = queue.last_error;
+#endif
+
+  queue.gl_context = nullptr;
+  queue.staging.reset();
+  queue.pending.clear();
+  queue.pending_bytes = 0;
+}
+
+// move assignment operator
+UploadQueue &UploadQueue::operator=(UploadQueue &&queue) noexcept {
+  if (&queue != this) {
+    cleanup();
+
+    name = queue.name;
+    gl_context = queue.gl_context;
+    staging = std::move(queue.staging);
+    staging_size = queue.staging_size;
+    frame_budget = queue.frame_budget;
+    pending = std::move(queue.pending);
+    pending_bytes = queue.pending_bytes;
+    bytes_uploaded_last_flush = queue.bytes_uploaded_last_flush;
+    total_bytes_uploaded = queue.total_bytes_uploaded;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = queue.last_operation_failed;
+    last_error = queue.last_error;
+#endif
+
+    queue.gl_context = nullptr;
+    queue.staging.reset();
+    queue.pending.clear();
+    queue.pending_bytes = 0;
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool UploadQueue::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || !staging)
+    return true;
+  else
+    return false;
+}
+
+bool UploadQueue::check_state() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw UploadQueueUnspecifiedStateError(
+        "Upload Queue is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  return true;
+}
+
+void UploadQueue::enqueue_buffer(VertexBufferObject &destination,
+                                 GLintptr offset,
+                                 std::span<const std::byte> data) {
+  if (!check_state())
+    return;
+
+  GLsizeiptr data_size = static_cast<GLsizeiptr>(data.size());
+
+  if ((data_size == 0) || (offset < 0) ||
+      (offset > destination.get_size() - data_size)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_RANGE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  Upload upload;
+  upload.buffer = &destination;
+  upload.offset = offset;
+  upload.data.assign(data.begin(), data.end());
+
+  pending.push_back(std::move(upload));
+  pending_bytes += data_size;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void UploadQueue::enqueue_texture(GLuint texture, GLint x, GLint y,
+                                  GLsizei width, GLsizei height, GLenum format,
+                                  GLenum type,
+                                  std::span<const std::byte> pixels) {
+  if (!check_state())
+    return;
+
+  // The unpack and pack alignments default to the same value, so
+  // rows are laid out the same way glReadPixels writes them
+  GLsizeiptr row_size =
+      AsyncReadback::pixel_data_size(width, 1, format, type);
+
+  if ((texture == 0) || (width <= 0) || (height <= 0) || (row_size == 0) ||
+      (row_size > staging_size) ||
+      (static_cast<GLsizeiptr>(pixels.size()) != row_size * height)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_PIXELS");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  Upload upload;
+  upload.texture = texture;
+  upload.x = x;
+  upload.y = y;
+  upload.width = width;
+  upload.height = height;
+  upload.format = format;
+  upload.type = type;
+  upload.row_size = row_size;
+  upload.data.assign(pixels.begin(), pixels.end());
+
+  pending.push_back(std::move(upload));
+  pending_bytes += static_cast<GLsizeiptr>(pixels.size());
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr UploadQueue::flush() {
+  if (!check_state())
+    return 0;
+
+  bytes_uploaded_last_flush = 0;
+
+  if (pending.empty()) {
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+    return 0;
+  }
+
+  GLsizeiptr budget = ((frame_budget == 0) || (frame_budget > staging_size))
+                          ? staging_size
+                          : frame_budget;
+
+  // Plan which part of each upload goes where in the staging buffer
+  struct Chunk {
+    Upload *upload;
+    GLintptr staging_offset;
+    GLsizeiptr chunk_size;
+  };
+  std::vector<Chunk> chunks;
+
+  GLsizeiptr staging_used = 0;
+  GLsizeiptr batch_bytes = 0;
+  bool has_buffers = false;
+  bool has_textures = false;
+
+  for (Upload &upload : pending) {
+    GLintptr staging_offset = (staging_used + staging_alignment - 1) /
+                              staging_alignment * staging_alignment;
+    if (staging_offset >= staging_size)
+      break;
+
+    GLsizeiptr remaining =
+        static_cast<GLsizeiptr>(upload.data.size()) - upload.uploaded;
+    GLsizeiptr chunk_size =
+        std::min({remaining, budget - batch_bytes,
+                  staging_size - staging_offset});
+
+    if (upload.buffer == nullptr) {
+      // Textures are uploaded in whole rows.  The first chunk always
+      // gets a row, enqueue_texture checked one fits.
+      chunk_size = chunk_size / upload.row_size * upload.row_size;
+      if ((chunk_size == 0) && chunks.empty())
+        chunk_size = upload.row_size;
+    }
+
+    if (chunk_size <= 0)
+      break;
+
+    chunks.push_back({&upload, staging_offset, chunk_size});
+    staging_used = staging_offset + chunk_size;
+    batch_bytes += chunk_size;
+
+    if (upload.buffer != nullptr)
+      has_buffers = true;
+    else
+      has_textures = true;
+
+    // Keep uploads in order, nothing after a partial upload
+    if (chunk_size < remaining)
+      break;
+  }
+
+  // One map for the whole batch.  Invalidating lets the driver hand
+  // back new storage instead of waiting for last frame's copies.
+  staging->bind(GL_COPY_READ_BUFFER);
+  std::byte *mapped = static_cast<std::byte *>(gl_context->glMapBufferRange(
+      GL_COPY_READ_BUFFER, 0, staging_used,
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+  if (mapped == nullptr) {
+    gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+#ifndef NO_EXCEPTIONS
+    throw UploadQueueMapError("ERROR::UPLOAD_QUEUE::MAP_BUFFER_FAILED");
+#else
+    set_error(std::optional<error>(error::MapBufferError));
+    return 0;
+#endif
+  }
+
+  for (const Chunk &chunk : chunks) {
+    std::memcpy(mapped + chunk.staging_offset,
+                chunk.upload->data.data() + chunk.upload->uploaded,
+                static_cast<size_t>(chunk.chunk_size));
+  }
+
+  // Nothing is consumed if the contents were lost, the same chunks
+  // are uploaded by the next flush
+  if (gl_context->glUnmapBuffer(GL_COPY_READ_BUFFER) == GL_FALSE) {
+    gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+#ifndef NO_EXCEPTIONS
+    throw UploadQueueMapError("ERROR::UPLOAD_QUEUE::UNMAP_BUFFER_FAILED");
+#else
+    set_error(std::optional<error>(error::MapBufferError));
+    return 0;
+#endif
+  }
+
+  // With a pixel unpack buffer bound the pixels pointer is an offset
+  // into the staging buffer
+  if (has_textures)
+    staging->bind(GL_PIXEL_UNPACK_BUFFER);
+
+  for (const Chunk &chunk : chunks) {
+    Upload &upload = *chunk.upload;
+
+    if (upload.buffer != nullptr) {
+      upload.buffer->bind(GL_COPY_WRITE_BUFFER);
+      gl_context->glCopyBufferSubData(
+          GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, chunk.staging_offset,
+          upload.offset + upload.uploaded, chunk.chunk_size);
+    } else {
+      GLint first_row = static_cast<GLint>(upload.uploaded / upload.row_size);
+      GLsizei rows = static_cast<GLsizei>(chunk.chunk_size / upload.row_size);
+
+      gl_context->glBindTexture(GL_TEXTURE_2D, upload.texture);
+      gl_context->glTexSubImage2D(
+          GL_TEXTURE_2D, 0, upload.x, upload.y + first_row, upload.width, rows,
+          upload.format, upload.type,
+          reinterpret_cast<const GLvoid *>(
+              static_cast<std::uintptr_t>(chunk.staging_offset)));
+    }
+
+    upload.uploaded += chunk.chunk_size;
+  }
+
+  gl_context->glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  if (has_buffers)
+    gl_context->glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  if (has_textures) {
+    gl_context->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    gl_context->glBindTexture(GL_TEXTURE_2D, 0);
+  }
+
+  while (!pending.empty() &&
+         (pending.front().uploaded ==
+          static_cast<GLsizeiptr>(pending.front().data.size())))
+    pending.pop_front();
+
+  pending_bytes -= batch_bytes;
+  bytes_uploaded_last_flush = batch_bytes;
+  total_bytes_uploaded += batch_bytes;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return batch_bytes;
+}
+
+void UploadQueue::flush_all() {
+  if (!check_state())
+    return;
+
+  GLsizeiptr saved_budget = frame_budget;
+  frame_budget = 0;
+
+#ifndef NO_EXCEPTIONS
+  try {
+    while (!pending.empty())
+      flush();
+  } catch (...) {
+    frame_budget = saved_budget;
+    throw;
+  }
+#else
+  while (!pending.empty()) {
+    flush();
+    if (!valid())
+      break;
+  }
+#endif
+
+  frame_budget = saved_budget;
+}
+
+void UploadQueue::set_frame_budget(GLsizeiptr budget) {
+  if (budget < 0) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_BUDGET");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  frame_budget = budget;
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLsizeiptr UploadQueue::get_frame_budget() const { return frame_budget; }
+
+GLsizeiptr UploadQueue::get_staging_size() const { return staging_size; }
+
+size_t UploadQueue::get_queue_depth() const { return pending.size(); }
+
+GLsizeiptr UploadQueue::get_pending_bytes() const { return pending_bytes; }
+
+GLsizeiptr UploadQueue::get_bytes_uploaded_last_flush() const {
+  return bytes_uploaded_last_flush;
+}
+
+GLsizeiptr UploadQueue::get_total_bytes_uploaded() const {
+  return total_bytes_uploaded;
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 
 #ifndef NO_EXCEPTIONS
 #include "spdlog/spdlog.h"
@@ -9,6 +11,50 @@
 using namespace sdl_opengl_cpp;
 using namespace sdl_opengl_cpp::vertex_array_object;
 
+// The layout used by the original constructor, three floats at
+// location 0
+static constexpr VertexAttribute packed_position_attribute[] = {
+    {0, 3, GL_FLOAT, GL_FALSE, false, 0}};
+
+// The size of an attribute in bytes
+static GLsizei attribute_size(const VertexAttribute &attribute) {
+  switch (attribute.type) {
+  case GL_BYTE:
+  case GL_UNSIGNED_BYTE:
+    return attribute.components;
+  case GL_SHORT:
+  case GL_UNSIGNED_SHORT:
+  case GL_HALF_FLOAT:
+    return attribute.components * 2;
+  case GL_DOUBLE:
+    return attribute.components * 8;
+  case GL_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+    return 4;
+  default:
+    return attribute.components * 4;
+  }
+}
+
+// glVertexAttribPointer treats a stride of 0 as tightly packed, a
+// vertex buffer binding reads the same vertex over and over
+static GLsizei binding_stride(std::span<const VertexAttribute> attributes,
+                              GLsizei stride) {
+  if (stride != 0)
+    return stride;
+
+  for (const VertexAttribute &attribute : attributes)
+    stride = std::max(stride, attribute.offset + attribute_size(attribute));
+
+  return stride;
+}
+
+VertexArrayObject::VertexArrayObject(const string &array_name,
+                                     const std::shared_ptr<GLContext> &ctx,
+                                     VertexBufferObject &&vbo_)
+    : VertexArrayObject(array_name, ctx, std::move(vbo_),
+                        packed_position_attribute, 0) {}
+
 VertexArrayObject::VertexArrayObject(const string &array_name,
                                      const std::shared_ptr<GLContext> &ctx,
                                      // TODO: Come up with a style
@@ -18,13 +64,23 @@ VertexArrayObject::VertexArrayObject(const string &array_name,
                                      // the opposite of Google, which
                                      // uses underscore for member
                                      // variables.
-                                     VertexBufferObject &&vbo_)
+                                     VertexBufferObject &&vbo_,
+                                     std::span<const VertexAttribute> attributes,
+                                     GLsizei stride)
     : name{array_name}, gl_context{ctx}, vbo{std::move(vbo_)} {
   // Previously we were using glGenBuffers to generate vertex arrays.
   // It seemed to actually work with results visible on screen.  But
   // it's not the proper way to generate vertex arrays.  Use
   // glGenVertexArrays.
-  gl_context->glGenVertexArrays(1, &VAO);
+  //
+  // With direct state access the vertex array object is set up by
+  // name and never bound here.
+  bool dsa = gl_context->direct_state_access();
+
+  if (dsa)
+    gl_context->glCreateVertexArrays(1, &VAO);
+  else
+    gl_context->glGenVertexArrays(1, &VAO);
 
   GLenum error = gl_context->glGetError();
 
@@ -42,6 +98,28 @@ VertexArrayObject::VertexArrayObject(const string &array_name,
 #endif
   }
 
+  if (dsa) {
+    set_attribute_formats(this->vbo, attributes, stride, 0);
+
+    error = gl_context->glGetError();
+
+    if (error != GL_NO_ERROR) {
+#ifndef NO_EXCEPTIONS
+      throw vertex_array_object::InvalidOperationError(
+          "ERROR::VERTEX_ARRAY::INVALID_OPERATION_ERROR");
+#else
+      set_error(
+          std::optional<sdl_opengl_cpp::error>(error::InvalidOperationError));
+      cleanup();
+      return;
+#endif
+    }
+
+    bindings.push_back({{attributes.begin(), attributes.end()}, stride, 0});
+
+    return;
+  }
+
   gl_context->glBindVertexArray(VAO);
   // glBindVertexArray can return an error
   error = gl_context->glGetError();
@@ -58,11 +136,17 @@ VertexArrayObject::VertexArrayObject(const string &array_name,
 #endif
   }
 
-  gl_context->glEnableVertexAttribArray(0);
+  // With vertex attribute bindings the buffer is attached to the
+  // binding, not bound to GL_ARRAY_BUFFER
+  bool formats = gl_context->vertex_attrib_binding();
 
-  this->vbo.bind();
+  if (formats) {
+    set_attribute_formats(this->vbo, attributes, stride, 0);
+  } else {
+    this->vbo.bind();
 
-  gl_context->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    set_attribute_pointers(attributes, stride, 0, 0);
+  }
 
   error = gl_context->glGetError();
 
@@ -78,13 +162,102 @@ VertexArrayObject::VertexArrayObject(const string &array_name,
 #endif
   }
 
-  gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  if (!formats)
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   gl_context->glBindVertexArray(0);
+
+  bindings.push_back({{attributes.begin(), attributes.end()}, stride, 0});
 }
 
 VertexArrayObject::~VertexArrayObject() { cleanup(); }
 
+void VertexArrayObject::set_attribute_pointers(
+    std::span<const VertexAttribute> attributes, GLsizei stride,
+    GLuint divisor, GLintptr offset) {
+  // The layout is already resolved, this is one enable and one
+  // pointer call per attribute
+  for (const VertexAttribute &attribute : attributes) {
+    const void *pointer = reinterpret_cast<const void *>(
+        static_cast<std::uintptr_t>(offset + attribute.offset));
+
+    gl_context->glEnableVertexAttribArray(attribute.location);
+
+    if (attribute.integer)
+      gl_context->glVertexAttribIPointer(attribute.location,
+                                         attribute.components, attribute.type,
+                                         stride, pointer);
+    else
+      gl_context->glVertexAttribPointer(
+          attribute.location, attribute.components, attribute.type,
+          attribute.normalized, stride, pointer);
+
+    if (divisor != 0)
+      gl_context->glVertexAttribDivisor(attribute.location, divisor);
+  }
+}
+
+void VertexArrayObject::set_attribute_formats(
+    const VertexBufferObject &buffer,
+    std::span<const VertexAttribute> attributes, GLsizei stride,
+    GLuint divisor) {
+  // Each buffer gets its own vertex buffer binding, the attributes
+  // only record their offset into a vertex
+  GLuint binding_index = static_cast<GLuint>(bindings.size());
+
+  if (!gl_context->direct_state_access()) {
+    gl_context->glBindVertexBuffer(binding_index, buffer.get_buffer(), 0,
+                                   binding_stride(attributes, stride));
+
+    for (const VertexAttribute &attribute : attributes) {
+      GLuint relative_offset = static_cast<GLuint>(attribute.offset);
+
+      gl_context->glEnableVertexAttribArray(attribute.location);
+
+      if (attribute.integer)
+        gl_context->glVertexAttribIFormat(attribute.location,
+                                          attribute.components, attribute.type,
+                                          relative_offset);
+      else
+        gl_context->glVertexAttribFormat(attribute.location,
+                                         attribute.components, attribute.type,
+                                         attribute.normalized, relative_offset);
+
+      gl_context->glVertexAttribBinding(attribute.location, binding_index);
+    }
+
+    if (divisor != 0)
+      gl_context->glVertexBindingDivisor(binding_index, divisor);
+
+    return;
+  }
+
+  gl_context->glVertexArrayVertexBuffer(VAO, binding_index,
+                                        buffer.get_buffer(), 0,
+                                        binding_stride(attributes, stride));
+
+  for (const VertexAttribute &attribute : attributes) {
+    GLuint relative_offset = static_cast<GLuint>(attribute.offset);
+
+    gl_context->glEnableVertexArrayAttrib(VAO, attribute.location);
+
+    if (attribute.integer)
+      gl_context->glVertexArrayAttribIFormat(VAO, attribute.location,
+                                             attribute.components,
+                                             attribute.type, relative_offset);
+    else
+      gl_context->glVertexArrayAttribFormat(
+          VAO, attribute.location, attribute.components, attribute.type,
+          attribute.normalized, relative_offset);
+
+    gl_context->glVertexArrayAttribBinding(VAO, attribute.location,
+                                           binding_index);
+  }
+
+  if (divisor != 0)
+    gl_context->glVertexArrayBindingDivisor(VAO, binding_index, divisor);
+}
+
 void VertexArrayObject::cleanup() noexcept {
   if (VAO != 0) {
     if (gl_context != nullptr) {
@@ -99,7 +272,10 @@ void VertexArrayObject::cleanup() noexcept {
 
 // move constructor
 VertexArrayObject::VertexArrayObject(VertexArrayObject &&vao) noexcept
-    : name{vao.name}, vbo{std::move(vao.vbo)} {
+    : name{vao.name}, vbo{std::move(vao.vbo)},
+      index_buffer{std::move(vao.index_buffer)},
+      attached_buffers{std::move(vao.attached_buffers)},
+      bindings{std::move(vao.bindings)} {
   gl_context = vao.gl_context;
   VAO = vao.VAO;
 #ifdef NO_EXCEPTIONS
@@ -109,16 +285,24 @@ VertexArrayObject::VertexArrayObject(VertexArrayObject &&vao) noexcept
 
   vao.gl_context = nullptr;
   vao.VAO = 0;
+  vao.index_buffer.reset();
+  vao.attached_buffers.clear();
+  vao.bindings.clear();
 }
 
 // move assignment operator
 VertexArrayObject &
 VertexArrayObject::operator=(VertexArrayObject &&vao) noexcept {
   if (&vao != this) {
+    cleanup();
+
     gl_context = vao.gl_context;
     name = vao.name;
     VAO = vao.VAO;
     vbo = std::move(vao.vbo);
+    index_buffer = std::move(vao.index_buffer);
+    attached_buffers = std::move(vao.attached_buffers);
+    bindings = std::move(vao.bindings);
 #ifdef NO_EXCEPTIONS
     last_operation_failed = vao.last_operation_failed;
     last_error = vao.last_error;
@@ -126,6 +310,9 @@ VertexArrayObject::operator=(VertexArrayObject &&vao) noexcept {
 
     vao.gl_context = nullptr;
     vao.VAO = 0;
+    vao.index_buffer.reset();
+    vao.attached_buffers.clear();
+    vao.bindings.clear();
   }
 
   return *this;
@@ -160,6 +347,279 @@ void VertexArrayObject::bind() {
 #endif
 }
 
+void VertexArrayObject::attach_index_buffer(IndexBufferObject &&ibo) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexArrayObjectUnspecifiedStateError(
+        "Vertex Array Object is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  index_buffer.emplace(std::move(ibo));
+
+  if (gl_context->direct_state_access()) {
+    gl_context->glVertexArrayElementBuffer(VAO, index_buffer->get_buffer());
+  } else {
+    gl_context->glBindVertexArray(VAO);
+    index_buffer->bind();
+    // Don't unbind GL_ELEMENT_ARRAY_BUFFER here, that would remove it
+    // from the vertex array object
+    gl_context->glBindVertexArray(0);
+  }
+
+#ifdef NO_EXCEPTIONS
+  if (!index_buffer->valid()) {
+    set_error(index_buffer->get_last_error());
+    index_buffer.reset();
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+bool VertexArrayObject::prepare_draw(bool indexed) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexArrayObjectUnspecifiedStateError(
+        "Vertex Array Object is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  if (indexed && !index_buffer) {
+#ifndef NO_EXCEPTIONS
+    throw vertex_array_object::InvalidOperationError(
+        "ERROR::VERTEX_ARRAY::NO_INDEX_BUFFER");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::InvalidOperationError));
+    return false;
+#endif
+  }
+
+  gl_context->glBindVertexArray(VAO);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return true;
+}
+
+void VertexArrayObject::draw_elements(GLenum mode, GLint base_vertex) {
+  if (!prepare_draw(true))
+    return;
+
+  if (base_vertex == 0)
+    gl_context->glDrawElements(mode, index_buffer->get_count(),
+                               index_buffer->get_index_type(), nullptr);
+  else
+    gl_context->glDrawElementsBaseVertex(mode, index_buffer->get_count(),
+                                         index_buffer->get_index_type(),
+                                         nullptr, base_vertex);
+}
+
+void VertexArrayObject::draw_arrays(GLenum mode, GLint first, GLsizei count) {
+  if (!prepare_draw(false))
+    return;
+
+  gl_context->glDrawArrays(mode, first, count);
+}
+
+void VertexArrayObject::draw_arrays_instanced(GLenum mode, GLint first,
+                                              GLsizei count,
+                                              GLsizei instance_count) {
+  if (!prepare_draw(false))
+    return;
+
+  gl_context->glDrawArraysInstanced(mode, first, count, instance_count);
+}
+
+void VertexArrayObject::draw_elements_instanced(GLenum mode,
+                                                GLsizei instance_count) {
+  if (!prepare_draw(true))
+    return;
+
+  gl_context->glDrawElementsInstanced(mode, index_buffer->get_count(),
+                                      index_buffer->get_index_type(), nullptr,
+                                      instance_count);
+}
+
+bool VertexArrayObject::add_buffer(const VertexBufferObject &buffer,
+                                   std::span<const VertexAttribute> attributes,
+                                   GLsizei stride, GLuint divisor) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexArrayObjectUnspecifiedStateError(
+        "Vertex Array Object is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  if (gl_context->direct_state_access()) {
+    set_attribute_formats(buffer, attributes, stride, divisor);
+
+    // GL_INVALID_VALUE for a location, size or binding out of range,
+    // GL_INVALID_ENUM for a bad type
+    if (gl_context->glGetError() != GL_NO_ERROR) {
+#ifndef NO_EXCEPTIONS
+      throw vertex_array_object::InvalidOperationError(
+          "ERROR::VERTEX_ARRAY::INVALID_OPERATION_ERROR");
+#else
+      set_error(
+          std::optional<sdl_opengl_cpp::error>(error::InvalidOperationError));
+      return false;
+#endif
+    }
+
+    bindings.push_back(
+        {{attributes.begin(), attributes.end()}, stride, divisor});
+
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = false;
+#endif
+
+    return true;
+  }
+
+  bool formats = gl_context->vertex_attrib_binding();
+
+  gl_context->glBindVertexArray(VAO);
+
+  if (formats) {
+    set_attribute_formats(buffer, attributes, stride, divisor);
+  } else {
+    buffer.bind();
+
+#ifdef NO_EXCEPTIONS
+    if (!buffer.valid()) {
+      gl_context->glBindVertexArray(0);
+      set_error(buffer.get_last_error());
+      return false;
+    }
+#endif
+
+    set_attribute_pointers(attributes, stride, divisor, 0);
+  }
+
+  GLenum error = gl_context->glGetError();
+
+  if (!formats)
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  gl_context->glBindVertexArray(0);
+
+  // GL_INVALID_VALUE for a location or size out of range,
+  // GL_INVALID_ENUM for a bad type
+  if (error != GL_NO_ERROR) {
+#ifndef NO_EXCEPTIONS
+    throw vertex_array_object::InvalidOperationError(
+        "ERROR::VERTEX_ARRAY::INVALID_OPERATION_ERROR");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::InvalidOperationError));
+    return false;
+#endif
+  }
+
+  bindings.push_back({{attributes.begin(), attributes.end()}, stride, divisor});
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return true;
+}
+
+void VertexArrayObject::attach_buffer(
+    VertexBufferObject &&vbo_, std::span<const VertexAttribute> attributes,
+    GLsizei stride, GLuint divisor) {
+  if (add_buffer(vbo_, attributes, stride, divisor))
+    attached_buffers.push_back(std::move(vbo_));
+}
+
+void VertexArrayObject::reference_buffer(
+    const VertexBufferObject &buffer,
+    std::span<const VertexAttribute> attributes, GLsizei stride,
+    GLuint divisor) {
+  add_buffer(buffer, attributes, stride, divisor);
+}
+
+void VertexArrayObject::bind_vertex_buffer(GLuint binding_index,
+                                           const VertexBufferObject &buffer,
+                                           GLintptr offset) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexArrayObjectUnspecifiedStateError(
+        "Vertex Array Object is in an unspecified state");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if (binding_index >= bindings.size()) {
+#ifndef NO_EXCEPTIONS
+    throw vertex_array_object::InvalidOperationError(
+        "ERROR::VERTEX_ARRAY::NO_VERTEX_BUFFER_BINDING");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::InvalidOperationError));
+    return;
+#endif
+  }
+
+  const VertexBinding &binding = bindings[binding_index];
+
+  if (gl_context->direct_state_access()) {
+    gl_context->glVertexArrayVertexBuffer(
+        VAO, binding_index, buffer.get_buffer(), offset,
+        binding_stride(binding.attributes, binding.stride));
+  } else if (gl_context->vertex_attrib_binding()) {
+    gl_context->glBindVertexArray(VAO);
+    gl_context->glBindVertexBuffer(
+        binding_index, buffer.get_buffer(), offset,
+        binding_stride(binding.attributes, binding.stride));
+  } else {
+    // The formats are part of the attribute pointers, specify them
+    // again for the new buffer
+    gl_context->glBindVertexArray(VAO);
+
+    buffer.bind();
+
+#ifdef NO_EXCEPTIONS
+    if (!buffer.valid()) {
+      set_error(buffer.get_last_error());
+      return;
+    }
+#endif
+
+    set_attribute_pointers(binding.attributes, binding.stride,
+                           binding.divisor, offset);
+
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLuint VertexArrayObject::get_binding_count() const {
+  return static_cast<GLuint>(bindings.size());
+}
+
 // Implement checking for an unspecified state
 bool VertexArrayObject::is_in_unspecified_state() const {
   if ((gl_context == nullptr) || (VAO == 0))
@@ -1,4 +1,4 @@
-#include <cmath>
+#include <limits>
 
 #ifndef NO_EXCEPTIONS
 #include "spdlog/fmt/ostr.h" // support for user defined types
@@ -12,13 +12,35 @@ using namespace sdl_opengl_cpp::vertex_buffer_object;
 
 VertexBufferObject::VertexBufferObject(const string &buffer_name,
                                        const std::shared_ptr<GLContext> &ctx,
-                                       const vector<GLfloat> &data)
-    : name{buffer_name},
-      gl_context{ctx} // ,
-                      // Errors { make_shared<VertexBufferObject>(this) }
+                                       const vector<GLfloat> &data,
+                                       GLenum usage_)
+    : VertexBufferObject(buffer_name, ctx,
+                         std::as_bytes(std::span<const GLfloat>(data)),
+                         usage_) {}
+
+VertexBufferObject::VertexBufferObject(const string &buffer_name,
+                                       const std::shared_ptr<GLContext> &ctx,
+                                       std::span<const std::byte> data,
+                                       GLenum usage_)
+    : VertexBufferObject(buffer_name, ctx, data.data(), data.size(), usage_) {}
+
+VertexBufferObject::VertexBufferObject(const string &buffer_name,
+                                       const std::shared_ptr<GLContext> &ctx,
+                                       GLsizeiptr buffer_size, GLenum usage_)
+    // A negative size wraps around and is rejected as too large
+    : VertexBufferObject(buffer_name, ctx, nullptr,
+                         static_cast<size_t>(buffer_size), usage_) {}
+
+VertexBufferObject::VertexBufferObject(const string &buffer_name,
+                                       const std::shared_ptr<GLContext> &ctx,
+                                       const void *data, size_t data_size,
+                                       GLenum usage_)
+    : name{buffer_name}, gl_context{ctx},
+      usage{usage_} // ,
+                    // Errors { make_shared<VertexBufferObject>(this) }
 {
-  if (data.size() > static_cast<std::vector<GLfloat>::size_type>(
-                        std::exp2(sizeof(GLsizei)))) {
+  if (data_size > static_cast<size_t>(
+                        std::numeric_limits<GLsizeiptr>::max())) {
 #ifndef NO_EXCEPTIONS
     throw BufferDataError(
         "ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::DATA_TOO_LARGE");
@@ -30,6 +52,23 @@ VertexBufferObject::VertexBufferObject(const string &buffer_name,
 #endif
   }
 
+  GLsizeiptr buffer_size = static_cast<GLsizeiptr>(data_size);
+
+  GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+  // Evict cached resources first if the buffer would go over the
+  // memory budget
+  if (!registry.reserve(buffer_size)) {
+#ifndef NO_EXCEPTIONS
+    throw OutOfMemoryError("ERROR::VERTEX_BUFFER::OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    cleanup();
+
+    return;
+#endif
+  }
+
   // It looks like scoped_lock can throw an exception.  From the
   // std::lock cppreference page:
   // "The objects are locked by an unspecified series of calls to
@@ -45,7 +84,15 @@ VertexBufferObject::VertexBufferObject(const string &buffer_name,
   // glGenBuffers with numbers besides one.
   //
   // There might be advantages with OpenGL hardware to sequential buffers
-  ctx->glGenBuffers(1, &VBO);
+  //
+  // With direct state access the buffer is created and filled by
+  // name, without touching the GL_ARRAY_BUFFER binding
+  bool dsa = ctx->direct_state_access();
+
+  if (dsa)
+    ctx->glCreateBuffers(1, &VBO);
+  else
+    ctx->glGenBuffers(1, &VBO);
 
   GLenum error = gl_context->glGetError();
 
@@ -68,8 +115,23 @@ VertexBufferObject::VertexBufferObject(const string &buffer_name,
 #endif
   }
 
-  GLsizei buffer_size =
-      static_cast<GLsizei>(sizeof(GLfloat) * (data.size() * 3));
+  if (dsa) {
+    if (buffer_data(buffer_size, data) == GL_OUT_OF_MEMORY) {
+      cleanup();
+#ifndef NO_EXCEPTIONS
+      throw OutOfMemoryError("ERROR::VERTEX_BUFFER::BUFFER_DATA_OUT_OF_MEMORY");
+#else
+      set_error(std::optional<sdl_opengl_cpp::error>(error::OutOfMemoryError));
+      return;
+#endif
+    }
+
+    size = buffer_size;
+
+    registry.track(GPUMemoryCategory::Buffer, VBO, name, size);
+
+    return;
+  }
 
   // spdlog::info("glBindBuffer in VertexBufferObject constructor: {}", VBO);
   ctx->glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -94,7 +156,20 @@ VertexBufferObject::VertexBufferObject(const string &buffer_name,
 #endif
   }
 
-  ctx->glBufferData(GL_ARRAY_BUFFER, buffer_size, data.data(), GL_STATIC_DRAW);
+  if (buffer_data(buffer_size, data) == GL_OUT_OF_MEMORY) {
+    ctx->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    cleanup();
+#ifndef NO_EXCEPTIONS
+    throw OutOfMemoryError("ERROR::VERTEX_BUFFER::BUFFER_DATA_OUT_OF_MEMORY");
+#else
+    set_error(std::optional<sdl_opengl_cpp::error>(error::OutOfMemoryError));
+    return;
+#endif
+  }
+
+  size = buffer_size;
+
+  registry.track(GPUMemoryCategory::Buffer, VBO, name, size);
 
   // When the VBO no longer needs to be an active target for reading
   // or writing, unbind it with the below
@@ -112,6 +187,7 @@ void VertexBufferObject::cleanup() noexcept {
 
     if (gl_context != nullptr) {
       gl_context->glDeleteBuffers(1, &VBO);
+      GPUMemoryRegistry::instance().release(GPUMemoryCategory::Buffer, VBO);
     }
 
     VBO = 0;
@@ -125,6 +201,8 @@ VertexBufferObject::VertexBufferObject(VertexBufferObject &&vbo) noexcept
     : name{vbo.name} {
   gl_context = vbo.gl_context;
   VBO = vbo.VBO;
+  size = vbo.size;
+  usage = vbo.usage;
 #ifdef NO_EXCEPTIONS
   last_operation_failed = vbo.last_operation_failed;
   last_error = vbo.last_error;
@@ -138,9 +216,13 @@ VertexBufferObject::VertexBufferObject(VertexBufferObject &&vbo) noexcept
 VertexBufferObject &
 VertexBufferObject::operator=(VertexBufferObject &&vbo) noexcept {
   if (&vbo != this) {
+    cleanup();
+
     gl_context = vbo.gl_context;
     name = vbo.name;
     VBO = vbo.VBO;
+    size = vbo.size;
+    usage = vbo.usage;
 #ifdef NO_EXCEPTIONS
     last_operation_failed = vbo.last_operation_failed;
     last_error = vbo.last_error;
@@ -174,7 +256,7 @@ bool VertexBufferObject::is_in_unspecified_state() const {
     return false;
 }
 
-void VertexBufferObject::bind() {
+void VertexBufferObject::bind() const {
   if (is_in_unspecified_state()) {
 #ifndef NO_EXCEPTIONS
     throw VertexBufferObjectUnspecifiedStateError(
@@ -191,3 +273,208 @@ void VertexBufferObject::bind() {
   last_operation_failed = false;
 #endif
 }
+
+void VertexBufferObject::bind(GLenum target) const {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexBufferObjectUnspecifiedStateError(
+        "Vertex Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  gl_context->glBindBuffer(target, VBO);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void VertexBufferObject::bind_base(GLenum target, GLuint index) const {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexBufferObjectUnspecifiedStateError(
+        "Vertex Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  gl_context->glBindBufferBase(target, index, VBO);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void VertexBufferObject::bind_range(GLenum target, GLuint index,
+                                    GLintptr offset,
+                                    GLsizeiptr range_size) const {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexBufferObjectUnspecifiedStateError(
+        "Vertex Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if ((offset < 0) || (range_size <= 0) || (offset > size) ||
+      (range_size > size - offset)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::RANGE_OUT_OF_BOUNDS");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  gl_context->glBindBufferRange(target, index, VBO, offset, range_size);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void VertexBufferObject::update(GLintptr offset,
+                                std::span<const std::byte> data) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexBufferObjectUnspecifiedStateError(
+        "Vertex Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  GLsizeiptr data_size = static_cast<GLsizeiptr>(data.size());
+
+  if ((offset < 0) || (offset > size) || (data_size > size - offset)) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError(
+        "ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::UPDATE_OUT_OF_RANGE");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  if (gl_context->direct_state_access()) {
+    gl_context->glNamedBufferSubData(VBO, offset, data_size, data.data());
+  } else {
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    gl_context->glBufferSubData(GL_ARRAY_BUFFER, offset, data_size,
+                                data.data());
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+void VertexBufferObject::orphan_and_refill(std::span<const std::byte> data) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexBufferObjectUnspecifiedStateError(
+        "Vertex Buffer Object is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  if (data.empty()) {
+#ifndef NO_EXCEPTIONS
+    throw BufferDataError("ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::NO_DATA");
+#else
+    set_error(std::optional<error>(error::BufferDataError));
+    return;
+#endif
+  }
+
+  GLsizeiptr data_size = static_cast<GLsizeiptr>(data.size());
+
+  GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+  // Growing the buffer has to fit in the memory budget like a new one
+  if ((data_size > size) && !registry.reserve(data_size - size)) {
+#ifndef NO_EXCEPTIONS
+    throw OutOfMemoryError("ERROR::VERTEX_BUFFER::OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    return;
+#endif
+  }
+
+  bool dsa = gl_context->direct_state_access();
+
+  if (!dsa)
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+  // Detach the old storage, draws still in flight keep reading it
+  // and we get a fresh block to write into.
+  GLenum gl_error = buffer_data(data_size, nullptr);
+
+  if (gl_error != GL_OUT_OF_MEMORY) {
+    if (dsa)
+      gl_context->glNamedBufferSubData(VBO, 0, data_size, data.data());
+    else
+      gl_context->glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, data.data());
+  }
+
+  if (!dsa)
+    gl_context->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  if (gl_error == GL_OUT_OF_MEMORY) {
+#ifndef NO_EXCEPTIONS
+    throw OutOfMemoryError("ERROR::VERTEX_BUFFER::BUFFER_DATA_OUT_OF_MEMORY");
+#else
+    set_error(std::optional<error>(error::OutOfMemoryError));
+    return;
+#endif
+  }
+
+  size = data_size;
+  registry.resize(GPUMemoryCategory::Buffer, VBO, size);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+GLenum VertexBufferObject::buffer_data(GLsizeiptr data_size,
+                                       const void *data) {
+  auto allocate = [&]() {
+    if (gl_context->direct_state_access())
+      gl_context->glNamedBufferData(VBO, data_size, data, usage);
+    else
+      gl_context->glBufferData(GL_ARRAY_BUFFER, data_size, data, usage);
+  };
+
+  allocate();
+
+  GLenum error = gl_context->glGetError();
+
+  // The data store is where the memory goes, so give the driver back
+  // some memory and try once more before giving up
+  if ((error == GL_OUT_OF_MEMORY) &&
+      (GPUMemoryRegistry::instance().evict(data_size) > 0)) {
+    allocate();
+    error = gl_context->glGetError();
+  }
+
+  return error;
+}
+
+GLsizeiptr VertexBufferObject::get_size() const { return size; }
+
+GLuint VertexBufferObject::get_buffer() const { return VBO; }
+
+GLenum VertexBufferObject::get_usage() const { return usage; }
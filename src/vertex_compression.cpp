@@ -0,0 +1,562 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "vertex_compression.h"
+
+// SSE2 is part of x86-64, so it's used without a runtime check.  The
+// AVX2 paths are compiled with target attributes and picked at
+// runtime, which needs GCC or Clang.
+#if defined(__x86_64__) || defined(_M_X64) ||                                 \
+    (defined(__i386__) && defined(__SSE2__))
+#define VERTEX_COMPRESSION_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define VERTEX_COMPRESSION_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::vertex_compression;
+
+namespace {
+
+// The scalar encoders are written to give the same bits as the SIMD
+// ones.  The clamp matches maxps then minps, which turn NaN into the
+// lower bound, and nearbyint rounds like cvtps2dq in the default
+// rounding mode.
+inline GLfloat clamp(GLfloat value, GLfloat low, GLfloat high) {
+  value = (value > low) ? value : low;
+  return (value < high) ? value : high;
+}
+
+inline std::int32_t quantize(GLfloat value, GLfloat low, GLfloat high,
+                             GLfloat scale) {
+  return static_cast<std::int32_t>(
+      std::nearbyint(clamp(value, low, high) * scale));
+}
+
+SIMDLevel detect_simd_level() {
+#ifdef VERTEX_COMPRESSION_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c"))
+    return SIMDLevel::AVX2;
+#endif
+#ifdef VERTEX_COMPRESSION_SSE2
+  return SIMDLevel::SSE2;
+#else
+  return SIMDLevel::Scalar;
+#endif
+}
+
+SIMDLevel supported_simd_level() {
+  static const SIMDLevel level = detect_simd_level();
+
+  return level;
+}
+
+SIMDLevel &current_simd_level() {
+  static SIMDLevel level = supported_simd_level();
+
+  return level;
+}
+
+#ifdef VERTEX_COMPRESSION_SSE2
+
+inline __m128i quantize_sse2(const GLfloat *source, __m128 low, __m128 high,
+                             __m128 scale) {
+  __m128 value = _mm_loadu_ps(source);
+  value = _mm_min_ps(_mm_max_ps(value, low), high);
+
+  return _mm_cvtps_epi32(_mm_mul_ps(value, scale));
+}
+
+// Each SIMD encoder handles whole blocks and returns how many values
+// it encoded, the caller finishes the tail with the scalar encoder
+
+size_t encode_half_sse2(const GLfloat *source, GLhalf *destination,
+                        size_t count) {
+  const __m128i sign_mask = _mm_set1_epi32(static_cast<int>(0x80000000));
+  const __m128i abs_mask = _mm_set1_epi32(0x7fffffff);
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i round_bias = _mm_set1_epi32(0xfff);
+  const __m128i rebias = _mm_set1_epi32(0x38000000);
+  const __m128i smallest_normal = _mm_set1_epi32(0x38800000);
+  const __m128i overflow = _mm_set1_epi32(0x477fefff);
+  const __m128i infinity = _mm_set1_epi32(0x7f800000);
+  const __m128i half_infinity = _mm_set1_epi32(0x7c00);
+  const __m128i quiet_bit = _mm_set1_epi32(0x200);
+  const __m128i mantissa_mask = _mm_set1_epi32(0x3ff);
+  const __m128 denormal_scale = _mm_set1_ps(16777216.0f);
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m128i halves[2];
+
+    for (int j = 0; j < 2; j++) {
+      __m128i bits = _mm_castps_si128(_mm_loadu_ps(source + i + j * 4));
+      __m128i sign = _mm_srli_epi32(_mm_and_si128(bits, sign_mask), 16);
+      __m128i abs = _mm_and_si128(bits, abs_mask);
+
+      // Normal halves, round to nearest even and rebias the exponent
+      __m128i odd = _mm_and_si128(_mm_srli_epi32(abs, 13), one);
+      __m128i result = _mm_srli_epi32(
+          _mm_sub_epi32(_mm_add_epi32(_mm_add_epi32(abs, round_bias), odd),
+                        rebias),
+          13);
+
+      // Denormal halves are the value in units of 2^-24
+      __m128i denormal = _mm_cvtps_epi32(
+          _mm_mul_ps(_mm_castsi128_ps(abs), denormal_scale));
+      __m128i is_denormal = _mm_cmplt_epi32(abs, smallest_normal);
+      result = _mm_or_si128(_mm_and_si128(is_denormal, denormal),
+                            _mm_andnot_si128(is_denormal, result));
+
+      __m128i is_overflow = _mm_cmpgt_epi32(abs, overflow);
+      result = _mm_or_si128(_mm_and_si128(is_overflow, half_infinity),
+                            _mm_andnot_si128(is_overflow, result));
+
+      __m128i is_nan = _mm_cmpgt_epi32(abs, infinity);
+      __m128i nan = _mm_or_si128(
+          quiet_bit, _mm_and_si128(_mm_srli_epi32(abs, 13), mantissa_mask));
+      result = _mm_or_si128(result, _mm_and_si128(is_nan, nan));
+
+      // Sign extend from 16 bits so the signed pack doesn't saturate
+      result = _mm_or_si128(result, sign);
+      halves[j] = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                     _mm_packs_epi32(halves[0], halves[1]));
+  }
+
+  return i;
+}
+
+size_t encode_snorm8_sse2(const GLfloat *source, GLbyte *destination,
+                          size_t count) {
+  const __m128 low = _mm_set1_ps(-1.0f);
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(127.0f);
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = quantize_sse2(source + i, low, high, scale);
+    __m128i b = quantize_sse2(source + i + 4, low, high, scale);
+    __m128i c = quantize_sse2(source + i + 8, low, high, scale);
+    __m128i d = quantize_sse2(source + i + 12, low, high, scale);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                     _mm_packs_epi16(_mm_packs_epi32(a, b),
+                                     _mm_packs_epi32(c, d)));
+  }
+
+  return i;
+}
+
+size_t encode_unorm8_sse2(const GLfloat *source, GLubyte *destination,
+                          size_t count) {
+  const __m128 low = _mm_setzero_ps();
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(255.0f);
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = quantize_sse2(source + i, low, high, scale);
+    __m128i b = quantize_sse2(source + i + 4, low, high, scale);
+    __m128i c = quantize_sse2(source + i + 8, low, high, scale);
+    __m128i d = quantize_sse2(source + i + 12, low, high, scale);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                     _mm_packus_epi16(_mm_packs_epi32(a, b),
+                                      _mm_packs_epi32(c, d)));
+  }
+
+  return i;
+}
+
+size_t encode_snorm16_sse2(const GLfloat *source, GLshort *destination,
+                           size_t count) {
+  const __m128 low = _mm_set1_ps(-1.0f);
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(32767.0f);
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    __m128i a = quantize_sse2(source + i, low, high, scale);
+    __m128i b = quantize_sse2(source + i + 4, low, high, scale);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                     _mm_packs_epi32(a, b));
+  }
+
+  return i;
+}
+
+size_t encode_unorm16_sse2(const GLfloat *source, GLushort *destination,
+                           size_t count) {
+  const __m128 low = _mm_setzero_ps();
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(65535.0f);
+  const __m128i bias32 = _mm_set1_epi32(32768);
+  const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+  size_t i = 0;
+
+  // SSE2 has no unsigned saturating pack from 32 bits, so shift the
+  // values into the signed range, pack, and shift them back
+  for (; i + 8 <= count; i += 8) {
+    __m128i a = _mm_sub_epi32(quantize_sse2(source + i, low, high, scale),
+                              bias32);
+    __m128i b = _mm_sub_epi32(
+        quantize_sse2(source + i + 4, low, high, scale), bias32);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                     _mm_xor_si128(_mm_packs_epi32(a, b), bias16));
+  }
+
+  return i;
+}
+
+// Counts vectors, not floats
+size_t encode_snorm_2_10_10_10_sse2(const GLfloat *source,
+                                    GLuint *destination, size_t count) {
+  const __m128 low = _mm_set1_ps(-1.0f);
+  const __m128 high = _mm_set1_ps(1.0f);
+  const __m128 scale = _mm_set1_ps(511.0f);
+  const __m128 w_scale = _mm_set1_ps(1.0f);
+  const __m128i mask = _mm_set1_epi32(0x3ff);
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(source + i * 4);
+    __m128 y = _mm_loadu_ps(source + i * 4 + 4);
+    __m128 z = _mm_loadu_ps(source + i * 4 + 8);
+    __m128 w = _mm_loadu_ps(source + i * 4 + 12);
+
+    // Rows were vectors, now they are components
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    auto quantize_row = [&](__m128 row, __m128 row_scale) {
+      row = _mm_min_ps(_mm_max_ps(row, low), high);
+      return _mm_cvtps_epi32(_mm_mul_ps(row, row_scale));
+    };
+
+    __m128i packed = _mm_and_si128(quantize_row(x, scale), mask);
+    packed = _mm_or_si128(
+        packed, _mm_slli_epi32(_mm_and_si128(quantize_row(y, scale), mask),
+                               10));
+    packed = _mm_or_si128(
+        packed, _mm_slli_epi32(_mm_and_si128(quantize_row(z, scale), mask),
+                               20));
+    packed = _mm_or_si128(packed,
+                          _mm_slli_epi32(quantize_row(w, w_scale), 30));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i), packed);
+  }
+
+  return i;
+}
+
+#endif
+
+#ifdef VERTEX_COMPRESSION_AVX2
+
+#define VERTEX_COMPRESSION_TARGET __attribute__((target("avx2,f16c")))
+
+VERTEX_COMPRESSION_TARGET inline __m256i
+quantize_avx2(const GLfloat *source, __m256 low, __m256 high, __m256 scale) {
+  __m256 value = _mm256_loadu_ps(source);
+  value = _mm256_min_ps(_mm256_max_ps(value, low), high);
+
+  return _mm256_cvtps_epi32(_mm256_mul_ps(value, scale));
+}
+
+VERTEX_COMPRESSION_TARGET size_t encode_half_avx2(const GLfloat *source,
+                                                  GLhalf *destination,
+                                                  size_t count) {
+  size_t i = 0;
+
+  for (; i + 8 <= count; i += 8) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(destination + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(source + i),
+                        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+
+  return i;
+}
+
+// The 256-bit packs work on each 128-bit half separately, these
+// put the results back in order
+VERTEX_COMPRESSION_TARGET inline __m256i fix_pack16_order(__m256i packed) {
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+VERTEX_COMPRESSION_TARGET inline __m256i fix_pack8_order(__m256i packed) {
+  return _mm256_permutevar8x32_epi32(packed,
+                                     _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+VERTEX_COMPRESSION_TARGET size_t encode_snorm8_avx2(const GLfloat *source,
+                                                    GLbyte *destination,
+                                                    size_t count) {
+  const __m256 low = _mm256_set1_ps(-1.0f);
+  const __m256 high = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(127.0f);
+  size_t i = 0;
+
+  for (; i + 32 <= count; i += 32) {
+    __m256i a = quantize_avx2(source + i, low, high, scale);
+    __m256i b = quantize_avx2(source + i + 8, low, high, scale);
+    __m256i c = quantize_avx2(source + i + 16, low, high, scale);
+    __m256i d = quantize_avx2(source + i + 24, low, high, scale);
+
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(destination + i),
+        fix_pack8_order(_mm256_packs_epi16(_mm256_packs_epi32(a, b),
+                                           _mm256_packs_epi32(c, d))));
+  }
+
+  return i;
+}
+
+VERTEX_COMPRESSION_TARGET size_t encode_unorm8_avx2(const GLfloat *source,
+                                                    GLubyte *destination,
+                                                    size_t count) {
+  const __m256 low = _mm256_setzero_ps();
+  const __m256 high = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(255.0f);
+  size_t i = 0;
+
+  for (; i + 32 <= count; i += 32) {
+    __m256i a = quantize_avx2(source + i, low, high, scale);
+    __m256i b = quantize_avx2(source + i + 8, low, high, scale);
+    __m256i c = quantize_avx2(source + i + 16, low, high, scale);
+    __m256i d = quantize_avx2(source + i + 24, low, high, scale);
+
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(destination + i),
+        fix_pack8_order(_mm256_packus_epi16(_mm256_packs_epi32(a, b),
+                                            _mm256_packs_epi32(c, d))));
+  }
+
+  return i;
+}
+
+VERTEX_COMPRESSION_TARGET size_t encode_snorm16_avx2(const GLfloat *source,
+                                                     GLshort *destination,
+                                                     size_t count) {
+  const __m256 low = _mm256_set1_ps(-1.0f);
+  const __m256 high = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(32767.0f);
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256i a = quantize_avx2(source + i, low, high, scale);
+    __m256i b = quantize_avx2(source + i + 8, low, high, scale);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i),
+                        fix_pack16_order(_mm256_packs_epi32(a, b)));
+  }
+
+  return i;
+}
+
+VERTEX_COMPRESSION_TARGET size_t encode_unorm16_avx2(const GLfloat *source,
+                                                     GLushort *destination,
+                                                     size_t count) {
+  const __m256 low = _mm256_setzero_ps();
+  const __m256 high = _mm256_set1_ps(1.0f);
+  const __m256 scale = _mm256_set1_ps(65535.0f);
+  size_t i = 0;
+
+  for (; i + 16 <= count; i += 16) {
+    __m256i a = quantize_avx2(source + i, low, high, scale);
+    __m256i b = quantize_avx2(source + i + 8, low, high, scale);
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(destination + i),
+                        fix_pack16_order(_mm256_packus_epi32(a, b)));
+  }
+
+  return i;
+}
+
+#endif
+
+// Run the best SIMD encoder available, then the scalar encoder on
+// what's left
+template <typename T, typename Scalar>
+size_t encode(std::span<const GLfloat> source, std::span<T> destination,
+              size_t (*sse2)(const GLfloat *, std::type_identity_t<T> *, size_t),
+              size_t (*avx2)(const GLfloat *, std::type_identity_t<T> *, size_t),
+              Scalar scalar) {
+  size_t count = std::min(source.size(), destination.size());
+  size_t i = 0;
+
+  switch (current_simd_level()) {
+  case SIMDLevel::AVX2:
+    if (avx2) {
+      i = avx2(source.data(), destination.data(), count);
+      break;
+    }
+    [[fallthrough]];
+  case SIMDLevel::SSE2:
+    if (sse2)
+      i = sse2(source.data(), destination.data(), count);
+    break;
+  case SIMDLevel::Scalar:
+    break;
+  }
+
+  for (; i < count; i++)
+    destination[i] = scalar(source[i]);
+
+  return count;
+}
+
+} // namespace
+
+// nullptr stands in for the SIMD encoders this build doesn't have
+#ifdef VERTEX_COMPRESSION_SSE2
+#define SSE2_ENCODER(name) name##_sse2
+#else
+#define SSE2_ENCODER(name) nullptr
+#endif
+
+#ifdef VERTEX_COMPRESSION_AVX2
+#define AVX2_ENCODER(name) name##_avx2
+#else
+#define AVX2_ENCODER(name) nullptr
+#endif
+
+SIMDLevel vertex_compression::get_simd_level() { return current_simd_level(); }
+
+SIMDLevel vertex_compression::set_simd_level(SIMDLevel level) {
+  current_simd_level() = std::min(level, supported_simd_level());
+
+  return current_simd_level();
+}
+
+GLhalf vertex_compression::float_to_half(GLfloat value) {
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  GLhalf sign = static_cast<GLhalf>((bits >> 16) & 0x8000);
+  std::uint32_t abs = bits & 0x7fffffff;
+
+  // NaN, keeping the top of the payload like F16C does
+  if (abs > 0x7f800000)
+    return sign | 0x7e00 | ((abs >> 13) & 0x3ff);
+
+  // Infinity, and everything that rounds up past the largest half
+  if (abs > 0x477fefff)
+    return sign | 0x7c00;
+
+  // Denormal halves are the value in units of 2^-24
+  if (abs < 0x38800000)
+    return sign | static_cast<GLhalf>(std::nearbyint(
+                      std::bit_cast<GLfloat>(abs) * 16777216.0f));
+
+  // Round to nearest even and rebias the exponent from 127 to 15
+  abs += 0xfff + ((abs >> 13) & 1);
+
+  return sign | static_cast<GLhalf>((abs - 0x38000000) >> 13);
+}
+
+GLfloat vertex_compression::half_to_float(GLhalf value) {
+  std::uint32_t sign = static_cast<std::uint32_t>(value & 0x8000) << 16;
+  std::uint32_t exponent = (value >> 10) & 0x1f;
+  std::uint32_t mantissa = value & 0x3ff;
+
+  if (exponent == 0) {
+    GLfloat magnitude = static_cast<GLfloat>(mantissa) / 16777216.0f;
+    return sign ? -magnitude : magnitude;
+  }
+
+  if (exponent == 0x1f)
+    return std::bit_cast<GLfloat>(sign | 0x7f800000 | (mantissa << 13));
+
+  return std::bit_cast<GLfloat>(sign | ((exponent + 112) << 23) |
+                                (mantissa << 13));
+}
+
+GLbyte vertex_compression::float_to_snorm8(GLfloat value) {
+  return static_cast<GLbyte>(quantize(value, -1.0f, 1.0f, 127.0f));
+}
+
+GLubyte vertex_compression::float_to_unorm8(GLfloat value) {
+  return static_cast<GLubyte>(quantize(value, 0.0f, 1.0f, 255.0f));
+}
+
+GLshort vertex_compression::float_to_snorm16(GLfloat value) {
+  return static_cast<GLshort>(quantize(value, -1.0f, 1.0f, 32767.0f));
+}
+
+GLushort vertex_compression::float_to_unorm16(GLfloat value) {
+  return static_cast<GLushort>(quantize(value, 0.0f, 1.0f, 65535.0f));
+}
+
+GLuint vertex_compression::pack_snorm_2_10_10_10(GLfloat x, GLfloat y,
+                                                 GLfloat z, GLfloat w) {
+  GLuint packed = static_cast<GLuint>(quantize(x, -1.0f, 1.0f, 511.0f)) & 0x3ff;
+  packed |= (static_cast<GLuint>(quantize(y, -1.0f, 1.0f, 511.0f)) & 0x3ff)
+            << 10;
+  packed |= (static_cast<GLuint>(quantize(z, -1.0f, 1.0f, 511.0f)) & 0x3ff)
+            << 20;
+  packed |= static_cast<GLuint>(quantize(w, -1.0f, 1.0f, 1.0f)) << 30;
+
+  return packed;
+}
+
+size_t vertex_compression::encode_half(std::span<const GLfloat> source,
+                                       std::span<GLhalf> destination) {
+  return encode(source, destination, SSE2_ENCODER(encode_half),
+                AVX2_ENCODER(encode_half), float_to_half);
+}
+
+size_t vertex_compression::encode_snorm8(std::span<const GLfloat> source,
+                                         std::span<GLbyte> destination) {
+  return encode(source, destination, SSE2_ENCODER(encode_snorm8),
+                AVX2_ENCODER(encode_snorm8), float_to_snorm8);
+}
+
+size_t vertex_compression::encode_unorm8(std::span<const GLfloat> source,
+                                         std::span<GLubyte> destination) {
+  return encode(source, destination, SSE2_ENCODER(encode_unorm8),
+                AVX2_ENCODER(encode_unorm8), float_to_unorm8);
+}
+
+size_t vertex_compression::encode_snorm16(std::span<const GLfloat> source,
+                                          std::span<GLshort> destination) {
+  return encode(source, destination, SSE2_ENCODER(encode_snorm16),
+                AVX2_ENCODER(encode_snorm16), float_to_snorm16);
+}
+
+size_t vertex_compression::encode_unorm16(std::span<const GLfloat> source,
+                                          std::span<GLushort> destination) {
+  return encode(source, destination, SSE2_ENCODER(encode_unorm16),
+                AVX2_ENCODER(encode_unorm16), float_to_unorm16);
+}
+
+size_t
+vertex_compression::encode_snorm_2_10_10_10(std::span<const GLfloat> source,
+                                            std::span<GLuint> destination) {
+  size_t count = std::min(source.size() / 4, destination.size());
+  size_t i = 0;
+
+  // The transpose costs as much as the wider registers save, so the
+  // AVX2 level uses the SSE2 encoder here
+#ifdef VERTEX_COMPRESSION_SSE2
+  if (current_simd_level() != SIMDLevel::Scalar)
+    i = encode_snorm_2_10_10_10_sse2(source.data(), destination.data(),
+                                     count);
+#endif
+
+  for (; i < count; i++)
+    destination[i] =
+        pack_snorm_2_10_10_10(source[i * 4], source[i * 4 + 1],
+                              source[i * 4 + 2], source[i * 4 + 3]);
+
+  return count;
+}
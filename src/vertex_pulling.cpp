@@ -0,0 +1,399 @@
+#include <cstdint>
+
+#include "vertex_pulling.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::vertex_pulling;
+
+namespace {
+
+// How a component type is stored in the words of the buffer
+struct ComponentFormat {
+  // Bits per component, packed types list the first component
+  GLuint bits = 0;
+  bool is_signed = false;
+  bool is_float = false;
+  bool packed = false;
+};
+
+bool component_format(GLenum type, ComponentFormat &format) {
+  switch (type) {
+  case GL_BYTE:
+    format = {8, true, false, false};
+    return true;
+  case GL_UNSIGNED_BYTE:
+    format = {8, false, false, false};
+    return true;
+  case GL_SHORT:
+    format = {16, true, false, false};
+    return true;
+  case GL_UNSIGNED_SHORT:
+    format = {16, false, false, false};
+    return true;
+  case GL_INT:
+    format = {32, true, false, false};
+    return true;
+  case GL_UNSIGNED_INT:
+    format = {32, false, false, false};
+    return true;
+  case GL_HALF_FLOAT:
+    format = {16, true, true, false};
+    return true;
+  case GL_FLOAT:
+    format = {32, true, true, false};
+    return true;
+  case GL_INT_2_10_10_10_REV:
+    format = {10, true, false, true};
+    return true;
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+    format = {10, false, false, true};
+    return true;
+  default:
+    return false;
+  }
+}
+
+string uint_literal(std::uint64_t value) {
+  return std::to_string(value) + "u";
+}
+
+string float_literal(std::uint64_t value) {
+  return std::to_string(value) + ".0";
+}
+
+// Read bits bits at bit offset bit of a vertex, as an int or uint
+string extract(const string &data, std::uint64_t bit, GLuint bits,
+               bool is_signed) {
+  string word = data + "[base + " + uint_literal(bit / 32) + "]";
+  std::uint64_t shift = bit % 32;
+
+  if (bits == 32)
+    return is_signed ? "int(" + word + ")" : word;
+
+  if (is_signed)
+    word = "int(" + word + ")";
+
+  return "bitfieldExtract(" + word + ", " + std::to_string(shift) + ", " +
+         std::to_string(bits) + ")";
+}
+
+// One component of an attribute, converted like glVertexAttribPointer
+// or glVertexAttribIPointer would
+string component(const string &data, const VertexAttribute &attribute,
+                 const ComponentFormat &format, GLint index) {
+  std::uint64_t bit = static_cast<std::uint64_t>(attribute.offset) * 8;
+  GLuint bits = format.bits;
+
+  if (format.packed) {
+    bit += static_cast<std::uint64_t>(index) * 10;
+    if (index == 3)
+      bits = 2;
+  } else {
+    bit += static_cast<std::uint64_t>(index) * format.bits;
+  }
+
+  if (format.is_float) {
+    string word = data + "[base + " + uint_literal(bit / 32) + "]";
+
+    if (format.bits == 32)
+      return "uintBitsToFloat(" + word + ")";
+
+    if (bit % 32 != 0)
+      word += " >> " + uint_literal(bit % 32);
+
+    return "unpackHalf2x16(" + word + ").x";
+  }
+
+  string value = extract(data, bit, bits, format.is_signed);
+
+  if (attribute.integer)
+    return value;
+
+  if (!attribute.normalized)
+    return "float(" + value + ")";
+
+  if (format.is_signed) {
+    std::uint64_t max = (std::uint64_t{1} << (bits - 1)) - 1;
+    return "max(float(" + value + ") / " + float_literal(max) + ", -1.0)";
+  }
+
+  std::uint64_t max = (std::uint64_t{1} << bits) - 1;
+  return "float(" + value + ") / " + float_literal(max);
+}
+
+// The GLSL type of an attribute with components components
+string glsl_type(const VertexAttribute &attribute,
+                 const ComponentFormat &format) {
+  string scalar = "float";
+  string vector = "vec";
+
+  if (attribute.integer) {
+    scalar = format.is_signed ? "int" : "uint";
+    vector = format.is_signed ? "ivec" : "uvec";
+  }
+
+  if (attribute.components == 1)
+    return scalar;
+
+  return vector + std::to_string(attribute.components);
+}
+
+bool valid_attribute(const VertexAttribute &attribute,
+                     const ComponentFormat &format, GLsizei stride) {
+  if ((attribute.components < 1) || (attribute.components > 4))
+    return false;
+
+  // Integer attributes have no float or packed forms
+  if (attribute.integer && (format.is_float || format.packed))
+    return false;
+
+  if (format.packed && (attribute.components != 4))
+    return false;
+
+  GLsizei alignment =
+      format.packed ? 4 : static_cast<GLsizei>(format.bits / 8);
+  GLsizei size = format.packed
+                     ? 4
+                     : alignment * static_cast<GLsizei>(attribute.components);
+
+  return (attribute.offset >= 0) && (attribute.offset % alignment == 0) &&
+         (attribute.offset + size <= stride);
+}
+
+} // namespace
+
+string vertex_pulling::fetch_source(std::span<const VertexAttribute> attributes,
+                                    GLsizei stride, GLuint binding,
+                                    const string &prefix) {
+  if ((stride <= 0) || (stride % 4 != 0))
+    return "";
+
+  string data = prefix + "_data";
+  string source = "layout(std430, binding = " + std::to_string(binding) +
+                  ") readonly buffer " + prefix + "_vertices {\n  uint " +
+                  data + "[];\n};\n";
+
+  for (const VertexAttribute &attribute : attributes) {
+    ComponentFormat format;
+
+    if (!component_format(attribute.type, format) ||
+        !valid_attribute(attribute, format, stride))
+      return "";
+
+    string type = glsl_type(attribute, format);
+    string function = prefix + "_" + std::to_string(attribute.location);
+
+    source += "\n" + type + " " + function + "(uint vertex) {\n";
+    source += "  uint base = vertex * " +
+              uint_literal(static_cast<std::uint64_t>(stride / 4)) + ";\n";
+
+    if (attribute.components == 1) {
+      source += "  return " + component(data, attribute, format, 0) + ";\n";
+    } else {
+      source += "  return " + type + "(";
+      for (GLint i = 0; i < attribute.components; i++) {
+        if (i != 0)
+          source += ",\n" + string(type.size() + 10, ' ');
+        source += component(data, attribute, format, i);
+      }
+      source += ");\n";
+    }
+    source += "}\n";
+
+    source += "\n" + type + " " + function + "() {\n";
+    source += "  return " + function + "(uint(gl_VertexID));\n}\n";
+  }
+
+  return source;
+}
+
+VertexPuller::VertexPuller(const string &puller_name,
+                           const std::shared_ptr<GLContext> &ctx,
+                           GLuint binding_)
+    : name{puller_name}, gl_context{ctx}, binding{binding_} {
+  gl_context->glGenVertexArrays(1, &VAO);
+
+  GLenum error = gl_context->glGetError();
+
+  if ((error == GL_OUT_OF_MEMORY) || (VAO == 0)) {
+#ifndef NO_EXCEPTIONS
+    throw GenVertexArraysError(
+        "ERROR::VERTEX_PULLER::GEN_VERTEX_ARRAYS_FAILED");
+#else
+    set_error(
+        std::optional<sdl_opengl_cpp::error>(error::GenVertexArraysError));
+    cleanup();
+    return;
+#endif
+  }
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+}
+
+VertexPuller::~VertexPuller() { cleanup(); }
+
+void VertexPuller::cleanup() noexcept {
+  if (VAO != 0) {
+    if (gl_context != nullptr) {
+      gl_context->glDeleteVertexArrays(1, &VAO);
+    }
+
+    VAO = 0;
+  }
+
+  gl_context = nullptr;
+}
+
+// move constructor
+VertexPuller::VertexPuller(VertexPuller &&puller) noexcept
+    : name{puller.name}, gl_context{puller.gl_context},
+      binding{puller.binding}, VAO{puller.VAO} {
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = puller.last_operation_failed;
+  last_error = puller.last_error;
+#endif
+
+  puller.gl_context = nullptr;
+  puller.VAO = 0;
+}
+
+// move assignment operator
+VertexPuller &VertexPuller::operator=(VertexPuller &&puller) noexcept {
+  if (&puller != this) {
+    cleanup();
+
+    name = puller.name;
+    gl_context = puller.gl_context;
+    binding = puller.binding;
+    VAO = puller.VAO;
+#ifdef NO_EXCEPTIONS
+    last_operation_failed = puller.last_operation_failed;
+    last_error = puller.last_error;
+#endif
+
+    puller.gl_context = nullptr;
+    puller.VAO = 0;
+  }
+
+  return *this;
+}
+
+// Implement checking for an unspecified state
+bool VertexPuller::is_in_unspecified_state() const {
+  if ((gl_context == nullptr) || (VAO == 0))
+    return true;
+  else
+    return false;
+}
+
+bool VertexPuller::prepare_draw() {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexPullerUnspecifiedStateError(
+        "Vertex Puller is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return false;
+#endif
+  }
+
+  gl_context->glBindVertexArray(VAO);
+
+#ifdef NO_EXCEPTIONS
+  last_operation_failed = false;
+#endif
+
+  return true;
+}
+
+void VertexPuller::bind() { prepare_draw(); }
+
+void VertexPuller::bind_vertices(ShaderStorageBufferObject &vertices) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexPullerUnspecifiedStateError(
+        "Vertex Puller is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  vertices.bind_base(binding);
+
+#ifdef NO_EXCEPTIONS
+  if (!vertices.valid()) {
+    set_error(vertices.get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+void VertexPuller::bind_vertices(ShaderStorageBufferObject &vertices,
+                                 GLintptr offset, GLsizeiptr size) {
+  if (is_in_unspecified_state()) {
+#ifndef NO_EXCEPTIONS
+    throw VertexPullerUnspecifiedStateError(
+        "Vertex Puller is in an unspecified state");
+#else
+    set_error(std::optional<error>(error::UnspecifiedStateError));
+    return;
+#endif
+  }
+
+  vertices.bind_range(binding, offset, size);
+
+#ifdef NO_EXCEPTIONS
+  if (!vertices.valid()) {
+    set_error(vertices.get_last_error());
+    return;
+  }
+
+  last_operation_failed = false;
+#endif
+}
+
+void VertexPuller::draw_arrays(GLenum mode, GLint first, GLsizei count) {
+  if (!prepare_draw())
+    return;
+
+  gl_context->glDrawArrays(mode, first, count);
+}
+
+void VertexPuller::draw_arrays_instanced(GLenum mode, GLint first,
+                                         GLsizei count,
+                                         GLsizei instance_count) {
+  if (!prepare_draw())
+    return;
+
+  gl_context->glDrawArraysInstanced(mode, first, count, instance_count);
+}
+
+void VertexPuller::draw_elements(IndexBufferObject &indices, GLenum mode,
+                                 GLint base_vertex) {
+  if (!prepare_draw())
+    return;
+
+  indices.bind();
+
+#ifdef NO_EXCEPTIONS
+  if (!indices.valid()) {
+    set_error(indices.get_last_error());
+    return;
+  }
+#endif
+
+  if (base_vertex == 0)
+    gl_context->glDrawElements(mode, indices.get_count(),
+                               indices.get_index_type(), nullptr);
+  else
+    gl_context->glDrawElementsBaseVertex(mode, indices.get_count(),
+                                         indices.get_index_type(), nullptr,
+                                         base_vertex);
+}
+
+GLuint VertexPuller::get_binding() const { return binding; }
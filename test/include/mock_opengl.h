@@ -1,6 +1,7 @@
 #ifndef _SDL_OPENGL_CPP_MOCK_OPENGL_H_
 #define _SDL_OPENGL_CPP_MOCK_OPENGL_H_
 
+#include <cstdint>
 #include <memory>
 
 #include "gmock/gmock.h"
@@ -23,16 +24,32 @@ namespace sdl_opengl_cpp {
 
 class MockOpenGLContext : public GLContext {
 public:
-  MockOpenGLContext(std::shared_ptr<GL_Context> &ctx) : GLContext(ctx) {}
+  MockOpenGLContext(std::shared_ptr<GL_Context> &ctx) : GLContext(ctx) {
+    // Bind-to-edit and glVertexAttribPointer unless a test asks for
+    // direct state access or vertex attribute bindings, a later
+    // EXPECT_CALL takes precedence
+    EXPECT_CALL(*this, direct_state_access())
+        .Times(::testing::AnyNumber())
+        .WillRepeatedly(::testing::Return(false));
+    EXPECT_CALL(*this, vertex_attrib_binding())
+        .Times(::testing::AnyNumber())
+        .WillRepeatedly(::testing::Return(false));
+  }
 
   ~MockOpenGLContext(){};
 
+  MOCK_METHOD(bool, supports, (GLFeature feature), (override));
+  MOCK_METHOD(bool, direct_state_access, (), (override));
+  MOCK_METHOD(bool, vertex_attrib_binding, (), (override));
+
   // General functions
 
   MOCK_METHOD(void, glPushAttrib, (GLbitfield mask), (override));
   MOCK_METHOD(void, glPopAttrib, (), (override));
 
   MOCK_METHOD(GLenum, glGetError, (), (override));
+  MOCK_METHOD(void, glGetIntegerv, (GLenum pname, GLint *params), (override));
+  MOCK_METHOD(void, glGetFloatv, (GLenum pname, GLfloat *params), (override));
 
   // Miscellaneous
 
@@ -44,29 +61,167 @@ public:
 
   MOCK_METHOD(void, glTexParameteri, (GLenum target, GLenum pname, GLint param),
               (override));
+  MOCK_METHOD(void, glTexParameterf,
+              (GLenum target, GLenum pname, GLfloat param), (override));
+  MOCK_METHOD(void, glTexStorage2D,
+              (GLenum target, GLsizei levels, GLenum internal_format,
+               GLsizei width, GLsizei height),
+              (override));
+  MOCK_METHOD(void, glTexStorage3D,
+              (GLenum target, GLsizei levels, GLenum internal_format,
+               GLsizei width, GLsizei height, GLsizei depth),
+              (override));
+  MOCK_METHOD(void, glGenerateMipmap, (GLenum target), (override));
+  MOCK_METHOD(void, glActiveTexture, (GLenum texture), (override));
+  MOCK_METHOD(void, glPixelStorei, (GLenum pname, GLint param), (override));
 
   MOCK_METHOD(void, glTexImage2D,
               (GLenum target, GLint level, GLint internalFormat, GLsizei width,
                GLsizei height, GLint border, GLenum format, GLenum type,
                const GLvoid *pixels),
               (override));
+  MOCK_METHOD(void, glTexSubImage2D,
+              (GLenum target, GLint level, GLint xoffset, GLint yoffset,
+               GLsizei width, GLsizei height, GLenum format, GLenum type,
+               const GLvoid *pixels),
+              (override));
+  MOCK_METHOD(void, glTexImage3D,
+              (GLenum target, GLint level, GLint internalFormat, GLsizei width,
+               GLsizei height, GLsizei depth, GLint border, GLenum format,
+               GLenum type, const GLvoid *pixels),
+              (override));
+  MOCK_METHOD(void, glTexSubImage3D,
+              (GLenum target, GLint level, GLint xoffset, GLint yoffset,
+               GLint zoffset, GLsizei width, GLsizei height, GLsizei depth,
+               GLenum format, GLenum type, const GLvoid *pixels),
+              (override));
 
   // 1.1 functions
   MOCK_METHOD(void, glGenTextures, (GLsizei n, GLuint *textures), (override));
+  MOCK_METHOD(void, glDeleteTextures, (GLsizei n, const GLuint *textures),
+              (override));
   MOCK_METHOD(void, glBindTexture, (GLenum target, GLuint texture), (override));
+  MOCK_METHOD(void, glCreateTextures,
+              (GLenum target, GLsizei n, GLuint *textures), (override));
+  MOCK_METHOD(void, glTextureParameteri,
+              (GLuint texture, GLenum pname, GLint param), (override));
+  MOCK_METHOD(void, glTextureParameterf,
+              (GLuint texture, GLenum pname, GLfloat param), (override));
+  MOCK_METHOD(void, glGenerateTextureMipmap, (GLuint texture), (override));
+  MOCK_METHOD(void, glTextureStorage2D,
+              (GLuint texture, GLsizei levels, GLenum internal_format,
+               GLsizei width, GLsizei height),
+              (override));
+  MOCK_METHOD(void, glTextureSubImage2D,
+              (GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+               GLsizei width, GLsizei height, GLenum format, GLenum type,
+               const void *pixels),
+              (override));
+  MOCK_METHOD(void, glTextureStorage3D,
+              (GLuint texture, GLsizei levels, GLenum internal_format,
+               GLsizei width, GLsizei height, GLsizei depth),
+              (override));
+  MOCK_METHOD(void, glTextureSubImage3D,
+              (GLuint texture, GLint level, GLint xoffset, GLint yoffset,
+               GLint zoffset, GLsizei width, GLsizei height, GLsizei depth,
+               GLenum format, GLenum type, const void *pixels),
+              (override));
   MOCK_METHOD(void, glPushMatrix, (), (override));
   MOCK_METHOD(void, glPopMatrix, (), (override));
   MOCK_METHOD(void, glViewport,
               (GLint x, GLint y, GLsizei width, GLsizei height), (override));
 
+  // Drawing functions
+  MOCK_METHOD(void, glDrawArrays, (GLenum mode, GLint first, GLsizei count),
+              (override));
+  MOCK_METHOD(void, glDrawElements,
+              (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices),
+              (override));
+  MOCK_METHOD(void, glDrawElementsBaseVertex,
+              (GLenum mode, GLsizei count, GLenum type, const GLvoid *indices,
+               GLint base_vertex),
+              (override));
+  MOCK_METHOD(void, glDrawArraysInstanced,
+              (GLenum mode, GLint first, GLsizei count,
+               GLsizei instance_count),
+              (override));
+  MOCK_METHOD(void, glDrawElementsInstanced,
+              (GLenum mode, GLsizei count, GLenum type, const void *indices,
+               GLsizei instance_count),
+              (override));
+  MOCK_METHOD(void, glDrawElementsInstancedBaseVertex,
+              (GLenum mode, GLsizei count, GLenum type, const void *indices,
+               GLsizei instance_count, GLint base_vertex),
+              (override));
+  MOCK_METHOD(void, glMultiDrawArrays,
+              (GLenum mode, const GLint *first, const GLsizei *count,
+               GLsizei draw_count),
+              (override));
+  MOCK_METHOD(void, glMultiDrawElementsBaseVertex,
+              (GLenum mode, const GLsizei *count, GLenum type,
+               const void *const *indices, GLsizei draw_count,
+               const GLint *base_vertex),
+              (override));
+  MOCK_METHOD(void, glMultiDrawArraysIndirect,
+              (GLenum mode, const void *indirect, GLsizei draw_count,
+               GLsizei stride),
+              (override));
+  MOCK_METHOD(void, glMultiDrawElementsIndirect,
+              (GLenum mode, GLenum type, const void *indirect,
+               GLsizei draw_count, GLsizei stride),
+              (override));
+
   // Virtual Buffer Object functions
   MOCK_METHOD(void, glGenBuffers, (GLsizei n, GLuint *buffers), (override));
   MOCK_METHOD(void, glBindBuffer, (GLenum target, GLuint buffer), (override));
+  MOCK_METHOD(void, glBindBufferBase,
+              (GLenum target, GLuint index, GLuint buffer), (override));
+  MOCK_METHOD(void, glBindBufferRange,
+              (GLenum target, GLuint index, GLuint buffer, GLintptr offset,
+               GLsizeiptr size),
+              (override));
   MOCK_METHOD(void, glBufferData,
               (GLenum target, GLsizeiptr size, const void *data, GLenum usage),
               (override));
   MOCK_METHOD(void, glDeleteBuffers, (GLsizei n, const GLuint *buffers),
               (override));
+  MOCK_METHOD(void, glBufferSubData,
+              (GLenum target, GLintptr offset, GLsizeiptr size,
+               const void *data),
+              (override));
+  MOCK_METHOD(void, glCreateBuffers, (GLsizei n, GLuint *buffers),
+              (override));
+  MOCK_METHOD(void, glNamedBufferData,
+              (GLuint buffer, GLsizeiptr size, const void *data, GLenum usage),
+              (override));
+  MOCK_METHOD(void, glNamedBufferSubData,
+              (GLuint buffer, GLintptr offset, GLsizeiptr size,
+               const void *data),
+              (override));
+  MOCK_METHOD(void, glBufferStorage,
+              (GLenum target, GLsizeiptr size, const void *data,
+               GLbitfield flags),
+              (override));
+  MOCK_METHOD(void *, glMapBufferRange,
+              (GLenum target, GLintptr offset, GLsizeiptr length,
+               GLbitfield access),
+              (override));
+  MOCK_METHOD(GLboolean, glUnmapBuffer, (GLenum target), (override));
+  MOCK_METHOD(void, glCopyBufferSubData,
+              (GLenum read_target, GLenum write_target, GLintptr read_offset,
+               GLintptr write_offset, GLsizeiptr size),
+              (override));
+  MOCK_METHOD(void, glReadPixels,
+              (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format,
+               GLenum type, GLvoid *pixels),
+              (override));
+
+  // Synchronization functions
+  MOCK_METHOD(GLsync, glFenceSync, (GLenum condition, GLbitfield flags),
+              (override));
+  MOCK_METHOD(GLenum, glClientWaitSync,
+              (GLsync sync, GLbitfield flags, GLuint64 timeout), (override));
+  MOCK_METHOD(void, glDeleteSync, (GLsync sync), (override));
 
   // Virtual Array Object functions
   MOCK_METHOD(void, glGenVertexArrays, (GLsizei n, GLuint *arrays), (override));
@@ -76,8 +231,51 @@ public:
               (GLuint index, GLint size, GLenum type, GLboolean normalized,
                GLsizei stride, const void *pointer),
               (override));
+  MOCK_METHOD(void, glVertexAttribIPointer,
+              (GLuint index, GLint size, GLenum type, GLsizei stride,
+               const void *pointer),
+              (override));
+  MOCK_METHOD(void, glVertexAttribDivisor, (GLuint index, GLuint divisor),
+              (override));
+  MOCK_METHOD(void, glVertexAttribFormat,
+              (GLuint index, GLint size, GLenum type, GLboolean normalized,
+               GLuint relative_offset),
+              (override));
+  MOCK_METHOD(void, glVertexAttribIFormat,
+              (GLuint index, GLint size, GLenum type, GLuint relative_offset),
+              (override));
+  MOCK_METHOD(void, glVertexAttribBinding,
+              (GLuint index, GLuint binding_index), (override));
+  MOCK_METHOD(void, glBindVertexBuffer,
+              (GLuint binding_index, GLuint buffer, GLintptr offset,
+               GLsizei stride),
+              (override));
+  MOCK_METHOD(void, glVertexBindingDivisor,
+              (GLuint binding_index, GLuint divisor), (override));
   MOCK_METHOD(void, glDeleteVertexArrays, (GLsizei n, const GLuint *arrays),
               (override));
+  MOCK_METHOD(void, glCreateVertexArrays, (GLsizei n, GLuint *arrays),
+              (override));
+  MOCK_METHOD(void, glEnableVertexArrayAttrib, (GLuint vao, GLuint index),
+              (override));
+  MOCK_METHOD(void, glVertexArrayVertexBuffer,
+              (GLuint vao, GLuint binding_index, GLuint buffer,
+               GLintptr offset, GLsizei stride),
+              (override));
+  MOCK_METHOD(void, glVertexArrayElementBuffer, (GLuint vao, GLuint buffer),
+              (override));
+  MOCK_METHOD(void, glVertexArrayAttribFormat,
+              (GLuint vao, GLuint index, GLint size, GLenum type,
+               GLboolean normalized, GLuint relative_offset),
+              (override));
+  MOCK_METHOD(void, glVertexArrayAttribIFormat,
+              (GLuint vao, GLuint index, GLint size, GLenum type,
+               GLuint relative_offset),
+              (override));
+  MOCK_METHOD(void, glVertexArrayAttribBinding,
+              (GLuint vao, GLuint index, GLuint binding_index), (override));
+  MOCK_METHOD(void, glVertexArrayBindingDivisor,
+              (GLuint vao, GLuint binding_index, GLuint divisor), (override));
 
   MOCK_METHOD(GLuint, glCreateShader, (GLenum type), (override));
   MOCK_METHOD(void, glShaderSource,
@@ -107,6 +305,12 @@ public:
   MOCK_METHOD(void, glUseProgram, (GLuint program), (override));
   MOCK_METHOD(GLint, glGetUniformLocation, (GLuint program, const GLchar *name),
               (override));
+  MOCK_METHOD(GLuint, glGetUniformBlockIndex,
+              (GLuint program, const GLchar *uniform_block_name), (override));
+  MOCK_METHOD(void, glUniformBlockBinding,
+              (GLuint program, GLuint uniform_block_index,
+               GLuint uniform_block_binding),
+              (override));
   MOCK_METHOD(void, glGetAttachedShaders,
               (GLuint program, GLsizei maxCount, GLsizei *count,
                GLuint *shaders),
@@ -116,6 +320,12 @@ public:
   MOCK_METHOD(void, glDisable, (GLenum cap), (override));
 };
 
+// Fake sync objects for the fence functions, the mock never
+// dereferences them
+inline GLsync fake_sync(std::uintptr_t id) {
+  return reinterpret_cast<GLsync>(id);
+}
+
 } // namespace sdl_opengl_cpp
 
 #endif
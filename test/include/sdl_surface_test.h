@@ -1,8 +1,10 @@
 #ifndef _SDL_OPENGL_CPP_SDL_SURFACE_TEST_H_
 #define _SDL_OPENGL_CPP_SDL_SURFACE_TEST_H_
 
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "mock_opengl.h"
 #include "sdl_surface_base.h"
@@ -37,6 +39,29 @@ public:
   std::optional<SDLSurface> sdl_surface = std::nullopt;
 };
 
+// An SDL_Surface over pixels owned by the test, every byte of it set
+// to value.  A pitch of 0 packs the rows tightly.
+struct TestSurface {
+  TestSurface(int width, int height, std::byte value,
+              Uint32 pixel_format = SDL_PIXELFORMAT_RGBA32, int pitch = 0);
+
+  // The surface points into format and pixels
+  TestSurface(const TestSurface &) = delete;
+  TestSurface &operator=(const TestSurface &) = delete;
+
+  SDL_PixelFormat format = {};
+  SDL_Surface surface = {};
+  std::vector<std::byte> pixels;
+};
+
+// Expectations for creating and deleting a texture with immutable
+// storage of levels levels, a 2D texture unless target is
+// GL_TEXTURE_2D_ARRAY
+void texture_storage_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLenum target,
+    GLuint texture, GLsizei levels, GLsizei width, GLsizei height,
+    GLsizei layers = 1);
+
 } // namespace sdl_opengl_cpp
 
 #endif
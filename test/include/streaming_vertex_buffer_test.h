@@ -0,0 +1,43 @@
+#ifndef _SDL_OPENGL_CPP_STREAMING_VERTEX_BUFFER_TEST_H_
+#define _SDL_OPENGL_CPP_STREAMING_VERTEX_BUFFER_TEST_H_
+
+#include <memory>
+#include <optional>
+
+#include "mock_opengl.h"
+#include "streaming_vertex_buffer.h"
+
+namespace sdl_opengl_cpp {
+
+class StreamingVertexBufferTester {
+public:
+  StreamingVertexBufferTester(const std::shared_ptr<GLContext> &ctx,
+                              GLsizeiptr region_size, GLuint region_count);
+
+  // Explicitly delete the generated default copy constructor
+  StreamingVertexBufferTester(const StreamingVertexBufferTester &) = delete;
+
+  // Explicitly delete the generated default copy assignment operator
+  StreamingVertexBufferTester &
+  operator=(const StreamingVertexBufferTester &) = delete;
+
+  // move constructor
+  StreamingVertexBufferTester(StreamingVertexBufferTester &&) = delete;
+
+  // move assignment operator
+  StreamingVertexBufferTester &
+  operator=(StreamingVertexBufferTester &&) = delete;
+
+  // Surface the underlying OpenGL buffer "name" so we can test it.
+  GLuint VBO();
+
+  // True if a fence guards a region, false if the region is free
+  bool fenced(GLuint region);
+
+public:
+  std::optional<StreamingVertexBuffer> buffer = std::nullopt;
+};
+
+} // namespace sdl_opengl_cpp
+
+#endif
@@ -40,6 +40,13 @@ extern void vertex_buffer_constructor_works_with_exceptions_expectations(
     std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLuint &buffer,
     GLuint &first_available_buffer);
 
+// Expectations for a wrapper that creates its buffer as buffer 1 with
+// size bytes through GL_ARRAY_BUFFER and deletes it on destruction.
+// The buffer is left empty unless filled is true.
+extern void buffer_constructor_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLsizeiptr size,
+    GLenum usage, bool filled = false);
+
 } // namespace sdl_opengl_cpp
 
 #endif
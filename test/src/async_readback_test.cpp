@@ -0,0 +1,315 @@
+#include <array>
+#include <cstdint>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "async_readback.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "vertex_buffer_object_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace async_readback;
+
+TEST_SUITE("sdl_opengl_cpp_async_readback") {
+  TEST_CASE("testing AsyncReadback pixel data sizes") {
+    // Rows are padded to four bytes
+    CHECK_EQ(AsyncReadback::pixel_data_size(3, 2, GL_RGB, GL_UNSIGNED_BYTE),
+             24);
+    CHECK_EQ(AsyncReadback::pixel_data_size(4, 4, GL_RGBA, GL_UNSIGNED_BYTE),
+             64);
+    CHECK_EQ(AsyncReadback::pixel_data_size(1, 1, GL_RED_INTEGER,
+                                            GL_UNSIGNED_INT),
+             4);
+    CHECK_EQ(
+        AsyncReadback::pixel_data_size(2, 2, GL_DEPTH_STENCIL,
+                                       GL_UNSIGNED_INT_24_8),
+        16);
+    CHECK_EQ(AsyncReadback::pixel_data_size(1, 1, GL_RGBA, GL_NONE), 0);
+  }
+
+  TEST_CASE("testing that AsyncReadback reads pixels without waiting") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 64, GL_STREAM_READ);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_PACK_BUFFER, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glReadPixels(0, 0, 3, 2, GL_RGB, GL_UNSIGNED_BYTE, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_PACK_BUFFER, 0))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x10)));
+
+    // Polls never block.  The first poll flushes, later ones don't.
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x10), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 0))
+        .Times(1)
+        .WillOnce(Return(GL_TIMEOUT_EXPIRED));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x10), 0, 0))
+        .Times(1)
+        .WillOnce(Return(GL_ALREADY_SIGNALED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+
+    std::array<std::byte, 24> pixels{};
+    pixels[0] = std::byte{0xab};
+    pixels[23] = std::byte{0xcd};
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glMapBufferRange(GL_COPY_READ_BUFFER, 0, 24, GL_MAP_READ_BIT))
+        .Times(1)
+        .WillOnce(Return(pixels.data()));
+    EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(GL_COPY_READ_BUFFER))
+        .Times(1)
+        .WillOnce(Return(GL_TRUE));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 0))
+        .Times(1);
+
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 64);
+
+    CHECK_FALSE(readback.is_ready());
+
+    readback.read_pixels(0, 0, 3, 2, GL_RGB, GL_UNSIGNED_BYTE);
+    CHECK_EQ(readback.get_result_size(), 24);
+
+    CHECK_FALSE(readback.is_ready());
+    CHECK(readback.is_ready());
+
+    std::array<std::byte, 32> result{};
+    std::span<std::byte> written = readback.get(result);
+
+    CHECK_EQ(written.size(), 24);
+    CHECK_EQ(result[0], std::byte{0xab});
+    CHECK_EQ(result[23], std::byte{0xcd});
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(readback.valid(), true);
+#endif
+  }
+
+  TEST_CASE("testing that AsyncReadback copies from a buffer and waits on "
+            "get") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // The source buffer is created first, as buffer 2
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillOnce(SetArgPointee<1>(2))
+        .WillOnce(SetArgPointee<1>(1));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 2))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_WRITE_BUFFER, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    8, 0, 16))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_WRITE_BUFFER, 0))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x20)));
+
+    // get() blocks on the fence, flushing on the first wait
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x20), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 testing::Gt(GLuint64{0})))
+        .Times(1)
+        .WillOnce(Return(GL_CONDITION_SATISFIED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x20))).Times(1);
+
+    std::array<std::byte, 16> data{};
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glMapBufferRange(GL_COPY_READ_BUFFER, 0, 16, GL_MAP_READ_BIT))
+        .Times(1)
+        .WillOnce(Return(data.data()));
+    EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(GL_COPY_READ_BUFFER))
+        .Times(1)
+        .WillOnce(Return(GL_TRUE));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 0))
+        .Times(2);
+
+    VertexBufferObject source(string("test-source"), mock_opengl_context,
+                              GLsizeiptr{32});
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 16);
+
+    readback.read_buffer(source, 8, 16);
+
+    std::array<std::byte, 16> result{};
+    CHECK_EQ(readback.get(result).size(), 16);
+    CHECK(readback.is_ready());
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(readback.valid(), true);
+#endif
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that AsyncReadback throws on invalid reads") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_READ);
+
+    EXPECT_CALL(*mock_opengl_context, glReadPixels(_, _, _, _, _, _, _))
+        .Times(0);
+
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 16);
+
+    std::array<std::byte, 16> result{};
+
+    CHECK_THROWS_WITH_AS(readback.get(result),
+                         "ERROR::ASYNC_READBACK::NOT_STARTED",
+                         ReadbackNotStartedError);
+
+    // 64 bytes don't fit
+    CHECK_THROWS_WITH_AS(
+        readback.read_pixels(0, 0, 4, 4, GL_RGBA, GL_UNSIGNED_BYTE),
+        "ERROR::ASYNC_READBACK::BUFFER_DATA_ERROR::INVALID_PIXELS",
+        BufferDataError);
+  }
+
+  TEST_CASE("testing that AsyncReadback throws when waiting on its fence "
+            "fails") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_READ);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_PACK_BUFFER, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glReadPixels(_, _, _, _, _, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x30)));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x30), _, _))
+        .Times(1)
+        .WillOnce(Return(GL_WAIT_FAILED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x30))).Times(1);
+
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 16);
+
+    readback.read_pixels(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE);
+
+    // The fence is deleted and the result dropped
+    CHECK_THROWS_WITH_AS(readback.wait(),
+                         "ERROR::ASYNC_READBACK::CLIENT_WAIT_SYNC_FAILED",
+                         ReadbackFenceError);
+    CHECK_EQ(readback.get_result_size(), 0);
+  }
+
+#else
+
+  TEST_CASE("testing that AsyncReadback sets error flag on invalid reads") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_READ);
+
+    EXPECT_CALL(*mock_opengl_context, glReadPixels(_, _, _, _, _, _, _))
+        .Times(0);
+
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 16);
+
+    std::array<std::byte, 16> result{};
+
+    CHECK(readback.get(result).empty());
+    CHECK_EQ(readback.valid(), false);
+    CHECK_EQ(readback.get_last_error(), error::ReadbackNotStartedError);
+  }
+
+  TEST_CASE("testing that AsyncReadback sets error flag when waiting on its "
+            "fence fails") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_READ);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_PACK_BUFFER, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glReadPixels(_, _, _, _, _, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x30)));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x30), _, _))
+        .Times(1)
+        .WillOnce(Return(GL_WAIT_FAILED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x30))).Times(1);
+
+    AsyncReadback readback(string("test-readback"), mock_opengl_context, 16);
+
+    readback.read_pixels(0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE);
+    readback.wait();
+
+    CHECK_EQ(readback.valid(), false);
+    CHECK_EQ(readback.get_last_error(), error::FenceSyncError);
+    CHECK_EQ(readback.get_result_size(), 0);
+  }
+
+#endif
+}
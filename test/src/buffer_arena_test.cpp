@@ -0,0 +1,236 @@
+#include <array>
+#include <span>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "buffer_arena.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+
+using ::testing::_;
+using testing::AnyNumber;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace buffer_arena;
+
+// Three float positions
+static constexpr GLsizei stride = 3 * sizeof(GLfloat);
+
+TEST_SUITE("sdl_opengl_cpp_buffer_arena") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that BufferArena rejects meshes larger than a page") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    BufferArena arena(string("test-arena"), mock_opengl_context, stride, 2);
+
+    std::array<GLfloat, 9> triangle = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    CHECK_THROWS_WITH_AS(arena.allocate(std::span<const GLfloat>(triangle)),
+                         "ERROR::BUFFER_ARENA::ALLOCATION_TOO_LARGE",
+                         ArenaAllocationError);
+
+    CHECK_THROWS_WITH_AS(
+        arena.allocate(std::span<const GLfloat>(triangle).first(4)),
+        "ERROR::BUFFER_ARENA::BUFFER_DATA_ERROR::PARTIAL_VERTEX",
+        BufferDataError);
+
+    CHECK_THROWS_WITH_AS(arena.free(BufferArena::Handle{}),
+                         "ERROR::BUFFER_ARENA::INVALID_HANDLE",
+                         InvalidArenaHandleError);
+
+    CHECK_THROWS_WITH_AS(arena.page_buffer(0),
+                         "ERROR::BUFFER_ARENA::INVALID_PAGE",
+                         InvalidArenaHandleError);
+  }
+
+#else
+
+  TEST_CASE("testing that BufferArena sets error flag for meshes larger "
+            "than a page") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    std::array<GLfloat, 9> triangle = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    // The first error is sticky, so use a new arena for each check
+    BufferArena large_arena(string("test-arena"), mock_opengl_context, stride,
+                            2);
+    large_arena.allocate(std::span<const GLfloat>(triangle));
+    CHECK_EQ(large_arena.valid(), false);
+    CHECK_EQ(large_arena.get_last_error(), error::ArenaAllocationError);
+
+    BufferArena partial_arena(string("test-arena"), mock_opengl_context,
+                              stride, 2);
+    partial_arena.allocate(std::span<const GLfloat>(triangle).first(4));
+    CHECK_EQ(partial_arena.valid(), false);
+    CHECK_EQ(partial_arena.get_last_error(), error::BufferDataError);
+
+    BufferArena handle_arena(string("test-arena"), mock_opengl_context,
+                             stride, 2);
+    handle_arena.free(BufferArena::Handle{});
+    CHECK_EQ(handle_arena.valid(), false);
+    CHECK_EQ(handle_arena.get_last_error(), error::InvalidHandleError);
+
+    BufferArena page_arena(string("test-arena"), mock_opengl_context, stride,
+                           2);
+    CHECK_EQ(page_arena.page_buffer(0), nullptr);
+    CHECK_EQ(page_arena.valid(), false);
+    CHECK_EQ(page_arena.get_last_error(), error::InvalidHandleError);
+  }
+
+#endif
+
+  TEST_CASE("testing that BufferArena sub-allocates, frees and "
+            "defragments") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // Two pages and one staging buffer for defragmenting
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(3)
+        .WillOnce(SetArgPointee<1>(1))
+        .WillOnce(SetArgPointee<1>(2))
+        .WillOnce(SetArgPointee<1>(3));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _)).Times(AnyNumber());
+
+    // Pages of eight vertices, storage without data
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 8 * stride, nullptr,
+                             GL_STATIC_DRAW))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 5 * stride, nullptr,
+                             GL_STREAM_COPY))
+        .Times(1);
+
+    // Each mesh is uploaded at its vertex offset, the last one into
+    // the space freed by defragmenting
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 0, 3 * stride, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 3 * stride, 2 * stride, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 5 * stride, 3 * stride, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 0, 1 * stride, _))
+        .Times(1);
+
+    // Defragmenting packs the live meshes of the first page into the
+    // staging buffer and copies them back
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    3 * stride, 0, 2 * stride))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    5 * stride, 2 * stride, 3 * stride))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    0, 0, 5 * stride))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(3);
+
+    BufferArena arena(string("test-arena"), mock_opengl_context, stride, 8);
+
+    std::array<GLfloat, 9> vertices = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::span<const GLfloat> triangle(vertices);
+
+    BufferArena::Handle a = arena.allocate(triangle);
+    BufferArena::Handle b = arena.allocate(triangle.first(6));
+    BufferArena::Handle c = arena.allocate(triangle);
+
+    // The first page is full
+    BufferArena::Handle d = arena.allocate(triangle.first(3));
+
+    CHECK_EQ(arena.page_count(), 2);
+    CHECK_EQ(arena.get(a)->first_vertex, 0);
+    CHECK_EQ(arena.get(b)->first_vertex, 3);
+    CHECK_EQ(arena.get(c)->first_vertex, 5);
+    CHECK_EQ(arena.get(c)->vertex_count, 3);
+    CHECK_EQ(arena.get(d)->page, 1);
+    CHECK_EQ(arena.get(d)->first_vertex, 0);
+
+    BufferArena::Stats stats = arena.stats();
+    CHECK_EQ(stats.allocation_count, 4);
+    CHECK_EQ(stats.used_bytes, 9 * stride);
+    CHECK_EQ(stats.free_bytes, 7 * stride);
+
+    arena.free(a);
+    CHECK_FALSE(arena.get(a).has_value());
+
+    arena.defragment();
+
+    CHECK_EQ(arena.page_count(), 2);
+    CHECK_EQ(arena.get(b)->page, 0);
+    CHECK_EQ(arena.get(b)->first_vertex, 0);
+    CHECK_EQ(arena.get(c)->first_vertex, 2);
+    CHECK_EQ(arena.get(d)->first_vertex, 0);
+
+    // The freed slot is reused with a new generation, so the old
+    // handle stays invalid
+    BufferArena::Handle e = arena.allocate(triangle);
+    CHECK_EQ(e.index, a.index);
+    CHECK_FALSE(arena.get(a).has_value());
+    CHECK_EQ(arena.get(e)->first_vertex, 5);
+  }
+
+  TEST_CASE("testing that BufferArena fits a mesh of exactly a page that "
+            "isn't a power of two") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(1));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _)).Times(AnyNumber());
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 1000 * stride, nullptr,
+                             GL_STATIC_DRAW))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 0, 1000 * stride, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+    BufferArena arena(string("test-arena"), mock_opengl_context, stride,
+                      1000);
+
+    std::vector<GLfloat> mesh(1000 * 3, 0.0f);
+
+    BufferArena::Handle handle =
+        arena.allocate(std::span<const GLfloat>(mesh));
+
+    REQUIRE(arena.get(handle).has_value());
+    CHECK_EQ(arena.get(handle)->first_vertex, 0);
+    CHECK_EQ(arena.get(handle)->vertex_count, 1000);
+    CHECK_EQ(arena.page_count(), 1);
+    CHECK_EQ(arena.stats().free_bytes, 0);
+  }
+}
@@ -0,0 +1,236 @@
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "draw_indirect_buffer.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+
+using ::testing::_;
+using testing::ElementsAre;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace draw_indirect_buffer;
+
+// Matches the first n elements of an array argument
+MATCHER_P2(FirstElementsAre, n, matcher, "") {
+  std::vector<std::remove_cv_t<std::remove_pointer_t<arg_type>>> elements(
+      arg, arg + n);
+  return testing::ExplainMatchResult(matcher, elements, result_listener);
+}
+
+TEST_SUITE("sdl_opengl_cpp_draw_indirect_buffer") {
+  TEST_CASE("testing that DrawIndirectBuffer submits commands with one "
+            "multi-draw indirect call") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::MultiDrawIndirect))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(1));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+
+    // Room for four commands of each kind, 4 * (16 + 20) bytes
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 144, nullptr, GL_DYNAMIC_DRAW))
+        .Times(1);
+
+    // The commands are uploaded once, drawing again without changes
+    // reuses them
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 0, 3 * 16, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 64, 2 * 20, _))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 1))
+        .Times(3);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0))
+        .Times(3);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, 3, 0))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glMultiDrawElementsIndirect(
+                    GL_TRIANGLES, GL_UNSIGNED_SHORT,
+                    reinterpret_cast<const void *>(64), 2, 0))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+    DrawIndirectBuffer commands(string("test-commands"), mock_opengl_context,
+                                4);
+
+    CHECK(commands.uses_indirect_buffer());
+
+    commands.add(DrawArraysIndirectCommand{3, 1, 0, 0});
+    commands.add(DrawArraysIndirectCommand{3, 1, 3, 0});
+    commands.add(DrawArraysIndirectCommand{6, 100, 6, 0});
+    commands.add(DrawElementsIndirectCommand{6, 1, 0, 0, 0});
+    commands.add(DrawElementsIndirectCommand{6, 1, 6, 4, 0});
+
+    CHECK_EQ(commands.get_arrays_commands().size(), 3);
+    CHECK_EQ(commands.get_elements_commands()[1].base_vertex, 4);
+
+    commands.draw_arrays(GL_TRIANGLES);
+    commands.draw_arrays(GL_TRIANGLES);
+    commands.draw_elements(GL_TRIANGLES, GL_UNSIGNED_SHORT);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(commands.valid(), true);
+#endif
+  }
+
+  TEST_CASE("testing that DrawIndirectBuffer falls back to glMultiDraw "
+            "calls") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // No buffer is created without multi-draw indirect
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::MultiDrawIndirect))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glMultiDrawArraysIndirect(_, _, _, _))
+        .Times(0);
+
+    // Commands without instances are skipped
+    EXPECT_CALL(*mock_opengl_context,
+                glMultiDrawArrays(GL_TRIANGLES,
+                                  FirstElementsAre(2, ElementsAre(0, 6)),
+                                  FirstElementsAre(2, ElementsAre(3, 3)), 2))
+        .Times(1);
+
+    // 16-bit indices, the second command starts 12 bytes in
+    EXPECT_CALL(*mock_opengl_context,
+                glMultiDrawElementsBaseVertex(
+                    GL_TRIANGLES, FirstElementsAre(2, ElementsAre(6, 6)),
+                    GL_UNSIGNED_SHORT,
+                    FirstElementsAre(
+                        2, ElementsAre(reinterpret_cast<const void *>(0),
+                                       reinterpret_cast<const void *>(12))),
+                    2, FirstElementsAre(2, ElementsAre(0, 4))))
+        .Times(1);
+
+    // Instanced commands are drawn one at a time
+    EXPECT_CALL(*mock_opengl_context,
+                glDrawArraysInstanced(GL_TRIANGLES, 0, 3, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glDrawArraysInstanced(GL_TRIANGLES, 3, 3, 50))
+        .Times(1);
+
+    DrawIndirectBuffer commands(string("test-commands"), mock_opengl_context,
+                                4);
+
+    CHECK_FALSE(commands.uses_indirect_buffer());
+
+    commands.add(DrawArraysIndirectCommand{3, 1, 0, 0});
+    commands.add(DrawArraysIndirectCommand{3, 0, 3, 0});
+    commands.add(DrawArraysIndirectCommand{3, 1, 6, 0});
+    commands.add(DrawElementsIndirectCommand{6, 1, 0, 0, 0});
+    commands.add(DrawElementsIndirectCommand{6, 1, 6, 4, 0});
+
+    commands.draw_arrays(GL_TRIANGLES);
+    commands.draw_elements(GL_TRIANGLES, GL_UNSIGNED_SHORT);
+
+    commands.clear();
+    commands.add(DrawArraysIndirectCommand{3, 1, 0, 0});
+    commands.add(DrawArraysIndirectCommand{3, 50, 3, 0});
+
+    commands.draw_arrays(GL_TRIANGLES);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(commands.valid(), true);
+#endif
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that DrawIndirectBuffer throws when full or a base "
+            "instance can't be drawn") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::MultiDrawIndirect))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glMultiDrawArrays(_, _, _, _)).Times(0);
+
+    DrawIndirectBuffer commands(string("test-commands"), mock_opengl_context,
+                                1);
+
+    commands.add(DrawArraysIndirectCommand{3, 1, 0, 2});
+
+    CHECK_THROWS_WITH_AS(commands.add(DrawArraysIndirectCommand{3, 1, 0, 0}),
+                         "ERROR::DRAW_INDIRECT_BUFFER::FULL",
+                         CommandBufferFullError);
+
+    CHECK_THROWS_WITH_AS(
+        commands.draw_arrays(GL_TRIANGLES),
+        "ERROR::DRAW_INDIRECT_BUFFER::BASE_INSTANCE_NOT_SUPPORTED",
+        BaseInstanceNotSupportedError);
+  }
+
+#else
+
+  TEST_CASE("testing that DrawIndirectBuffer sets error flag when full or a "
+            "base instance can't be drawn") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::MultiDrawIndirect))
+        .Times(2)
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glMultiDrawArrays(_, _, _, _)).Times(0);
+
+    // The first error is sticky, so use a new buffer for each check
+    DrawIndirectBuffer full_commands(string("test-commands"),
+                                     mock_opengl_context, 1);
+    full_commands.add(DrawArraysIndirectCommand{3, 1, 0, 0});
+    full_commands.add(DrawArraysIndirectCommand{3, 1, 0, 0});
+    CHECK_EQ(full_commands.valid(), false);
+    CHECK_EQ(full_commands.get_last_error(), error::CommandBufferFullError);
+
+    DrawIndirectBuffer instance_commands(string("test-commands"),
+                                         mock_opengl_context, 1);
+    instance_commands.add(DrawArraysIndirectCommand{3, 1, 0, 2});
+    instance_commands.draw_arrays(GL_TRIANGLES);
+    CHECK_EQ(instance_commands.valid(), false);
+    CHECK_EQ(instance_commands.get_last_error(),
+             error::FeatureNotSupportedError);
+  }
+
+#endif
+}
@@ -0,0 +1,164 @@
+#include <cstdint>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "fence.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+
+using ::testing::_;
+using testing::Return;
+
+using namespace sdl_opengl_cpp;
+using namespace fence;
+
+TEST_SUITE("sdl_opengl_cpp_fence") {
+  TEST_CASE("testing that Fence polls without blocking") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x10)));
+
+    // The first poll flushes, later ones don't.  Once signaled the
+    // result is cached.
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x10), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 0))
+        .Times(1)
+        .WillOnce(Return(GL_TIMEOUT_EXPIRED));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x10), 0, 0))
+        .Times(1)
+        .WillOnce(Return(GL_ALREADY_SIGNALED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+
+    Fence fence(mock_opengl_context);
+
+    CHECK_FALSE(fence.is_signaled());
+    CHECK(fence.is_signaled());
+    CHECK(fence.is_signaled());
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(fence.valid(), true);
+#endif
+  }
+
+  TEST_CASE("testing that Fence wait keeps waiting after a timeout") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x20)));
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x20), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 testing::Gt(GLuint64{0})))
+        .Times(1)
+        .WillOnce(Return(GL_TIMEOUT_EXPIRED));
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x20), 0, testing::Gt(GLuint64{0})))
+        .Times(1)
+        .WillOnce(Return(GL_CONDITION_SATISFIED));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x20))).Times(1);
+
+    Fence fence(mock_opengl_context);
+    fence.wait();
+
+    CHECK(fence.is_signaled());
+  }
+
+  TEST_CASE("testing that a moved Fence is deleted once") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x30)));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x30))).Times(1);
+
+    Fence fence(mock_opengl_context);
+    Fence moved(std::move(fence));
+
+    CHECK(fence.is_in_unspecified_state());
+    CHECK_FALSE(moved.is_in_unspecified_state());
+
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(fence.is_signaled(), "Fence is in an unspecified state",
+                         FenceUnspecifiedStateError);
+#else
+    CHECK_FALSE(fence.is_signaled());
+    CHECK_EQ(fence.get_last_error(),
+             std::optional<error>(error::UnspecifiedStateError));
+#endif
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that Fence throws when the sync object can't be "
+            "created") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(_)).Times(0);
+
+    CHECK_THROWS_WITH_AS(Fence(mock_opengl_context),
+                         "ERROR::FENCE::FENCE_SYNC_FAILED", FenceSyncError);
+  }
+
+#else
+
+  TEST_CASE("testing that Fence sets error flag when the sync object can't "
+            "be created") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(nullptr));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(_)).Times(0);
+
+    Fence fence(mock_opengl_context);
+
+    CHECK_EQ(fence.valid(), false);
+    CHECK_EQ(fence.get_last_error(),
+             std::optional<error>(error::FenceSyncError));
+  }
+
+#endif
+}
@@ -0,0 +1,158 @@
+#include <cstdint>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "frame_in_flight.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+
+using ::testing::_;
+using testing::InSequence;
+using testing::Return;
+
+using namespace sdl_opengl_cpp;
+using namespace frame_in_flight;
+
+// A CPU side resource that remembers which copy it is
+struct FrameData {
+  size_t index;
+  int value;
+};
+
+TEST_SUITE("sdl_opengl_cpp_frame_in_flight") {
+  TEST_CASE("testing that FrameInFlight only waits after N frames") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(4)
+        .WillOnce(Return(fake_sync(0x10)))
+        .WillOnce(Return(fake_sync(0x20)))
+        .WillOnce(Return(fake_sync(0x30)))
+        .WillOnce(Return(fake_sync(0x40)));
+
+    // Only the first frame's fence is waited on, when its copy comes
+    // around again on the fourth frame
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x10), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 testing::Gt(GLuint64{0})))
+        .Times(1)
+        .WillOnce(Return(GL_CONDITION_SATISFIED));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x20), _, _))
+        .Times(0);
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x30), _, _))
+        .Times(0);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x20))).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x30))).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x40))).Times(1);
+
+    FrameInFlight<FrameData, 3> frames(
+        mock_opengl_context, [](size_t i) { return FrameData{i, 0}; });
+
+    CHECK_EQ(frames.size(), 3);
+
+    for (size_t frame = 0; frame < 4; frame++) {
+      FrameData &data = frames.begin_frame();
+      CHECK_EQ(data.index, frame % 3);
+      data.value++;
+      frames.end_frame();
+    }
+
+    CHECK_EQ(frames.get_current_index(), 1);
+    CHECK_EQ(frames.get_resources()[0].value, 2);
+    CHECK_EQ(frames.get_resources()[1].value, 1);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(frames.valid(), true);
+#endif
+  }
+
+  TEST_CASE("testing that FrameInFlight reports when the current copy is "
+            "free") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x10)));
+    {
+      InSequence seq;
+
+      EXPECT_CALL(*mock_opengl_context,
+                  glClientWaitSync(fake_sync(0x10), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                   0))
+          .WillOnce(Return(GL_TIMEOUT_EXPIRED));
+      EXPECT_CALL(*mock_opengl_context,
+                  glClientWaitSync(fake_sync(0x10), 0, 0))
+          .WillOnce(Return(GL_ALREADY_SIGNALED));
+    }
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+
+    FrameInFlight<int, 1> frames(mock_opengl_context,
+                                 [](size_t) { return 0; });
+
+    CHECK(frames.is_current_ready());
+
+    frames.begin_frame();
+    frames.end_frame();
+
+    CHECK_FALSE(frames.is_current_ready());
+    CHECK(frames.is_current_ready());
+
+    // Already signaled, so this doesn't wait
+    frames.begin_frame();
+  }
+
+  TEST_CASE("testing that a moved FrameInFlight is in an unspecified "
+            "state") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(1)
+        .WillOnce(Return(fake_sync(0x10)));
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+
+    FrameInFlight<int, 2> frames(mock_opengl_context,
+                                 [](size_t i) { return static_cast<int>(i); });
+    frames.begin_frame();
+    frames.end_frame();
+
+    FrameInFlight<int, 2> moved(std::move(frames));
+
+    CHECK(frames.is_in_unspecified_state());
+    CHECK_FALSE(moved.is_in_unspecified_state());
+    CHECK_EQ(moved.get_current(), 1);
+
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(frames.begin_frame(),
+                         "Frame In Flight is in an unspecified state",
+                         FrameInFlightUnspecifiedStateError);
+#else
+    frames.begin_frame();
+    CHECK_EQ(frames.valid(), false);
+#endif
+  }
+}
@@ -0,0 +1,177 @@
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "geometry_cache.h"
+#include "gl_context.h"
+#include "mock_opengl.h"
+
+using ::testing::_;
+using testing::AnyNumber;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace geometry_cache;
+
+namespace {
+
+std::uint64_t hash_string(std::string_view text) {
+  return GeometryCache::hash(
+      std::as_bytes(std::span(text.data(), text.size())));
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_geometry_cache") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  TEST_CASE("testing that GeometryCache::hash is XXH64") {
+    CHECK_EQ(hash_string(""), 0xef46db3751d8e999ULL);
+    CHECK_EQ(hash_string("abc"), 0x44bc2cf5ad770999ULL);
+
+    // Every tail length and the 32 byte stripes hash differently
+    std::string text = "0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+    for (size_t length = 1; length < text.size(); length++)
+      CHECK_NE(hash_string(std::string_view(text).substr(0, length)),
+               hash_string(std::string_view(text).substr(0, length + 1)));
+
+    CHECK_NE(GeometryCache::hash({}, 1), GeometryCache::hash({}, 0));
+  }
+
+  TEST_CASE("testing that GeometryCache::layout_key tells layouts apart") {
+    using Positions = VertexLayout<Attr<vec3, 0>>;
+    using Colored = VertexLayout<Attr<vec3, 0>, Attr<rgba8_norm, 1>>;
+    using Moved = VertexLayout<Attr<vec3, 1>>;
+
+    CHECK_EQ(GeometryCache::layout_key<Positions>(),
+             GeometryCache::layout_key<Positions>());
+    CHECK_NE(GeometryCache::layout_key<Positions>(),
+             GeometryCache::layout_key<Colored>());
+    CHECK_NE(GeometryCache::layout_key<Positions>(),
+             GeometryCache::layout_key<Moved>());
+  }
+
+  TEST_CASE("testing that GeometryCache shares buffers with the same "
+            "content") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::array<GLfloat, 9> triangle = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    std::array<GLfloat, 9> other = {9, 1, 2, 3, 4, 5, 6, 7, 8};
+    GLsizeiptr size = sizeof(triangle);
+
+    // One buffer for the triangle, one for the other triangle, one
+    // for the triangle read with another layout and one when the
+    // triangle is loaded again after being released
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(4)
+        .WillOnce(SetArgPointee<1>(1))
+        .WillOnce(SetArgPointee<1>(2))
+        .WillOnce(SetArgPointee<1>(3))
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _)).Times(AnyNumber());
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, size, _, GL_STATIC_DRAW))
+        .Times(4);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(4);
+
+    GeometryCache cache(string("test-cache"), mock_opengl_context);
+
+    using Positions = VertexLayout<Attr<vec3, 0>>;
+    using Pairs = VertexLayout<Attr<vec3, 0>, Attr<vec3, 1>>;
+
+    GeometryCache::Handle a =
+        cache.acquire<Positions>("rock", std::span<const GLfloat>(triangle));
+    GeometryCache::Handle b =
+        cache.acquire<Positions>("boulder", std::span<const GLfloat>(triangle));
+    GeometryCache::Handle c =
+        cache.acquire<Positions>("pebble", std::span<const GLfloat>(other));
+    GeometryCache::Handle d =
+        cache.acquire<Pairs>("pair", std::span<const GLfloat>(triangle));
+
+    CHECK_EQ(a, b);
+    CHECK_NE(a, c);
+    CHECK_NE(a, d);
+    CHECK_EQ(a.use_count(), 2);
+
+    // Sharers can bind the buffer but not change it under each other
+    static_assert(std::is_const_v<GeometryCache::Handle::element_type>);
+    b->bind();
+    CHECK_EQ(b->get_buffer(), 1);
+
+    GeometryCache::Stats stats = cache.stats();
+    CHECK_EQ(stats.entry_count, 3);
+    CHECK_EQ(stats.hit_count, 1);
+    CHECK_EQ(stats.miss_count, 3);
+    CHECK_EQ(stats.unique_bytes, 3 * size);
+    CHECK_EQ(stats.bytes_saved, size);
+    CHECK_EQ(cache.get_bytes_saved(), size);
+
+    // Dropping every handle deletes the buffer, and the content is
+    // uploaded again on the next acquire
+    a.reset();
+    b.reset();
+    CHECK_EQ(cache.stats().entry_count, 2);
+
+    cache.purge();
+    GeometryCache::Handle e =
+        cache.acquire<Positions>("rock", std::span<const GLfloat>(triangle));
+    CHECK_NE(e, nullptr);
+    CHECK_EQ(cache.stats().miss_count, 4);
+
+    // Handles outlive the cache
+    cache.cleanup();
+    CHECK_NE(c, nullptr);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that GeometryCache rejects empty vertices") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    GeometryCache cache(string("test-cache"), mock_opengl_context);
+
+    CHECK_THROWS_WITH_AS(
+        cache.acquire("empty", std::span<const std::byte>()),
+        "ERROR::GEOMETRY_CACHE::BUFFER_DATA_ERROR::EMPTY_VERTICES",
+        BufferDataError);
+
+    GeometryCache moved(std::move(cache));
+    CHECK_THROWS_AS(cache.acquire("empty", std::span<const std::byte>()),
+                    GeometryCacheUnspecifiedStateError);
+  }
+
+#else
+
+  TEST_CASE("testing that GeometryCache sets error flag for empty "
+            "vertices") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    GeometryCache cache(string("test-cache"), mock_opengl_context);
+
+    CHECK_EQ(cache.acquire("empty", std::span<const std::byte>()), nullptr);
+    CHECK_EQ(cache.valid(), false);
+    CHECK_EQ(cache.get_last_error(), error::BufferDataError);
+  }
+
+#endif
+}
@@ -0,0 +1,430 @@
+#include <array>
+#include <optional>
+#include <span>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "gpu_memory_registry.h"
+#include "mock_opengl.h"
+#include "sdl_surface_base.h"
+#include "vertex_buffer_object.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+
+TEST_SUITE("sdl_opengl_cpp_gpu_memory_registry") {
+  TEST_CASE("testing GPUMemoryRegistry accounting") {
+    GPUMemoryRegistry registry;
+
+    registry.track(GPUMemoryCategory::Buffer, 1, "mesh", 100);
+    registry.track(GPUMemoryCategory::Texture, 1, "font", 400);
+    registry.track(GPUMemoryCategory::Buffer, 2, "instances", 50);
+
+    CHECK_EQ(registry.get_allocation_count(), 3);
+    CHECK_EQ(registry.get_total_bytes(), 550);
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), 150);
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture), 400);
+
+    registry.resize(GPUMemoryCategory::Buffer, 2, 250);
+    CHECK_EQ(registry.get_total_bytes(), 750);
+    CHECK_EQ(registry.get_peak_bytes(), 750);
+
+    // The same name in another category is a different object
+    registry.release(GPUMemoryCategory::Buffer, 1);
+    CHECK_EQ(registry.get_total_bytes(), 650);
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture), 400);
+    CHECK_EQ(registry.get_peak_bytes(), 750);
+
+    std::vector<GPUAllocation> allocations = registry.get_allocations();
+    CHECK_EQ(allocations.size(), 2);
+    CHECK_EQ(allocations[0].name, "instances");
+    CHECK_EQ(allocations[0].bytes, 250);
+    CHECK_FALSE(allocations[0].evictable);
+
+    // Unknown objects are ignored
+    registry.release(GPUMemoryCategory::Other, 9);
+    registry.resize(GPUMemoryCategory::Other, 9, 10);
+    CHECK_EQ(registry.get_total_bytes(), 650);
+  }
+
+  TEST_CASE("testing that GPUMemoryRegistry evicts least recently used "
+            "resources") {
+    GPUMemoryRegistry registry;
+    registry.set_budget(1000);
+
+    std::vector<GLuint> evicted;
+
+    for (GLuint id = 1; id <= 3; id++) {
+      registry.track(GPUMemoryCategory::Texture, id, "cached", 300);
+      registry.set_evictor(GPUMemoryCategory::Texture, id, [&, id]() {
+        evicted.push_back(id);
+        registry.release(GPUMemoryCategory::Texture, id);
+      });
+    }
+
+    // Permanent allocations are never evicted
+    registry.track(GPUMemoryCategory::Buffer, 1, "mesh", 100);
+
+    registry.touch(GPUMemoryCategory::Texture, 1);
+
+    // 1000 in use, 300 more needs one eviction
+    CHECK(registry.reserve(0));
+    CHECK(registry.reserve(300));
+    CHECK_EQ(evicted, std::vector<GLuint>{2});
+    CHECK_EQ(registry.get_total_bytes(), 700);
+
+    // Too big even with every cached resource gone
+    CHECK_FALSE(registry.reserve(1000));
+    CHECK_EQ(evicted, (std::vector<GLuint>{2, 3, 1}));
+    CHECK_EQ(registry.get_total_bytes(), 100);
+    CHECK_EQ(registry.get_eviction_count(), 3);
+
+    // No budget, no evictions
+    registry.set_budget(0);
+    CHECK(registry.reserve(1000000));
+  }
+
+  TEST_CASE("testing that GPUMemoryRegistry doesn't evict for more than "
+            "the budget") {
+    GPUMemoryRegistry registry;
+    registry.set_budget(1000);
+
+    bool evicted = false;
+
+    registry.track(GPUMemoryCategory::Texture, 1, "cached", 300);
+    registry.set_evictor(GPUMemoryCategory::Texture, 1,
+                         [&evicted]() { evicted = true; });
+
+    CHECK_FALSE(registry.reserve(1001));
+    CHECK_FALSE(evicted);
+    CHECK_EQ(registry.get_allocation_count(), 1);
+    CHECK_EQ(registry.get_eviction_count(), 0);
+  }
+
+  TEST_CASE("testing that GPUMemoryRegistry evict frees at least the "
+            "requested bytes") {
+    GPUMemoryRegistry registry;
+
+    int evictions = 0;
+
+    for (GLuint id = 1; id <= 3; id++) {
+      registry.track(GPUMemoryCategory::Other, id, "cached", 100);
+      registry.set_evictor(GPUMemoryCategory::Other, id,
+                           [&evictions]() { evictions++; });
+    }
+
+    // The evictors don't release, the registry does it for them
+    CHECK_EQ(registry.evict(150), 200);
+    CHECK_EQ(evictions, 2);
+    CHECK_EQ(registry.get_allocation_count(), 1);
+
+    CHECK_EQ(registry.evict(1000), 100);
+    CHECK_EQ(registry.evict(1000), 0);
+  }
+
+  TEST_CASE("testing that VertexBufferObject records its memory") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+    GLsizeiptr before = registry.get_bytes(GPUMemoryCategory::Buffer);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(41));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glBufferSubData(GL_ARRAY_BUFFER, _, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+    {
+      VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                             GLsizeiptr{64}, GL_DYNAMIC_DRAW);
+
+      CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before + 64);
+
+      std::array<std::byte, 128> data{};
+      vbo.orphan_and_refill(data);
+
+      CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before + 128);
+    }
+
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before);
+  }
+
+  TEST_CASE("testing that VertexBufferObject move assignment releases the "
+            "buffer it replaces") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+    GLsizeiptr before = registry.get_bytes(GPUMemoryCategory::Buffer);
+    size_t allocations = registry.get_allocation_count();
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillOnce(SetArgPointee<1>(47))
+        .WillOnce(SetArgPointee<1>(48));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+        .Times(2);
+
+    // The replaced buffer is deleted by the assignment, the moved in
+    // one when vbo goes out of scope
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, testing::Pointee(47)))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, testing::Pointee(48)))
+        .Times(1);
+
+    {
+      VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                             GLsizeiptr{64});
+      VertexBufferObject replacement(string("test-replacement"),
+                                     mock_opengl_context, GLsizeiptr{32});
+
+      CHECK_EQ(registry.get_allocation_count(), allocations + 2);
+      CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before + 96);
+
+      vbo = std::move(replacement);
+
+      CHECK_EQ(registry.get_allocation_count(), allocations + 1);
+      CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before + 32);
+      CHECK_EQ(vbo.get_size(), 32);
+    }
+
+    CHECK_EQ(registry.get_allocation_count(), allocations);
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Buffer), before);
+  }
+
+  TEST_CASE("testing that VertexBufferObject evicts cached buffers to fit "
+            "the budget") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillOnce(SetArgPointee<1>(42))
+        .WillOnce(SetArgPointee<1>(43));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+    // Room for 500 bytes more than is in use now
+    registry.set_budget(registry.get_total_bytes() + 500);
+
+    std::optional<VertexBufferObject> cached;
+    cached.emplace(string("test-cached"), mock_opengl_context,
+                   GLsizeiptr{300});
+    registry.set_evictor(GPUMemoryCategory::Buffer, 42,
+                         [&cached]() { cached.reset(); });
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           GLsizeiptr{400});
+
+    CHECK_FALSE(cached.has_value());
+
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(VertexBufferObject(string("test-too-big"),
+                                            mock_opengl_context,
+                                            GLsizeiptr{200}),
+                         "ERROR::VERTEX_BUFFER::OUT_OF_MEMORY",
+                         OutOfMemoryError);
+#else
+    VertexBufferObject too_big(string("test-too-big"), mock_opengl_context,
+                               GLsizeiptr{200});
+    CHECK_EQ(too_big.valid(), false);
+    CHECK_EQ(too_big.get_last_error(),
+             std::optional<error>(error::OutOfMemoryError));
+#endif
+
+    registry.set_budget(0);
+  }
+
+  TEST_CASE("testing that VertexBufferObject evicts and retries when "
+            "glBufferData runs out of memory") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillOnce(SetArgPointee<1>(44))
+        .WillOnce(SetArgPointee<1>(45));
+
+    // The cached buffer is created without errors, then the data store
+    // of the second one runs out of memory once
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(8)
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_OUT_OF_MEMORY))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_OUT_OF_MEMORY));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 100, _, GL_STATIC_DRAW))
+        .Times(4);
+    EXPECT_CALL(*mock_opengl_context, glBufferSubData(_, _, _, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+    GLsizeiptr total_bytes = registry.get_total_bytes();
+
+    std::optional<VertexBufferObject> cached;
+    cached.emplace(string("test-cached"), mock_opengl_context,
+                   GLsizeiptr{100});
+    registry.set_evictor(GPUMemoryCategory::Buffer, 44,
+                         [&cached]() { cached.reset(); });
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           GLsizeiptr{100});
+
+    CHECK_FALSE(cached.has_value());
+    CHECK_FALSE(vbo.is_in_unspecified_state());
+    CHECK_EQ(registry.get_total_bytes(), total_bytes + 100);
+
+    // Nothing is left to evict, so running out again is an error and
+    // the buffer keeps its old size
+    std::array<std::byte, 100> refill = {};
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(
+        vbo.orphan_and_refill(std::span<const std::byte>(refill)),
+        "ERROR::VERTEX_BUFFER::BUFFER_DATA_OUT_OF_MEMORY", OutOfMemoryError);
+#else
+    vbo.orphan_and_refill(std::span<const std::byte>(refill));
+    CHECK_EQ(vbo.valid(), false);
+    CHECK_EQ(vbo.get_last_error(),
+             std::optional<error>(error::OutOfMemoryError));
+#endif
+    CHECK_EQ(vbo.get_size(), 100);
+  }
+
+  TEST_CASE("testing that VertexBufferObject growth fits the budget") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(46));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, 100, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, 150, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, 300, _, _))
+        .Times(0);
+    EXPECT_CALL(*mock_opengl_context, glBufferSubData(GL_ARRAY_BUFFER, 0, _, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           GLsizeiptr{100});
+
+    // Room for 100 bytes more than is in use now
+    registry.set_budget(registry.get_total_bytes() + 100);
+
+    std::array<std::byte, 150> grown = {};
+    vbo.orphan_and_refill(std::span<const std::byte>(grown));
+    CHECK_EQ(vbo.get_size(), 150);
+
+    std::array<std::byte, 300> too_big = {};
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(
+        vbo.orphan_and_refill(std::span<const std::byte>(too_big)),
+        "ERROR::VERTEX_BUFFER::OUT_OF_MEMORY", OutOfMemoryError);
+#else
+    vbo.orphan_and_refill(std::span<const std::byte>(too_big));
+    CHECK_EQ(vbo.valid(), false);
+    CHECK_EQ(vbo.get_last_error(),
+             std::optional<error>(error::OutOfMemoryError));
+#endif
+    CHECK_EQ(vbo.get_size(), 150);
+
+    registry.set_budget(0);
+  }
+
+  TEST_CASE("testing that SDLSurface::GL_DeleteTexture releases the "
+            "texture's memory") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+    GLsizeiptr before = registry.get_bytes(GPUMemoryCategory::Texture);
+    size_t allocations = registry.get_allocation_count();
+
+    // Recorded the way GL_LoadTexture records its textures
+    registry.track(GPUMemoryCategory::Texture, 49, "test-texture", 256);
+    CHECK_EQ(registry.get_allocation_count(), allocations + 1);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, testing::Pointee(49)))
+        .Times(1);
+
+    SDLSurface::GL_DeleteTexture(mock_opengl_context, 49);
+
+    CHECK_EQ(registry.get_allocation_count(), allocations);
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture), before);
+  }
+}
@@ -0,0 +1,113 @@
+#include <array>
+#include <span>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "index_buffer_object.h"
+#include "mock_opengl.h"
+#include "vertex_buffer_object_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace index_buffer_object;
+
+// Expectations for constructing an IndexBufferObject holding size
+// bytes of indices
+static void index_buffer_constructor_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLsizeiptr size) {
+  buffer_constructor_expectations(mock_opengl_context, size, GL_STATIC_DRAW,
+                                  true);
+
+  // Only the three error checks of the constructor
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(3)
+      .WillRepeatedly(Return(GL_NO_ERROR));
+
+  // Filled through GL_ARRAY_BUFFER, not GL_ELEMENT_ARRAY_BUFFER
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0)).Times(1);
+}
+
+TEST_SUITE("sdl_opengl_cpp_index_buffer_object") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::array<GLuint, 6> quad = {0, 1, 2, 2, 3, 0};
+
+  TEST_CASE("testing that IndexBufferObject uses 16-bit indices for small "
+            "meshes") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    index_buffer_constructor_expectations(mock_opengl_context,
+                                          6 * sizeof(GLushort));
+
+    // The largest vertex count 16-bit indices can address
+    IndexBufferObject ibo(string("test-ibo"), mock_opengl_context, quad,
+                          65536);
+
+    CHECK_EQ(ibo.get_index_type(), GL_UNSIGNED_SHORT);
+    CHECK_EQ(ibo.get_count(), 6);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 1))
+        .Times(1);
+
+    ibo.bind();
+  }
+
+  TEST_CASE("testing that IndexBufferObject uses 32-bit indices for large "
+            "meshes") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    index_buffer_constructor_expectations(mock_opengl_context,
+                                          6 * sizeof(GLuint));
+
+    IndexBufferObject ibo(string("test-ibo"), mock_opengl_context, quad,
+                          65537);
+
+    CHECK_EQ(ibo.get_index_type(), GL_UNSIGNED_INT);
+    CHECK_EQ(ibo.get_count(), 6);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that IndexBufferObject constructor throws when an index "
+            "is out of range") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    CHECK_THROWS_WITH_AS(
+        IndexBufferObject(string("test-ibo"), mock_opengl_context, quad, 3),
+        "ERROR::INDEX_BUFFER::BUFFER_DATA_ERROR::INDEX_OUT_OF_RANGE",
+        BufferDataError);
+  }
+
+#else
+
+  TEST_CASE("testing that IndexBufferObject constructor sets error flag when "
+            "an index is out of range") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    IndexBufferObject ibo(string("test-ibo"), mock_opengl_context, quad, 3);
+
+    CHECK_EQ(ibo.valid(), false);
+    CHECK_EQ(ibo.get_last_error(), error::BufferDataError);
+  }
+
+#endif
+}
@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "mesh_optimizer.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::mesh_optimizer;
+
+namespace {
+
+struct GridVertex {
+  GLfloat position[3];
+  GLfloat uv[2];
+};
+
+// A size by size grid of quads, with its triangles shuffled like an
+// exporter that doesn't care about order
+void make_shuffled_grid(size_t size, std::vector<GridVertex> &vertices,
+                        std::vector<GLuint> &indices) {
+  for (size_t y = 0; y <= size; y++) {
+    for (size_t x = 0; x <= size; x++) {
+      GLfloat fx = static_cast<GLfloat>(x);
+      GLfloat fy = static_cast<GLfloat>(y);
+      vertices.push_back({{fx, fy, 0.0f}, {fx, fy}});
+    }
+  }
+
+  std::vector<std::array<GLuint, 3>> triangles;
+  for (size_t y = 0; y < size; y++) {
+    for (size_t x = 0; x < size; x++) {
+      GLuint corner = static_cast<GLuint>(y * (size + 1) + x);
+      GLuint row = static_cast<GLuint>(size + 1);
+
+      triangles.push_back({corner, corner + 1, corner + row + 1});
+      triangles.push_back({corner, corner + row + 1, corner + row});
+    }
+  }
+
+  std::mt19937 random(1234);
+  std::shuffle(triangles.begin(), triangles.end(), random);
+
+  for (const auto &triangle : triangles)
+    indices.insert(indices.end(), triangle.begin(), triangle.end());
+}
+
+// Every triangle as the positions of its corners, rotated to start at
+// the smallest so the winding is kept, then sorted
+std::vector<std::array<GLfloat, 9>>
+triangle_set(const std::vector<GridVertex> &vertices,
+             const std::vector<GLuint> &indices) {
+  std::vector<std::array<GLfloat, 9>> result;
+
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    std::array<std::array<GLfloat, 3>, 3> corners;
+    for (size_t c = 0; c < 3; c++) {
+      const GLfloat *p = vertices[indices[t + c]].position;
+      corners[c] = {p[0], p[1], p[2]};
+    }
+
+    std::rotate(corners.begin(),
+                std::min_element(corners.begin(), corners.end()),
+                corners.end());
+
+    std::array<GLfloat, 9> flat;
+    for (size_t c = 0; c < 3; c++)
+      std::copy(corners[c].begin(), corners[c].end(), flat.begin() + c * 3);
+    result.push_back(flat);
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_mesh_optimizer") {
+  TEST_CASE("testing that analyze_vertex_cache counts cache misses") {
+    std::array<GLuint, 6> quad = {0, 1, 2, 2, 1, 3};
+
+    VertexCacheStatistics statistics = analyze_vertex_cache(quad, 4);
+    CHECK_EQ(statistics.misses, 4);
+    CHECK_EQ(statistics.acmr, doctest::Approx(2.0f));
+    CHECK_EQ(statistics.atvr, doctest::Approx(1.0f));
+
+    // A cache of two entries has evicted vertex 0 by the second
+    // triangle, but still holds 1 and 2
+    std::array<GLuint, 6> again = {0, 1, 2, 0, 1, 2};
+    CHECK_EQ(analyze_vertex_cache(again, 3, 2).misses, 6);
+    CHECK_EQ(analyze_vertex_cache(again, 3, 3).misses, 3);
+  }
+
+  TEST_CASE("testing that optimize_vertex_cache lowers the ACMR") {
+    std::vector<GridVertex> vertices;
+    std::vector<GLuint> indices;
+    make_shuffled_grid(32, vertices, indices);
+
+    std::vector<GLuint> optimized =
+        optimize_vertex_cache(indices, vertices.size());
+
+    REQUIRE_EQ(optimized.size(), indices.size());
+    CHECK(triangle_set(vertices, optimized) == triangle_set(vertices, indices));
+
+    float before = analyze_vertex_cache(indices, vertices.size()).acmr;
+    float after = analyze_vertex_cache(optimized, vertices.size()).acmr;
+
+    CHECK_GT(before, 2.0f);
+    CHECK_LT(after, 0.8f);
+  }
+
+  TEST_CASE("testing that optimize_overdraw draws outer clusters first") {
+    // Two triangles facing +z, one at the center of the mesh and one
+    // in front of it
+    std::vector<GridVertex> vertices = {
+        {{0.0f, 0.0f, 0.0f}, {}},  {{1.0f, 0.0f, 0.0f}, {}},
+        {{0.0f, 1.0f, 0.0f}, {}},  {{0.0f, 0.0f, 10.0f}, {}},
+        {{1.0f, 0.0f, 10.0f}, {}}, {{0.0f, 1.0f, 10.0f}, {}},
+    };
+    std::vector<GLuint> indices = {0, 1, 2, 3, 4, 5};
+
+    std::vector<GLuint> ordered = optimize_overdraw<GridVertex>(
+        indices, vertices, offsetof(GridVertex, position));
+
+    CHECK_EQ(ordered, std::vector<GLuint>({3, 4, 5, 0, 1, 2}));
+  }
+
+  TEST_CASE("testing that optimize_overdraw keeps most of the cache order") {
+    std::vector<GridVertex> vertices;
+    std::vector<GLuint> indices;
+    make_shuffled_grid(32, vertices, indices);
+
+    std::vector<GLuint> cache_ordered =
+        optimize_vertex_cache(indices, vertices.size());
+    std::vector<GLuint> ordered =
+        optimize_overdraw<GridVertex>(cache_ordered, vertices);
+
+    REQUIRE_EQ(ordered.size(), indices.size());
+    CHECK(triangle_set(vertices, ordered) == triangle_set(vertices, indices));
+
+    float cache_acmr =
+        analyze_vertex_cache(cache_ordered, vertices.size()).acmr;
+    CHECK_LE(analyze_vertex_cache(ordered, vertices.size()).acmr,
+             cache_acmr * 1.25f);
+  }
+
+  TEST_CASE("testing that the vertex fetch remap orders by first use") {
+    std::vector<GLuint> indices = {2, 0, 1, 2, 1, 3};
+
+    std::vector<GLuint> remap = generate_vertex_fetch_remap(indices, 5);
+    CHECK_EQ(remap, std::vector<GLuint>({1, 2, 0, 3, unused_vertex}));
+    CHECK_EQ(remap_indices(indices, remap),
+             std::vector<GLuint>({0, 1, 2, 0, 2, 3}));
+
+    std::vector<int> vertices = {10, 11, 12, 13, 14};
+    CHECK(optimize_vertex_fetch(vertices, indices));
+    CHECK_EQ(vertices, std::vector<int>({12, 10, 11, 13}));
+    CHECK_EQ(indices, std::vector<GLuint>({0, 1, 2, 0, 2, 3}));
+  }
+
+  TEST_CASE("testing that the passes reject invalid indices") {
+    std::vector<GLuint> partial = {0, 1, 2, 0};
+    std::vector<GLuint> out_of_range = {0, 1, 3};
+
+    CHECK(optimize_vertex_cache(partial, 3).empty());
+    CHECK(optimize_vertex_cache(out_of_range, 3).empty());
+    CHECK(generate_vertex_fetch_remap(out_of_range, 3).empty());
+    CHECK_EQ(analyze_vertex_cache(out_of_range, 3).misses, 0);
+
+    std::vector<int> vertices = {10, 11, 12};
+    CHECK_FALSE(optimize_mesh(vertices, out_of_range));
+    CHECK_EQ(vertices.size(), 3);
+    CHECK_EQ(out_of_range, std::vector<GLuint>({0, 1, 3}));
+  }
+
+  TEST_CASE("testing that optimize_mesh runs every pass") {
+    std::vector<GridVertex> vertices;
+    std::vector<GLuint> indices;
+    make_shuffled_grid(32, vertices, indices);
+
+    // An unused vertex is dropped
+    vertices.push_back({{-1.0f, -1.0f, -1.0f}, {}});
+
+    std::vector<GridVertex> original_vertices = vertices;
+    std::vector<GLuint> original_indices = indices;
+    float before = analyze_vertex_cache(indices, vertices.size()).acmr;
+
+    REQUIRE(optimize_mesh(vertices, indices));
+
+    CHECK_EQ(vertices.size(), original_vertices.size() - 1);
+    CHECK(triangle_set(vertices, indices) ==
+          triangle_set(original_vertices, original_indices));
+
+    // Vertices are first used in order
+    GLuint next = 0;
+    for (GLuint index : indices) {
+      CHECK_LE(index, next);
+      next = std::max(next, index + 1);
+    }
+
+    float after = analyze_vertex_cache(indices, vertices.size()).acmr;
+    CHECK_LT(after, before / 2.0f);
+  }
+}
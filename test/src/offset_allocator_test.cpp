@@ -0,0 +1,126 @@
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "offset_allocator.h"
+
+using namespace sdl_opengl_cpp;
+
+TEST_SUITE("sdl_opengl_cpp_offset_allocator") {
+  TEST_CASE("testing that OffsetAllocator hands out consecutive offsets") {
+    OffsetAllocator allocator(100);
+
+    OffsetAllocator::Allocation a = allocator.allocate(10);
+    OffsetAllocator::Allocation b = allocator.allocate(20);
+    OffsetAllocator::Allocation c = allocator.allocate(30);
+
+    CHECK_EQ(a.offset, 0);
+    CHECK_EQ(b.offset, 10);
+    CHECK_EQ(c.offset, 30);
+
+    CHECK_EQ(allocator.allocation_size(b), 20);
+    CHECK_EQ(allocator.storage_report().total_free_space, 40);
+  }
+
+  TEST_CASE("testing that OffsetAllocator fails when out of space") {
+    OffsetAllocator allocator(64);
+
+    OffsetAllocator::Allocation a = allocator.allocate(64);
+    CHECK_EQ(a.offset, 0);
+
+    CHECK_EQ(allocator.allocate(1).offset, OffsetAllocator::no_space);
+    CHECK_EQ(allocator.allocate(0).offset, OffsetAllocator::no_space);
+    CHECK_EQ(allocator.storage_report().total_free_space, 0);
+    CHECK_EQ(allocator.storage_report().largest_free_region, 0);
+
+    allocator.free(a);
+    CHECK_EQ(allocator.storage_report().total_free_space, 64);
+    CHECK_EQ(allocator.allocate(64).offset, 0);
+  }
+
+  TEST_CASE("testing that OffsetAllocator merges freed neighbors") {
+    OffsetAllocator allocator(96);
+
+    OffsetAllocator::Allocation a = allocator.allocate(32);
+    OffsetAllocator::Allocation b = allocator.allocate(32);
+    OffsetAllocator::Allocation c = allocator.allocate(32);
+
+    // Free the outer ranges first, then the middle one, so it has
+    // to merge with both neighbors
+    allocator.free(a);
+    allocator.free(c);
+    CHECK_EQ(allocator.storage_report().total_free_space, 64);
+    CHECK_EQ(allocator.allocate(64).offset, OffsetAllocator::no_space);
+
+    allocator.free(b);
+    CHECK_EQ(allocator.storage_report().total_free_space, 96);
+
+    OffsetAllocator::Allocation all = allocator.allocate(96);
+    CHECK_EQ(all.offset, 0);
+
+    // Freeing twice is ignored
+    allocator.free(all);
+    allocator.free(all);
+    CHECK_EQ(allocator.storage_report().total_free_space, 96);
+  }
+
+  TEST_CASE("testing that OffsetAllocator reuses freed ranges") {
+    // Sizes that are exact bin sizes, so free ranges are found for
+    // requests of their full size
+    OffsetAllocator allocator(1024);
+
+    std::vector<OffsetAllocator::Allocation> allocations;
+    for (int i = 0; i < 8; i++)
+      allocations.push_back(allocator.allocate(128));
+
+    CHECK_EQ(allocator.allocate(1).offset, OffsetAllocator::no_space);
+
+    allocator.free(allocations[3]);
+
+    OffsetAllocator::Allocation small = allocator.allocate(40);
+    CHECK_EQ(small.offset, 384);
+
+    // The remainder of the freed range is still available
+    OffsetAllocator::Allocation rest = allocator.allocate(88);
+    CHECK_EQ(rest.offset, 424);
+
+    CHECK_EQ(allocator.allocate(1).offset, OffsetAllocator::no_space);
+  }
+
+  TEST_CASE("testing that OffsetAllocator hands out all of a size that "
+            "isn't a bin size") {
+    // 1000 is filed in the bin for 960, below the bin a request for
+    // 1000 rounds up to
+    for (uint32_t request : {1000u, 999u, 961u}) {
+      OffsetAllocator allocator(1000, 1000);
+
+      OffsetAllocator::Allocation all = allocator.allocate(request);
+      CHECK_EQ(all.offset, 0);
+      CHECK_EQ(allocator.allocation_size(all), request);
+      CHECK_EQ(allocator.storage_report().total_free_space, 1000 - request);
+    }
+
+    OffsetAllocator allocator(1000, 1000);
+    CHECK_EQ(allocator.allocate(1001).offset, OffsetAllocator::no_space);
+
+    // A freed range that isn't a bin size is found again too
+    OffsetAllocator::Allocation a = allocator.allocate(999);
+    allocator.free(a);
+    CHECK_EQ(allocator.allocate(1000).offset, 0);
+  }
+
+  TEST_CASE("testing that OffsetAllocator reset frees everything") {
+    OffsetAllocator allocator(256, 4);
+
+    allocator.allocate(10);
+    allocator.allocate(10);
+    allocator.allocate(10);
+
+    // Every node is in use, three allocations and one free range
+    CHECK_EQ(allocator.allocate(10).offset, OffsetAllocator::no_space);
+
+    allocator.reset();
+    CHECK_EQ(allocator.storage_report().total_free_space, 256);
+    CHECK_EQ(allocator.allocate(256).offset, 0);
+  }
+}
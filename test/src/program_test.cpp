@@ -394,3 +394,68 @@ TEST_CASE("testing that the Program constructor works with two shaders and "
 }
 
 #endif
+
+TEST_CASE("testing that Program bind_uniform_block() connects a block to a "
+          "binding point") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  GLint return_success_value = 1;
+
+  EXPECT_CALL(*mock_opengl_context, glCreateShader(GL_VERTEX_SHADER))
+      .Times(1)
+      .WillOnce(testing::Return(1));
+  EXPECT_CALL(*mock_opengl_context, glShaderSource(1, 1, _, NULL)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glCompileShader(1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glGetShaderiv(1, GL_COMPILE_STATUS, _))
+      .Times(1)
+      .WillOnce(SetArgPointee<2>(return_success_value));
+  EXPECT_CALL(*mock_opengl_context, glDeleteShader(1)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glCreateProgram())
+      .Times(1)
+      .WillOnce(testing::Return(1));
+  EXPECT_CALL(*mock_opengl_context, glAttachShader(1, 1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glLinkProgram(1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glGetProgramiv(1, _, _))
+      .Times(1)
+      .WillOnce(SetArgPointee<2>(return_success_value));
+  EXPECT_CALL(*mock_opengl_context, glGetError()).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glGetUniformBlockIndex(1, testing::StrEq("Camera")))
+      .Times(1)
+      .WillOnce(testing::Return(3));
+  EXPECT_CALL(*mock_opengl_context,
+              glGetUniformBlockIndex(1, testing::StrEq("Missing")))
+      .Times(1)
+      .WillOnce(testing::Return(GL_INVALID_INDEX));
+  EXPECT_CALL(*mock_opengl_context, glUniformBlockBinding(1, 3, 0)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteProgram(1)).Times(1);
+
+  UncompiledShader uncompiled_shader = {string("vertex-shader"),
+                                        vertex_shader_src, GL_VERTEX_SHADER};
+  vector<UncompiledShader> uncompiled_shaders = {uncompiled_shader};
+  ProgramTester program_tester(mock_opengl_context, uncompiled_shaders);
+
+  program_tester.program->bind_uniform_block("Camera", 0);
+
+#ifndef NO_EXCEPTIONS
+  CHECK_THROWS_WITH_AS(
+      program_tester.program->bind_uniform_block("Missing", 0),
+      "Couldn't get index of uniform block", GetUniformBlockIndexError);
+#else
+  CHECK_EQ(program_tester.program->valid(), true);
+
+  program_tester.program->bind_uniform_block("Missing", 0);
+  CHECK_EQ(program_tester.program->valid(), false);
+  CHECK_EQ(program_tester.program->get_last_error(),
+           error::GetUniformBlockIndexError);
+#endif
+}
@@ -63,6 +63,7 @@ int SDLOpenGLTester::LoadContext() {
 // TODO: Get SDL_GL_GetProcAddress wrapped up somehow
 #if defined __SDL_NOGETPROCADDR__
 #define SDL_PROC(ret, func, params) gl_context.func = func;
+#define SDL_PROC_OPTIONAL(ret, func, params) gl_context.func = nullptr;
 #else
 #define SDL_PROC(ret, func, params)                                            \
   do {                                                                         \
@@ -73,10 +74,16 @@ int SDLOpenGLTester::LoadContext() {
                           SDL_GetError());                                     \
     }                                                                          \
   } while (0);
+// Optional functions are left as nullptr if they aren't available,
+// GLContext::supports() checks for them before they are used
+#define SDL_PROC_OPTIONAL(ret, func, params)                                   \
+  gl_context.func =                                                            \
+      reinterpret_cast<ret(*) params>(SDL_GL_GetProcAddress(#func));
 #endif /* __SDL_NOGETPROCADDR__ */
 
 #include "SDL_glfuncs.h"
 #undef SDL_PROC
+#undef SDL_PROC_OPTIONAL
   return 0;
 }
 
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <doctest/doctest.h>
 #include <memory>
 
@@ -35,6 +36,52 @@ void SDLSurfaceTester::set_invalid_sdl_surface() {
   sdl_surface->surface = nullptr;
 }
 
+TestSurface::TestSurface(int width, int height, std::byte value,
+                         Uint32 pixel_format, int pitch) {
+  if (pitch == 0)
+    pitch = width * 4;
+
+  pixels.assign(static_cast<size_t>(height * pitch), value);
+
+  format.format = pixel_format;
+  format.BitsPerPixel = 32;
+  format.BytesPerPixel = 4;
+
+  surface.format = &format;
+  surface.w = width;
+  surface.h = height;
+  surface.pitch = pitch;
+  surface.pixels = pixels.data();
+}
+
+void sdl_opengl_cpp::texture_storage_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLenum target,
+    GLuint texture, GLsizei levels, GLsizei width, GLsizei height,
+    GLsizei layers) {
+  EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+      .Times(1)
+      .WillOnce(SetArgPointee<1>(texture));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindTexture(target, texture))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+      .Times(1)
+      .WillOnce(testing::Return(true));
+  if (target == GL_TEXTURE_2D_ARRAY)
+    EXPECT_CALL(*mock_opengl_context,
+                glTexStorage3D(target, levels, GL_RGBA8, width, height,
+                               layers))
+        .Times(1);
+  else
+    EXPECT_CALL(*mock_opengl_context,
+                glTexStorage2D(target, levels, GL_RGBA8, width, height))
+        .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glTexParameteri(target, _, _)).Times(2);
+  EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+}
+
 #ifndef NO_EXCEPTIONS
 
 TEST_CASE("testing that the SDLSurface constructor works with exceptions") {
@@ -179,3 +226,31 @@ TEST_CASE("testing that the SDLSurface constructor sets an error when "
 }
 
 #endif
+
+TEST_CASE("testing that gl_pixel_format reads SDL pixel formats in place") {
+  sdl_surface::GLPixelFormat pixel_format;
+
+  CHECK(sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_ARGB8888, pixel_format));
+  CHECK_EQ(pixel_format.format, GL_BGRA);
+  CHECK_EQ(pixel_format.type, GL_UNSIGNED_INT_8_8_8_8_REV);
+  CHECK_EQ(pixel_format.internal_format, GL_RGBA8);
+
+  // RGBA32 is the byte order R, G, B, A, an alias of a different
+  // packed format on each endianness
+  CHECK(sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_RGBA32, pixel_format));
+  CHECK_EQ(pixel_format.format, GL_RGBA);
+
+  CHECK(sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_RGB565, pixel_format));
+  CHECK_EQ(pixel_format.format, GL_RGB);
+  CHECK_EQ(pixel_format.type, GL_UNSIGNED_SHORT_5_6_5);
+  CHECK_EQ(pixel_format.internal_format, GL_RGB8);
+
+  CHECK(sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_BGR24, pixel_format));
+  CHECK_EQ(pixel_format.format, GL_BGR);
+  CHECK_EQ(pixel_format.type, GL_UNSIGNED_BYTE);
+
+  CHECK_FALSE(
+      sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_INDEX8, pixel_format));
+  CHECK_FALSE(
+      sdl_surface::gl_pixel_format(SDL_PIXELFORMAT_YV12, pixel_format));
+}
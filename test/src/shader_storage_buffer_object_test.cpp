@@ -0,0 +1,136 @@
+#include <array>
+#include <span>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "shader_storage_buffer_object.h"
+#include "vertex_buffer_object_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace shader_storage_buffer_object;
+
+// One column-major 4x4 matrix per object
+using Transform = std::array<GLfloat, 16>;
+
+TEST_SUITE("sdl_opengl_cpp_shader_storage_buffer_object") {
+  TEST_CASE("testing that ShaderStorageBufferObject uploads, updates and "
+            "binds per-object data") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    const GLsizeiptr transforms_size = 10000 * sizeof(Transform);
+
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::ShaderStorageBufferObject))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context,
+                glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(16));
+    buffer_constructor_expectations(mock_opengl_context, transforms_size,
+                                    GL_DYNAMIC_DRAW, true);
+
+    // Only the moved object is rewritten
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 42 * sizeof(Transform),
+                                sizeof(Transform), _))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, 1,
+                                  5000 * sizeof(Transform),
+                                  5000 * sizeof(Transform)))
+        .Times(1);
+
+    std::vector<Transform> transforms(10000, Transform{});
+    ShaderStorageBufferObject ssbo(string("test-ssbo"), mock_opengl_context,
+                                   std::span<const Transform>(transforms));
+
+    CHECK_EQ(ssbo.get_size(), transforms_size);
+    CHECK_EQ(ssbo.get_offset_alignment(), 16);
+
+    transforms[42][12] = 1.0f;
+    ssbo.update(42 * sizeof(Transform),
+                std::span<const Transform>(transforms).subspan(42, 1));
+
+    // Move the buffer, the new owner binds it
+    ShaderStorageBufferObject moved(std::move(ssbo));
+    CHECK(ssbo.is_in_unspecified_state());
+
+    moved.bind_base(0);
+    moved.bind_range(1, 5000 * sizeof(Transform), 5000 * sizeof(Transform));
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(moved.valid(), true);
+#endif
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that ShaderStorageBufferObject throws when shader "
+            "storage isn't supported") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::ShaderStorageBufferObject))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    CHECK_THROWS_WITH_AS(ShaderStorageBufferObject(string("test-ssbo"),
+                                                   mock_opengl_context, 1024),
+                         "ERROR::SHADER_STORAGE_BUFFER::NOT_SUPPORTED",
+                         ShaderStorageNotSupportedError);
+  }
+
+#else
+
+  TEST_CASE("testing that ShaderStorageBufferObject sets error flag when "
+            "shader storage isn't supported") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::ShaderStorageBufferObject))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    ShaderStorageBufferObject ssbo(string("test-ssbo"), mock_opengl_context,
+                                   1024);
+
+    CHECK_EQ(ssbo.valid(), false);
+    CHECK_EQ(ssbo.get_last_error(), error::FeatureNotSupportedError);
+  }
+
+#endif
+}
@@ -0,0 +1,123 @@
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include <doctest/doctest.h>
+
+#include "std140.h"
+
+using namespace sdl_opengl_cpp;
+
+namespace {
+
+// layout(std140) uniform Camera {
+//   mat4 view_projection;
+//   vec3 position;
+//   float exposure;
+// };
+using CameraBlock = Std140Block<std140::mat4, std140::vec3, std140::scalar>;
+
+// A hand written struct that happens to match, the float fills the
+// padding after the vec3
+struct CameraData {
+  GLfloat view_projection[16];
+  GLfloat position[3];
+  GLfloat exposure;
+};
+
+// These are checked when the test is compiled
+static_assert(CameraBlock::offset<0> == 0);
+static_assert(CameraBlock::offset<1> == 64);
+static_assert(CameraBlock::offset<2> == 76);
+static_assert(CameraBlock::size == 80);
+static_assert(CameraBlock::matches<CameraData>);
+static_assert(offsetof(CameraData, position) == CameraBlock::offset<1>);
+static_assert(offsetof(CameraData, exposure) == CameraBlock::offset<2>);
+
+// The layout example from the OpenGL specification, without the
+// boolean members
+//
+// layout(std140) uniform Example {
+//   float a;
+//   vec2 b;
+//   vec3 c;
+//   struct { int d; ivec2 e; } f;
+//   float g;
+//   float h[2];
+//   mat2 i;
+// };
+using NestedBlock = Std140Block<std140::int_scalar, std140::ivec2>;
+using ExampleBlock =
+    Std140Block<std140::scalar, std140::vec2, std140::vec3, NestedBlock,
+                std140::scalar, std140::array_of<std140::scalar, 2>,
+                std140::mat2>;
+
+static_assert(NestedBlock::offset<1> == 8);
+static_assert(NestedBlock::size == 16);
+
+static_assert(ExampleBlock::offset<0> == 0);
+static_assert(ExampleBlock::offset<1> == 8);
+static_assert(ExampleBlock::offset<2> == 16);
+static_assert(ExampleBlock::offset<3> == 32);
+static_assert(ExampleBlock::offset<4> == 48);
+static_assert(ExampleBlock::offset<5> == 64);
+static_assert(ExampleBlock::offset<6> == 96);
+static_assert(ExampleBlock::size == 128);
+
+// A vec3 can't be stored as a packed C++ array of three floats in
+// an array, every element is padded to 16 bytes
+static_assert(std140::array_of<std140::vec3, 4>::size == 64);
+static_assert(std140::mat3::size == 48);
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_std140") {
+  TEST_CASE("testing that Std140Block packs members at their offsets") {
+    std::array<GLfloat, 16> identity = {1, 0, 0, 0, 0, 1, 0, 0,
+                                        0, 0, 1, 0, 0, 0, 0, 1};
+    std::array<GLfloat, 3> position = {1.0f, 2.0f, 3.0f};
+
+    CameraBlock::Storage block = CameraBlock::pack(identity, position, 0.5f);
+
+    // The same bytes as the matching C++ struct
+    CameraData data = {};
+    std::memcpy(data.view_projection, identity.data(), sizeof(identity));
+    std::memcpy(data.position, position.data(), sizeof(position));
+    data.exposure = 0.5f;
+
+    CHECK_EQ(std::memcmp(block.data(), &data, sizeof(data)), 0);
+
+    CameraBlock::set<2>(block, 2.0f);
+
+    GLfloat exposure = 0.0f;
+    std::memcpy(&exposure, block.data() + 76, sizeof(exposure));
+    CHECK_EQ(exposure, 2.0f);
+  }
+
+  TEST_CASE("testing that Std140Block pads arrays and matrix columns") {
+    using Block = Std140Block<std140::array_of<std140::scalar, 2>,
+                              std140::mat3>;
+
+    static_assert(Block::offset<1> == 32);
+    static_assert(Block::size == 80);
+
+    Block::Storage block =
+        Block::pack({7.0f, 8.0f}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+
+    std::array<GLfloat, Block::size / sizeof(GLfloat)> floats;
+    std::memcpy(floats.data(), block.data(), Block::size);
+
+    // Array elements are 16 bytes apart, the padding is zero
+    CHECK_EQ(floats[0], 7.0f);
+    CHECK_EQ(floats[1], 0.0f);
+    CHECK_EQ(floats[4], 8.0f);
+
+    // Each matrix column is padded to a vec4
+    CHECK_EQ(floats[8], 1.0f);
+    CHECK_EQ(floats[10], 3.0f);
+    CHECK_EQ(floats[11], 0.0f);
+    CHECK_EQ(floats[12], 4.0f);
+    CHECK_EQ(floats[16], 7.0f);
+    CHECK_EQ(floats[18], 9.0f);
+  }
+}
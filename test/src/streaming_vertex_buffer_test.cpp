@@ -0,0 +1,209 @@
+#include <array>
+#include <cstdint>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "streaming_vertex_buffer.h"
+#include "streaming_vertex_buffer_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace streaming_vertex_buffer;
+
+StreamingVertexBufferTester::StreamingVertexBufferTester(
+    const std::shared_ptr<GLContext> &ctx, GLsizeiptr region_size,
+    GLuint region_count) {
+  buffer.emplace(StreamingVertexBuffer(string("test-streaming-vbo"), ctx,
+                                       region_size, region_count));
+}
+
+GLuint StreamingVertexBufferTester::VBO() { return buffer->VBO; }
+
+bool StreamingVertexBufferTester::fenced(GLuint region) {
+  return buffer->fences[region].has_value();
+}
+
+// Expectations for a successful construction with region_count
+// regions of region_size bytes, mapped to storage
+static void streaming_vertex_buffer_constructor_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context,
+    GLsizeiptr region_size, GLuint region_count, void *storage) {
+  EXPECT_CALL(*mock_opengl_context, supports(GLFeature::BufferStorage))
+      .Times(1)
+      .WillOnce(Return(true));
+
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(1)
+      .WillOnce(SetArgPointee<1>(1));
+
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(1)
+      .WillOnce(Return(GL_NO_ERROR));
+
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1)).Times(1);
+
+  GLbitfield flags =
+      GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+  EXPECT_CALL(*mock_opengl_context,
+              glBufferStorage(GL_ARRAY_BUFFER, region_size * region_count,
+                              nullptr, flags))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glMapBufferRange(GL_ARRAY_BUFFER, 0, region_size * region_count,
+                               flags))
+      .Times(1)
+      .WillOnce(Return(storage));
+
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0)).Times(1);
+
+  // Called on destruction of the StreamingVertexBuffer
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+}
+
+TEST_SUITE("sdl_opengl_cpp_streaming_vertex_buffer") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that StreamingVertexBuffer constructor throws when "
+            "buffer storage isn't supported") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::BufferStorage))
+        .Times(1)
+        .WillOnce(Return(false));
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    CHECK_THROWS_WITH_AS(
+        [mock_opengl_context] {
+          StreamingVertexBufferTester tester(mock_opengl_context, 256, 3);
+        }(),
+        "ERROR::STREAMING_VERTEX_BUFFER::BUFFER_STORAGE_NOT_SUPPORTED",
+        StreamingBufferNotSupportedError);
+  }
+
+  TEST_CASE("testing that StreamingVertexBuffer constructor throws when the "
+            "buffer can't be mapped") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    streaming_vertex_buffer_constructor_expectations(mock_opengl_context, 256,
+                                                     3, nullptr);
+
+    CHECK_THROWS_WITH_AS(
+        [mock_opengl_context] {
+          StreamingVertexBufferTester tester(mock_opengl_context, 256, 3);
+        }(),
+        "ERROR::STREAMING_VERTEX_BUFFER::MAP_BUFFER_FAILED",
+        StreamingBufferMapError);
+  }
+
+#else
+
+  TEST_CASE("testing that StreamingVertexBuffer constructor sets error flag "
+            "when buffer storage isn't supported") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::BufferStorage))
+        .Times(1)
+        .WillOnce(Return(false));
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    StreamingVertexBufferTester tester(mock_opengl_context, 256, 3);
+
+    CHECK_EQ(tester.buffer->valid(), false);
+    CHECK_EQ(tester.buffer->get_last_error(), error::FeatureNotSupportedError);
+  }
+
+  TEST_CASE("testing that StreamingVertexBuffer constructor sets error flag "
+            "when the buffer can't be mapped") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    streaming_vertex_buffer_constructor_expectations(mock_opengl_context, 256,
+                                                     3, nullptr);
+
+    StreamingVertexBufferTester tester(mock_opengl_context, 256, 3);
+
+    CHECK_EQ(tester.buffer->valid(), false);
+    CHECK_EQ(tester.buffer->get_last_error(), error::MapBufferError);
+  }
+
+#endif
+
+  TEST_CASE("testing that StreamingVertexBuffer cycles through fenced "
+            "regions") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::array<std::byte, 3 * 256> storage{};
+
+    streaming_vertex_buffer_constructor_expectations(mock_opengl_context, 256,
+                                                     3, storage.data());
+
+    EXPECT_CALL(*mock_opengl_context,
+                glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0))
+        .Times(4)
+        .WillOnce(Return(fake_sync(0x10)))
+        .WillOnce(Return(fake_sync(0x20)))
+        .WillOnce(Return(fake_sync(0x30)))
+        .WillOnce(Return(fake_sync(0x40)));
+
+    // Reusing the first region waits on its fence.  The first wait
+    // flushes, later waits after a timeout don't.
+    EXPECT_CALL(*mock_opengl_context,
+                glClientWaitSync(fake_sync(0x10), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                 _))
+        .Times(1)
+        .WillOnce(Return(GL_TIMEOUT_EXPIRED));
+    EXPECT_CALL(*mock_opengl_context, glClientWaitSync(fake_sync(0x10), 0, _))
+        .Times(1)
+        .WillOnce(Return(GL_CONDITION_SATISFIED));
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x10))).Times(1);
+
+    // The remaining fences are deleted on destruction
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x20))).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x30))).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteSync(fake_sync(0x40))).Times(1);
+
+    StreamingVertexBufferTester tester(mock_opengl_context, 256, 3);
+    StreamingVertexBuffer &buffer = *tester.buffer;
+
+    CHECK_EQ(tester.VBO(), 1);
+
+    for (GLuint region = 0; region < 3; region++) {
+      std::span<std::byte> mapped = buffer.begin_region();
+      CHECK_EQ(mapped.data(), storage.data() + region * 256);
+      CHECK_EQ(mapped.size(), 256);
+      CHECK_EQ(buffer.region_offset(), region * 256);
+      buffer.end_region();
+    }
+
+    CHECK(tester.fenced(0));
+
+    // Back to the first region
+    std::span<std::byte> mapped = buffer.begin_region();
+    CHECK_EQ(mapped.data(), storage.data());
+    CHECK_FALSE(tester.fenced(0));
+    buffer.end_region();
+
+    CHECK_EQ(buffer.region_offset(), 256);
+  }
+}
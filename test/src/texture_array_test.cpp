@@ -0,0 +1,147 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "mock_sdl.h"
+#include "sdl_surface_test.h"
+#include "texture_array.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SaveArg;
+
+using namespace sdl_opengl_cpp;
+
+TEST_SUITE("sdl_opengl_cpp_texture_array") {
+  TEST_CASE("testing that TextureArray uploads surfaces to layers and "
+            "finds them by key") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(_)).Times(3);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    texture_storage_expectations(mock_opengl_context, GL_TEXTURE_2D_ARRAY, 4,
+                                 4, 8, 8, 3);
+
+    // Each surface goes to its own layer, read in place without
+    // changing the pixel store
+    const GLvoid *first_uploaded = nullptr;
+    EXPECT_CALL(*mock_opengl_context, glPixelStorei(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, 8, 8, 1,
+                                GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, _))
+        .Times(2)
+        .WillOnce(SaveArg<10>(&first_uploaded))
+        .WillOnce(Return());
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 1, 8, 8, 1,
+                                GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glGenerateMipmap(GL_TEXTURE_2D_ARRAY))
+        .Times(1);
+
+    TestSurface grass(8, 8, std::byte{0x11});
+    TestSurface stone(8, 8, std::byte{0x22});
+    TestSurface moss(8, 8, std::byte{0x33});
+
+    TextureArray array(string("test-array"), mock_opengl_context, 8, 8, 3);
+
+    CHECK_EQ(array.get_texture(), 4);
+    CHECK_EQ(array.get_layers(), 3);
+    CHECK_EQ(array.get_levels(), 4);
+    CHECK_EQ(array.get_size(), (64 + 16 + 4 + 1) * 4 * 3);
+
+    {
+      SDLSurface surface(sdl, &grass.surface);
+      CHECK_EQ(array.add("grass", surface), 0);
+    }
+    {
+      SDLSurface surface(sdl, &stone.surface);
+      CHECK_EQ(array.add("stone", surface), 1);
+    }
+
+    CHECK_EQ(first_uploaded, grass.pixels.data());
+
+    // Adding a key again replaces its layer
+    {
+      SDLSurface surface(sdl, &moss.surface);
+      CHECK_EQ(array.add("grass", surface), 0);
+    }
+
+    array.generate_mipmaps();
+
+    CHECK_EQ(array.find("grass"), 0);
+    CHECK_EQ(array.find("stone"), 1);
+    CHECK_EQ(array.find("sand"), -1);
+    CHECK_EQ(array.get_used_layers(), 2);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that TextureArray throws when it is full or a surface "
+            "doesn't fit a layer") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(_)).Times(2);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    texture_storage_expectations(mock_opengl_context, GL_TEXTURE_2D_ARRAY, 4,
+                                 4, 8, 8, 1);
+    EXPECT_CALL(*mock_opengl_context, glTexSubImage3D(_, _, _, _, _, _, _, _,
+                                                      _, _, _))
+        .Times(1);
+
+    TestSurface tile(8, 8, std::byte{0});
+    TestSurface small(4, 4, std::byte{0});
+    SDLSurface tile_surface(sdl, &tile.surface);
+    SDLSurface small_surface(sdl, &small.surface);
+
+    TextureArray array(string("test-array"), mock_opengl_context, 8, 8, 1);
+
+    CHECK_THROWS_AS(array.add("small", small_surface), TextureDataError);
+    CHECK_EQ(array.find("small"), -1);
+
+    CHECK_EQ(array.add("tile", tile_surface), 0);
+    CHECK_THROWS_AS(array.add("another", tile_surface), TextureDataError);
+    CHECK_THROWS_AS(array.upload(1, tile_surface), TextureDataError);
+
+    CHECK_THROWS_AS(
+        TextureArray(string("test-array"), mock_opengl_context, 8, 8, 0),
+        TextureDataError);
+    CHECK_THROWS_AS(TextureArray(string("test-array"), mock_opengl_context, 8,
+                                 8, 1, GL_RGBA),
+                    TextureDataError);
+  }
+
+#endif
+}
@@ -0,0 +1,232 @@
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "mock_sdl.h"
+#include "sdl_surface_test.h"
+#include "texture_atlas.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SaveArg;
+
+using namespace sdl_opengl_cpp;
+
+namespace {
+
+struct Rect {
+  GLint x;
+  GLint y;
+  GLsizei width;
+  GLsizei height;
+};
+
+bool overlaps(const Rect &a, const Rect &b) {
+  return (a.x < b.x + b.width) && (b.x < a.x + a.width) &&
+         (a.y < b.y + b.height) && (b.y < a.y + a.height);
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_texture_atlas") {
+  TEST_CASE("testing that SkylinePacker places rectangles bottom left") {
+    SkylinePacker packer(10, 10);
+    GLint x = -1;
+    GLint y = -1;
+
+    REQUIRE(packer.insert(4, 4, x, y));
+    CHECK_EQ(x, 0);
+    CHECK_EQ(y, 0);
+
+    REQUIRE(packer.insert(4, 4, x, y));
+    CHECK_EQ(x, 4);
+    CHECK_EQ(y, 0);
+
+    // Too wide for the 2 texels left on the first row
+    REQUIRE(packer.insert(4, 4, x, y));
+    CHECK_EQ(x, 0);
+    CHECK_EQ(y, 4);
+
+    // The narrow gap on the right still takes a tall rectangle
+    REQUIRE(packer.insert(2, 10, x, y));
+    CHECK_EQ(x, 8);
+    CHECK_EQ(y, 0);
+
+    CHECK_FALSE(packer.insert(6, 6, x, y));
+    CHECK_FALSE(packer.insert(11, 1, x, y));
+    CHECK_FALSE(packer.insert(0, 1, x, y));
+
+    CHECK_EQ(packer.get_used_area(), 3 * 16 + 20);
+  }
+
+  TEST_CASE("testing that SkylinePacker never overlaps rectangles") {
+    SkylinePacker packer(64, 64);
+    std::vector<Rect> placed;
+
+    for (GLsizei i = 0; i < 200; i++) {
+      Rect rect = {0, 0, 1 + (i * 7) % 13, 1 + (i * 5) % 11};
+
+      if (!packer.insert(rect.width, rect.height, rect.x, rect.y))
+        continue;
+
+      CHECK(rect.x >= 0);
+      CHECK(rect.y >= 0);
+      CHECK(rect.x + rect.width <= 64);
+      CHECK(rect.y + rect.height <= 64);
+
+      for (const Rect &other : placed)
+        CHECK_FALSE(overlaps(rect, other));
+
+      placed.push_back(rect);
+    }
+
+    CHECK(placed.size() > 20);
+  }
+
+  TEST_CASE("testing that TextureAtlas packs surfaces into a page and "
+            "uploads the dirty rectangle") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(_)).Times(3);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    texture_storage_expectations(mock_opengl_context, GL_TEXTURE_2D, 3, 1, 16,
+                                 16);
+
+    // Both images and their gutters in one upload, rows read 16
+    // texels apart
+    const GLvoid *uploaded = nullptr;
+    EXPECT_CALL(*mock_opengl_context,
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, 16))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glPixelStorei(GL_UNPACK_ROW_LENGTH, 0))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 9, 4, GL_RGBA,
+                                GL_UNSIGNED_BYTE, _))
+        .Times(1)
+        .WillOnce(SaveArg<8>(&uploaded));
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 9, 0, 3, 3, GL_RGBA,
+                                GL_UNSIGNED_BYTE, _))
+        .Times(1);
+
+    TestSurface small(2, 2, std::byte{0x11});
+    TestSurface wide(3, 2, std::byte{0x22});
+    TestSurface dot(1, 1, std::byte{0x33});
+
+    TextureAtlas atlas(string("test-atlas"), mock_opengl_context, 16, 16);
+
+    std::optional<AtlasRegion> first;
+    std::optional<AtlasRegion> second;
+    {
+      SDLSurface surface(sdl, &small.surface);
+      first = atlas.add(surface);
+    }
+    {
+      SDLSurface surface(sdl, &wide.surface);
+      second = atlas.add(surface);
+    }
+
+    REQUIRE(first);
+    CHECK_EQ(first->page, 0);
+    CHECK_EQ(first->x, 1);
+    CHECK_EQ(first->y, 1);
+    CHECK_EQ(first->texcoord[0], doctest::Approx(1.0f / 16));
+    CHECK_EQ(first->texcoord[1], doctest::Approx(1.0f / 16));
+    CHECK_EQ(first->texcoord[2], doctest::Approx(3.0f / 16));
+    CHECK_EQ(first->texcoord[3], doctest::Approx(3.0f / 16));
+
+    REQUIRE(second);
+    CHECK_EQ(second->page, 0);
+    CHECK_EQ(second->x, 5);
+    CHECK_EQ(second->y, 1);
+    CHECK_EQ(second->width, 3);
+    CHECK_EQ(second->height, 2);
+
+    CHECK_EQ(atlas.get_page_count(), 1);
+    CHECK_EQ(atlas.get_page(0)->get_texture(), 3);
+    CHECK_EQ(atlas.get_used_area(), 4 * 4 + 5 * 4);
+
+    CHECK_EQ(atlas.flush(), 9 * 4 * 4);
+    REQUIRE(uploaded != nullptr);
+
+    const std::byte *texels = static_cast<const std::byte *>(uploaded);
+    CHECK_EQ(texels[0], std::byte{0});
+    CHECK_EQ(texels[(1 * 16 + 1) * 4], std::byte{0x11});
+    CHECK_EQ(texels[(2 * 16 + 2) * 4 + 3], std::byte{0x11});
+    CHECK_EQ(texels[(1 * 16 + 3) * 4], std::byte{0});
+    CHECK_EQ(texels[(2 * 16 + 7) * 4], std::byte{0x22});
+
+    // Nothing new to upload
+    CHECK_EQ(atlas.flush(), 0);
+
+    // Only the new image goes up
+    {
+      SDLSurface surface(sdl, &dot.surface);
+      std::optional<AtlasRegion> third = atlas.add(surface);
+      REQUIRE(third);
+      CHECK_EQ(third->x, 10);
+      CHECK_EQ(third->y, 1);
+    }
+    CHECK_EQ(atlas.flush(), 3 * 3 * 4);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that TextureAtlas throws for a surface larger than a "
+            "page") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(_)).Times(1);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(_, _)).Times(0);
+
+    // 15 texels and two gutters don't fit in 16
+    TestSurface large(15, 1, std::byte{0});
+    SDLSurface surface(sdl, &large.surface);
+
+    TextureAtlas atlas(string("test-atlas"), mock_opengl_context, 16, 16);
+    CHECK_THROWS_AS(atlas.add(surface), TextureDataError);
+    CHECK_EQ(atlas.get_page_count(), 0);
+    CHECK_THROWS_AS(atlas.get_page(0), TextureDataError);
+
+    CHECK_THROWS_AS(
+        TextureAtlas(string("test-atlas"), mock_opengl_context, 2, 16),
+        TextureDataError);
+  }
+
+#endif
+}
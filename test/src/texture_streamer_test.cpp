@@ -0,0 +1,270 @@
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "mock_sdl.h"
+#include "sdl_surface_test.h"
+#include "texture_streamer.h"
+
+using ::testing::_;
+using testing::Invoke;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+
+namespace {
+
+// A 4x5 ARGB8888 surface with rows padded to 20 bytes.  Byte i of
+// the tightly packed pixels is i, the padding is 0xff.
+struct StreamedSurface : TestSurface {
+  StreamedSurface()
+      : TestSurface(4, 5, std::byte{0xff}, SDL_PIXELFORMAT_ARGB8888, 20) {
+    for (size_t row = 0; row < 5; row++)
+      for (size_t byte = 0; byte < 16; byte++)
+        pixels[row * 20 + byte] = std::byte(row * 16 + byte);
+  }
+};
+
+// Expectations for a streamer of two 64 byte slots, mapped count
+// times into scratch
+void slot_expectations(std::shared_ptr<MockOpenGLContext> &mock_opengl_context,
+                       std::vector<std::array<std::byte, 64>> &scratch,
+                       size_t &maps) {
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(2)
+      .WillOnce(SetArgPointee<1>(1))
+      .WillOnce(SetArgPointee<1>(2));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context,
+              glBufferData(GL_ARRAY_BUFFER, 64, _, GL_STREAM_DRAW))
+      .Times(2);
+  EXPECT_CALL(*mock_opengl_context,
+              glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, 64,
+                               GL_MAP_WRITE_BIT |
+                                   GL_MAP_INVALIDATE_BUFFER_BIT))
+      .Times(static_cast<int>(scratch.size()))
+      .WillRepeatedly(Invoke([&scratch, &maps](GLenum, GLintptr, GLsizeiptr,
+                                               GLbitfield) -> void * {
+        return scratch[maps++].data();
+      }));
+
+  // Each map is unmapped for an upload or when the streamer is
+  // destroyed
+  EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+      .Times(static_cast<int>(scratch.size()))
+      .WillRepeatedly(Return(GL_TRUE));
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+}
+
+// Expectations for the 4x5 texture, uploaded as a band of four rows
+// from one slot and a band of one row from the other
+void texture_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context) {
+  texture_storage_expectations(mock_opengl_context, GL_TEXTURE_2D, 6, 3, 4, 5);
+  EXPECT_CALL(*mock_opengl_context,
+              glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 4, 4, GL_BGRA,
+                              GL_UNSIGNED_INT_8_8_8_8_REV, nullptr))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 4, 4, 1, GL_BGRA,
+                              GL_UNSIGNED_INT_8_8_8_8_REV, nullptr))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glGenerateMipmap(GL_TEXTURE_2D))
+      .Times(1);
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_texture_streamer") {
+  TEST_CASE("testing that TextureStreamer copies rows into pixel unpack "
+            "buffers and uploads them from there") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    StreamedSurface test_surface;
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(&test_surface.surface))
+        .Times(1);
+
+    std::vector<std::array<std::byte, 64>> scratch(4);
+    size_t maps = 0;
+    slot_expectations(mock_opengl_context, scratch, maps);
+    texture_expectations(mock_opengl_context);
+
+    TextureStreamHandle handle;
+
+    {
+      TextureStreamer streamer(
+          string("test-streamer"), mock_opengl_context,
+          [&sdl, &test_surface](const string &) {
+            return std::optional<SDLSurface>(
+                SDLSurface(sdl, &test_surface.surface));
+          },
+          64, 2);
+
+      CHECK_EQ(streamer.get_slot_size(), 64);
+      CHECK_EQ(streamer.get_slot_count(), 2);
+
+      handle = streamer.request("test.bmp");
+      CHECK_EQ(handle->get_status(), StreamStatus::Pending);
+      CHECK_EQ(handle->get_texture(), nullptr);
+      CHECK_EQ(streamer.get_pending_count(), 1);
+
+      // Let the worker copy both bands first.  A band uploaded
+      // earlier frees its slot, which is mapped again into the next
+      // scratch array and could take the second band.
+      while (streamer.get_decoded_bytes() < 80)
+        std::this_thread::yield();
+
+      streamer.finish();
+
+      CHECK(handle->is_ready());
+      CHECK_EQ(streamer.get_pending_count(), 0);
+      CHECK_EQ(streamer.get_total_bytes_uploaded(), 80);
+
+      // The padding SDL puts after each row isn't copied
+      for (size_t byte = 0; byte < 64; byte++)
+        CHECK_EQ(scratch[0][byte], std::byte(byte));
+      for (size_t byte = 0; byte < 16; byte++)
+        CHECK_EQ(scratch[1][byte], std::byte(64 + byte));
+    }
+
+    // The texture belongs to the handle and outlives the streamer
+    REQUIRE(handle->get_texture() != nullptr);
+    CHECK_EQ(handle->get_texture()->get_texture(), 6);
+    CHECK_EQ(handle->get_texture()->get_height(), 5);
+  }
+
+  TEST_CASE("testing that TextureStreamer spreads uploads over frames with "
+            "a frame budget") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::shared_ptr<MockSDLWrapper> mock_sdl_wrapper =
+        std::make_shared<MockSDLWrapper>();
+
+    EXPECT_CALL(*mock_sdl_wrapper, Init(0)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mock_sdl_wrapper, Quit()).Times(1);
+
+    std::shared_ptr<SDL> sdl = std::make_shared<SDL>(mock_sdl_wrapper);
+
+    StreamedSurface test_surface;
+    EXPECT_CALL(*mock_sdl_wrapper, FreeSurface(&test_surface.surface))
+        .Times(1);
+
+    std::vector<std::array<std::byte, 64>> scratch(4);
+    size_t maps = 0;
+    slot_expectations(mock_opengl_context, scratch, maps);
+    texture_expectations(mock_opengl_context);
+
+    TextureStreamer streamer(
+        string("test-streamer"), mock_opengl_context,
+        [&sdl, &test_surface](const string &) {
+          return std::optional<SDLSurface>(
+              SDLSurface(sdl, &test_surface.surface));
+        },
+        64, 2, 64);
+
+    TextureStreamHandle handle = streamer.request("test.bmp");
+
+    // Both bands fit in the ring, wait for the worker to copy them
+    while (streamer.get_decoded_bytes() < 80)
+      std::this_thread::yield();
+
+    CHECK_EQ(streamer.update(), 64);
+    CHECK_EQ(streamer.get_bytes_uploaded_last_update(), 64);
+    CHECK_EQ(handle->get_status(), StreamStatus::Pending);
+    CHECK_EQ(streamer.get_decoded_bytes(), 16);
+
+    CHECK_EQ(streamer.update(), 16);
+    CHECK(handle->is_ready());
+
+    CHECK_EQ(streamer.update(), 0);
+    CHECK_EQ(streamer.get_total_bytes_uploaded(), 80);
+  }
+
+  TEST_CASE("testing that TextureStreamer fails requests the decoder can't "
+            "decode") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // Mapped when the streamer is created and unmapped when it is
+    // destroyed
+    std::vector<std::array<std::byte, 64>> scratch(2);
+    size_t maps = 0;
+    slot_expectations(mock_opengl_context, scratch, maps);
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(_, _)).Times(0);
+
+    TextureStreamer streamer(
+        string("test-streamer"), mock_opengl_context,
+        [](const string &) { return std::optional<SDLSurface>(); }, 64, 2);
+
+    TextureStreamHandle handle = streamer.request("missing.bmp");
+    streamer.finish();
+
+    CHECK_EQ(handle->get_status(), StreamStatus::Failed);
+    CHECK_EQ(handle->get_texture(), nullptr);
+    CHECK_EQ(streamer.get_pending_count(), 0);
+    CHECK_EQ(streamer.get_total_bytes_uploaded(), 0);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that TextureStreamer throws on an invalid slot size") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+
+    CHECK_THROWS_AS(TextureStreamer(string("test-streamer"),
+                                    mock_opengl_context,
+                                    [](const string &) {
+                                      return std::optional<SDLSurface>();
+                                    },
+                                    0),
+                    BufferDataError);
+  }
+
+#endif
+}
@@ -0,0 +1,534 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "gpu_memory_registry.h"
+#include "mock_opengl.h"
+#include "texture.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+
+TEST_SUITE("sdl_opengl_cpp_texture") {
+  TEST_CASE("testing that Texture allocates a full mipmap chain with "
+            "immutable storage") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context,
+                glTexStorage2D(GL_TEXTURE_2D, 9, GL_RGBA8, 256, 128))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexImage2D(_, _, _, _, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                GL_LINEAR_MIPMAP_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                                GL_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 128, GL_RGBA,
+                                GL_UNSIGNED_BYTE, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glGenerateMipmap(GL_TEXTURE_2D))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glActiveTexture(GL_TEXTURE0 + 2))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+    GLsizeiptr textures = registry.get_bytes(GPUMemoryCategory::Texture);
+
+    {
+      Texture texture(string("test-texture"), mock_opengl_context, 256, 128);
+
+      CHECK_EQ(texture.get_texture(), 4);
+      CHECK_EQ(texture.get_levels(), 9);
+      CHECK_EQ(texture.get_filter(), TextureFilter::Trilinear);
+
+      // 256x128, 128x64, ... 2x1, 1x1 texels of 4 bytes
+      GLsizeiptr size = 0;
+      for (GLsizeiptr level = 0; level < 9; level++)
+        size += std::max<GLsizeiptr>(256 >> level, 1) *
+                std::max<GLsizeiptr>(128 >> level, 1) * 4;
+      CHECK_EQ(texture.get_size(), size);
+      CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture),
+               textures + size);
+
+      std::vector<std::byte> pixels(256 * 128 * 4);
+      texture.upload(pixels);
+      texture.generate_mipmaps();
+      texture.bind(2);
+    }
+
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture), textures);
+  }
+
+  TEST_CASE("testing that Texture allocates every level with glTexImage2D "
+            "without texture storage") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glTexStorage2D(_, _, _, _, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, 4, 2, 0, GL_RG,
+                             GL_UNSIGNED_BYTE, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexImage2D(GL_TEXTURE_2D, 1, GL_RG8, 2, 1, 0, GL_RG,
+                             GL_UNSIGNED_BYTE, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexImage2D(GL_TEXTURE_2D, 2, GL_RG8, 1, 1, 0, GL_RG,
+                             GL_UNSIGNED_BYTE, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                GL_LINEAR_MIPMAP_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                                GL_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                                GL_NEAREST_MIPMAP_NEAREST))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER,
+                                GL_NEAREST))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,
+                                GL_CLAMP_TO_EDGE))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 1, 1, 0, 1, 1, GL_RG,
+                                GL_UNSIGNED_BYTE, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    Texture texture(string("test-texture"), mock_opengl_context, 4, 2, GL_RG8);
+
+    CHECK_EQ(texture.get_levels(), 3);
+    CHECK_EQ(texture.get_size(), (4 * 2 + 2 * 1 + 1 * 1) * 2);
+
+    texture.set_filter(TextureFilter::Nearest);
+    CHECK_EQ(texture.get_filter(), TextureFilter::Nearest);
+
+    texture.set_wrap(GL_CLAMP_TO_EDGE, GL_REPEAT);
+
+    // One texel of level 1, rows of two bytes need no padding on the
+    // last row
+    std::vector<std::byte> texel(2);
+    texture.upload(1, 0, 1, 1, texel, GL_RG, GL_UNSIGNED_BYTE, 1);
+  }
+
+  TEST_CASE("testing that Texture allocates integer and float formats with "
+            "a matching format and type without texture storage") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(2)
+        .WillRepeatedly(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(2)
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_opengl_context,
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, 2, 2, 0,
+                             GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, 2, 2, 0, GL_RGB,
+                             GL_FLOAT, nullptr))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexParameteri(GL_TEXTURE_2D, _, _))
+        .Times(4);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(2);
+
+    Texture integer(string("test-texture"), mock_opengl_context, 2, 2,
+                    GL_RGBA16UI, 1);
+    CHECK_EQ(integer.get_size(), 2 * 2 * 8);
+
+    // Three 32 bit floats count as four
+    Texture floating(string("test-texture"), mock_opengl_context, 2, 2,
+                     GL_RGB32F, 1);
+    CHECK_EQ(floating.get_size(), 2 * 2 * 16);
+  }
+
+  TEST_CASE("testing that Texture is created and edited by name with direct "
+            "state access") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, direct_state_access())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glCreateTextures(GL_TEXTURE_2D, 1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<2>(6));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context,
+                glTextureStorage2D(6, 1, GL_SRGB8_ALPHA8, 16, 16))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTextureParameteri(6, GL_TEXTURE_MIN_FILTER, GL_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTextureParameteri(6, GL_TEXTURE_MAG_FILTER, GL_LINEAR))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTextureSubImage2D(6, 0, 0, 0, 16, 16, GL_RGBA,
+                                    GL_UNSIGNED_BYTE, _))
+        .Times(1);
+
+    // A single level has nothing to generate
+    EXPECT_CALL(*mock_opengl_context, glGenerateTextureMipmap(_)).Times(0);
+
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::AnisotropicFiltering))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context,
+                glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(8.0f));
+    EXPECT_CALL(*mock_opengl_context,
+                glTextureParameterf(6, GL_TEXTURE_MAX_ANISOTROPY_EXT, 8.0f))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    Texture texture(string("test-texture"), mock_opengl_context, 16, 16,
+                    GL_SRGB8_ALPHA8, 1);
+
+    std::vector<std::byte> pixels(16 * 16 * 4);
+    texture.upload(pixels);
+    texture.generate_mipmaps();
+
+    CHECK_EQ(texture.set_anisotropy(16.0f), 8.0f);
+  }
+
+  TEST_CASE("testing that Texture skips anisotropy without support") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glTexStorage2D(_, _, _, _, _)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexParameteri(_, _, _)).Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::AnisotropicFiltering))
+        .Times(1)
+        .WillOnce(Return(false));
+    EXPECT_CALL(*mock_opengl_context, glGetFloatv(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glTexParameterf(_, _, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    Texture texture(string("test-texture"), mock_opengl_context, 8, 8);
+
+    CHECK_EQ(texture.set_anisotropy(4.0f), 1.0f);
+  }
+
+  TEST_CASE("testing that Texture uploads padded rows in place") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context,
+                glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGB8, 5, 3))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexParameteri(_, _, _)).Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    {
+      testing::InSequence sequence;
+
+      // Tightly packed 565 rows of 10 bytes, read with an alignment
+      // of 2
+      EXPECT_CALL(*mock_opengl_context,
+                  glPixelStorei(GL_UNPACK_ALIGNMENT, 2))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context,
+                  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 5, 3, GL_RGB,
+                                  GL_UNSIGNED_SHORT_5_6_5, _))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context,
+                  glPixelStorei(GL_UNPACK_ALIGNMENT, 4))
+          .Times(1);
+
+      // Three texels of each 16 texel row
+      EXPECT_CALL(*mock_opengl_context,
+                  glPixelStorei(GL_UNPACK_ROW_LENGTH, 16))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context,
+                  glTexSubImage2D(GL_TEXTURE_2D, 0, 2, 1, 3, 2, GL_BGRA,
+                                  GL_UNSIGNED_INT_8_8_8_8_REV, _))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context,
+                  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0))
+          .Times(1);
+    }
+
+    Texture texture(string("test-texture"), mock_opengl_context, 5, 3,
+                    GL_RGB8, 1);
+
+    std::vector<std::byte> packed(5 * 3 * 2);
+    texture.upload(0, 0, 5, 3, packed, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, 0, 0,
+                   2);
+
+    // The last row only needs its own three texels
+    std::vector<std::byte> wide(16 * 4 + 3 * 4);
+    texture.upload(2, 1, 3, 2, wide, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0,
+                   16);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that Texture throws on bad pixels") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glTexStorage2D(_, _, _, _, _)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexParameteri(_, _, _)).Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(_, _, _, _, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    CHECK_THROWS_AS(
+        Texture(string("test-texture"), mock_opengl_context, 0, 8),
+        TextureDataError);
+    CHECK_THROWS_AS(
+        Texture(string("test-texture"), mock_opengl_context, 8, 8, GL_RGBA8,
+                5),
+        TextureDataError);
+
+    // An unsized format has no texel size to account for
+    CHECK_THROWS_AS(
+        Texture(string("test-texture"), mock_opengl_context, 8, 8, GL_RGBA),
+        TextureDataError);
+
+    Texture texture(string("test-texture"), mock_opengl_context, 8, 8);
+
+    // One byte short of level 0
+    std::vector<std::byte> pixels(8 * 8 * 4 - 1);
+    CHECK_THROWS_AS(texture.upload(pixels), TextureDataError);
+
+    std::vector<std::byte> rect(4 * 4 * 4);
+    CHECK_THROWS_AS(
+        texture.upload(6, 0, 4, 4, rect, GL_RGBA, GL_UNSIGNED_BYTE),
+        TextureDataError);
+    CHECK_THROWS_AS(
+        texture.upload(0, 0, 4, 4, rect, GL_RGBA, GL_UNSIGNED_BYTE, 2),
+        TextureDataError);
+    CHECK_THROWS_AS(
+        texture.upload(0, 0, 1, 1, rect, GL_RGBA, GL_UNSIGNED_BYTE, 4),
+        TextureDataError);
+
+    // Rows shorter than the rectangle, and an alignment OpenGL
+    // doesn't have
+    CHECK_THROWS_AS(
+        texture.upload(0, 0, 4, 4, rect, GL_RGBA, GL_UNSIGNED_BYTE, 0, 2),
+        TextureDataError);
+    CHECK_THROWS_AS(
+        texture.upload(0, 0, 4, 4, rect, GL_RGBA, GL_UNSIGNED_BYTE, 0, 0, 3),
+        TextureDataError);
+
+    // Rows of 8 texels need more than the 4x4 rectangle's bytes
+    CHECK_THROWS_AS(
+        texture.upload(0, 0, 4, 4, rect, GL_RGBA, GL_UNSIGNED_BYTE, 0, 8),
+        TextureDataError);
+  }
+
+  TEST_CASE("testing that Texture throws when the texture can't be "
+            "generated") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(2)
+        .WillOnce(SetArgPointee<1>(0))
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(3)
+        .WillOnce(Return(GL_OUT_OF_MEMORY))
+        .WillOnce(Return(GL_NO_ERROR))
+        .WillOnce(Return(GL_INVALID_ENUM));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glTexStorage2D(_, _, _, _, _)).Times(1);
+
+    // The texture whose storage failed is deleted
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    GPUMemoryRegistry &registry = GPUMemoryRegistry::instance();
+    GLsizeiptr textures = registry.get_bytes(GPUMemoryCategory::Texture);
+
+    CHECK_THROWS_AS(
+        Texture(string("test-texture"), mock_opengl_context, 8, 8),
+        GenTexturesError);
+    CHECK_THROWS_AS(
+        Texture(string("test-texture"), mock_opengl_context, 8, 8),
+        GenTexturesError);
+
+    CHECK_EQ(registry.get_bytes(GPUMemoryCategory::Texture), textures);
+  }
+
+  TEST_CASE("testing that a moved from Texture throws on use") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenTextures(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(4));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(2)
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 4))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, supports(GLFeature::TextureStorage))
+        .Times(1)
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_opengl_context, glTexStorage2D(_, _, _, _, _)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glTexParameteri(_, _, _)).Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteTextures(1, _)).Times(1);
+
+    Texture texture(string("test-texture"), mock_opengl_context, 8, 8);
+    Texture other(std::move(texture));
+
+    CHECK(texture.is_in_unspecified_state());
+    CHECK_FALSE(other.is_in_unspecified_state());
+    CHECK_EQ(other.get_texture(), 4);
+    CHECK_THROWS_AS(texture.bind(), TextureUnspecifiedStateError);
+  }
+
+#endif
+}
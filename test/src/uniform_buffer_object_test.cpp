@@ -0,0 +1,148 @@
+#include <array>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "std140.h"
+#include "uniform_buffer_object.h"
+#include "vertex_buffer_object_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace uniform_buffer_object;
+
+using CameraBlock = Std140Block<std140::mat4, std140::vec3, std140::scalar>;
+
+// Expectations for constructing a UniformBufferObject of size bytes
+// on a driver with 256 byte offset alignment
+static void uniform_buffer_constructor_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLsizeiptr size) {
+  EXPECT_CALL(*mock_opengl_context,
+              glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, _))
+      .Times(1)
+      .WillOnce(SetArgPointee<1>(256));
+
+  buffer_constructor_expectations(mock_opengl_context, size, GL_DYNAMIC_DRAW);
+}
+
+TEST_SUITE("sdl_opengl_cpp_uniform_buffer_object") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  TEST_CASE("testing that UniformBufferObject uploads and binds blocks") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // Two camera blocks, one per view, at aligned offsets
+    uniform_buffer_constructor_expectations(mock_opengl_context, 512);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 0, CameraBlock::size, _))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 256, CameraBlock::size, _))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBufferBase(GL_UNIFORM_BUFFER, 0, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBufferRange(GL_UNIFORM_BUFFER, 1, 1, 256,
+                                  CameraBlock::size))
+        .Times(1);
+
+    UniformBufferObject ubo(string("test-ubo"), mock_opengl_context, 512);
+
+    CHECK_EQ(ubo.get_size(), 512);
+    CHECK_EQ(ubo.get_offset_alignment(), 256);
+    CHECK_EQ(ubo.aligned_stride(CameraBlock::size), 256);
+
+    std::array<GLfloat, 16> identity = {1, 0, 0, 0, 0, 1, 0, 0,
+                                        0, 0, 1, 0, 0, 0, 0, 1};
+    CameraBlock::Storage camera =
+        CameraBlock::pack(identity, {0.0f, 1.0f, 5.0f}, 1.0f);
+
+    ubo.update(0, camera);
+    ubo.update(ubo.aligned_stride(CameraBlock::size), camera);
+
+    ubo.bind_base(0);
+    ubo.bind_range(1, 256, CameraBlock::size);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(ubo.valid(), true);
+#endif
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that UniformBufferObject rejects misaligned and out of "
+            "range bindings") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    uniform_buffer_constructor_expectations(mock_opengl_context, 512);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBufferRange(_, _, _, _, _))
+        .Times(0);
+
+    UniformBufferObject ubo(string("test-ubo"), mock_opengl_context, 512);
+
+    CHECK_THROWS_WITH_AS(
+        ubo.bind_range(0, 64, CameraBlock::size),
+        "ERROR::UNIFORM_BUFFER::BUFFER_DATA_ERROR::MISALIGNED_OFFSET",
+        BufferDataError);
+
+    CHECK_THROWS_WITH_AS(
+        ubo.bind_range(0, 512, CameraBlock::size),
+        "ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::RANGE_OUT_OF_BOUNDS",
+        BufferDataError);
+  }
+
+#else
+
+  TEST_CASE("testing that UniformBufferObject sets error flag for misaligned "
+            "and out of range bindings") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // The first error is sticky, so use a new buffer for each check
+    EXPECT_CALL(*mock_opengl_context, glGetIntegerv(_, _))
+        .Times(2)
+        .WillRepeatedly(SetArgPointee<1>(256));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillRepeatedly(SetArgPointee<1>(1));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBufferData(_, _, _, _)).Times(2);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBufferRange(_, _, _, _, _))
+        .Times(0);
+
+    UniformBufferObject misaligned_ubo(string("test-ubo"), mock_opengl_context,
+                                       512);
+    misaligned_ubo.bind_range(0, 64, CameraBlock::size);
+    CHECK_EQ(misaligned_ubo.valid(), false);
+    CHECK_EQ(misaligned_ubo.get_last_error(), error::BufferDataError);
+
+    UniformBufferObject range_ubo(string("test-ubo"), mock_opengl_context,
+                                  512);
+    range_ubo.bind_range(0, 512, CameraBlock::size);
+    CHECK_EQ(range_ubo.valid(), false);
+    CHECK_EQ(range_ubo.get_last_error(), error::BufferDataError);
+  }
+
+#endif
+}
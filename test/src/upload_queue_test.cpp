@@ -0,0 +1,284 @@
+#include <array>
+#include <cstdint>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "upload_queue.h"
+#include "vertex_buffer_object_test.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace upload_queue;
+
+// Offsets into a pixel unpack buffer are passed as pointers
+static const GLvoid *staging_offset(std::uintptr_t offset) {
+  return reinterpret_cast<const GLvoid *>(offset);
+}
+
+TEST_SUITE("sdl_opengl_cpp_upload_queue") {
+  TEST_CASE("testing that UploadQueue batches buffer uploads in one map") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 64, GL_STREAM_DRAW);
+
+    // The destination buffer is buffer 2
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(2))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 32, nullptr, GL_STATIC_DRAW))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _))
+        .Times(1)
+        .RetiresOnSaturation();
+
+    std::array<std::byte, 64> staging{};
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 1))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glMapBufferRange(GL_COPY_READ_BUFFER, 0, 14,
+                                 GL_MAP_WRITE_BIT |
+                                     GL_MAP_INVALIDATE_BUFFER_BIT))
+        .Times(1)
+        .WillOnce(Return(staging.data()));
+    EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(GL_COPY_READ_BUFFER))
+        .Times(1)
+        .WillOnce(Return(GL_TRUE));
+
+    // The second upload starts at the next four byte boundary
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_WRITE_BUFFER, 2))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    0, 4, 6))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                    8, 16, 6))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 0))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_WRITE_BUFFER, 0))
+        .Times(1);
+
+    VertexBufferObject destination(string("test-destination"),
+                                   mock_opengl_context, GLsizeiptr{32});
+    UploadQueue queue(string("test-upload-queue"), mock_opengl_context, 64);
+
+    std::array<std::uint8_t, 6> first{1, 2, 3, 4, 5, 6};
+    std::array<std::uint8_t, 6> second{7, 8, 9, 10, 11, 12};
+
+    queue.enqueue_buffer(destination, 4, std::span<const std::uint8_t>(first));
+    queue.enqueue_buffer(destination, 16,
+                         std::span<const std::uint8_t>(second));
+
+    CHECK_EQ(queue.get_queue_depth(), 2);
+    CHECK_EQ(queue.get_pending_bytes(), 12);
+
+    CHECK_EQ(queue.flush(), 12);
+
+    CHECK_EQ(staging[0], std::byte{1});
+    CHECK_EQ(staging[5], std::byte{6});
+    CHECK_EQ(staging[8], std::byte{7});
+    CHECK_EQ(staging[13], std::byte{12});
+
+    CHECK_EQ(queue.get_queue_depth(), 0);
+    CHECK_EQ(queue.get_pending_bytes(), 0);
+    CHECK_EQ(queue.get_bytes_uploaded_last_flush(), 12);
+    CHECK_EQ(queue.get_total_bytes_uploaded(), 12);
+
+    // Nothing left, so nothing is mapped
+    CHECK_EQ(queue.flush(), 0);
+    CHECK_EQ(queue.get_bytes_uploaded_last_flush(), 0);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(queue.valid(), true);
+#endif
+  }
+
+  TEST_CASE("testing that UploadQueue spreads texture rows over frames") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 64, GL_STREAM_DRAW);
+
+    std::array<std::byte, 64> staging{};
+
+    // A 2x4 RGBA texture is 8 bytes per row, a 20 byte budget fits
+    // two rows each flush
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 1))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glMapBufferRange(GL_COPY_READ_BUFFER, 0, 16,
+                                 GL_MAP_WRITE_BIT |
+                                     GL_MAP_INVALIDATE_BUFFER_BIT))
+        .Times(2)
+        .WillRepeatedly(Return(staging.data()));
+    EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(GL_COPY_READ_BUFFER))
+        .Times(2)
+        .WillRepeatedly(Return(GL_TRUE));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 1))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 7))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 2, 2, GL_RGBA,
+                                GL_UNSIGNED_BYTE, staging_offset(0)))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 2, 2, 2, GL_RGBA,
+                                GL_UNSIGNED_BYTE, staging_offset(0)))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_COPY_READ_BUFFER, 0))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0))
+        .Times(2);
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(GL_TEXTURE_2D, 0))
+        .Times(2);
+
+    UploadQueue queue(string("test-upload-queue"), mock_opengl_context, 64,
+                      20);
+
+    std::array<std::byte, 32> pixels{};
+    pixels[16] = std::byte{0xab};
+
+    queue.enqueue_texture(7, 0, 0, 2, 4, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    CHECK_EQ(queue.flush(), 16);
+    CHECK_EQ(queue.get_queue_depth(), 1);
+    CHECK_EQ(queue.get_pending_bytes(), 16);
+
+    CHECK_EQ(queue.flush(), 16);
+    CHECK_EQ(staging[0], std::byte{0xab});
+    CHECK_EQ(queue.get_queue_depth(), 0);
+    CHECK_EQ(queue.get_total_bytes_uploaded(), 32);
+  }
+
+  TEST_CASE("testing that UploadQueue always uploads at least one row") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 64, GL_STREAM_DRAW);
+
+    std::array<std::byte, 64> staging{};
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glBindTexture(_, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context, glMapBufferRange(_, 0, 16, _))
+        .Times(2)
+        .WillRepeatedly(Return(staging.data()));
+    EXPECT_CALL(*mock_opengl_context, glUnmapBuffer(_))
+        .Times(2)
+        .WillRepeatedly(Return(GL_TRUE));
+    EXPECT_CALL(*mock_opengl_context,
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _, 4, 1, GL_RGBA,
+                                GL_UNSIGNED_BYTE, _))
+        .Times(2);
+
+    // Each row is 16 bytes, more than the budget
+    UploadQueue queue(string("test-upload-queue"), mock_opengl_context, 64, 4);
+
+    std::array<std::byte, 32> pixels{};
+    queue.enqueue_texture(7, 0, 0, 4, 2, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    queue.flush();
+    queue.flush();
+
+    CHECK_EQ(queue.get_queue_depth(), 0);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that UploadQueue throws on invalid uploads") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_DRAW);
+
+    EXPECT_CALL(*mock_opengl_context, glMapBufferRange(_, _, _, _)).Times(0);
+
+    UploadQueue queue(string("test-upload-queue"), mock_opengl_context, 16);
+
+    // 32 bytes, a row of 8 RGBA pixels doesn't fit in the staging
+    // buffer
+    std::array<std::byte, 32> pixels{};
+    CHECK_THROWS_WITH_AS(
+        queue.enqueue_texture(7, 0, 0, 8, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                              pixels),
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_PIXELS",
+        BufferDataError);
+
+    // Wrong size for the rectangle
+    CHECK_THROWS_WITH_AS(
+        queue.enqueue_texture(7, 0, 0, 2, 2, GL_RGBA, GL_UNSIGNED_BYTE,
+                              pixels),
+        "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_PIXELS",
+        BufferDataError);
+
+    CHECK_THROWS_WITH_AS(queue.set_frame_budget(-1),
+                         "ERROR::UPLOAD_QUEUE::BUFFER_DATA_ERROR::INVALID_BUDGET",
+                         BufferDataError);
+
+    CHECK_EQ(queue.get_queue_depth(), 0);
+  }
+
+#else
+
+  TEST_CASE("testing that UploadQueue sets error flag on invalid uploads") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    buffer_constructor_expectations(mock_opengl_context, 16, GL_STREAM_DRAW);
+
+    EXPECT_CALL(*mock_opengl_context, glMapBufferRange(_, _, _, _)).Times(0);
+
+    UploadQueue queue(string("test-upload-queue"), mock_opengl_context, 16);
+
+    std::array<std::byte, 32> pixels{};
+    queue.enqueue_texture(7, 0, 0, 8, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    CHECK_EQ(queue.valid(), false);
+    CHECK_EQ(queue.get_last_error(),
+             std::optional<error>(error::BufferDataError));
+    CHECK_EQ(queue.get_queue_depth(), 0);
+  }
+
+#endif
+}
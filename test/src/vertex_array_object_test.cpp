@@ -73,7 +73,8 @@ TEST_CASE("testing that VertexArrayObject constructor throws GenVertexArrays "
           testing::SaveArgPointee<1>(&array1)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(3)
+      .Times(4)
+      .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_OUT_OF_MEMORY));
@@ -139,7 +140,8 @@ TEST_CASE("testing that VertexArrayObject constructor sets error flag") {
           testing::SaveArgPointee<1>(&array1)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(3)
+      .Times(4)
+      .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_NO_ERROR))
       .WillOnce(testing::Return(GL_OUT_OF_MEMORY));
@@ -211,7 +213,7 @@ TEST_CASE("testing that VertexArrayObject constructor works with exceptions") {
           testing::SaveArgPointee<1>(&array1)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(5)
+      .Times(6)
       .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
   // Bind the VBO buffer
@@ -277,7 +279,7 @@ TEST_CASE("testing that VertexBufferObject constructor works with exceptions "
           testing::SaveArgPointee<1>(&array1)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(5)
+      .Times(6)
       .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
   // Bind the VBO buffer
@@ -340,7 +342,7 @@ TEST_CASE("testing that VertexArrayObject bind() throws an exception when the "
             .WillOnce(testing::DoAll(testing::SetArgPointee<1>(1)));
 
         EXPECT_CALL(*mock_opengl_context, glGetError())
-            .Times(5)
+            .Times(6)
             .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
         // Bind the VBO buffer
@@ -403,7 +405,7 @@ TEST_CASE("testing that VertexArrayObject bind() sets error flag when the VAO "
       .WillOnce(testing::DoAll(testing::SetArgPointee<1>(1)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(5)
+      .Times(6)
       .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
   // Bind the VBO buffer
@@ -451,3 +453,526 @@ TEST_CASE("testing that VertexArrayObject bind() sets error flag when the VAO "
 }
 
 #endif
+
+TEST_CASE("testing that VertexArrayObject draws with an attached index "
+          "buffer") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  // The vertex buffer is 1, the index buffer is 2
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(2)
+      .WillOnce(testing::SetArgPointee<1>(1))
+      .WillOnce(testing::SetArgPointee<1>(2));
+
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(_, _, _, _)).Times(2);
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(0)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribPointer(0, 3, _, _, 0, NULL))
+      .Times(1);
+
+  // Constructing, attaching and drawing twice
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(1)).Times(4);
+  // Constructing and attaching
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(0)).Times(2);
+
+  // The element array binding is recorded in the VAO and never unbound
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 2))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0))
+      .Times(0);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT, nullptr))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glDrawElementsBaseVertex(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT,
+                                       nullptr, 3))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+  VertexArrayObjectTester vao_tester(mock_opengl_context);
+  VertexArrayObject &vao = *vao_tester.vao;
+
+  vector<GLuint> indices = {0, 1, 2};
+  vao.attach_index_buffer(
+      IndexBufferObject(string("test-ibo"), mock_opengl_context, indices, 3));
+
+  vao.draw_elements(GL_TRIANGLES);
+  vao.draw_elements(GL_TRIANGLES, 3);
+
+#ifdef NO_EXCEPTIONS
+  CHECK_EQ(vao.valid(), true);
+#endif
+}
+
+#ifndef NO_EXCEPTIONS
+
+TEST_CASE("testing that VertexArrayObject draw_elements() throws without an "
+          "index buffer") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(_, _, _, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(0)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribPointer(0, 3, _, _, 0, NULL))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(_))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glDrawElements(_, _, _, _)).Times(0);
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+  VertexArrayObjectTester vao_tester(mock_opengl_context);
+
+  CHECK_THROWS_WITH_AS(vao_tester.vao->draw_elements(GL_TRIANGLES),
+                       "ERROR::VERTEX_ARRAY::NO_INDEX_BUFFER",
+                       vertex_array_object::InvalidOperationError);
+}
+
+#endif
+
+TEST_CASE("testing that VertexArrayObject configures a compile time vertex "
+          "layout") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(6)
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(_, _, _, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(_))
+      .Times(testing::AnyNumber());
+
+  // One enable and one pointer call per attribute, integer
+  // attributes go through glVertexAttribIPointer
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(0)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(2)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 20,
+                                    reinterpret_cast<const void *>(0)))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 20,
+                                    reinterpret_cast<const void *>(12)))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribIPointer(2, 4, GL_UNSIGNED_BYTE, 20,
+                                     reinterpret_cast<const void *>(16)))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+  vector<GLfloat> vertices(10, 0.0f);
+  VertexBufferObject vbo(string("test-vbo"), mock_opengl_context, vertices);
+
+  VertexArrayObject vao(
+      string("test-vao"), mock_opengl_context, std::move(vbo),
+      VertexLayout<Attr<vec3, 0>, Attr<rgba8_norm, 1>, Attr<u8vec4, 2>>{});
+
+#ifdef NO_EXCEPTIONS
+  CHECK_EQ(vao.valid(), true);
+#endif
+}
+
+TEST_CASE("testing that VertexArrayObject draws instances from an attached "
+          "per-instance buffer") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  // The mesh is 1, the per-instance offsets 2, the shared colors 3
+  // and the index buffer 4
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(4)
+      .WillOnce(testing::SetArgPointee<1>(1))
+      .WillOnce(testing::SetArgPointee<1>(2))
+      .WillOnce(testing::SetArgPointee<1>(3))
+      .WillOnce(testing::SetArgPointee<1>(4));
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(_, _, _, _)).Times(4);
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(_))
+      .Times(testing::AnyNumber());
+
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(_)).Times(3);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribPointer(0, 3, _, _, 0, NULL))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8,
+                                    reinterpret_cast<const void *>(0)))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, 4,
+                                    reinterpret_cast<const void *>(0)))
+      .Times(1);
+
+  // Only the per-instance attributes get a divisor
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribDivisor(0, _)).Times(0);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribDivisor(1, 1)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribDivisor(2, 4)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glDrawArraysInstanced(GL_TRIANGLES, 0, 3, 50000))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glDrawElementsInstanced(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT,
+                                      nullptr, 100))
+      .Times(1);
+
+  // The referenced color buffer is deleted by its owner, after the
+  // vertex array object
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(4);
+
+  vector<GLfloat> colors(4, 0.0f);
+  VertexBufferObject color_vbo(string("test-colors"), mock_opengl_context,
+                               colors);
+
+  {
+    VertexArrayObjectTester vao_tester(mock_opengl_context);
+    VertexArrayObject &vao = *vao_tester.vao;
+
+    vector<GLfloat> offsets(2 * 16, 0.0f);
+    vao.attach_buffer(
+        VertexBufferObject(string("test-offsets"), mock_opengl_context,
+                           offsets),
+        VertexLayout<Attr<vec2, 1>>{}, 1);
+
+    vao.reference_buffer(color_vbo, VertexLayout<Attr<rgba8_norm, 2>>{}, 4);
+
+    vao.draw_arrays_instanced(GL_TRIANGLES, 0, 3, 50000);
+
+    vector<GLuint> indices = {0, 1, 2};
+    vao.attach_index_buffer(IndexBufferObject(
+        string("test-ibo"), mock_opengl_context, indices, 3));
+
+    vao.draw_elements_instanced(GL_TRIANGLES, 100);
+
+#ifdef NO_EXCEPTIONS
+    CHECK_EQ(vao.valid(), true);
+#endif
+  }
+}
+
+TEST_CASE("testing that VertexArrayObject sets up vertex buffer bindings by "
+          "name with direct state access") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  EXPECT_CALL(*mock_opengl_context, direct_state_access())
+      .WillRepeatedly(testing::Return(true));
+
+  // The mesh is 1, the per-instance offsets 2 and the index buffer 3
+  EXPECT_CALL(*mock_opengl_context, glCreateBuffers(1, _))
+      .Times(3)
+      .WillOnce(testing::SetArgPointee<1>(1))
+      .WillOnce(testing::SetArgPointee<1>(2))
+      .WillOnce(testing::SetArgPointee<1>(3));
+  EXPECT_CALL(*mock_opengl_context, glCreateVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(5));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glNamedBufferData(_, _, _, _)).Times(3);
+
+  // The interleaved mesh at binding 0
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayVertexBuffer(5, 0, 1, 0, 20))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexArrayAttribFormat(5, 0, 3, GL_FLOAT, GL_FALSE, 0))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexArrayAttribFormat(5, 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, 12))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexArrayAttribIFormat(5, 2, 4, GL_UNSIGNED_BYTE, 16))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayAttribBinding(5, 0, 0))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayAttribBinding(5, 1, 0))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayAttribBinding(5, 2, 0))
+      .Times(1);
+
+  // The per-instance offsets at binding 1, with a divisor
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayVertexBuffer(5, 1, 2, 0, 8))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexArrayAttribFormat(5, 3, 2, GL_FLOAT, GL_FALSE, 0))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayAttribBinding(5, 3, 1))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayBindingDivisor(5, 1, 1))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexArrayAttrib(5, _)).Times(4);
+  EXPECT_CALL(*mock_opengl_context, glVertexArrayElementBuffer(5, 3))
+      .Times(1);
+
+  // Only drawing binds the vertex array object
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(0)).Times(0);
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _)).Times(0);
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(_)).Times(0);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glDrawElementsInstanced(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT,
+                                      nullptr, 16))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(3);
+
+  vector<GLfloat> vertices(15, 0.0f);
+  VertexBufferObject vbo(string("test-vbo"), mock_opengl_context, vertices);
+
+  VertexArrayObject vao(
+      string("test-vao"), mock_opengl_context, std::move(vbo),
+      VertexLayout<Attr<vec3, 0>, Attr<rgba8_norm, 1>, Attr<u8vec4, 2>>{});
+
+  vector<GLfloat> offsets(2 * 16, 0.0f);
+  vao.attach_buffer(VertexBufferObject(string("test-offsets"),
+                                       mock_opengl_context, offsets),
+                    VertexLayout<Attr<vec2, 3>>{}, 1);
+
+  vector<GLuint> indices = {0, 1, 2};
+  vao.attach_index_buffer(
+      IndexBufferObject(string("test-ibo"), mock_opengl_context, indices, 3));
+
+  vao.draw_elements_instanced(GL_TRIANGLES, 16);
+
+#ifdef NO_EXCEPTIONS
+  CHECK_EQ(vao.valid(), true);
+#endif
+}
+
+TEST_CASE("testing that VertexArrayObject swaps the buffer of a vertex "
+          "buffer binding without specifying the attributes again") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  EXPECT_CALL(*mock_opengl_context, vertex_attrib_binding())
+      .WillRepeatedly(testing::Return(true));
+
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(2)
+      .WillOnce(testing::SetArgPointee<1>(1))
+      .WillOnce(testing::SetArgPointee<1>(2));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+      .Times(2);
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(5));
+
+  // The format is set up once
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(_)).Times(2);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribFormat(0, 3, GL_FLOAT, GL_FALSE, 0))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribFormat(1, 2, GL_FLOAT, GL_FALSE, 12))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribBinding(_, 0)).Times(2);
+  EXPECT_CALL(*mock_opengl_context, glVertexAttribPointer(_, _, _, _, _, _))
+      .Times(0);
+
+  {
+    testing::InSequence seq;
+
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexBuffer(0, 1, 0, 20))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(0)).Times(1);
+
+    // Each mesh is one buffer bind and one draw
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexBuffer(0, 2, 0, 20))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDrawArrays(GL_TRIANGLES, 0, 3))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexBuffer(0, 2, 60, 20))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(5)).Times(1);
+    EXPECT_CALL(*mock_opengl_context, glDrawArrays(GL_TRIANGLES, 0, 3))
+        .Times(1);
+  }
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+  vector<GLfloat> vertices(30, 0.0f);
+  VertexBufferObject vbo(string("test-vbo"), mock_opengl_context, vertices);
+  VertexBufferObject other(string("test-other"), mock_opengl_context,
+                           vertices);
+
+  VertexArrayObject vao(string("test-vao"), mock_opengl_context,
+                        std::move(vbo),
+                        VertexLayout<Attr<vec3, 0>, Attr<vec2, 1>>{});
+
+  CHECK_EQ(vao.get_binding_count(), 1);
+
+  vao.bind_vertex_buffer(0, other);
+  vao.draw_arrays(GL_TRIANGLES, 0, 3);
+
+#ifdef NO_EXCEPTIONS
+  CHECK_EQ(vao.valid(), true);
+#endif
+
+  // Three vertices into the buffer
+  vao.bind_vertex_buffer(0, other, 60);
+  vao.draw_arrays(GL_TRIANGLES, 0, 3);
+
+#ifndef NO_EXCEPTIONS
+  CHECK_THROWS_AS(vao.bind_vertex_buffer(1, other),
+                  vertex_array_object::InvalidOperationError);
+#else
+  vao.bind_vertex_buffer(1, other);
+  CHECK_EQ(vao.valid(), false);
+  CHECK_EQ(vao.get_last_error(), error::InvalidOperationError);
+#endif
+}
+
+TEST_CASE("testing that VertexArrayObject specifies the attributes again "
+          "to swap a buffer without vertex attribute bindings") {
+  GL_Context gl_context = {};
+
+  std::shared_ptr<GL_Context> glcontext =
+      std::make_shared<GL_Context>(gl_context);
+
+  std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+      std::make_shared<MockOpenGLContext>(glcontext);
+
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(2)
+      .WillOnce(testing::SetArgPointee<1>(1))
+      .WillOnce(testing::SetArgPointee<1>(2));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+      .Times(2);
+  EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(5));
+  EXPECT_CALL(*mock_opengl_context, glBindVertexArray(_))
+      .Times(testing::AnyNumber());
+  EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(_))
+      .Times(testing::AnyNumber());
+
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 20,
+                                    reinterpret_cast<const void *>(0)))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 20,
+                                    reinterpret_cast<const void *>(12)))
+      .Times(1);
+
+  // Every attribute is pointed at the new buffer, offset 40 bytes in
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 20,
+                                    reinterpret_cast<const void *>(40)))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 20,
+                                    reinterpret_cast<const void *>(52)))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glBindVertexBuffer(_, _, _, _)).Times(0);
+  EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+  vector<GLfloat> vertices(30, 0.0f);
+  VertexBufferObject vbo(string("test-vbo"), mock_opengl_context, vertices);
+  VertexBufferObject other(string("test-other"), mock_opengl_context,
+                           vertices);
+
+  VertexArrayObject vao(string("test-vao"), mock_opengl_context,
+                        std::move(vbo),
+                        VertexLayout<Attr<vec3, 0>, Attr<vec2, 1>>{});
+
+  vao.bind_vertex_buffer(0, other, 40);
+
+#ifdef NO_EXCEPTIONS
+  CHECK_EQ(vao.valid(), true);
+#endif
+}
@@ -1,3 +1,6 @@
+#include <array>
+#include <span>
+
 #include <doctest/doctest.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -58,7 +61,7 @@ void vertex_buffer_constructor_works_with_exceptions_expectations(
           testing::SaveArgPointee<1>(&buffer)));
 
   EXPECT_CALL(*mock_opengl_context, glGetError())
-      .Times(2)
+      .Times(3)
       .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
   // Bind the VBO buffer
@@ -74,8 +77,55 @@ void vertex_buffer_constructor_works_with_exceptions_expectations(
   // Called on destruction of the VertexBufferObject
   EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
 }
+
+void buffer_constructor_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLsizeiptr size,
+    GLenum usage, bool filled) {
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(testing::AnyNumber())
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+      .Times(testing::AnyNumber());
+  if (filled)
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, size, testing::NotNull(), usage))
+        .Times(1);
+  else
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage))
+        .Times(1);
+
+  // Called on destruction of the wrapper
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+}
 } // namespace sdl_opengl_cpp
 
+// Expectations for constructing a nine float VertexBufferObject with
+// the given usage hint
+static void vertex_buffer_update_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLenum usage) {
+  EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+      .Times(1)
+      .WillOnce(testing::SetArgPointee<1>(1));
+
+  EXPECT_CALL(*mock_opengl_context, glGetError())
+      .Times(3)
+      .WillRepeatedly(testing::Return(GL_NO_ERROR));
+
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context,
+              glBufferData(GL_ARRAY_BUFFER, 9 * sizeof(GLfloat), _, usage))
+      .Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0)).Times(1);
+
+  EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+}
+
 TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
   GL_Context gl_context = {};
 
@@ -204,7 +254,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
             testing::SaveArgPointee<1>(&buffer)));
 
     EXPECT_CALL(*mock_opengl_context, glGetError())
-        .Times(2)
+        .Times(3)
         .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
     // Bind the VBO buffer
@@ -267,7 +317,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
             testing::SaveArgPointee<1>(&buffer)));
 
     EXPECT_CALL(*mock_opengl_context, glGetError())
-        .Times(2)
+        .Times(3)
         .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
     // Bind the VBO buffer
@@ -310,7 +360,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
         .WillOnce(testing::DoAll(testing::SetArgPointee<1>(1)));
 
     EXPECT_CALL(*mock_opengl_context, glGetError())
-        .Times(2)
+        .Times(3)
         .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
     // glBindBuffer gets call twice, once in the constructor and once
@@ -348,7 +398,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
               .WillOnce(testing::DoAll(testing::SetArgPointee<1>(1)));
 
           EXPECT_CALL(*mock_opengl_context, glGetError())
-              .Times(2)
+              .Times(3)
               .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
           // glBindBuffer gets call once, once in the constructor.
@@ -417,7 +467,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
     ;
 
     EXPECT_CALL(*mock_opengl_context, glGetError())
-        .Times(2)
+        .Times(3)
         .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
     // glBindBuffer gets call once
@@ -500,7 +550,7 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
     ;
 
     EXPECT_CALL(*mock_opengl_context, glGetError())
-        .Times(2)
+        .Times(3)
         .WillRepeatedly(testing::Return(GL_NO_ERROR));
 
     // glBindBuffer gets call once
@@ -556,4 +606,225 @@ TEST_SUITE("sdl_opengl_cpp_vertex_buffer_object") {
     }
   }
 #endif
+
+  TEST_CASE("testing that VertexBufferObject passes the usage hint to "
+            "glBufferData") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    vertex_buffer_update_expectations(mock_opengl_context, GL_DYNAMIC_DRAW);
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8}, GL_DYNAMIC_DRAW);
+
+    CHECK_EQ(vbo.get_size(), 9 * sizeof(GLfloat));
+    CHECK_EQ(vbo.get_usage(), GL_DYNAMIC_DRAW);
+  }
+
+  TEST_CASE("testing that VertexBufferObject update() writes in place") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    vertex_buffer_update_expectations(mock_opengl_context, GL_DYNAMIC_DRAW);
+
+    std::array<GLfloat, 3> vertex = {9, 10, 11};
+
+    // The update binds and unbinds the buffer
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1))
+        .Times(1)
+        .RetiresOnSaturation();
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferSubData(GL_ARRAY_BUFFER, 3 * sizeof(GLfloat),
+                                3 * sizeof(GLfloat), vertex.data()))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0))
+        .Times(1)
+        .RetiresOnSaturation();
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8}, GL_DYNAMIC_DRAW);
+
+    vbo.update(3 * sizeof(GLfloat), std::span<const GLfloat>(vertex));
+
+    CHECK_EQ(vbo.get_size(), 9 * sizeof(GLfloat));
+  }
+
+  TEST_CASE("testing that VertexBufferObject update() rejects data past the "
+            "end of the buffer") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    vertex_buffer_update_expectations(mock_opengl_context, GL_DYNAMIC_DRAW);
+
+    EXPECT_CALL(*mock_opengl_context, glBufferSubData(_, _, _, _)).Times(0);
+
+    std::array<GLfloat, 3> vertex = {9, 10, 11};
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8}, GL_DYNAMIC_DRAW);
+
+#ifndef NO_EXCEPTIONS
+    CHECK_THROWS_WITH_AS(
+        vbo.update(7 * sizeof(GLfloat), std::span<const GLfloat>(vertex)),
+        "ERROR::VERTEX_BUFFER::BUFFER_DATA_ERROR::UPDATE_OUT_OF_RANGE",
+        BufferDataError);
+#else
+    vbo.update(7 * sizeof(GLfloat), std::span<const GLfloat>(vertex));
+
+    CHECK_EQ(vbo.valid(), false);
+    CHECK_EQ(vbo.get_last_error(), error::BufferDataError);
+#endif
+  }
+
+  TEST_CASE("testing that VertexBufferObject orphan_and_refill() orphans the "
+            "old storage") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    vertex_buffer_update_expectations(mock_opengl_context, GL_STREAM_DRAW);
+
+    std::array<GLfloat, 4> vertices = {1, 2, 3, 4};
+
+    {
+      testing::InSequence seq;
+
+      EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1))
+          .Times(1)
+          .RetiresOnSaturation();
+      EXPECT_CALL(*mock_opengl_context,
+                  glBufferData(GL_ARRAY_BUFFER, 4 * sizeof(GLfloat), nullptr,
+                               GL_STREAM_DRAW))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context, glGetError())
+          .Times(1)
+          .WillOnce(testing::Return(GL_NO_ERROR))
+          .RetiresOnSaturation();
+      EXPECT_CALL(*mock_opengl_context,
+                  glBufferSubData(GL_ARRAY_BUFFER, 0, 4 * sizeof(GLfloat),
+                                  vertices.data()))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0))
+          .Times(1)
+          .RetiresOnSaturation();
+    }
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8}, GL_STREAM_DRAW);
+
+    vbo.orphan_and_refill(std::span<const GLfloat>(vertices));
+
+    CHECK_EQ(vbo.get_size(), 4 * sizeof(GLfloat));
+  }
+
+  TEST_CASE("testing that VertexBufferObject creates and writes buffers by "
+            "name with direct state access") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    std::array<GLfloat, 3> vertex = {9, 10, 11};
+    std::array<GLfloat, 4> vertices = {1, 2, 3, 4};
+
+    EXPECT_CALL(*mock_opengl_context, direct_state_access())
+        .WillRepeatedly(testing::Return(true));
+
+    EXPECT_CALL(*mock_opengl_context, glCreateBuffers(1, _))
+        .Times(1)
+        .WillOnce(testing::SetArgPointee<1>(1));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(3)
+        .WillRepeatedly(testing::Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context,
+                glNamedBufferData(1, 9 * sizeof(GLfloat), _, GL_DYNAMIC_DRAW))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glNamedBufferSubData(1, 3 * sizeof(GLfloat),
+                                     3 * sizeof(GLfloat), vertex.data()))
+        .Times(1);
+
+    {
+      testing::InSequence seq;
+
+      EXPECT_CALL(*mock_opengl_context,
+                  glNamedBufferData(1, 4 * sizeof(GLfloat), nullptr,
+                                    GL_DYNAMIC_DRAW))
+          .Times(1);
+      EXPECT_CALL(*mock_opengl_context,
+                  glNamedBufferSubData(1, 0, 4 * sizeof(GLfloat),
+                                       vertices.data()))
+          .Times(1);
+    }
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(1);
+
+    // Nothing is bound to edit the buffer
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(_, _)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(_, _)).Times(0);
+
+    VertexBufferObject vbo(string("test-vbo"), mock_opengl_context,
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8}, GL_DYNAMIC_DRAW);
+
+    CHECK_EQ(vbo.get_buffer(), 1);
+
+    vbo.update(3 * sizeof(GLfloat), std::span<const GLfloat>(vertex));
+    vbo.orphan_and_refill(std::span<const GLfloat>(vertices));
+
+    CHECK_EQ(vbo.get_size(), 4 * sizeof(GLfloat));
+  }
+
+  TEST_CASE("testing that VertexBufferObject uploads contiguous ranges without "
+            "copying") {
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    // An interleaved vertex with a float position and packed color
+    struct Vertex {
+      GLfloat position[3];
+      GLubyte color[4];
+    };
+
+    std::array<Vertex, 3> vertices = {{{{0, 0, 0}, {255, 0, 0, 255}},
+                                       {{1, 0, 0}, {0, 255, 0, 255}},
+                                       {{0, 1, 0}, {0, 0, 255, 255}}}};
+
+    std::vector<GLushort> indices = {0, 1, 2};
+
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(2)
+        .WillRepeatedly(testing::SetArgPointee<1>(1));
+
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(6)
+        .WillRepeatedly(testing::Return(GL_NO_ERROR));
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 1))
+        .Times(2);
+
+    // The data pointer is the caller's memory, not a temporary copy
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, sizeof(vertices),
+                             static_cast<const void *>(vertices.data()),
+                             GL_STATIC_DRAW))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 3 * sizeof(GLushort),
+                             static_cast<const void *>(indices.data()),
+                             GL_DYNAMIC_DRAW))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, 0))
+        .Times(2);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(2);
+
+    VertexBufferObject vertex_vbo(string("test-vbo"), mock_opengl_context,
+                                  vertices);
+
+    VertexBufferObject index_vbo(string("test-vbo"), mock_opengl_context,
+                                 std::span<const GLushort>(indices),
+                                 GL_DYNAMIC_DRAW);
+
+    CHECK_EQ(vertex_vbo.get_size(), sizeof(vertices));
+    CHECK_EQ(index_vbo.get_size(), 3 * sizeof(GLushort));
+  }
 }
@@ -0,0 +1,211 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "vertex_compression.h"
+#include "vertex_layout.h"
+
+using namespace sdl_opengl_cpp;
+using namespace sdl_opengl_cpp::vertex_compression;
+
+namespace {
+
+// Values that hit every clamp, rounding and half float special case,
+// followed by a spread of ordinary values.  The count isn't a
+// multiple of any SIMD width so the scalar tail runs too.
+std::vector<GLfloat> test_values() {
+  std::vector<GLfloat> values = {
+      0.0f,
+      -0.0f,
+      1.0f,
+      -1.0f,
+      0.5f,
+      -0.5f,
+      2.0f,
+      -2.0f,
+      // Ties for the 8-bit and 16-bit scales
+      0.5f / 127.0f,
+      1.5f / 127.0f,
+      0.5f / 255.0f,
+      2.5f / 255.0f,
+      65504.0f,
+      65519.0f,
+      65520.0f,
+      -65536.0f,
+      6.1035156e-05f,
+      6.0e-08f,
+      2.9802322e-08f,
+      1.0e-30f,
+      std::numeric_limits<GLfloat>::denorm_min(),
+      std::numeric_limits<GLfloat>::infinity(),
+      -std::numeric_limits<GLfloat>::infinity(),
+      std::numeric_limits<GLfloat>::quiet_NaN(),
+      -std::numeric_limits<GLfloat>::quiet_NaN(),
+  };
+
+  for (int i = 0; i < 1000; i++)
+    values.push_back(std::sin(static_cast<GLfloat>(i) * 0.37f) *
+                     static_cast<GLfloat>(1 + i % 7) * 0.3f);
+
+  values.push_back(0.25f);
+
+  return values;
+}
+
+// Run a check at every instruction set this machine supports
+template <typename Check> void for_each_simd_level(Check check) {
+  SIMDLevel supported = set_simd_level(SIMDLevel::AVX2);
+
+  for (SIMDLevel level :
+       {SIMDLevel::Scalar, SIMDLevel::SSE2, SIMDLevel::AVX2}) {
+    if (level > supported)
+      break;
+
+    CAPTURE(static_cast<int>(level));
+    CHECK_EQ(set_simd_level(level), level);
+    check();
+  }
+
+  set_simd_level(supported);
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_vertex_compression") {
+  TEST_CASE("testing that float_to_half encodes special values") {
+    CHECK_EQ(float_to_half(0.0f), 0x0000);
+    CHECK_EQ(float_to_half(-0.0f), 0x8000);
+    CHECK_EQ(float_to_half(1.0f), 0x3c00);
+    CHECK_EQ(float_to_half(-2.0f), 0xc000);
+    CHECK_EQ(float_to_half(65504.0f), 0x7bff);
+    CHECK_EQ(float_to_half(65519.0f), 0x7bff);
+    CHECK_EQ(float_to_half(65520.0f), 0x7c00);
+    CHECK_EQ(float_to_half(std::numeric_limits<GLfloat>::infinity()), 0x7c00);
+    CHECK_EQ(float_to_half(6.1035156e-05f), 0x0400);
+    CHECK_EQ(float_to_half(5.9604645e-08f), 0x0001);
+    CHECK_EQ(float_to_half(1.0e-30f), 0x0000);
+
+    GLhalf nan = float_to_half(std::numeric_limits<GLfloat>::quiet_NaN());
+    CHECK_EQ(nan & 0x7c00, 0x7c00);
+    CHECK_NE(nan & 0x3ff, 0);
+
+    // 1 + 2^-11 is halfway between two halves, ties go to even
+    CHECK_EQ(float_to_half(1.00048828125f), 0x3c00);
+    CHECK_EQ(float_to_half(1.00146484375f), 0x3c02);
+  }
+
+  TEST_CASE("testing that half_to_float reverses float_to_half") {
+    for (GLfloat value : {0.0f, 1.0f, -2.5f, 0.333251953125f, 65504.0f,
+                          6.1035156e-05f, 5.9604645e-08f}) {
+      CHECK_EQ(half_to_float(float_to_half(value)), value);
+    }
+
+    CHECK(std::isinf(half_to_float(0x7c00)));
+    CHECK(std::isnan(half_to_float(0x7e00)));
+  }
+
+  TEST_CASE("testing that the normalized encoders clamp and round") {
+    CHECK_EQ(float_to_snorm8(1.0f), 127);
+    CHECK_EQ(float_to_snorm8(-1.0f), -127);
+    CHECK_EQ(float_to_snorm8(-2.0f), -127);
+    CHECK_EQ(float_to_snorm8(0.5f), 64);
+    CHECK_EQ(float_to_unorm8(1.0f), 255);
+    CHECK_EQ(float_to_unorm8(-1.0f), 0);
+    CHECK_EQ(float_to_unorm8(0.5f), 128);
+    CHECK_EQ(float_to_snorm16(1.0f), 32767);
+    CHECK_EQ(float_to_snorm16(-1.0f), -32767);
+    CHECK_EQ(float_to_unorm16(1.0f), 65535);
+    CHECK_EQ(float_to_unorm16(0.5f), 32768);
+
+    GLfloat nan = std::numeric_limits<GLfloat>::quiet_NaN();
+    CHECK_EQ(float_to_snorm8(nan), -127);
+    CHECK_EQ(float_to_unorm16(nan), 0);
+  }
+
+  TEST_CASE("testing that pack_snorm_2_10_10_10 packs the components") {
+    CHECK_EQ(pack_snorm_2_10_10_10(0.0f, 0.0f, 0.0f, 0.0f), 0u);
+    CHECK_EQ(pack_snorm_2_10_10_10(1.0f, 0.0f, 0.0f, 0.0f), 0x1ffu);
+    CHECK_EQ(pack_snorm_2_10_10_10(0.0f, 1.0f, 0.0f, 0.0f), 0x1ffu << 10);
+    CHECK_EQ(pack_snorm_2_10_10_10(0.0f, 0.0f, -1.0f, 0.0f), 0x201u << 20);
+    CHECK_EQ(pack_snorm_2_10_10_10(0.0f, 0.0f, 0.0f, 1.0f), 1u << 30);
+    CHECK_EQ(pack_snorm_2_10_10_10(0.0f, 0.0f, 0.0f, -1.0f), 3u << 30);
+  }
+
+  TEST_CASE("testing that every SIMD level encodes like the scalar encoders") {
+    std::vector<GLfloat> values = test_values();
+
+    for_each_simd_level([&]() {
+      std::vector<GLhalf> halves(values.size());
+      std::vector<GLbyte> snorm8(values.size());
+      std::vector<GLubyte> unorm8(values.size());
+      std::vector<GLshort> snorm16(values.size());
+      std::vector<GLushort> unorm16(values.size());
+
+      CHECK_EQ(encode_half(values, halves), values.size());
+      CHECK_EQ(encode_snorm8(values, snorm8), values.size());
+      CHECK_EQ(encode_unorm8(values, unorm8), values.size());
+      CHECK_EQ(encode_snorm16(values, snorm16), values.size());
+      CHECK_EQ(encode_unorm16(values, unorm16), values.size());
+
+      size_t mismatches = 0;
+      for (size_t i = 0; i < values.size(); i++) {
+        mismatches += (halves[i] != float_to_half(values[i])) +
+                      (snorm8[i] != float_to_snorm8(values[i])) +
+                      (unorm8[i] != float_to_unorm8(values[i])) +
+                      (snorm16[i] != float_to_snorm16(values[i])) +
+                      (unorm16[i] != float_to_unorm16(values[i]));
+      }
+      CHECK_EQ(mismatches, 0);
+
+      std::vector<GLuint> packed(values.size() / 4);
+      CHECK_EQ(encode_snorm_2_10_10_10(values, packed), values.size() / 4);
+
+      mismatches = 0;
+      for (size_t i = 0; i < packed.size(); i++) {
+        mismatches +=
+            (packed[i] != pack_snorm_2_10_10_10(values[i * 4], values[i * 4 + 1],
+                                                values[i * 4 + 2],
+                                                values[i * 4 + 3]));
+      }
+      CHECK_EQ(mismatches, 0);
+    });
+  }
+
+  TEST_CASE("testing that the encoders stop at the shorter span") {
+    std::vector<GLfloat> values(40, 0.5f);
+    std::vector<GLshort> encoded(20, 0);
+
+    CHECK_EQ(encode_snorm16(values, encoded), 20);
+    CHECK_EQ(encoded[19], float_to_snorm16(0.5f));
+
+    std::vector<GLuint> packed(20, 0);
+    CHECK_EQ(encode_snorm_2_10_10_10(std::span(values).first(10), packed), 2);
+    CHECK_EQ(packed[2], 0u);
+  }
+
+  TEST_CASE("testing that compressed formats fit in a VertexLayout") {
+    using CompressedLayout =
+        VertexLayout<Attr<vec3, 0>, Attr<snorm_2_10_10_10, 1>,
+                     Attr<half2, 2>, Attr<unorm8x4, 3>>;
+
+    // 12 + 4 + 4 + 4 bytes, half of the 48 with float normals, uvs
+    // and colors
+    CHECK_EQ(CompressedLayout::stride, 24);
+    CHECK_EQ(CompressedLayout::attributes[1].components, 4);
+    CHECK_EQ(CompressedLayout::attributes[1].type, GL_INT_2_10_10_10_REV);
+    CHECK_EQ(CompressedLayout::attributes[1].normalized, GL_TRUE);
+    CHECK_FALSE(CompressedLayout::attributes[1].integer);
+    CHECK_EQ(CompressedLayout::attributes[2].type, GL_HALF_FLOAT);
+    CHECK_EQ(CompressedLayout::attributes[2].normalized, GL_FALSE);
+    CHECK_EQ(CompressedLayout::offset<2>, 16);
+    CHECK_EQ(CompressedLayout::offset<3>, 20);
+
+    CHECK_EQ(snorm16x2::size, 4);
+    CHECK_EQ(snorm16x4::type, GL_SHORT);
+    CHECK_EQ(unorm16x4::size, 8);
+    CHECK_EQ(snorm8x4::normalized, GL_TRUE);
+  }
+}
@@ -0,0 +1,59 @@
+#include <doctest/doctest.h>
+
+#include "vertex_layout.h"
+
+using namespace sdl_opengl_cpp;
+
+namespace {
+
+struct ColoredVertex {
+  GLfloat position[3];
+  GLubyte color[4];
+  GLfloat uv[2];
+};
+
+using ColoredLayout =
+    VertexLayout<Attr<vec3, 0>, Attr<rgba8_norm, 1>, Attr<vec2, 2>>;
+
+// These are checked when the test is compiled
+static_assert(ColoredLayout::stride == 24);
+static_assert(ColoredLayout::offset<0> == 0);
+static_assert(ColoredLayout::offset<1> == 12);
+static_assert(ColoredLayout::offset<2> == 16);
+static_assert(ColoredLayout::matches<ColoredVertex>);
+static_assert(!ColoredLayout::matches<GLfloat[3]>);
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_vertex_layout") {
+  TEST_CASE("testing that VertexLayout computes the attribute table") {
+    constexpr auto &attributes = ColoredLayout::attributes;
+
+    CHECK_EQ(ColoredLayout::size, 3);
+
+    CHECK_EQ(attributes[0].location, 0);
+    CHECK_EQ(attributes[0].components, 3);
+    CHECK_EQ(attributes[0].type, GL_FLOAT);
+    CHECK_EQ(attributes[0].normalized, GL_FALSE);
+
+    CHECK_EQ(attributes[1].location, 1);
+    CHECK_EQ(attributes[1].components, 4);
+    CHECK_EQ(attributes[1].type, GL_UNSIGNED_BYTE);
+    CHECK_EQ(attributes[1].normalized, GL_TRUE);
+    CHECK_EQ(attributes[1].offset, 12);
+
+    CHECK_EQ(attributes[2].location, 2);
+    CHECK_EQ(attributes[2].offset, 16);
+  }
+
+  TEST_CASE("testing that VertexLayout marks integer attributes") {
+    using SkinnedLayout =
+        VertexLayout<Attr<vec3, 0>, Attr<u8vec4, 3>, Attr<vec4, 4>>;
+
+    CHECK_EQ(SkinnedLayout::stride, 32);
+    CHECK_FALSE(SkinnedLayout::attributes[0].integer);
+    CHECK(SkinnedLayout::attributes[1].integer);
+    CHECK_EQ(SkinnedLayout::attributes[1].location, 3);
+    CHECK_EQ(SkinnedLayout::attributes[2].offset, 16);
+  }
+}
@@ -0,0 +1,256 @@
+#include <array>
+#include <span>
+#include <string>
+
+#include <doctest/doctest.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "gl_context.h"
+#include "mock_opengl.h"
+#include "vertex_pulling.h"
+
+using ::testing::_;
+using testing::Return;
+using testing::SetArgPointee;
+
+using namespace sdl_opengl_cpp;
+using namespace vertex_pulling;
+
+namespace {
+
+// A position, texture coordinates, a packed normal and a color, 24
+// bytes per vertex
+using PackedVertex =
+    VertexLayout<Attr<vec3, 0>, Attr<half2, 1>, Attr<snorm_2_10_10_10, 2>,
+                 Attr<u8vec4, 3>>;
+
+bool contains(const string &source, const string &text) {
+  return source.find(text) != string::npos;
+}
+
+// Expectations for a ShaderStorageBufferObject holding size bytes in
+// buffer, bound once as pulled vertices
+void pulled_storage_expectations(
+    std::shared_ptr<MockOpenGLContext> &mock_opengl_context, GLuint buffer,
+    GLsizeiptr size) {
+  EXPECT_CALL(*mock_opengl_context,
+              glBufferData(GL_ARRAY_BUFFER, size, _, GL_DYNAMIC_DRAW))
+      .Times(1);
+  EXPECT_CALL(*mock_opengl_context,
+              glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buffer))
+      .Times(1);
+}
+
+} // namespace
+
+TEST_SUITE("sdl_opengl_cpp_vertex_pulling") {
+  TEST_CASE("testing that fetch_source reads every attribute of a layout") {
+    string source = fetch_source<PackedVertex>(3, "mesh");
+
+    CHECK(contains(source, "layout(std430, binding = 3) readonly buffer "
+                           "mesh_vertices {\n  uint mesh_data[];\n};"));
+
+    // Six words per vertex
+    CHECK(contains(source, "uint base = vertex * 6u;"));
+
+    CHECK(contains(source, "vec3 mesh_0(uint vertex) {"));
+    CHECK(contains(source, "uintBitsToFloat(mesh_data[base + 2u])"));
+    CHECK(contains(source, "vec3 mesh_0() {\n  return "
+                           "mesh_0(uint(gl_VertexID));\n}"));
+
+    CHECK(contains(source, "vec2 mesh_1(uint vertex) {"));
+    CHECK(contains(source, "unpackHalf2x16(mesh_data[base + 3u]).x"));
+    CHECK(contains(source, "unpackHalf2x16(mesh_data[base + 3u] >> 16u).x"));
+
+    CHECK(contains(source, "vec4 mesh_2(uint vertex) {"));
+    CHECK(contains(source, "max(float(bitfieldExtract(int(mesh_data[base + "
+                           "4u]), 20, 10)) / 511.0, -1.0)"));
+    CHECK(contains(source, "max(float(bitfieldExtract(int(mesh_data[base + "
+                           "4u]), 30, 2)) / 1.0, -1.0)"));
+
+    // Integer attributes keep their values
+    CHECK(contains(source, "uvec4 mesh_3(uint vertex) {"));
+    CHECK(contains(source, "bitfieldExtract(mesh_data[base + 5u], 24, 8)"));
+  }
+
+  TEST_CASE("testing that fetch_source normalizes like glVertexAttribPointer") {
+    std::array<VertexAttribute, 3> attributes = {{
+        {0, 2, GL_UNSIGNED_SHORT, GL_TRUE, false, 0},
+        {1, 1, GL_SHORT, GL_FALSE, false, 4},
+        {2, 1, GL_BYTE, GL_FALSE, true, 6},
+    }};
+
+    string source = fetch_source(attributes, 8, 0);
+
+    CHECK(contains(source, "vec2 pulled_0(uint vertex) {"));
+    CHECK(contains(source,
+                   "float(bitfieldExtract(pulled_data[base + 0u], 16, 16)) / "
+                   "65535.0"));
+    CHECK(contains(source, "float pulled_1(uint vertex) {"));
+    CHECK(contains(source,
+                   "return float(bitfieldExtract(int(pulled_data[base + 1u]), "
+                   "0, 16));"));
+    CHECK(contains(source, "int pulled_2(uint vertex) {"));
+    CHECK(contains(source,
+                   "return bitfieldExtract(int(pulled_data[base + 1u]), 16, "
+                   "8);"));
+  }
+
+  TEST_CASE("testing that fetch_source rejects layouts it can't read") {
+    std::array<VertexAttribute, 1> position = {{
+        {0, 3, GL_FLOAT, GL_FALSE, false, 0},
+    }};
+
+    // Not a whole number of words
+    CHECK(fetch_source(position, 14, 0).empty());
+
+    // Past the end of the vertex
+    CHECK(fetch_source(position, 8, 0).empty());
+
+    std::array<VertexAttribute, 1> unaligned = {{
+        {0, 1, GL_FLOAT, GL_FALSE, false, 2},
+    }};
+    CHECK(fetch_source(unaligned, 8, 0).empty());
+
+    std::array<VertexAttribute, 1> doubles = {{
+        {0, 1, GL_DOUBLE, GL_FALSE, false, 0},
+    }};
+    CHECK(fetch_source(doubles, 8, 0).empty());
+
+    std::array<VertexAttribute, 1> integer_half = {{
+        {0, 2, GL_HALF_FLOAT, GL_FALSE, true, 0},
+    }};
+    CHECK(fetch_source(integer_half, 4, 0).empty());
+  }
+
+  TEST_CASE("testing that VertexPuller draws different layouts with one "
+            "vertex array object") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context,
+                supports(GLFeature::ShaderStorageBufferObject))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_opengl_context,
+                glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, _))
+        .Times(2)
+        .WillRepeatedly(SetArgPointee<1>(16));
+    EXPECT_CALL(*mock_opengl_context, glGenBuffers(1, _))
+        .Times(3)
+        .WillOnce(SetArgPointee<1>(1))
+        .WillOnce(SetArgPointee<1>(2))
+        .WillOnce(SetArgPointee<1>(3));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(testing::AnyNumber())
+        .WillRepeatedly(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glBindBuffer(GL_ARRAY_BUFFER, _))
+        .Times(testing::AnyNumber());
+    EXPECT_CALL(*mock_opengl_context,
+                glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(GLushort), _,
+                             GL_STATIC_DRAW))
+        .Times(1);
+
+    pulled_storage_expectations(mock_opengl_context, 1,
+                                3 * PackedVertex::stride);
+    pulled_storage_expectations(mock_opengl_context, 2,
+                                4 * 3 * sizeof(GLfloat));
+
+    // One vertex array object, never given any attributes
+    EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(7));
+    EXPECT_CALL(*mock_opengl_context, glBindVertexArray(7)).Times(2);
+    EXPECT_CALL(*mock_opengl_context, glEnableVertexAttribArray(_)).Times(0);
+    EXPECT_CALL(*mock_opengl_context, glVertexAttribPointer(_, _, _, _, _, _))
+        .Times(0);
+
+    EXPECT_CALL(*mock_opengl_context, glDrawArrays(GL_TRIANGLES, 0, 3))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 3))
+        .Times(1);
+    EXPECT_CALL(*mock_opengl_context,
+                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr))
+        .Times(1);
+
+    EXPECT_CALL(*mock_opengl_context, glDeleteBuffers(1, _)).Times(3);
+    EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+
+    ShaderStorageBufferObject triangle(string("test-triangle"),
+                                       mock_opengl_context,
+                                       3 * PackedVertex::stride);
+    ShaderStorageBufferObject quad(string("test-quad"), mock_opengl_context,
+                                   4 * 3 * sizeof(GLfloat));
+    std::array<GLuint, 6> quad_indices = {0, 1, 2, 2, 3, 0};
+    IndexBufferObject indices(string("test-ibo"), mock_opengl_context,
+                              quad_indices, 4);
+
+    VertexPuller puller(string("test-puller"), mock_opengl_context, 3);
+    CHECK_EQ(puller.get_binding(), 3);
+
+    puller.bind_vertices(triangle);
+    puller.draw_arrays(GL_TRIANGLES, 0, 3);
+
+    puller.bind_vertices(quad);
+    puller.draw_elements(indices, GL_TRIANGLES);
+  }
+
+#ifndef NO_EXCEPTIONS
+
+  TEST_CASE("testing that VertexPuller throws when the vertex array object "
+            "can't be generated") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(0));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(1)
+        .WillOnce(Return(GL_OUT_OF_MEMORY));
+
+    CHECK_THROWS_AS(
+        VertexPuller(string("test-puller"), mock_opengl_context),
+        GenVertexArraysError);
+  }
+
+  TEST_CASE("testing that a moved from VertexPuller throws on draw") {
+    GL_Context gl_context = {};
+
+    std::shared_ptr<GL_Context> glcontext =
+        std::make_shared<GL_Context>(gl_context);
+
+    std::shared_ptr<MockOpenGLContext> mock_opengl_context =
+        std::make_shared<MockOpenGLContext>(glcontext);
+
+    EXPECT_CALL(*mock_opengl_context, glGenVertexArrays(1, _))
+        .Times(1)
+        .WillOnce(SetArgPointee<1>(7));
+    EXPECT_CALL(*mock_opengl_context, glGetError())
+        .Times(1)
+        .WillOnce(Return(GL_NO_ERROR));
+    EXPECT_CALL(*mock_opengl_context, glDeleteVertexArrays(1, _)).Times(1);
+
+    VertexPuller puller(string("test-puller"), mock_opengl_context);
+    VertexPuller other(std::move(puller));
+
+    CHECK(puller.is_in_unspecified_state());
+    CHECK_FALSE(other.is_in_unspecified_state());
+    CHECK_THROWS_AS(puller.draw_arrays(GL_TRIANGLES, 0, 3),
+                    VertexPullerUnspecifiedStateError);
+  }
+
+#endif
+}